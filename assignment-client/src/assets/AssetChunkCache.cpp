@@ -0,0 +1,140 @@
+//
+//  AssetChunkCache.cpp
+//  assignment-client/src/assets
+//
+//  Created by Roxanne Skelly on 2019-06-20.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetChunkCache.h"
+
+#include <algorithm>
+
+const qint64 AssetChunkCache::CHUNK_SIZE = 256 * 1024;
+const qint64 AssetChunkCache::DEFAULT_MAX_SIZE = 256 * 1024 * 1024;
+
+AssetChunkCache::AssetChunkCache(qint64 maxSize) : _maxSize(maxSize) {
+}
+
+void AssetChunkCache::setMaxSize(qint64 maxSize) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxSize = maxSize;
+    trim();
+}
+
+qint64 AssetChunkCache::getMaxSize() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxSize;
+}
+
+AssetChunkCache::Chunk AssetChunkCache::getChunk(const AssetUtils::AssetHash& hash, int index, qint64 assetSize,
+                                                 const Loader& loader) {
+    Key key { hash, index };
+    std::promise<Chunk> promise;
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        auto it = _chunks.find(key);
+        if (it != _chunks.end()) {
+            ++_stats.hits;
+            _lru.splice(_lru.begin(), _lru, it->lruPosition);
+            return it->chunk;
+        }
+
+        auto loadingIt = _loading.find(key);
+        if (loadingIt != _loading.end()) {
+            ++_stats.coalesced;
+            auto load = loadingIt.value();
+            lock.unlock();
+            return load.get();
+        }
+
+        ++_stats.misses;
+        _loading.insert(key, promise.get_future().share());
+    }
+
+    // load outside the lock, anyone else after this chunk waits on the promise
+    qint64 offset = (qint64)index * CHUNK_SIZE;
+    qint64 size = std::min(CHUNK_SIZE, assetSize - offset);
+
+    Chunk chunk;
+    if (size > 0) {
+        QByteArray data;
+        if (loader(offset, size, data) && data.size() == size) {
+            chunk = std::make_shared<const QByteArray>(std::move(data));
+        }
+    }
+
+    if (!chunk) {
+        ++_stats.failures;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // an eviction while we were loading means the asset is going away, don't keep it
+        if (_loading.remove(key) > 0 && chunk) {
+            _lru.push_front(key);
+            _chunks.insert(key, { chunk, _lru.begin() });
+            _size += chunk->size();
+            trim();
+        }
+    }
+
+    promise.set_value(chunk);
+    return chunk;
+}
+
+void AssetChunkCache::evict(const AssetUtils::AssetHash& hash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto it = _chunks.begin(); it != _chunks.end();) {
+        if (it.key().first == hash) {
+            _size -= it->chunk->size();
+            _lru.erase(it->lruPosition);
+            it = _chunks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (auto it = _loading.begin(); it != _loading.end();) {
+        if (it.key().first == hash) {
+            it = _loading.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void AssetChunkCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _lru.clear();
+    _chunks.clear();
+    _loading.clear();
+    _size = 0;
+}
+
+qint64 AssetChunkCache::getSize() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _size;
+}
+
+int AssetChunkCache::getNumChunks() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _chunks.size();
+}
+
+void AssetChunkCache::trim() {
+    while (_size > _maxSize && !_lru.empty()) {
+        auto it = _chunks.find(_lru.back());
+        _size -= it->chunk->size();
+        _chunks.erase(it);
+        _lru.pop_back();
+        ++_stats.evictions;
+    }
+}
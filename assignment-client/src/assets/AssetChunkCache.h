@@ -0,0 +1,89 @@
+//
+//  AssetChunkCache.h
+//  assignment-client/src/assets
+//
+//  Created by Roxanne Skelly on 2019-06-20.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetChunkCache_h
+#define hifi_AssetChunkCache_h
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+
+#include <AssetUtils.h>
+
+// Size bounded LRU cache of fixed size chunks of asset files, keyed by asset hash and chunk index.
+//
+//   Transfers asking for a chunk that is already being loaded wait for that load rather than starting their own, so
+//   a crowd requesting the same asset at once reads it from disk once.
+//
+//   AssetChunkCache is thread-safe.
+class AssetChunkCache {
+public:
+    static const qint64 CHUNK_SIZE;
+    static const qint64 DEFAULT_MAX_SIZE;
+
+    using Chunk = std::shared_ptr<const QByteArray>;
+
+    // reads size bytes of the asset starting at offset into data
+    using Loader = std::function<bool(qint64 offset, qint64 size, QByteArray& data)>;
+
+    struct Stats {
+        std::atomic<quint64> hits { 0 };
+        std::atomic<quint64> coalesced { 0 };   // misses that waited on a load already in progress
+        std::atomic<quint64> misses { 0 };
+        std::atomic<quint64> failures { 0 };
+        std::atomic<quint64> evictions { 0 };
+    };
+
+    AssetChunkCache(qint64 maxSize = DEFAULT_MAX_SIZE);
+
+    void setMaxSize(qint64 maxSize);
+    qint64 getMaxSize() const;
+
+    // returns the chunk at index of an asset of assetSize bytes, or nullptr if it couldn't be loaded
+    Chunk getChunk(const AssetUtils::AssetHash& hash, int index, qint64 assetSize, const Loader& loader);
+
+    // drops the chunks of an asset, before it is deleted
+    void evict(const AssetUtils::AssetHash& hash);
+    void clear();
+
+    qint64 getSize() const;
+    int getNumChunks() const;
+    const Stats& getStats() const { return _stats; }
+
+private:
+    using Key = QPair<AssetUtils::AssetHash, int>;
+
+    struct Entry {
+        Chunk chunk;
+        std::list<Key>::iterator lruPosition;
+    };
+
+    void trim();
+
+    mutable std::mutex _mutex;
+    qint64 _maxSize;
+    qint64 _size { 0 };
+
+    std::list<Key> _lru;        // most recently used first
+    QHash<Key, Entry> _chunks;
+    QHash<Key, std::shared_future<Chunk>> _loading;
+
+    Stats _stats;
+};
+
+#endif // hifi_AssetChunkCache_h
@@ -12,6 +12,7 @@
 
 #include "AssetServer.h"
 
+#include <algorithm>
 #include <thread>
 #include <memory>
 
@@ -115,6 +116,7 @@ void AssetServer::bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetU
     if (it == _pendingBakes.end()) {
         auto task = std::make_shared<BakeAssetTask>(assetHash, assetPath, filePath);
         task->setAutoDelete(false);
+        task->setTextureCompressionThreads(_textureCompressionThreads);
         _pendingBakes[assetHash] = task;
 
         connect(task.get(), &BakeAssetTask::bakeComplete, this, &AssetServer::handleCompletedBake);
@@ -387,6 +389,10 @@ void AssetServer::completeSetup() {
                     " (" << maxBandwidth << "bits/s)";
     }
 
+    // the oven compresses each texture on this many threads, bakes run one at a time
+    static const QString TEXTURE_COMPRESSION_THREADS_OPTION = "texture_compression_threads";
+    _textureCompressionThreads = std::max(0, assetServerObject[TEXTURE_COMPRESSION_THREADS_OPTION].toInt(0));
+
     // get the path to the asset folder from the domain server settings
     static const QString ASSETS_PATH_OPTION = "assets_path";
     auto assetsJSONValue = assetServerObject[ASSETS_PATH_OPTION];
@@ -453,6 +459,17 @@ void AssetServer::completeSetup() {
         _filesizeLimit = assetsFilesizeLimit * BITS_PER_MEGABITS;
     }
 
+    // get the size of the in-memory cache of asset chunks
+    static const QString ASSETS_CACHE_SIZE_OPTION = "assets_cache_size";
+    static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+    auto assetsCacheSize = (qint64)assetServerObject[ASSETS_CACHE_SIZE_OPTION].toInt(
+        AssetChunkCache::DEFAULT_MAX_SIZE / BYTES_PER_MEGABYTE);
+
+    if (assetsCacheSize > 0) {
+        _chunkCache = std::make_shared<AssetChunkCache>(assetsCacheSize * BYTES_PER_MEGABYTE);
+        qCInfo(asset_server) << "Caching up to" << assetsCacheSize << "MB of asset data in memory.";
+    }
+
     PathUtils::removeTemporaryApplicationDirs();
     PathUtils::removeTemporaryApplicationDirs("Oven");
 
@@ -531,6 +548,10 @@ void AssetServer::cleanupUnmappedFiles() {
             }
             if (!matched) {
                 // remove the unmapped file
+                _mappedFiles.evict(fileInfo.absoluteFilePath());
+                if (_chunkCache) {
+                    _chunkCache->evict(filename);
+                }
                 QFile removeableFile { fileInfo.absoluteFilePath() };
 
                 if (removeableFile.remove()) {
@@ -872,7 +893,7 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _filesDirectory, _mappedFiles, _chunkCache);
     _transferTaskPool.start(task);
 }
 
@@ -962,6 +983,41 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     });
 
+    static const double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+
+    const auto& transferStats = _mappedFiles.getStats();
+    QJsonObject transfers;
+    transfers["1. Downloads"] = transferStats.numStreams.load();
+    transfers["2. In Flight (MB)"] = (double)transferStats.bytesInFlight.load() / BYTES_PER_MEGABYTE;
+    transfers["3. Streamed (MB)"] = (double)transferStats.bytesStreamed.load() / BYTES_PER_MEGABYTE;
+    transfers["4. Mapped Files"] = transferStats.numMappings.load();
+    transfers["5. Hot Files"] = _mappedFiles.getNumHotFiles();
+
+    MemoryInfo memoryInfo;
+    if (getMemoryInfo(memoryInfo)) {
+        transfers["6. RSS (MB)"] = (double)memoryInfo.processUsedMemoryBytes / BYTES_PER_MEGABYTE;
+        transfers["7. Peak RSS (MB)"] = (double)memoryInfo.processPeakUsedMemoryBytes / BYTES_PER_MEGABYTE;
+    }
+    serverStats["transfers"] = transfers;
+
+    if (_chunkCache) {
+        const auto& cacheStats = _chunkCache->getStats();
+        auto hits = cacheStats.hits.load();
+        auto coalesced = cacheStats.coalesced.load();
+        auto requests = hits + coalesced + cacheStats.misses.load();
+
+        QJsonObject cache;
+        cache["1. Hit Ratio"] = requests > 0 ? (double)(hits + coalesced) / requests : 0.0;
+        cache["2. Hits"] = (double)hits;
+        cache["3. Coalesced"] = (double)coalesced;
+        cache["4. Misses"] = (double)cacheStats.misses.load();
+        cache["5. Evictions"] = (double)cacheStats.evictions.load();
+        cache["6. Chunks"] = _chunkCache->getNumChunks();
+        cache["7. Used (MB)"] = (double)_chunkCache->getSize() / BYTES_PER_MEGABYTE;
+        cache["8. Capacity (MB)"] = (double)_chunkCache->getMaxSize() / BYTES_PER_MEGABYTE;
+        serverStats["cache"] = cache;
+    }
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
@@ -1175,6 +1231,10 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
         // we now have a set of hashes that are unmapped - we will delete those asset files
         for (auto& hash : hashesToCheckForDeletion) {
             // remove the unmapped file
+            _mappedFiles.evict(_filesDirectory.absoluteFilePath(hash));
+            if (_chunkCache) {
+                _chunkCache->evict(hash);
+            }
             QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
 
             if (removeableFile.remove()) {
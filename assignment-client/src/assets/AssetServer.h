@@ -19,6 +19,7 @@
 #include <ThreadedAssignment.h>
 
 #include "AssetUtils.h"
+#include "MappedAssetFiles.h"
 #include "ReceivedMessage.h"
 
 #include "RegisteredMetaTypes.h"
@@ -159,9 +160,18 @@ private:
     /// Task pool for handling uploads and downloads of assets
     QThreadPool _transferTaskPool;
 
+    /// Mappings of the asset files being sent, shared by the transfers
+    MappedAssetFiles _mappedFiles;
+
+    /// Chunks of the most requested assets, null when the cache is turned off
+    std::shared_ptr<AssetChunkCache> _chunkCache;
+
     QHash<AssetUtils::AssetHash, std::shared_ptr<BakeAssetTask>> _pendingBakes;
     QThreadPool _bakingTaskPool;
 
+    /// Most threads the oven compresses a texture on, 0 for one per core
+    int _textureCompressionThreads { 0 };
+
     QMutex _queuedRequestsMutex;
     bool _isQueueingRequests { true };
     using RequestQueue = QVector<QPair<QSharedPointer<ReceivedMessage>, SharedNodePointer>>;
@@ -66,6 +66,9 @@ void BakeAssetTask::run() {
         "-o", tempOutputDir,
         "-t", extension,
     };
+    if (_textureCompressionThreads > 0) {
+        args << "--texture-compression-threads" << QString::number(_textureCompressionThreads);
+    }
 
     _ovenProcess.reset(new QProcess());
 
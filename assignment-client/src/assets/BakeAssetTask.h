@@ -31,6 +31,9 @@ public:
     bool isBaking() { return _isBaking.load(); }
     bool wasAborted() const { return _wasAborted.load(); }
 
+    // the most threads the oven compresses a texture on, 0 for one per core
+    void setTextureCompressionThreads(int numThreads) { _textureCompressionThreads = numThreads; }
+
     void run() override;
 
 public slots:
@@ -48,6 +51,7 @@ private:
     QString _filePath;
     std::unique_ptr<QProcess> _ovenProcess { nullptr };
     std::atomic<bool> _wasAborted { false };
+    int _textureCompressionThreads { 0 };
 };
 
 #endif // hifi_BakeAssetTask_h
@@ -0,0 +1,215 @@
+//
+//  MappedAssetFiles.cpp
+//  assignment-client/src/assets
+//
+//  Created by Roxanne Skelly on 2019-06-19.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MappedAssetFiles.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtCore/QFileInfo>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+const int MappedAssetFiles::DEFAULT_MAX_HOT_FILES = 256;
+
+// sequential readahead takes over once the stream gets going
+static const qint64 MAX_PREFETCH_BYTES = 4 * 1024 * 1024;
+
+MappedAssetFile::MappedAssetFile(const QString& filePath) :
+    _hash(QFileInfo(filePath).fileName()),
+    _file(filePath)
+{
+    if (_file.open(QIODevice::ReadOnly)) {
+        _size = _file.size();
+        if (_size > 0) {
+            _data = _file.map(0, _size);
+        }
+    }
+}
+
+MappedAssetFile::~MappedAssetFile() {
+    if (_data) {
+        _file.unmap(_data);
+    }
+}
+
+void MappedAssetFile::prefetch(qint64 offset, qint64 size) const {
+#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
+    static const qint64 PAGE_SIZE = sysconf(_SC_PAGESIZE);
+
+    if (!_data || size <= 0) {
+        return;
+    }
+
+    qint64 start = offset - (offset % PAGE_SIZE);
+    madvise(_data + start, (size_t)(offset + size - start), MADV_WILLNEED);
+#else
+    Q_UNUSED(offset);
+    Q_UNUSED(size);
+#endif
+}
+
+MappedAssetFiles::MappedAssetFiles(int maxHotFiles) :
+    _maxHotFiles(maxHotFiles),
+    _stats(std::make_shared<Stats>())
+{
+}
+
+MappedAssetFilePointer MappedAssetFiles::open(const QString& filePath) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = std::find_if(_hotFiles.begin(), _hotFiles.end(), [&](const HotFile& hotFile) {
+        return hotFile.first == filePath;
+    });
+    if (it != _hotFiles.end()) {
+        _hotFiles.splice(_hotFiles.begin(), _hotFiles, it);
+        return it->second;
+    }
+
+    // another transfer may still hold a mapping that already fell out of the hot set
+    auto file = _openFiles.value(filePath).lock();
+    if (!file) {
+        file = std::make_shared<MappedAssetFile>(filePath);
+        if (!file->isValid()) {
+            return nullptr;
+        }
+
+        // count the mapping until the last transfer using it lets go
+        auto stats = _stats;
+        ++stats->numMappings;
+        auto mapping = file;
+        file = MappedAssetFilePointer(file.get(), [mapping, stats](MappedAssetFile*) mutable {
+            mapping.reset();
+            --stats->numMappings;
+        });
+        _openFiles[filePath] = file;
+    }
+
+    _hotFiles.emplace_front(filePath, file);
+    if ((int)_hotFiles.size() > _maxHotFiles) {
+        // a transfer still streaming the file keeps its mapping, and later requests for it should share that
+        QString coldFilePath = _hotFiles.back().first;
+        _hotFiles.pop_back();
+        if (_openFiles.value(coldFilePath).expired()) {
+            _openFiles.remove(coldFilePath);
+        }
+    }
+
+    // drop the mappings that fell out of the hot set and have since been let go of
+    if (_openFiles.size() > 2 * _maxHotFiles) {
+        auto openIt = _openFiles.begin();
+        while (openIt != _openFiles.end()) {
+            if (openIt.value().expired()) {
+                openIt = _openFiles.erase(openIt);
+            } else {
+                ++openIt;
+            }
+        }
+    }
+
+    return file;
+}
+
+void MappedAssetFiles::evict(const QString& filePath) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // transfers in progress keep their mapping, which stays valid after the file is unlinked
+    _hotFiles.remove_if([&](const HotFile& hotFile) {
+        return hotFile.first == filePath;
+    });
+    _openFiles.remove(filePath);
+}
+
+void MappedAssetFiles::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _hotFiles.clear();
+    _openFiles.clear();
+}
+
+int MappedAssetFiles::getNumHotFiles() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (int)_hotFiles.size();
+}
+
+udt::PacketList::DeferredReader MappedAssetFiles::createReader(MappedAssetFilePointer file, qint64 offset, qint64 size,
+                                                               std::shared_ptr<AssetChunkCache> chunkCache) {
+    // lives as long as the packet list holds on to the reader
+    struct Stream {
+        Stream(MappedAssetFilePointer file, std::shared_ptr<Stats> stats, qint64 size) :
+            file(file), stats(stats), bytesRemaining(size)
+        {
+            ++stats->numStreams;
+            stats->bytesInFlight += bytesRemaining;
+        }
+
+        ~Stream() {
+            stats->bytesInFlight -= bytesRemaining;
+            --stats->numStreams;
+        }
+
+        MappedAssetFilePointer file;
+        std::shared_ptr<Stats> stats;
+        qint64 bytesRemaining;
+
+        // the cached chunk being read from
+        AssetChunkCache::Chunk chunk;
+        int chunkIndex { -1 };
+    };
+
+    auto stream = std::make_shared<Stream>(file, _stats, size);
+
+    // the head of the range is read straight away, get the OS started on it
+    file->prefetch(offset, std::min(size, MAX_PREFETCH_BYTES));
+
+    return [stream, offset, chunkCache](char* destination, qint64 readOffset, qint64 readSize) {
+        const MappedAssetFile& file = *stream->file;
+        if (readOffset < 0 || offset + readOffset + readSize > file.getSize()) {
+            return false;
+        }
+
+        if (!chunkCache) {
+            memcpy(destination, file.getData() + offset + readOffset, readSize);
+        } else {
+            auto loader = [&file](qint64 chunkOffset, qint64 chunkSize, QByteArray& data) {
+                data = QByteArray(file.getData() + chunkOffset, chunkSize);
+                return true;
+            };
+
+            qint64 position = offset + readOffset;
+            qint64 end = position + readSize;
+            while (position < end) {
+                int index = (int)(position / AssetChunkCache::CHUNK_SIZE);
+                if (stream->chunkIndex != index) {
+                    stream->chunk = chunkCache->getChunk(file.getHash(), index, file.getSize(), loader);
+                    stream->chunkIndex = stream->chunk ? index : -1;
+                    if (!stream->chunk) {
+                        return false;
+                    }
+                }
+
+                qint64 chunkOffset = position - (qint64)index * AssetChunkCache::CHUNK_SIZE;
+                qint64 count = std::min(end - position, (qint64)stream->chunk->size() - chunkOffset);
+                memcpy(destination, stream->chunk->constData() + chunkOffset, count);
+
+                destination += count;
+                position += count;
+            }
+        }
+
+        stream->bytesRemaining -= readSize;
+        stream->stats->bytesInFlight -= readSize;
+        stream->stats->bytesStreamed += readSize;
+        return true;
+    };
+}
@@ -0,0 +1,102 @@
+//
+//  MappedAssetFiles.h
+//  assignment-client/src/assets
+//
+//  Created by Roxanne Skelly on 2019-06-19.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MappedAssetFiles_h
+#define hifi_MappedAssetFiles_h
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include <udt/PacketList.h>
+
+#include "AssetChunkCache.h"
+
+// A read-only memory mapping of an asset file. Asset files are content addressed and never change, so a mapping can be
+// shared by every transfer of the same asset.
+class MappedAssetFile {
+public:
+    MappedAssetFile(const QString& filePath);
+    ~MappedAssetFile();
+
+    bool isValid() const { return _data != nullptr; }
+    const AssetUtils::AssetHash& getHash() const { return _hash; }
+    const char* getData() const { return reinterpret_cast<const char*>(_data); }
+    qint64 getSize() const { return _size; }
+
+    // asks the OS to start reading a range in, so the send queue doesn't block on it
+    void prefetch(qint64 offset, qint64 size) const;
+
+private:
+    AssetUtils::AssetHash _hash;
+    QFile _file;
+    uchar* _data { nullptr };
+    qint64 _size { 0 };
+};
+
+using MappedAssetFilePointer = std::shared_ptr<MappedAssetFile>;
+
+// The mappings of the asset files being sent, plus a hot set of the most recently sent ones that stay mapped while
+// idle. The pages themselves live in the OS page cache, so concurrent downloads of the same asset share them and an
+// idle mapping costs address space rather than memory.
+//
+//   Replies stream their byte range out of the mapping as the send queue drains (see PacketList::writeDeferred), so a
+//   transfer only ever holds a congestion window of packets.
+//
+//   MappedAssetFiles is thread-safe.
+class MappedAssetFiles {
+public:
+    static const int DEFAULT_MAX_HOT_FILES;
+
+    struct Stats {
+        std::atomic<int> numStreams { 0 };          // replies still being streamed
+        std::atomic<qint64> bytesInFlight { 0 };    // bytes of those replies the send queue hasn't taken yet
+        std::atomic<qint64> bytesStreamed { 0 };
+        std::atomic<int> numMappings { 0 };
+    };
+
+    MappedAssetFiles(int maxHotFiles = DEFAULT_MAX_HOT_FILES);
+
+    // returns nullptr if the file can't be mapped
+    MappedAssetFilePointer open(const QString& filePath);
+
+    // drops the file from the hot set, before it is deleted
+    void evict(const QString& filePath);
+    void clear();
+
+    // a reader for PacketList::writeDeferred over [offset, offset + size) of the file, which counts as a stream
+    // until the packet list lets go of it - with a chunk cache the data is copied out of the cached chunks, which
+    // are loaded from the mapping on a miss
+    udt::PacketList::DeferredReader createReader(MappedAssetFilePointer file, qint64 offset, qint64 size,
+                                                 std::shared_ptr<AssetChunkCache> chunkCache = nullptr);
+
+    const Stats& getStats() const { return *_stats; }
+    int getNumHotFiles() const;
+
+private:
+    using HotFile = std::pair<QString, MappedAssetFilePointer>;
+
+    int _maxHotFiles;
+
+    mutable std::mutex _mutex;
+    std::list<HotFile> _hotFiles;   // most recently used first
+    QHash<QString, std::weak_ptr<MappedAssetFile>> _openFiles;
+
+    // shared with the readers, which can outlive us in a send queue
+    std::shared_ptr<Stats> _stats;
+};
+
+#endif // hifi_MappedAssetFiles_h
@@ -25,12 +25,16 @@
 #include "AssetUtils.h"
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
+#include "MappedAssetFiles.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                             MappedAssetFiles& mappedFiles, std::shared_ptr<AssetChunkCache> chunkCache) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _mappedFiles(mappedFiles),
+    _chunkCache(chunkCache)
 {
     
 }
@@ -64,17 +68,18 @@ void SendAssetTask::run() {
         replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
     } else {
         QString filePath = _resourcesDir.filePath(QString(hexHash));
-        
-        QFile file { filePath };
 
-        if (file.open(QIODevice::ReadOnly)) {
+        // the range is streamed out of the mapping as the send queue drains, rather than read in up front
+        auto mappedFile = _mappedFiles.open(filePath);
+        if (mappedFile) {
+            auto fileSize = mappedFile->getSize();
 
             // first fixup the range based on the now known file size
-            byteRange.fixupRange(file.size());
+            byteRange.fixupRange(fileSize);
 
             // check if we're being asked to read data that we just don't have
             // because of the file size
-            if (file.size() < byteRange.fromInclusive || file.size() < byteRange.toExclusive) {
+            if (fileSize < byteRange.fromInclusive || fileSize < byteRange.toExclusive) {
                 replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
                 qCDebug(networking) << "Bad byte range: " << hexHash << " "
                     << byteRange.fromInclusive << ":" << byteRange.toExclusive;
@@ -82,32 +87,55 @@ void SendAssetTask::run() {
                 // we have a valid byte range, handle it and send the asset
                 auto size = byteRange.size();
 
-                if (byteRange.fromInclusive >= 0) {
+                // a negative range is read back from the end of the file
+                auto offset = byteRange.fromInclusive >= 0 ? byteRange.fromInclusive : fileSize + byteRange.fromInclusive;
 
-                    // this range is positive, meaning we just need to seek into the file and then read from there
-                    file.seek(byteRange.fromInclusive);
-                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
-                    replyPacketList->write(file.read(size));
+                replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
+                replyPacketList->writePrimitive(size);
+                if (replyPacketList->writeDeferred(size, _mappedFiles.createReader(mappedFile, offset, size, _chunkCache))) {
+                    qCDebug(networking) << "Sending asset: " << hexHash;
                 } else {
-                    // this range is negative, at least the first part of the read will be back into the end of the file
+                    // nothing has gone out yet, so the reply can still be an error
+                    qCWarning(networking) << "Failed to read asset: " << hexHash;
+                    replyPacketList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+                    replyPacketList->write(assetHash);
+                    replyPacketList->writePrimitive(messageID);
+                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::FileOperationFailed);
+                }
+            }
+        } else {
+            // empty files can't be mapped, and the mapping could fail for plenty of other reasons
+            QFile file { filePath };
 
-                    // seek to the part of the file where the negative range begins
-                    file.seek(file.size() + byteRange.fromInclusive);
+            if (file.open(QIODevice::ReadOnly)) {
+
+                // first fixup the range based on the now known file size
+                byteRange.fixupRange(file.size());
+
+                // check if we're being asked to read data that we just don't have
+                // because of the file size
+                if (file.size() < byteRange.fromInclusive || file.size() < byteRange.toExclusive) {
+                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
+                    qCDebug(networking) << "Bad byte range: " << hexHash << " "
+                        << byteRange.fromInclusive << ":" << byteRange.toExclusive;
+                } else {
+                    // we have a valid byte range, handle it and send the asset
+                    auto size = byteRange.size();
+
+                    // a negative range is read back from the end of the file
+                    file.seek(byteRange.fromInclusive >= 0 ? byteRange.fromInclusive : file.size() + byteRange.fromInclusive);
 
                     replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
                     replyPacketList->writePrimitive(size);
-
-                    // first write everything from the negative range to the end of the file
                     replyPacketList->write(file.read(size));
-                }
 
-                qCDebug(networking) << "Sending asset: " << hexHash;
+                    qCDebug(networking) << "Sending asset: " << hexHash;
+                }
+                file.close();
+            } else {
+                qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
+                replyPacketList->writePrimitive(AssetUtils::AssetServerError::AssetNotFound);
             }
-            file.close();
-        } else {
-            qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
-            replyPacketList->writePrimitive(AssetUtils::AssetServerError::AssetNotFound);
         }
     }
 
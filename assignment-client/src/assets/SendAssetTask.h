@@ -25,7 +25,8 @@ class NLPacket;
 
 class SendAssetTask : public QRunnable {
 public:
-    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir);
+    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                  MappedAssetFiles& mappedFiles, std::shared_ptr<AssetChunkCache> chunkCache);
 
     void run() override;
 
@@ -33,6 +34,8 @@ private:
     QSharedPointer<ReceivedMessage> _message;
     SharedNodePointer _senderNode;
     QDir _resourcesDir;
+    MappedAssetFiles& _mappedFiles;
+    std::shared_ptr<AssetChunkCache> _chunkCache;
 };
 
 #endif
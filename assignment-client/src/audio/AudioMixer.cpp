@@ -84,13 +84,20 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
     auto nodeList = DependencyManager::get<NodeList>();
     auto& packetReceiver = nodeList->getPacketReceiver();
 
-    // packets whose consequences are limited to their own node can be parallelized
-    packetReceiver.registerListenerForTypes({
+    // audio streams are single unreliable packets at the highest rate we see - they skip ReceivedMessage and the
+    // main thread's event queue and go straight to the client's packet queue
+    packetReceiver.registerPacketHandlerForTypes({
             PacketType::MicrophoneAudioNoEcho,
             PacketType::MicrophoneAudioWithEcho,
             PacketType::InjectAudio,
+            PacketType::SilentAudioFrame },
+            this, [this](ReceivedPacketPointer packet, SharedNodePointer node) {
+                queueAudioStreamPacket(std::move(packet), node);
+            });
+
+    // packets whose consequences are limited to their own node can be parallelized
+    packetReceiver.registerListenerForTypes({
             PacketType::AudioStreamStats,
-            PacketType::SilentAudioFrame,
             PacketType::NegotiateAudioFormat,
             PacketType::MuteEnvironment,
             PacketType::NodeIgnoreRequest,
@@ -122,11 +129,34 @@ void AudioMixer::aboutToFinish() {
 }
 
 void AudioMixer::queueAudioPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
-    if (message->getType() == PacketType::SilentAudioFrame) {
+    getOrCreateClientData(node.data())->queuePacket(ReceivedMessage::toPacketPointer(message), node);
+}
+
+void AudioMixer::queueAudioStreamPacket(ReceivedPacketPointer packet, SharedNodePointer node) {
+    if (!node) {
+        return;
+    }
+
+    AudioMixerClientData* clientData;
+    {
+        QMutexLocker locker(&node->getMutex());
+        clientData = dynamic_cast<AudioMixerClientData*>(node->getLinkedData());
+    }
+
+    if (!clientData) {
+        // the client data is a QObject and has to be created on our thread, this frame of the stream is dropped
+        QMetaObject::invokeMethod(this, [this, node] {
+            QMutexLocker locker(&node->getMutex());
+            getOrCreateClientData(node.data());
+        });
+        return;
+    }
+
+    if (packet->getType() == PacketType::SilentAudioFrame) {
         _numSilentPackets++;
     }
 
-    getOrCreateClientData(node.data())->queuePacket(message, node);
+    clientData->queuePacket(std::move(packet), node);
 }
 
 void AudioMixer::queueReplicatedAudioPacket(QSharedPointer<ReceivedMessage> message) {
@@ -154,7 +184,8 @@ void AudioMixer::queueReplicatedAudioPacket(QSharedPointer<ReceivedMessage> mess
                                                                      versionForPacketType(rewrittenType),
                                                                      message->getSenderSockAddr(), Node::NULL_LOCAL_ID);
 
-    getOrCreateClientData(replicatedNode.data())->queuePacket(replicatedMessage, replicatedNode);
+    getOrCreateClientData(replicatedNode.data())->queuePacket(ReceivedMessage::toPacketPointer(replicatedMessage),
+                                                              replicatedNode);
 }
 
 void AudioMixer::handleMuteEnvironmentPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
@@ -327,6 +358,10 @@ void AudioMixer::sendStatsPacket() {
     mixStats["3_active_to_skippped"] = (int)(_stats.activeToSkipped / (float)_numStatFrames);
     mixStats["3_active_to_inactive"] = (int)(_stats.activeToInactive / (float)_numStatFrames);
 
+    mixStats["4_far_field_clusters"] = (int)(_stats.farFieldClusters / (float)_numStatFrames);
+    mixStats["4_far_field_hrtfs_saved"] = (int)(_stats.farFieldStreams / (float)_numStatFrames);
+    mixStats["4_far_field_renders"] = (int)(_stats.farFieldRenders / (float)_numStatFrames);
+
     mixStats["total_mixes"] = _stats.totalMixes;
     mixStats["avg_mixes_per_block"] = _stats.totalMixes / _numStatFrames;
 
@@ -450,6 +485,11 @@ void AudioMixer::start() {
         nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
             // mix across slave threads
             auto mixTimer = _mixTiming.timer();
+
+            // premix the far-field clusters once, every slave reads them
+            _workerSharedData.clusters.build(cbegin, cend);
+            _stats.farFieldClusters += _workerSharedData.clusters.getNumClusters();
+
             _slavePool.mix(cbegin, cend, frame, numToRetain);
         });
 
@@ -577,6 +617,23 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
         }
 
         qCDebug(audio) << "Throttle Start:" << _throttleStartTarget << "Throttle Backoff:" << _throttleBackoffTarget;
+
+        const QString FAR_FIELD_MIXING_KEY = "far_field_mixing";
+        const QString FAR_FIELD_HRTF_STREAMS_KEY = "far_field_hrtf_streams";
+        const QString FAR_FIELD_CELL_SIZE_KEY = "far_field_cell_size";
+
+        const int DEFAULT_FAR_FIELD_HRTF_STREAMS = 16;
+        const float DEFAULT_FAR_FIELD_CELL_SIZE = 10.0f;
+
+        bool farFieldMixing = audioThreadingGroupObject[FAR_FIELD_MIXING_KEY].toBool();
+        int farFieldHRTFStreams = audioThreadingGroupObject[FAR_FIELD_HRTF_STREAMS_KEY].toInt(DEFAULT_FAR_FIELD_HRTF_STREAMS);
+        float farFieldCellSize = audioThreadingGroupObject[FAR_FIELD_CELL_SIZE_KEY].toDouble(DEFAULT_FAR_FIELD_CELL_SIZE);
+        _workerSharedData.clusters.configure(farFieldMixing, farFieldCellSize, farFieldHRTFStreams);
+
+        if (farFieldMixing) {
+            qCDebug(audio) << "Far-field mixing enabled - HRTF streams:" << _workerSharedData.clusters.getNumHRTFStreams()
+                << "Cell size:" << farFieldCellSize;
+        }
     }
 
     if (settingsObject.contains(AUDIO_BUFFER_GROUP_KEY)) {
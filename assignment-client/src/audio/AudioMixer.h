@@ -12,6 +12,8 @@
 #ifndef hifi_AudioMixer_h
 #define hifi_AudioMixer_h
 
+#include <atomic>
+
 #include <AABox.h>
 #include <AudioHRTF.h>
 #include <AudioRingBuffer.h>
@@ -89,6 +91,9 @@ private:
 
     AudioMixerClientData* getOrCreateClientData(Node* node);
 
+    // called directly on the receiving thread
+    void queueAudioStreamPacket(ReceivedPacketPointer packet, SharedNodePointer sendingNode);
+
     QString percentageForMixStats(int counter);
 
     void parseSettingsObject(const QJsonObject& settingsObject);
@@ -100,7 +105,7 @@ private:
     float _trailingMixRatio { 0.0f };
     float _throttlingRatio { 0.0f };
 
-    int _numSilentPackets { 0 };
+    std::atomic<int> _numSilentPackets { 0 };
 
     int _numStatFrames { 0 };
     AudioMixerStats _stats;
@@ -50,20 +50,29 @@ AudioMixerClientData::~AudioMixerClientData() {
     }
 }
 
-void AudioMixerClientData::queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
+void AudioMixerClientData::queuePacket(ReceivedPacketPointer message, SharedNodePointer node) {
+    std::lock_guard<std::mutex> lock(_packetQueueLock);
     if (!_packetQueue.node) {
         _packetQueue.node = node;
     }
-    _packetQueue.push(message);
+    _packetQueue.push(std::move(message));
 }
 
 int AudioMixerClientData::processPackets(ConcurrentAddedStreams& addedStreams) {
-    SharedNodePointer node = _packetQueue.node;
-    assert(_packetQueue.empty() || node);
-    _packetQueue.node.clear();
+    // take what's queued so far, packets that arrive while we process go to the next frame
+    PacketQueue packetQueue;
+    {
+        std::lock_guard<std::mutex> lock(_packetQueueLock);
+        packetQueue.swap(_packetQueue);
+        packetQueue.node = _packetQueue.node;
+        _packetQueue.node.clear();
+    }
+
+    SharedNodePointer node = packetQueue.node;
+    assert(packetQueue.empty() || node);
 
-    while (!_packetQueue.empty()) {
-        auto& packet = _packetQueue.front();
+    while (!packetQueue.empty()) {
+        auto& packet = packetQueue.front();
 
         switch (packet->getType()) {
             case PacketType::MicrophoneAudioNoEcho:
@@ -71,7 +80,7 @@ int AudioMixerClientData::processPackets(ConcurrentAddedStreams& addedStreams) {
             case PacketType::InjectAudio:
             case PacketType::SilentAudioFrame: {
                 if (node->isUpstream()) {
-                    setupCodecForReplicatedAgent(packet);
+                    setupCodecForReplicatedAgent(*packet);
                 }
 
                 processStreamPacket(*packet, addedStreams);
@@ -93,21 +102,21 @@ int AudioMixerClientData::processPackets(ConcurrentAddedStreams& addedStreams) {
                 parsePerAvatarGainSet(*packet, node);
                 break;
             case PacketType::NodeIgnoreRequest:
-                parseNodeIgnoreRequest(packet, node);
+                parseNodeIgnoreRequest(*packet, node);
                 break;
             case PacketType::RadiusIgnoreRequest:
-                parseRadiusIgnoreRequest(packet, node);
+                parseRadiusIgnoreRequest(*packet, node);
                 break;
             case PacketType::AudioSoloRequest:
-                parseSoloRequest(packet, node);
+                parseSoloRequest(*packet, node);
                 break;
             default:
                 Q_UNREACHABLE();
         }
 
-        _packetQueue.pop();
+        packetQueue.pop();
     }
-    assert(_packetQueue.empty());
+    assert(packetQueue.empty());
 
     // now that we have processed all packets for this frame
     // we can prepare the sources from this client to be ready for mixing
@@ -121,7 +130,7 @@ bool isReplicatedPacket(PacketType packetType) {
         || packetType == PacketType::ReplicatedSilentAudioFrame;
 }
 
-void AudioMixerClientData::optionallyReplicatePacket(ReceivedMessage& message, const Node& node) {
+void AudioMixerClientData::optionallyReplicatePacket(ReceivedPacket& message, const Node& node) {
 
     // first, make sure that this is a packet from a node we are supposed to replicate
     if (node.isReplicated()) {
@@ -167,7 +176,7 @@ void AudioMixerClientData::optionallyReplicatePacket(ReceivedMessage& message, c
 
 }
 
-void AudioMixerClientData::negotiateAudioFormat(ReceivedMessage& message, const SharedNodePointer& node) {
+void AudioMixerClientData::negotiateAudioFormat(ReceivedPacket& message, const SharedNodePointer& node) {
     quint8 numberOfCodecs;
     message.readPrimitive(&numberOfCodecs);
     std::vector<QString> codecs;
@@ -180,13 +189,13 @@ void AudioMixerClientData::negotiateAudioFormat(ReceivedMessage& message, const
     sendSelectAudioFormat(node, codec.first);
 }
 
-void AudioMixerClientData::parseRequestsDomainListData(ReceivedMessage& message) {
+void AudioMixerClientData::parseRequestsDomainListData(ReceivedPacket& message) {
     bool isRequesting;
     message.readPrimitive(&isRequesting);
     setRequestsDomainListData(isRequesting);
 }
 
-void AudioMixerClientData::parsePerAvatarGainSet(ReceivedMessage& message, const SharedNodePointer& node) {
+void AudioMixerClientData::parsePerAvatarGainSet(ReceivedPacket& message, const SharedNodePointer& node) {
     QUuid uuid = node->getUUID();
     // parse the UUID from the packet
     QUuid avatarUUID = QUuid::fromRfc4122(message.readWithoutCopy(NUM_BYTES_RFC4122_UUID));
@@ -215,7 +224,7 @@ void AudioMixerClientData::setGainForAvatar(QUuid nodeID, float gain) {
     }
 }
 
-void AudioMixerClientData::parseNodeIgnoreRequest(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& node) {
+void AudioMixerClientData::parseNodeIgnoreRequest(ReceivedPacket& message, const SharedNodePointer& node) {
     auto ignoredNodesPair = node->parseIgnoreRequestMessage(message);
 
     // we have a vector of ignored or unignored node UUIDs - update our internal data structures so that
@@ -280,9 +289,9 @@ void AudioMixerClientData::clearStagedIgnoreChanges() {
     _newUnignoringNodeIDs.clear();
 }
 
-void AudioMixerClientData::parseRadiusIgnoreRequest(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& node) {
+void AudioMixerClientData::parseRadiusIgnoreRequest(ReceivedPacket& message, const SharedNodePointer& node) {
     bool enabled;
-    message->readPrimitive(&enabled);
+    message.readPrimitive(&enabled);
 
     _isIgnoreRadiusEnabled = enabled;
 
@@ -299,14 +308,14 @@ void AudioMixerClientData::parseRadiusIgnoreRequest(QSharedPointer<ReceivedMessa
 }
 
 
-void AudioMixerClientData::parseSoloRequest(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& node) {
+void AudioMixerClientData::parseSoloRequest(ReceivedPacket& message, const SharedNodePointer& node) {
 
     uint8_t addToSolo;
-    message->readPrimitive(&addToSolo);
+    message.readPrimitive(&addToSolo);
 
-    while (message->getBytesLeftToRead()) {
+    while (message.getBytesLeftToRead()) {
         // parse out the UUID being soloed from the packet
-        QUuid soloedUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        QUuid soloedUUID = QUuid::fromRfc4122(message.readWithoutCopy(NUM_BYTES_RFC4122_UUID));
 
         if (addToSolo) {
             _soloedNodes.push_back(soloedUUID);
@@ -347,7 +356,7 @@ void AudioMixerClientData::removeAgentAvatarAudioStream() {
     }
 }
 
-int AudioMixerClientData::parseData(ReceivedMessage& message) {
+int AudioMixerClientData::parseData(ReceivedPacket& message) {
     PacketType packetType = message.getType();
 
     if (packetType == PacketType::AudioStreamStats) {
@@ -371,7 +380,7 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
     return 0;
 }
 
-bool AudioMixerClientData::containsValidPosition(ReceivedMessage& message) const {
+bool AudioMixerClientData::containsValidPosition(ReceivedPacket& message) const {
     static const int SEQUENCE_NUMBER_BYTES = sizeof(quint16);
 
     auto posBefore = message.getPosition();
@@ -416,7 +425,7 @@ bool AudioMixerClientData::containsValidPosition(ReceivedMessage& message) const
     return true;
 }
 
-void AudioMixerClientData::processStreamPacket(ReceivedMessage& message, ConcurrentAddedStreams &addedStreams) {
+void AudioMixerClientData::processStreamPacket(ReceivedPacket& message, ConcurrentAddedStreams &addedStreams) {
 
     if (!containsValidPosition(message)) {
         qDebug() << "Refusing to process audio stream from" << message.getSourceID() << "with invalid position";
@@ -769,12 +778,12 @@ void AudioMixerClientData::cleanupCodec() {
     }
 }
 
-void AudioMixerClientData::setupCodecForReplicatedAgent(QSharedPointer<ReceivedMessage> message) {
+void AudioMixerClientData::setupCodecForReplicatedAgent(ReceivedPacket& message) {
     // hop past the sequence number that leads the packet
-    message->seek(sizeof(quint16));
+    message.seek(sizeof(quint16));
 
     // pull the codec string from the packet
-    auto codecString = message->readString();
+    auto codecString = message.readString();
 
     if (codecString != _selectedCodecName) {
         qCDebug(audio) << "Manually setting codec for replicated agent" << uuidStringWithoutCurlyBraces(getNodeID())
@@ -784,6 +793,6 @@ void AudioMixerClientData::setupCodecForReplicatedAgent(QSharedPointer<ReceivedM
         setupCodec(codec.second, codec.first);
 
         // seek back to the beginning of the message so other readers are in the right place
-        message->seek(0);
+        message.seek(0);
     }
 }
@@ -12,6 +12,7 @@
 #ifndef hifi_AudioMixerClientData_h
 #define hifi_AudioMixerClientData_h
 
+#include <mutex>
 #include <queue>
 
 #include <tbb/concurrent_vector.h>
@@ -19,6 +20,7 @@
 #include <QtCore/QJsonObject>
 
 #include <AABox.h>
+#include <AudioFOA.h>
 #include <AudioHRTF.h>
 #include <AudioLimiter.h>
 #include <UUIDHasher.h>
@@ -49,7 +51,8 @@ public:
     using SharedStreamPointer = std::shared_ptr<PositionalAudioStream>;
     using AudioStreamVector = std::vector<SharedStreamPointer>;
 
-    void queuePacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer node);
+    // thread-safe, audio stream packets are queued directly from the receiving threads
+    void queuePacket(ReceivedPacketPointer packet, SharedNodePointer node);
     int processPackets(ConcurrentAddedStreams& addedStreams); // returns the number of available streams this frame
 
     AudioStreamVector& getAudioStreams() { return _audioStreams; }
@@ -58,14 +61,14 @@ public:
     void removeAgentAvatarAudioStream();
 
     // packet parsers
-    int parseData(ReceivedMessage& message) override;
-    void processStreamPacket(ReceivedMessage& message, ConcurrentAddedStreams& addedStreams);
-    void negotiateAudioFormat(ReceivedMessage& message, const SharedNodePointer& node);
-    void parseRequestsDomainListData(ReceivedMessage& message);
-    void parsePerAvatarGainSet(ReceivedMessage& message, const SharedNodePointer& node);
-    void parseNodeIgnoreRequest(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& node);
-    void parseRadiusIgnoreRequest(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& node);
-    void parseSoloRequest(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& node);
+    int parseData(ReceivedPacket& message) override;
+    void processStreamPacket(ReceivedPacket& message, ConcurrentAddedStreams& addedStreams);
+    void negotiateAudioFormat(ReceivedPacket& message, const SharedNodePointer& node);
+    void parseRequestsDomainListData(ReceivedPacket& message);
+    void parsePerAvatarGainSet(ReceivedPacket& message, const SharedNodePointer& node);
+    void parseNodeIgnoreRequest(ReceivedPacket& message, const SharedNodePointer& node);
+    void parseRadiusIgnoreRequest(ReceivedPacket& message, const SharedNodePointer& node);
+    void parseSoloRequest(ReceivedPacket& message, const SharedNodePointer& node);
 
     // attempt to pop a frame from each audio stream, and return the number of streams from this client
     int checkBuffersBeforeFrameSend();
@@ -87,6 +90,10 @@ public:
 
     AudioLimiter audioLimiter;
 
+    // decodes the far-field bed for this listener, see AudioMixerClusters
+    AudioFOA farFieldFOA;
+    bool hasFarFieldMix { false };
+
     void setupCodec(CodecPluginPointer codec, const QString& codecName);
     void cleanupCodec();
     void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) {
@@ -109,7 +116,7 @@ public:
     bool getRequestsDomainListData() const { return _requestsDomainListData; }
     void setRequestsDomainListData(bool requesting) { _requestsDomainListData = requesting; }
 
-    void setupCodecForReplicatedAgent(QSharedPointer<ReceivedMessage> message);
+    void setupCodecForReplicatedAgent(ReceivedPacket& message);
 
     struct MixableStream {
         float approximateVolume { 0.0f };
@@ -119,6 +126,10 @@ public:
         bool ignoredByListener { false };
         bool ignoringListener { false };
 
+        // far-field mixing state, the cluster is only valid for the current frame
+        int farFieldCluster { -1 };
+        bool isInFarField { false };
+
         MixableStream(NodeIDStreamID nodeIDStreamID, PositionalAudioStream* positionalStream) :
             nodeStreamID(nodeIDStreamID), hrtf(new AudioHRTF), positionalStream(positionalStream) {};
         MixableStream(QUuid nodeID, Node::LocalID localNodeID, StreamID streamID, PositionalAudioStream* positionalStream) :
@@ -167,18 +178,19 @@ public slots:
     void sendSelectAudioFormat(SharedNodePointer node, const QString& selectedCodecName);
 
 private:
-    struct PacketQueue : public std::queue<QSharedPointer<ReceivedMessage>> {
+    struct PacketQueue : public std::queue<ReceivedPacketPointer> {
         QWeakPointer<Node> node;
     };
+    std::mutex _packetQueueLock;
     PacketQueue _packetQueue;
 
     AudioStreamVector _audioStreams; // microphone stream from avatar has a null stream ID
 
-    void optionallyReplicatePacket(ReceivedMessage& packet, const Node& node);
+    void optionallyReplicatePacket(ReceivedPacket& packet, const Node& node);
 
     void setGainForAvatar(QUuid nodeID, float gain);
 
-    bool containsValidPosition(ReceivedMessage& message) const;
+    bool containsValidPosition(ReceivedPacket& message) const;
 
     Streams _streams;
 
@@ -0,0 +1,124 @@
+//
+//  AudioMixerClusters.cpp
+//  assignment-client/src/audio
+//
+//  Created by Roxanne Skelly on 2019-06-19.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerClusters.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <AudioRingBuffer.h>
+#include <InjectedAudioStream.h>
+#include <NumericalConstants.h>
+#include <PositionalAudioStream.h>
+
+#include "AudioMixerClientData.h"
+
+// avatars in a cluster are heard side-on, since their facing relative to each listener is not known
+static const float CLUSTER_OFF_AXIS_ATTENUATION = 0.6f;
+
+// packs the integer cell coordinates into a single key, 21 bits per axis
+static uint64_t cellKey(const glm::vec3& position, float cellSize) {
+    const int64_t CELL_MASK = (1 << 21) - 1;
+    glm::vec3 cell = glm::floor(position / cellSize);
+
+    return (((uint64_t)((int64_t)cell.x & CELL_MASK)) << 42) |
+        (((uint64_t)((int64_t)cell.y & CELL_MASK)) << 21) |
+        ((uint64_t)((int64_t)cell.z & CELL_MASK));
+}
+
+void AudioMixerClusters::configure(bool isEnabled, float cellSize, int numHRTFStreams) {
+    _isEnabled = isEnabled;
+    _cellSize = std::max(cellSize, 1.0f);
+    _numHRTFStreams = std::max(numHRTFStreams, 0);
+}
+
+void AudioMixerClusters::build(ConstIter begin, ConstIter end) {
+    _numClusters = 0;
+    _clustersByCell.clear();
+    _clustersByStream.clear();
+
+    if (!_isEnabled) {
+        return;
+    }
+
+    int16_t streamSamples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    const float scale = 1 / 32768.0f; // int16_t to float
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        if (!nodeData) {
+            return;
+        }
+
+        for (auto& stream : nodeData->getAudioStreams()) {
+            // only streams that will be mixed through the HRTF this frame can be clustered
+            if (stream->isStereo() || !stream->lastPopSucceeded() || stream->getLastPopOutputLoudness() == 0.0f) {
+                continue;
+            }
+
+            auto key = cellKey(stream->getPosition(), _cellSize);
+            auto it = _clustersByCell.find(key);
+
+            int index;
+            if (it != _clustersByCell.end()) {
+                index = it->second;
+            } else {
+                index = _numClusters++;
+                if (index == (int)_clusters.size()) {
+                    _clusters.emplace_back();
+                    _weights.emplace_back();
+                }
+
+                auto& cluster = _clusters[index];
+                cluster.position = glm::vec3(0.0f);
+                cluster.numStreams = 0;
+                memset(cluster.avatarSamples, 0, sizeof(cluster.avatarSamples));
+                memset(cluster.injectorSamples, 0, sizeof(cluster.injectorSamples));
+                _weights[index] = 0.0f;
+
+                _clustersByCell.emplace(key, index);
+            }
+
+            auto& cluster = _clusters[index];
+            float gain = scale;
+            float* samples;
+            if (stream->getType() == PositionalAudioStream::Injector) {
+                gain *= static_cast<const InjectedAudioStream*>(stream.get())->getAttenuationRatio();
+                samples = cluster.injectorSamples;
+            } else {
+                gain *= CLUSTER_OFF_AXIS_ATTENUATION;
+                samples = cluster.avatarSamples;
+            }
+
+            stream->getLastPopOutput().readSamples(streamSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+            for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+                samples[i] += (float)streamSamples[i] * gain;
+            }
+
+            // louder streams pull the centroid towards them
+            float weight = stream->getLastPopOutputTrailingLoudness() + EPSILON;
+            cluster.position += stream->getPosition() * weight;
+            _weights[index] += weight;
+            ++cluster.numStreams;
+
+            _clustersByStream.emplace(stream.get(), index);
+        }
+    });
+
+    for (int i = 0; i < _numClusters; ++i) {
+        _clusters[i].position /= _weights[i];
+    }
+}
+
+int AudioMixerClusters::findCluster(const PositionalAudioStream* stream) const {
+    auto it = _clustersByStream.find(stream);
+    return (it != _clustersByStream.end()) ? it->second : NO_CLUSTER;
+}
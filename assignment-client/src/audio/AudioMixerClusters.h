@@ -0,0 +1,73 @@
+//
+//  AudioMixerClusters.h
+//  assignment-client/src/audio
+//
+//  Created by Roxanne Skelly on 2019-06-19.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerClusters_h
+#define hifi_AudioMixerClusters_h
+
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <AudioConstants.h>
+#include <NodeList.h>
+
+class PositionalAudioStream;
+
+// Far-field mixing groups the mono streams of each spatial cell into a cluster, premixed once per frame.
+// Listeners then hear distant streams through one first-order ambisonic bed built from these clusters,
+// instead of running a separate HRTF for every stream.
+class AudioMixerClusters {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    struct Cluster {
+        glm::vec3 position;     // loudness weighted centroid of the streams in the cluster
+        int numStreams { 0 };
+
+        // premixed mono samples - avatars are kept apart from injectors, only avatars take the listener's master gain
+        float avatarSamples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+        float injectorSamples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    };
+
+    static const int NO_CLUSTER = -1;
+
+    void configure(bool isEnabled, float cellSize, int numHRTFStreams);
+
+    bool isEnabled() const { return _isEnabled; }
+
+    // the number of loudest streams each listener keeps on a full HRTF
+    int getNumHRTFStreams() const { return _numHRTFStreams; }
+
+    // premix the streams popped this frame, call on the mixer thread before mixing
+    void build(ConstIter begin, ConstIter end);
+
+    // returns the index of the cluster this stream was premixed into or NO_CLUSTER
+    int findCluster(const PositionalAudioStream* stream) const;
+
+    const Cluster& getCluster(int index) const { return _clusters[index]; }
+    int getNumClusters() const { return _numClusters; }
+
+private:
+    bool _isEnabled { false };
+    float _cellSize { 10.0f };
+    int _numHRTFStreams { 16 };
+
+    // clusters are re-used between frames, only the first _numClusters are valid
+    std::vector<Cluster> _clusters;
+    std::vector<float> _weights;
+    int _numClusters { 0 };
+
+    std::unordered_map<uint64_t, int> _clustersByCell;
+    std::unordered_map<const PositionalAudioStream*, int> _clustersByStream;
+};
+
+#endif // hifi_AudioMixerClusters_h
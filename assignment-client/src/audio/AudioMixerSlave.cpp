@@ -41,6 +41,11 @@ using AudioStreamVector = AudioMixerClientData::AudioStreamVector;
 using MixableStream = AudioMixerClientData::MixableStream;
 using MixableStreamsVector = AudioMixerClientData::MixableStreamsVector;
 
+static const int HRTF_DATASET_INDEX = 1;
+
+// a listener only switches to the far-field bed once it replaces at least this many HRTFs
+static const int MIN_FAR_FIELD_STREAMS = 4;
+
 // packet helpers
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec);
 void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QByteArray& buffer);
@@ -52,6 +57,8 @@ void sendEnvironmentPacket(const SharedNodePointer& node, AudioMixerClientData&
 inline float approximateGain(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd);
 inline float computeGain(float masterListenerGain, const AvatarAudioStream& listeningNodeStream,
         const PositionalAudioStream& streamToAdd, const glm::vec3& relativePosition, float distance, bool isEcho);
+inline float computeDistanceGain(const AvatarAudioStream& listeningNodeStream, const glm::vec3& sourcePosition,
+        float distance);
 inline float computeAzimuth(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
         const glm::vec3& relativePosition);
 
@@ -316,6 +323,14 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     bool isThrottling = _numToRetain != -1;
     bool isSoloing = !listenerData->getSoloedNodes().empty();
 
+    // far-field mixing ranks the active streams the same way throttling does, soloed streams are always mixed in full
+    auto& clusters = _sharedData.clusters;
+    bool isFarField = clusters.isEnabled() && !isSoloing;
+    bool isRanking = isThrottling || isFarField;
+    if (isFarField) {
+        _farFieldClusterCounts.assign(clusters.getNumClusters(), 0);
+    }
+
     auto& streams = listenerData->getStreams();
 
     addStreams(*listener, *listenerData);
@@ -375,9 +390,9 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
             return true;
         }
 
-        if (isThrottling) {
-            // we're throttling, so we need to update the approximate volume for any un-skipped streams
-            // unless this is simply for an echo (in which case the approx volume is 1.0)
+        if (isRanking) {
+            // we're throttling or far-field mixing, so we need to update the approximate volume for any un-skipped
+            // streams unless this is simply for an echo (in which case the approx volume is 1.0)
             stream.approximateVolume = approximateVolume(stream, listenerAudioStream);
         } else {
             if (shouldBeSkipped(stream, *listener, *listenerAudioStream, *listenerData)) {
@@ -403,19 +418,27 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         return false;
     });
 
-    if (isThrottling) {
-        // since we're throttling, we need to partition the mixable into throttled and unthrottled streams
-        int numToRetain = min(_numToRetain, (int)streams.active.size()); // Make sure we don't overflow
+    if (isRanking) {
+        // we need to partition the mixable into throttled and unthrottled streams
+        int numToRetain = (int)streams.active.size();
+        if (isThrottling) {
+            numToRetain = min(_numToRetain, numToRetain); // Make sure we don't overflow
+        }
         auto throttlePoint = begin(streams.active) + numToRetain;
 
-        std::nth_element(streams.active.begin(), throttlePoint, streams.active.end(),
-                         [](const auto& a, const auto& b)
-                         {
-                             return a.approximateVolume > b.approximateVolume;
-                         });
+        // with far-field mixing only the loudest of the unthrottled streams keep their own HRTF
+        int numHRTFStreams = isFarField ? min(clusters.getNumHRTFStreams(), numToRetain) : numToRetain;
+        auto farFieldPoint = begin(streams.active) + numHRTFStreams;
 
-        SegmentedEraseIf<MixableStreamsVector> erase(streams.active);
-        erase.iterateTo(throttlePoint, [&](MixableStream& stream) {
+        auto isLouder = [](const auto& a, const auto& b) {
+            return a.approximateVolume > b.approximateVolume;
+        };
+        std::nth_element(streams.active.begin(), throttlePoint, streams.active.end(), isLouder);
+        if (farFieldPoint != throttlePoint) {
+            std::nth_element(streams.active.begin(), farFieldPoint, throttlePoint, isLouder);
+        }
+
+        auto mixWithHRTF = [&](MixableStream& stream) {
             if (shouldBeSkipped(stream, *listener, *listenerAudioStream, *listenerData)) {
                 resetHRTFState(stream);
                 streams.skipped.push_back(move(stream));
@@ -435,6 +458,29 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
                 return true;
             }
 
+            return false;
+        };
+
+        SegmentedEraseIf<MixableStreamsVector> erase(streams.active);
+        erase.iterateTo(farFieldPoint, mixWithHRTF);
+        erase.iterateTo(throttlePoint, [&](MixableStream& stream) {
+            // streams premixed into a cluster are flagged here and mixed by addFarFieldStreams once we know
+            // whether their whole cluster is in the far-field for this listener
+            int cluster = clusters.findCluster(stream.positionalStream);
+            if (cluster == AudioMixerClusters::NO_CLUSTER || stream.positionalStream == listenerAudioStream ||
+                stream.hrtf->getGainAdjustment() != 1.0f) {
+                return mixWithHRTF(stream);
+            }
+
+            if (shouldBeSkipped(stream, *listener, *listenerAudioStream, *listenerData)) {
+                resetHRTFState(stream);
+                streams.skipped.push_back(move(stream));
+                ++stats.activeToSkipped;
+                return true;
+            }
+
+            stream.farFieldCluster = cluster;
+            ++_farFieldClusterCounts[cluster];
             return false;
         });
         erase.iterateTo(end(streams.active), [&](MixableStream& stream) {
@@ -443,6 +489,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
             // this ensures at least remove the tail from last mixed block
             // preventing excessive artifacts on the next first block
             resetHRTFState(stream);
+            stream.isInFarField = false;
 
             if (shouldBeSkipped(stream, *listener, *listenerAudioStream, *listenerData)) {
                 streams.skipped.push_back(move(stream));
@@ -460,6 +507,10 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         });
     }
 
+    if (isFarField || listenerData->hasFarFieldMix) {
+        stats.farFieldStreams += addFarFieldStreams(streams.active, *listenerAudioStream, *listenerData);
+    }
+
     stats.skipped += (int)streams.skipped.size();
     stats.inactive += (int)streams.inactive.size();
     stats.active += (int)streams.active.size();
@@ -494,6 +545,9 @@ void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStre
                                 float masterListenerGain, bool isSoloing) {
     ++stats.totalMixes;
 
+    // a stream mixed through its own HRTF is no longer heard through the far-field bed
+    mixableStream.isInFarField = false;
+
     auto streamToAdd = mixableStream.positionalStream;
 
     // check if this is a server echo of a source back to itself
@@ -509,8 +563,6 @@ void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStre
         gain = computeGain(masterListenerGain, listeningNodeStream, *streamToAdd, relativePosition, distance, isEcho);
     }
 
-    const int HRTF_DATASET_INDEX = 1;
-
     if (!streamToAdd->lastPopSucceeded()) {
         bool forceSilentBlock = true;
 
@@ -584,6 +636,108 @@ void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStre
     }
 }
 
+int AudioMixerSlave::addFarFieldStreams(MixableStreamsVector& activeStreams, AvatarAudioStream& listeningNodeStream,
+                                        AudioMixerClientData& listenerData) {
+    auto& clusters = _sharedData.clusters;
+    float masterListenerGain = listenerData.getMasterAvatarGain();
+
+    // a cluster can only stand in for its streams if every one of them is in the far-field for this listener
+    auto isCovered = [&](int cluster) {
+        return _farFieldClusterCounts[cluster] == clusters.getCluster(cluster).numStreams;
+    };
+
+    int numFarFieldStreams = 0;
+    for (const auto& stream : activeStreams) {
+        if (stream.farFieldCluster != AudioMixerClusters::NO_CLUSTER && isCovered(stream.farFieldCluster)) {
+            ++numFarFieldStreams;
+        }
+    }
+
+    bool useBed = numFarFieldStreams >= MIN_FAR_FIELD_STREAMS;
+
+    for (auto& stream : activeStreams) {
+        int cluster = stream.farFieldCluster;
+        if (cluster == AudioMixerClusters::NO_CLUSTER) {
+            continue;
+        }
+        stream.farFieldCluster = AudioMixerClusters::NO_CLUSTER;
+
+        if (useBed && isCovered(cluster)) {
+            // drop the HRTF tail on the first frame the stream moves to the bed, like a throttled stream
+            if (!stream.isInFarField) {
+                resetHRTFState(stream);
+                stream.isInFarField = true;
+            }
+        } else {
+            addStream(stream, listeningNodeStream, masterListenerGain, false);
+        }
+    }
+
+    if (!useBed) {
+        if (listenerData.hasFarFieldMix) {
+            // render one silent block to flush the tail of the last bed
+            memset(_farFieldBedSamples, 0, sizeof(_farFieldBedSamples));
+            glm::quat orientation = glm::inverse(listeningNodeStream.getOrientation());
+            listenerData.farFieldFOA.render(_farFieldBedSamples, _mixSamples, HRTF_DATASET_INDEX,
+                                            orientation.w, -orientation.z, -orientation.x, orientation.y, 1.0f,
+                                            AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+            listenerData.hasFarFieldMix = false;
+        }
+        return 0;
+    }
+
+    // encode every covered cluster into a world aligned bed, as a point source at its centroid
+    memset(_farFieldSamples, 0, sizeof(_farFieldSamples));
+    for (int i = 0; i < clusters.getNumClusters(); ++i) {
+        if (!isCovered(i)) {
+            continue;
+        }
+
+        const auto& cluster = clusters.getCluster(i);
+        glm::vec3 relativePosition = cluster.position - listeningNodeStream.getPosition();
+        float distance = glm::max(glm::length(relativePosition), EPSILON);
+        glm::vec3 direction = relativePosition / distance;
+
+        float distanceGain = computeDistanceGain(listeningNodeStream, cluster.position, distance);
+        float injectorGain = std::min(distanceGain, ATTN_GAIN_MAX);
+        float avatarGain = std::min(distanceGain * masterListenerGain, ATTN_GAIN_MAX);
+
+        // convert from Y-up (OpenGL) to Z-up (Ambisonic) coordinate system, ambiX channel order is W, Y, Z, X
+        float x = -direction.z;
+        float y = -direction.x;
+        float z = direction.y;
+
+        for (int j = 0; j < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; j++) {
+            float sample = cluster.avatarSamples[j] * avatarGain + cluster.injectorSamples[j] * injectorGain;
+            _farFieldSamples[4*j+0] += sample;
+            _farFieldSamples[4*j+1] += sample * y;
+            _farFieldSamples[4*j+2] += sample * z;
+            _farFieldSamples[4*j+3] += sample * x;
+        }
+    }
+
+    // AudioFOA takes int16_t input, so scale the bed down if it would clip and make that up in the render gain
+    float peak = 0.0f;
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC; i++) {
+        peak = std::max(peak, std::abs(_farFieldSamples[i]));
+    }
+    float scale = (peak > 1.0f) ? (1.0f / peak) : 1.0f;
+
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC; i++) {
+        _farFieldBedSamples[i] = (int16_t)(_farFieldSamples[i] * scale * 32767.0f);
+    }
+
+    // the bed is in world orientation, rotate it into the listener's
+    glm::quat orientation = glm::inverse(listeningNodeStream.getOrientation());
+    listenerData.farFieldFOA.render(_farFieldBedSamples, _mixSamples, HRTF_DATASET_INDEX,
+                                    orientation.w, -orientation.z, -orientation.x, orientation.y, 1.0f / scale,
+                                    AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    listenerData.hasFarFieldMix = true;
+    ++stats.farFieldRenders;
+
+    return numFarFieldStreams;
+}
+
 void AudioMixerSlave::updateHRTFParameters(AudioMixerClientData::MixableStream& mixableStream,
                                       AvatarAudioStream& listeningNodeStream,
                                       float masterListenerGain) {
@@ -758,13 +912,24 @@ float computeGain(float masterListenerGain, const AvatarAudioStream& listeningNo
         gain *= masterListenerGain;
     }
 
+    gain *= computeDistanceGain(listeningNodeStream, streamToAdd.getPosition(), distance);
+    gain = std::min(gain, ATTN_GAIN_MAX);
+
+    return gain;
+}
+
+// the distance attenuation for a source, unclamped
+float computeDistanceGain(const AvatarAudioStream& listeningNodeStream, const glm::vec3& sourcePosition,
+        float distance) {
+    float gain = 1.0f;
+
     auto& audioZones = AudioMixer::getAudioZones();
     auto& zoneSettings = AudioMixer::getZoneSettings();
 
     // find distance attenuation coefficient
     float attenuationPerDoublingInDistance = AudioMixer::getAttenuationPerDoublingInDistance();
     for (const auto& settings : zoneSettings) {
-        if (audioZones[settings.source].area.contains(streamToAdd.getPosition()) &&
+        if (audioZones[settings.source].area.contains(sourcePosition) &&
             audioZones[settings.listener].area.contains(listeningNodeStream.getPosition())) {
             attenuationPerDoublingInDistance = settings.coefficient;
             break;
@@ -780,7 +945,6 @@ float computeGain(float masterListenerGain, const AvatarAudioStream& listeningNo
         // reference attenuation of 0dB at distance = ATTN_DISTANCE_REF
         float d = distance - ATTN_DISTANCE_REF;
         gain *= std::max(1.0f - d / (distanceLimit - ATTN_DISTANCE_REF), 0.0f);
-        gain = std::min(gain, ATTN_GAIN_MAX);
 
     } else {
         // translate a positive zone setting to gain per log2(distance)
@@ -791,7 +955,6 @@ float computeGain(float masterListenerGain, const AvatarAudioStream& listeningNo
         // reference attenuation of 0dB at distance = ATTN_DISTANCE_REF
         float d = (1.0f / ATTN_DISTANCE_REF) * std::max(distance, HRTF_NEARFIELD_MIN);
         gain *= fastExp2f(fastLog2f(g) * fastLog2f(d));
-        gain = std::min(gain, ATTN_GAIN_MAX);
     }
 
     return gain;
@@ -23,6 +23,7 @@
 #include <PositionalAudioStream.h>
 
 #include "AudioMixerClientData.h"
+#include "AudioMixerClusters.h"
 #include "AudioMixerStats.h"
 
 class AvatarAudioStream;
@@ -36,6 +37,7 @@ public:
         AudioMixerClientData::ConcurrentAddedStreams addedStreams;
         std::vector<Node::LocalID> removedNodes;
         std::vector<NodeIDStreamID> removedStreams;
+        AudioMixerClusters clusters;
     };
 
     AudioMixerSlave(SharedData& sharedData) : _sharedData(sharedData) {};
@@ -65,10 +67,19 @@ private:
 
     void addStreams(Node& listener, AudioMixerClientData& listenerData);
 
+    // mix the far-field streams flagged by prepareMix, returns the number of streams that went to the ambisonic bed
+    int addFarFieldStreams(AudioMixerClientData::MixableStreamsVector& activeStreams,
+                           AvatarAudioStream& listeningNodeStream, AudioMixerClientData& listenerData);
+
     // mixing buffers
     float _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     int16_t _bufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
 
+    // far-field buffers, an interleaved first-order ambisonic bed
+    float _farFieldSamples[AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC];
+    int16_t _farFieldBedSamples[AudioConstants::NETWORK_FRAME_SAMPLES_AMBISONIC];
+    std::vector<int> _farFieldClusterCounts;
+
     // frame state
     ConstIter _begin;
     ConstIter _end;
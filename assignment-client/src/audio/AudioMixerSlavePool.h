@@ -12,56 +12,25 @@
 #ifndef hifi_AudioMixerSlavePool_h
 #define hifi_AudioMixerSlavePool_h
 
-#include <condition_variable>
-#include <mutex>
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include <QThread>
 
-#include <TBBHelpers.h>
+#include <WorkStealingScheduler.h>
 
 #include "AudioMixerSlave.h"
 
-class AudioMixerSlavePool;
-
-class AudioMixerSlaveThread : public QThread, public AudioMixerSlave {
-    Q_OBJECT
-    using ConstIter = NodeList::const_iterator;
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
-
-public:
-    AudioMixerSlaveThread(AudioMixerSlavePool& pool, AudioMixerSlave::SharedData& sharedData)
-        : AudioMixerSlave(sharedData), _pool(pool) {}
-
-    void run() override final;
-
-private:
-    friend class AudioMixerSlavePool;
-
-    void wait();
-    void notify(bool stopping);
-    bool try_pop(SharedNodePointer& node);
-
-    AudioMixerSlavePool& _pool;
-    void (AudioMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
-    bool _stop { false };
-};
-
 // Slave pool for audio mixers
+//   Nodes are handed out in chunks by a WorkStealingScheduler, with one AudioMixerSlave per worker thread.
 //   AudioMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
 class AudioMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
-    using ConditionVariable = std::condition_variable;
-
 public:
     using ConstIter = NodeList::const_iterator;
 
     AudioMixerSlavePool(AudioMixerSlave::SharedData& sharedData, int numThreads = QThread::idealThreadCount())
         : _workerSharedData(sharedData) { setNumThreads(numThreads); }
-    ~AudioMixerSlavePool() { resize(0); }
 
     // process packets on slave threads
     void processPackets(ConstIter begin, ConstIter end);
@@ -79,29 +48,20 @@ private:
     void run(ConstIter begin, ConstIter end);
     void resize(int numThreads);
 
-    std::vector<std::unique_ptr<AudioMixerSlaveThread>> _slaves;
-
-    friend void AudioMixerSlaveThread::wait();
-    friend void AudioMixerSlaveThread::notify(bool stopping);
-    friend bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node);
+    std::vector<std::unique_ptr<AudioMixerSlave>> _slaves;
 
-    // synchronization state
-    Mutex _mutex;
-    ConditionVariable _slaveCondition;
-    ConditionVariable _poolCondition;
     void (AudioMixerSlave::*_function)(const SharedNodePointer& node);
     std::function<void(AudioMixerSlave&)> _configure;
     int _numThreads { 0 };
-    int _numStarted { 0 }; // guarded by _mutex
-    int _numFinished { 0 }; // guarded by _mutex
-    int _numStopped { 0 }; // guarded by _mutex
 
     // frame state
-    Queue _queue;
     ConstIter _begin;
     ConstIter _end;
 
     AudioMixerSlave::SharedData& _workerSharedData;
+
+    // declared last so the workers are stopped before the slaves they use are destroyed
+    WorkStealingScheduler _scheduler { "AudioMixerSlave" };
 };
 
 #endif // hifi_AudioMixerSlavePool_h
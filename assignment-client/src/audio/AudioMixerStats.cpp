@@ -25,6 +25,10 @@ void AudioMixerStats::reset() {
     manualStereoMixes = 0;
     manualEchoMixes = 0;
 
+    farFieldClusters = 0;
+    farFieldStreams = 0;
+    farFieldRenders = 0;
+
     skippedToActive = 0;
     skippedToInactive = 0;
     inactiveToSkipped = 0;
@@ -55,6 +59,10 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     manualStereoMixes += otherStats.manualStereoMixes;
     manualEchoMixes += otherStats.manualEchoMixes;
 
+    farFieldClusters += otherStats.farFieldClusters;
+    farFieldStreams += otherStats.farFieldStreams;
+    farFieldRenders += otherStats.farFieldRenders;
+
     skippedToActive += otherStats.skippedToActive;
     skippedToInactive += otherStats.skippedToInactive;
     inactiveToSkipped += otherStats.inactiveToSkipped;
@@ -30,6 +30,10 @@ struct AudioMixerStats {
     int manualStereoMixes { 0 };
     int manualEchoMixes { 0 };
 
+    int farFieldClusters { 0 };
+    int farFieldStreams { 0 };      // streams heard through a far-field bed, each one an HRTF render saved
+    int farFieldRenders { 0 };
+
     int skippedToActive { 0 };
     int skippedToInactive { 0 };
     int inactiveToSkipped { 0 };
@@ -0,0 +1,201 @@
+//
+//  AvatarEncodeCache.cpp
+//  assignment-client/src/avatars
+//
+//  Created by Roxanne Skelly on 2019-06-21.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarEncodeCache.h"
+
+const int AvatarEncodeCache::NUM_DISTANCE_BANDS = 6;
+
+static const float DISTANCE_BAND_LIMITS[] = {
+    AVATAR_DISTANCE_LEVEL_1,
+    AVATAR_DISTANCE_LEVEL_2,
+    AVATAR_DISTANCE_LEVEL_3,
+    AVATAR_DISTANCE_LEVEL_4,
+    AVATAR_DISTANCE_LEVEL_5
+};
+
+// the distance each band's deltas are encoded for, well inside the band
+static const float DISTANCE_BAND_ENCODE_DISTANCES[] = {
+    0.0f,
+    (AVATAR_DISTANCE_LEVEL_1 + AVATAR_DISTANCE_LEVEL_2) / 2.0f,
+    (AVATAR_DISTANCE_LEVEL_2 + AVATAR_DISTANCE_LEVEL_3) / 2.0f,
+    (AVATAR_DISTANCE_LEVEL_3 + AVATAR_DISTANCE_LEVEL_4) / 2.0f,
+    (AVATAR_DISTANCE_LEVEL_4 + AVATAR_DISTANCE_LEVEL_5) / 2.0f,
+    AVATAR_DISTANCE_LEVEL_5 * 2.0f
+};
+
+int AvatarEncodeCache::getDistanceBand(float distance) {
+    int band = 0;
+    while (band < NUM_DISTANCE_BANDS - 1 && distance >= DISTANCE_BAND_LIMITS[band]) {
+        ++band;
+    }
+    return band;
+}
+
+QByteArray AvatarEncodeCache::getEncoding(const AvatarData& avatar, AvatarData::AvatarDataDetail detail, const Frame& frame,
+                                          AvatarDataSequenceNumber sequenceNumber, float distance, int maxSize,
+                                          DestinationState& state, QVector<JointData>& lastSentJoints) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    beginFrame(frame, sequenceNumber);
+
+    bool wasSentLastGeneration = state.generation != 0 && state.generation + 1 == _generation;
+
+    switch (detail) {
+        case AvatarData::PALMinimum: {
+            // only the position and loudness, which leave the destination's state alone
+            if (_palMinimum.isEmpty()) {
+                QVector<JointData> noJoints;
+                _palMinimum = encode(avatar, detail, 0, noJoints);
+            }
+
+            if (_palMinimum.size() > maxSize) {
+                return QByteArray();
+            }
+            return _palMinimum;
+        }
+
+        case AvatarData::MinimumData: {
+            QByteArray& bytes = wasSentLastGeneration ? _minimumDelta : _minimumKeyframe;
+            if (bytes.isEmpty()) {
+                QVector<JointData> noJoints;
+                bytes = encode(avatar, detail, wasSentLastGeneration ? _lastGenerationTime : 0, noJoints);
+            }
+
+            if (bytes.size() > maxSize) {
+                return QByteArray();
+            }
+            state.generation = _generation;
+            return bytes;
+        }
+
+        case AvatarData::CullSmallData: {
+            // a destination that has come closer than its band needs finer joints than the band sends
+            bool followsBand = state.band >= 0 && state.jointsGeneration != 0 && state.jointsGeneration + 1 == _generation
+                && getDistanceBand(distance) >= state.band;
+            if (followsBand && _bands[state.band].hasBase) {
+                Band& band = _bands[state.band];
+                if (band.delta.isEmpty()) {
+                    QVector<JointData> joints = band.baseJoints;
+                    band.delta = encode(avatar, detail, _lastGenerationTime, joints, state.band);
+                    band.joints = joints;
+                    band.generation = _generation;
+                }
+
+                if (band.delta.size() > maxSize) {
+                    return QByteArray();
+                }
+                state.generation = _generation;
+                state.jointsGeneration = _generation;
+                lastSentJoints = band.joints;
+                return band.delta;
+            }
+
+            // the destination fell off its band, it starts over from the keyframe
+            Q_FALLTHROUGH();
+        }
+
+        case AvatarData::SendAllData: {
+            int band = getDistanceBand(distance);
+            const QByteArray& bytes = getKeyframe(avatar, band);
+
+            if (bytes.size() > maxSize) {
+                return QByteArray();
+            }
+            state.generation = _generation;
+            state.jointsGeneration = _generation;
+            state.band = band;
+            lastSentJoints = _keyframeJoints;
+            return bytes;
+        }
+
+        default:
+            return QByteArray();
+    }
+}
+
+void AvatarEncodeCache::ownEncodingSent(AvatarData::AvatarDataDetail detail, const Frame& frame,
+                                        AvatarDataSequenceNumber sequenceNumber, DestinationState& state) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    beginFrame(frame, sequenceNumber);
+
+    // every changed section went out, the joints are the destination's own now
+    if (detail == AvatarData::MinimumData || detail == AvatarData::CullSmallData ||
+        detail == AvatarData::IncludeSmallData || detail == AvatarData::SendAllData) {
+        state.generation = _generation;
+    }
+}
+
+void AvatarEncodeCache::beginFrame(const Frame& frame, AvatarDataSequenceNumber sequenceNumber) {
+    if (_frame == frame.number) {
+        return;
+    }
+    _frame = frame.number;
+
+    // nothing new from the avatar, this frame's encodings would be the last generation's
+    if (_generation != 0 && sequenceNumber == _sequenceNumber) {
+        return;
+    }
+    _sequenceNumber = sequenceNumber;
+    ++_generation;
+    _lastGenerationTime = _generationTime;
+    _generationTime = frame.broadcastTime;
+
+    _keyframe.clear();
+    _minimumDelta.clear();
+    _minimumKeyframe.clear();
+    _palMinimum.clear();
+
+    if (_bands.empty()) {
+        _bands.resize(NUM_DISTANCE_BANDS);
+    }
+
+    for (auto& band : _bands) {
+        // a band no destination was sent last generation has no one left to make deltas for
+        band.hasBase = band.generation != 0 && band.generation + 1 == _generation;
+        if (band.hasBase) {
+            band.baseJoints = band.joints;
+        } else {
+            band.baseJoints.clear();
+            band.joints.clear();
+        }
+        band.delta.clear();
+    }
+}
+
+const QByteArray& AvatarEncodeCache::getKeyframe(const AvatarData& avatar, int band) {
+    if (_keyframe.isEmpty()) {
+        _keyframeJoints.clear();
+        _keyframe = encode(avatar, AvatarData::SendAllData, 0, _keyframeJoints);
+    }
+
+    // the first keyframe of the generation in a band starts its deltas, if none were made on the previous one's
+    Band& keyframeBand = _bands[band];
+    if (keyframeBand.generation != _generation) {
+        keyframeBand.joints = _keyframeJoints;
+        keyframeBand.generation = _generation;
+    }
+
+    return _keyframe;
+}
+
+QByteArray AvatarEncodeCache::encode(const AvatarData& avatar, AvatarData::AvatarDataDetail detail, quint64 lastSentTime,
+                                     QVector<JointData>& joints, int band) const {
+    // changes are culled by distance, encode as if seen from within the band
+    glm::vec3 viewerPosition = avatar.getClientGlobalPosition() + glm::vec3(DISTANCE_BAND_ENCODE_DISTANCES[band], 0.0f, 0.0f);
+
+    const bool dropFaceTracking = false;
+    const bool distanceAdjust = true;
+    AvatarDataPacket::SendStatus sendStatus;
+    sendStatus.sendUUID = true;
+
+    // the joints are both what was last sent and what this sends, toByteArray allows for that
+    return avatar.toByteArray(detail, lastSentTime, joints, sendStatus, dropFaceTracking, distanceAdjust, viewerPosition,
+                              &joints, 0);
+}
@@ -0,0 +1,105 @@
+//
+//  AvatarEncodeCache.h
+//  assignment-client/src/avatars
+//
+//  Created by Roxanne Skelly on 2019-06-21.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarEncodeCache_h
+#define hifi_AvatarEncodeCache_h
+
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+
+#include <AvatarData.h>
+#include <SharedUtil.h>
+
+// The encodings of one avatar for the current broadcast frame, made once and shared by every destination it is sent
+// to, instead of being encoded again for each of them.
+//
+//   Encodings are made per generation of the avatar's data - a broadcast frame that has new data from the avatar
+//   starts a new one, a frame without (the avatar sends slower than we mix) keeps the last, so destinations held back
+//   for it keep their delta base.
+//
+//   SendAllData doubles as the keyframe, it doesn't depend on the destination at all.
+//   MinimumData and CullSmallData are deltas on the previous generation, good for any destination that was sent the
+//   avatar then. Joint changes are culled against what the shared deltas of the destination's distance band have
+//   sent so far rather than what each destination holds, so a destination's joints can lag the avatar by up to
+//   twice the band's tolerance. A destination that misses a generation, or comes closer than its band, gets the
+//   keyframe and picks up a band again.
+//
+//   The cache belongs to the avatar's client data and is used by all slaves at once, the first one to ask for an
+//   encoding makes it.
+class AvatarEncodeCache {
+public:
+    static const int NUM_DISTANCE_BANDS;
+
+    // the broadcast frame encodings are made in, set by the mixer before the slaves broadcast
+    struct Frame {
+        uint32_t number { 0 };
+        quint64 broadcastTime { 0 };        // when this frame's broadcast started
+
+        void advance() {
+            ++number;
+            broadcastTime = usecTimestampNow();
+        }
+    };
+
+    // what a destination has been sent of the avatar, kept by the destination
+    struct DestinationState {
+        uint32_t generation { 0 };          // last generation it was sent every section that changed
+        uint32_t jointsGeneration { 0 };    // last generation its joints came from a shared encoding
+        int band { -1 };                    // the band of joint deltas it follows
+    };
+
+    // the band a viewer at distance culls joint changes at, see AvatarData::getDistanceBasedMinRotationDOT
+    static int getDistanceBand(float distance);
+
+    // Returns the shared encoding of the avatar for a destination at distance, or an empty array if it has to be
+    // encoded for the destination on its own (no shared encoding of that detail, or one bigger than maxSize).
+    // When an encoding is returned the destination's state and last sent joints are brought up to date.
+    // sequenceNumber is the last one received from the avatar, it tells whether its data is new this frame.
+    QByteArray getEncoding(const AvatarData& avatar, AvatarData::AvatarDataDetail detail, const Frame& frame,
+                           AvatarDataSequenceNumber sequenceNumber, float distance, int maxSize,
+                           DestinationState& state, QVector<JointData>& lastSentJoints);
+
+    // records an encoding made for the destination on its own
+    void ownEncodingSent(AvatarData::AvatarDataDetail detail, const Frame& frame, AvatarDataSequenceNumber sequenceNumber,
+                         DestinationState& state);
+
+private:
+    struct Band {
+        uint32_t generation { 0 };          // generation the joints are as of
+        QVector<JointData> joints;          // what the band's destinations hold
+        bool hasBase { false };
+        QVector<JointData> baseJoints;      // the joints as of the previous generation, this one's delta is made on
+        QByteArray delta;
+    };
+
+    void beginFrame(const Frame& frame, AvatarDataSequenceNumber sequenceNumber);
+    const QByteArray& getKeyframe(const AvatarData& avatar, int band);
+    QByteArray encode(const AvatarData& avatar, AvatarData::AvatarDataDetail detail, quint64 lastSentTime,
+                      QVector<JointData>& joints, int band = 0) const;
+
+    std::mutex _mutex;
+    uint32_t _frame { 0 };
+    AvatarDataSequenceNumber _sequenceNumber { 0 };  // of the avatar data the current generation was made from
+    uint32_t _generation { 0 };
+    quint64 _generationTime { 0 };      // broadcast time of the frame the current generation started in
+    quint64 _lastGenerationTime { 0 };  // and of the previous one, deltas carry what changed since
+
+    QByteArray _keyframe;
+    QVector<JointData> _keyframeJoints;
+    QByteArray _minimumDelta;
+    QByteArray _minimumKeyframe;
+    QByteArray _palMinimum;
+    std::vector<Band> _bands;
+};
+
+#endif // hifi_AvatarEncodeCache_h
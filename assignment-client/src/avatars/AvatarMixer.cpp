@@ -65,7 +65,12 @@ AvatarMixer::AvatarMixer(ReceivedMessage& message) :
     connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &AvatarMixer::handleAvatarKilled);
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
-    packetReceiver.registerListener(PacketType::AvatarData, this, "queueIncomingPacket");
+    // avatar data is a single unreliable packet per avatar per frame - it skips ReceivedMessage and the main thread's
+    // event queue and goes straight to the client's packet queue
+    packetReceiver.registerPacketHandler(PacketType::AvatarData, this,
+        [this](ReceivedPacketPointer packet, SharedNodePointer node) {
+            queueAvatarDataPacket(std::move(packet), node);
+        });
     packetReceiver.registerListener(PacketType::AdjustAvatarSorting, this, "handleAdjustAvatarSorting");
     packetReceiver.registerListener(PacketType::AvatarQuery, this, "handleAvatarQueryPacket");
     packetReceiver.registerListener(PacketType::AvatarIdentity, this, "handleAvatarIdentityPacket");
@@ -155,7 +160,8 @@ void AvatarMixer::handleReplicatedBulkAvatarPacket(QSharedPointer<ReceivedMessag
 
         // queue up the replicated avatar data with the client data for the replicated node
         auto start = usecTimestampNow();
-        getOrCreateClientData(replicatedNode)->queuePacket(replicatedMessage, replicatedNode);
+        getOrCreateClientData(replicatedNode)->queuePacket(ReceivedMessage::toPacketPointer(replicatedMessage),
+                                                           replicatedNode);
         auto end = usecTimestampNow();
         _queueIncomingPacketElapsedTime += (end - start);
     }
@@ -198,7 +204,33 @@ void AvatarMixer::optionallyReplicatePacket(ReceivedMessage& message, const Node
 
 void AvatarMixer::queueIncomingPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
     auto start = usecTimestampNow();
-    getOrCreateClientData(node)->queuePacket(message, node);
+    getOrCreateClientData(node)->queuePacket(ReceivedMessage::toPacketPointer(message), node);
+    auto end = usecTimestampNow();
+    _queueIncomingPacketElapsedTime += (end - start);
+}
+
+void AvatarMixer::queueAvatarDataPacket(ReceivedPacketPointer packet, SharedNodePointer node) {
+    if (!node) {
+        return;
+    }
+
+    auto start = usecTimestampNow();
+    AvatarMixerClientData* clientData;
+    {
+        QMutexLocker locker(&node->getMutex());
+        clientData = dynamic_cast<AvatarMixerClientData*>(node->getLinkedData());
+    }
+
+    if (!clientData) {
+        // the client data is a QObject and has to be created on our thread, this frame of avatar data is dropped
+        QMetaObject::invokeMethod(this, [this, node] {
+            QMutexLocker locker(&node->getMutex());
+            getOrCreateClientData(node);
+        });
+        return;
+    }
+
+    clientData->queuePacket(std::move(packet), node);
     auto end = usecTimestampNow();
     _queueIncomingPacketElapsedTime += (end - start);
 }
@@ -296,6 +328,13 @@ void AvatarMixer::start() {
             auto start = usecTimestampNow();
             nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
                 auto start = usecTimestampNow();
+
+                // index this frame's avatars once, every slave queries it for its destinations
+                _slaveSharedData.grid.build(cbegin, cend);
+
+                // avatars are only encoded again once they have been processed for a new frame
+                _slaveSharedData.encodeFrame.advance();
+
                 _slavePool.broadcastAvatarData(cbegin, cend, _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio);
                 auto end = usecTimestampNow();
                 _broadcastAvatarDataInner += (end - start);
@@ -800,6 +839,15 @@ void AvatarMixer::sendStatsPacket() {
     slavesAggregatObject["sent_6_averageIdentityBytes"] = TIGHT_LOOP_STAT(aggregateStats.numIdentityBytesSent);
     slavesAggregatObject["sent_7_averageHeroAvatars"] = TIGHT_LOOP_STAT(aggregateStats.numHeroesIncluded);
 
+    float averageOthersConsidered = averageNodes ? aggregateStats.numOthersConsidered / averageNodes : 0.0f;
+    slavesAggregatObject["sent_8_averageOthersConsidered"] = TIGHT_LOOP_STAT(averageOthersConsidered);
+
+    int encodingsSent = aggregateStats.numSharedEncodingsSent + aggregateStats.numOwnEncodingsSent;
+    slavesAggregatObject["sent_9_sharedEncodingRatio"] =
+        encodingsSent > 0 ? (float)aggregateStats.numSharedEncodingsSent / (float)encodingsSent : 0.0f;
+    slavesAggregatObject["sent_10_averageTraitsDeferred"] = TIGHT_LOOP_STAT(aggregateStats.numTraitsDeferred);
+    slavesAggregatObject["sent_11_averageIdentitiesDeferred"] = TIGHT_LOOP_STAT(aggregateStats.numIdentitiesDeferred);
+
     slavesAggregatObject["timing_1_processIncomingPackets"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.processIncomingPacketsElapsedTime);
     slavesAggregatObject["timing_2_ignoreCalculation"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.ignoreCalculationElapsedTime);
     slavesAggregatObject["timing_3_toByteArray"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.toByteArrayElapsedTime);
@@ -965,6 +1013,29 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
         qCDebug(avatars) << "Avatar mixer will automatically determine number of threads to use. Using:" << _slavePool.numThreads() << "threads.";
     }
 
+    {
+        const QString SPATIAL_CULLING = "spatial_culling";
+        const QString SPATIAL_CULLING_CELL_SIZE = "spatial_culling_cell_size";
+
+        bool spatialCulling = avatarMixerGroupObject[SPATIAL_CULLING].toBool();
+        float cellSize = avatarMixerGroupObject[SPATIAL_CULLING_CELL_SIZE].toDouble(AvatarMixerGrid::DEFAULT_CELL_SIZE);
+        _slaveSharedData.grid.setEnabled(spatialCulling);
+        _slaveSharedData.grid.setCellSize(cellSize);
+
+        if (spatialCulling) {
+            qCDebug(avatars) << "Avatar mixer will only consider nearby and in view avatars each frame, cell size:" << cellSize;
+        }
+    }
+
+    {
+        const QString SHARE_ENCODINGS = "share_encodings";
+        _slaveSharedData.shareEncodings = avatarMixerGroupObject[SHARE_ENCODINGS].toBool(true);
+
+        if (!_slaveSharedData.shareEncodings) {
+            qCDebug(avatars) << "Avatar mixer will encode every avatar separately for each agent it is sent to";
+        }
+    }
+
     {
         const QString CONNECTION_RATE = "connection_rate";
         auto nodeList = DependencyManager::get<NodeList>();
@@ -15,6 +15,7 @@
 #ifndef hifi_AvatarMixer_h
 #define hifi_AvatarMixer_h
 
+#include <atomic>
 #include <set>
 #include <shared/RateCounter.h>
 #include <PortableHighResolutionClock.h>
@@ -64,6 +65,9 @@ private slots:
 
 private:
     AvatarMixerClientData* getOrCreateClientData(SharedNodePointer node);
+
+    // called directly on the receiving thread
+    void queueAvatarDataPacket(ReceivedPacketPointer packet, SharedNodePointer node);
     std::chrono::microseconds timeFrame(p_high_resolution_clock::time_point& timestamp);
     void throttle(std::chrono::microseconds duration, int frame);
 
@@ -139,7 +143,7 @@ private:
 
     quint64 _processEventsElapsedTime { 0 };
     quint64 _sendStatsElapsedTime { 0 };
-    quint64 _queueIncomingPacketElapsedTime { 0 };
+    std::atomic<quint64> _queueIncomingPacketElapsedTime { 0 };
     quint64 _lastStatsTime { usecTimestampNow() };
 
     RateCounter<> _loopRate; // this is the rate that the main thread tight loop runs
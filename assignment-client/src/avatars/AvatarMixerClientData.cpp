@@ -46,21 +46,31 @@ void AvatarMixerClientData::setLastOtherAvatarEncodeTime(NLPacket::LocalID other
     }
 }
 
-void AvatarMixerClientData::queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
+void AvatarMixerClientData::queuePacket(ReceivedPacketPointer message, SharedNodePointer node) {
+    std::lock_guard<std::mutex> lock(_packetQueueLock);
     if (!_packetQueue.node) {
         _packetQueue.node = node;
     }
-    _packetQueue.push(message);
+    _packetQueue.push(std::move(message));
 }
 
 int AvatarMixerClientData::processPackets(const SlaveSharedData& slaveSharedData) {
     int packetsProcessed = 0;
-    SharedNodePointer node = _packetQueue.node;
-    assert(_packetQueue.empty() || node);
-    _packetQueue.node.clear();
 
-    while (!_packetQueue.empty()) {
-        auto& packet = _packetQueue.front();
+    // take what's queued so far, packets that arrive while we process go to the next frame
+    PacketQueue packetQueue;
+    {
+        std::lock_guard<std::mutex> lock(_packetQueueLock);
+        packetQueue.swap(_packetQueue);
+        packetQueue.node = _packetQueue.node;
+        _packetQueue.node.clear();
+    }
+
+    SharedNodePointer node = packetQueue.node;
+    assert(packetQueue.empty() || node);
+
+    while (!packetQueue.empty()) {
+        auto& packet = packetQueue.front();
 
         packetsProcessed++;
 
@@ -77,9 +87,9 @@ int AvatarMixerClientData::processPackets(const SlaveSharedData& slaveSharedData
             default:
                 Q_UNREACHABLE();
         }
-        _packetQueue.pop();
+        packetQueue.pop();
     }
-    assert(_packetQueue.empty());
+    assert(packetQueue.empty());
 
     return packetsProcessed;
 }
@@ -119,7 +129,7 @@ namespace {
 
 }  // Close anonymous namespace.
 
-int AvatarMixerClientData::parseData(ReceivedMessage& message, const SlaveSharedData& slaveSharedData) {
+int AvatarMixerClientData::parseData(ReceivedPacket& message, const SlaveSharedData& slaveSharedData) {
     // pull the sequence number from the data first
     uint16_t sequenceNumber;
 
@@ -158,7 +168,7 @@ int AvatarMixerClientData::parseData(ReceivedMessage& message, const SlaveShared
     return true;
 }
 
-void AvatarMixerClientData::processSetTraitsMessage(ReceivedMessage& message,
+void AvatarMixerClientData::processSetTraitsMessage(ReceivedPacket& message,
                                                     const SlaveSharedData& slaveSharedData,
                                                     Node& sendingNode) {
     // pull the trait version from the message
@@ -247,7 +257,7 @@ void AvatarMixerClientData::processSetTraitsMessage(ReceivedMessage& message,
     }
 }
 
-void AvatarMixerClientData::processBulkAvatarTraitsAckMessage(ReceivedMessage& message) {
+void AvatarMixerClientData::processBulkAvatarTraitsAckMessage(ReceivedPacket& message) {
     // Avatar Traits flow control marks each outgoing avatar traits packet with a
     // sequence number. The mixer caches the traits sent in the traits packet.
     // Until an ack with the sequence number comes back, all updates to _traits
@@ -465,6 +475,7 @@ AvatarMixerClientData::TraitsCheckTimestamp AvatarMixerClientData::getLastOtherA
 void AvatarMixerClientData::cleanupKilledNode(const QUuid&, Node::LocalID nodeLocalID) {
     removeLastBroadcastSequenceNumber(nodeLocalID);
     removeLastBroadcastTime(nodeLocalID);
+    _lastOtherAvatarEncodeStates.erase(nodeLocalID);
     _lastSentTraitsTimestamps.erase(nodeLocalID);
     _perNodeSentTraitVersions.erase(nodeLocalID);
 }
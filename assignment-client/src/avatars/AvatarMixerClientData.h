@@ -15,12 +15,14 @@
 #include <algorithm>
 #include <cfloat>
 #include <unordered_map>
+#include <mutex>
 #include <vector>
 #include <queue>
 
 #include <QtCore/QJsonObject>
 #include <QtCore/QUrl>
 
+#include "AvatarEncodeCache.h"
 #include "MixerAvatar.h"
 #include <AssociatedTraitValues.h>
 #include <NodeData.h>
@@ -46,7 +48,7 @@ public:
     using PerNodeTraitVersions = std::unordered_map<Node::LocalID, AvatarTraits::TraitVersions>;
 
     using NodeData::parseData;  // Avoid clang warning about hiding.
-    int parseData(ReceivedMessage& message, const SlaveSharedData& SlaveSharedData);
+    int parseData(ReceivedPacket& message, const SlaveSharedData& SlaveSharedData);
     MixerAvatar& getAvatar() { return *_avatar; }
     const MixerAvatar& getAvatar() const { return *_avatar; }
     const MixerAvatar* getConstAvatarData() const { return _avatar.get(); }
@@ -127,12 +129,18 @@ public:
     void setLastOtherAvatarEncodeTime(NLPacket::LocalID otherAvatar, uint64_t time);
 
     QVector<JointData>& getLastOtherAvatarSentJoints(NLPacket::LocalID otherAvatar) { return _lastOtherAvatarSentJoints[otherAvatar]; }
+    AvatarEncodeCache::DestinationState& getLastOtherAvatarEncodeState(NLPacket::LocalID otherAvatar)
+        { return _lastOtherAvatarEncodeStates[otherAvatar]; }
 
-    void queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
+    // this avatar's encodings for the current frame, shared by every node it is sent to
+    AvatarEncodeCache& getEncodeCache() const { return _encodeCache; }
+
+    // thread-safe, avatar data packets are queued directly from the receiving threads
+    void queuePacket(ReceivedPacketPointer message, SharedNodePointer node);
     int processPackets(const SlaveSharedData& slaveSharedData); // returns number of packets processed
 
-    void processSetTraitsMessage(ReceivedMessage& message, const SlaveSharedData& slaveSharedData, Node& sendingNode);
-    void processBulkAvatarTraitsAckMessage(ReceivedMessage& message);
+    void processSetTraitsMessage(ReceivedPacket& message, const SlaveSharedData& slaveSharedData, Node& sendingNode);
+    void processBulkAvatarTraitsAckMessage(ReceivedPacket& message);
     void checkSkeletonURLAgainstWhitelist(const SlaveSharedData& slaveSharedData, Node& sendingNode,
                                           AvatarTraits::TraitVersion traitVersion);
 
@@ -159,9 +167,10 @@ public:
     void resetSentTraitData(Node::LocalID nodeID);
 
 private:
-    struct PacketQueue : public std::queue<QSharedPointer<ReceivedMessage>> {
+    struct PacketQueue : public std::queue<ReceivedPacketPointer> {
         QWeakPointer<Node> node;
     };
+    std::mutex _packetQueueLock;
     PacketQueue _packetQueue;
 
     MixerAvatarSharedPointer _avatar { new MixerAvatar() };
@@ -174,6 +183,9 @@ private:
     // sending to "this" node
     std::unordered_map<NLPacket::LocalID, uint64_t> _lastOtherAvatarEncodeTime;
     std::unordered_map<NLPacket::LocalID, QVector<JointData>> _lastOtherAvatarSentJoints;
+    std::unordered_map<NLPacket::LocalID, AvatarEncodeCache::DestinationState> _lastOtherAvatarEncodeStates;
+
+    mutable AvatarEncodeCache _encodeCache;
 
     uint64_t _identityChangeTimestamp;
     bool _avatarSessionDisplayNameMustChange{ true };
@@ -0,0 +1,110 @@
+//
+//  AvatarMixerGrid.cpp
+//  assignment-client/src/avatars
+//
+//  Created by Roxanne Skelly on 2019-06-17.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarMixerGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "AvatarMixerClientData.h"
+
+const float AvatarMixerGrid::DEFAULT_CELL_SIZE = 16.0f;
+const int AvatarMixerGrid::COARSE_TIER_INTERVAL = 15; // a third of a second at the broadcast rate
+
+static const float MIN_CELL_SIZE = 1.0f;
+
+// cell coordinates are packed into 21 bits per axis, which covers the whole domain at any sane cell size
+static const int CELL_KEY_BITS = 21;
+static const int64_t CELL_KEY_OFFSET = 1 << (CELL_KEY_BITS - 1);
+static const int64_t CELL_KEY_MASK = (1 << CELL_KEY_BITS) - 1;
+
+void AvatarMixerGrid::setCellSize(float cellSize) {
+    _cellSize = std::max(cellSize, MIN_CELL_SIZE);
+}
+
+uint64_t AvatarMixerGrid::keyForPosition(const glm::vec3& position) const {
+    auto axisKey = [&](float coordinate) {
+        return (uint64_t)(((int64_t)std::floor(coordinate / _cellSize) + CELL_KEY_OFFSET) & CELL_KEY_MASK);
+    };
+    return (axisKey(position.x) << (2 * CELL_KEY_BITS)) | (axisKey(position.y) << CELL_KEY_BITS) | axisKey(position.z);
+}
+
+void AvatarMixerGrid::build(ConstIter begin, ConstIter end) {
+    _entries.clear();
+    _cells.clear();
+    _heroes.clear();
+
+    if (!_isEnabled) {
+        return;
+    }
+
+    ++_frame;
+
+    for (auto it = begin; it != end; ++it) {
+        const Node* node = it->data();
+        if (node->getType() != NodeType::Agent || !node->getLinkedData()) {
+            continue;
+        }
+
+        int offset = (int)(it - begin);
+        const auto* nodeData = reinterpret_cast<const AvatarMixerClientData*>(node->getLinkedData());
+        const MixerAvatar& avatar = nodeData->getAvatar();
+
+        if (avatar.getHasPriority()) {
+            _heroes.push_back(offset);
+            continue;
+        }
+
+        // bubble checks are made against the default bubble box, so the cell has to cover it as well
+        AABox bounds = avatar.getGlobalBoundingBox();
+        bounds += avatar.getDefaultBubbleBox();
+
+        _entries.push_back({ keyForPosition(avatar.getClientGlobalPosition()), offset, bounds });
+    }
+
+    std::sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b) {
+        return a.key < b.key;
+    });
+
+    for (int i = 0; i < (int)_entries.size(); ++i) {
+        const Entry& entry = _entries[i];
+        if (_cells.empty() || _cells.back().key != entry.key) {
+            // the slot only has to be stable while the cell is occupied, a cheap mix of the key will do
+            uint32_t slot = (uint32_t)((entry.key * 0x9E3779B97F4A7C15ull) >> 32);
+            _cells.push_back({ entry.key, slot, i, 0, entry.bounds.getMinimumPoint(), entry.bounds.getMaximumPoint() });
+        }
+
+        Cell& cell = _cells.back();
+        ++cell.numEntries;
+        cell.minimum = glm::min(cell.minimum, entry.bounds.getMinimumPoint());
+        cell.maximum = glm::max(cell.maximum, entry.bounds.getMaximumPoint());
+    }
+}
+
+void AvatarMixerGrid::findCandidates(const AABox& nearBox, const ConicalViewFrustums& views, uint32_t coarseSlot,
+                                     std::vector<int>& candidates) const {
+    candidates.insert(candidates.end(), _heroes.begin(), _heroes.end());
+
+    for (const Cell& cell : _cells) {
+        AABox cellBox(cell.minimum, cell.maximum - cell.minimum);
+
+        bool isRelevant = nearBox.touches(cellBox) || (cell.slot + coarseSlot) % COARSE_TIER_INTERVAL == 0;
+        for (auto viewIter = views.begin(); !isRelevant && viewIter != views.end(); ++viewIter) {
+            isRelevant = viewIter->intersects(cellBox);
+        }
+
+        if (isRelevant) {
+            for (int i = cell.firstEntry; i < cell.firstEntry + cell.numEntries; ++i) {
+                candidates.push_back(_entries[i].offset);
+            }
+        }
+    }
+}
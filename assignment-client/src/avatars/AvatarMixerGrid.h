@@ -0,0 +1,82 @@
+//
+//  AvatarMixerGrid.h
+//  assignment-client/src/avatars
+//
+//  Created by Roxanne Skelly on 2019-06-17.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarMixerGrid_h
+#define hifi_AvatarMixerGrid_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <AABox.h>
+#include <NodeList.h>
+#include <shared/ConicalViewFrustum.h>
+
+// Loose uniform grid of the avatars in the mixer, rebuilt once per broadcast frame and then read by every slave.
+//   Each avatar lands in the cell holding its position, and each cell's bounds grow to cover the bounding and bubble
+//   boxes of the avatars in it, so a cell that doesn't touch a query can't hold an avatar that does.
+//   Avatars are referred to by their offset into the frame's node range.
+class AvatarMixerGrid {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    static const float DEFAULT_CELL_SIZE;
+
+    // cells outside a destination's view and bubble are considered once every this many frames
+    static const int COARSE_TIER_INTERVAL;
+
+    void setEnabled(bool isEnabled) { _isEnabled = isEnabled; }
+    bool isEnabled() const { return _isEnabled; }
+
+    void setCellSize(float cellSize);
+
+    // rebuild the grid for the nodes of this frame (must be called before the slaves broadcast)
+    void build(ConstIter begin, ConstIter end);
+
+    // append the offsets of the avatars that are worth considering for a destination - the avatars in cells touching
+    // nearBox or any of the views, the heroes, and a rotating slice of the remaining cells picked by coarseSlot
+    void findCandidates(const AABox& nearBox, const ConicalViewFrustums& views, uint32_t coarseSlot,
+                        std::vector<int>& candidates) const;
+
+    // counts builds, so the coarse tier moves on every frame
+    uint32_t getFrame() const { return _frame; }
+
+    int getNumAvatars() const { return (int)_entries.size() + (int)_heroes.size(); }
+    int getNumCells() const { return (int)_cells.size(); }
+
+private:
+    struct Entry {
+        uint64_t key;
+        int offset;
+        AABox bounds;
+    };
+
+    struct Cell {
+        uint64_t key;
+        uint32_t slot;          // spreads the coarse tier over frames
+        int firstEntry;
+        int numEntries;
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+    };
+
+    uint64_t keyForPosition(const glm::vec3& position) const;
+
+    bool _isEnabled { false };
+    float _cellSize { DEFAULT_CELL_SIZE };
+    uint32_t _frame { 0 };
+
+    std::vector<Entry> _entries;    // sorted by cell
+    std::vector<Cell> _cells;
+    std::vector<int> _heroes;       // always considered, so kept out of the cells
+};
+
+#endif // hifi_AvatarMixerGrid_h
@@ -258,6 +258,9 @@ int AvatarMixerSlave::sendReplicatedIdentityPacket(const Node& agentNode, const
 
 static const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 45;
 
+// avatars in cells within this distance of a destination are always considered, even when out of view
+static const float AVATAR_NEAR_RADIUS = 20.0f;
+
 void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
     quint64 start = usecTimestampNow();
 
@@ -309,6 +312,8 @@ namespace {
 
 void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node) {
     const float AVATAR_HERO_FRACTION { 0.4f };
+    const float AVATAR_TRAITS_FRACTION { 0.3f };
+    const float AVATAR_OUT_OF_VIEW_TRAITS_FRACTION { 0.1f };
     const Node* destinationNode = node.data();
 
     auto nodeList = DependencyManager::get<NodeList>();
@@ -345,6 +350,11 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
     const int maxAvatarBytesPerFrame = int(_maxKbpsPerNode * BYTES_PER_KILOBIT / AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND);
     const int maxHeroBytesPerFrame = int(maxAvatarBytesPerFrame * AVATAR_HERO_FRACTION);  // 5555, typical
 
+    // Identity and traits are sent in the avatars' priority order until these run out, the rest wait for a later
+    // frame.  Out of view avatars only get a trickle, so a join storm doesn't crowd out the avatars being looked at.
+    const int maxTraitBytesPerFrame = int(maxAvatarBytesPerFrame * AVATAR_TRAITS_FRACTION);  // 4170, typical
+    const int maxOutOfViewTraitBytesPerFrame = int(maxAvatarBytesPerFrame * AVATAR_OUT_OF_VIEW_TRAITS_FRACTION);  // 1390, typical
+
     // keep track of the number of other avatars held back in this frame
     int numAvatarsHeldBack = 0;
 
@@ -381,9 +391,23 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
             AvatarData::_avatarSortCoefficientCenter, AvatarData::_avatarSortCoefficientAge}
     };
 
-    avatarPriorityQueues[kNonhero].reserve(_end - _begin);
+    // With the grid, only the avatars near the destination, in its views, or due a coarse update are considered.
+    // With the PAL open (or just closed) the client has to hear about everyone, so we fall back to all nodes.
+    const AvatarMixerGrid& grid = _sharedData->grid;
+    bool useGrid = grid.isEnabled() && !PALIsOpen && !PALWasOpen;
+    _candidates.clear();
+    if (useGrid) {
+        AABox nearBox = destinationNodeBox;
+        nearBox.setScaleStayCentered(glm::max(nearBox.getScale(), glm::vec3(2.0f * AVATAR_NEAR_RADIUS)));
+        grid.findCandidates(nearBox, cameraViews, grid.getFrame() + destinationNode->getLocalID(), _candidates);
+    }
+    int numCandidates = useGrid ? (int)_candidates.size() : (int)(_end - _begin);
+    _stats.numOthersConsidered += numCandidates;
 
-    for (auto listedNode = _begin; listedNode != _end; ++listedNode) {
+    avatarPriorityQueues[kNonhero].reserve(numCandidates);
+
+    for (int candidate = 0; candidate < numCandidates; ++candidate) {
+        auto listedNode = _begin + (useGrid ? _candidates[candidate] : candidate);
         Node* otherNodeRaw = (*listedNode).data();
         if (otherNodeRaw->getType() != NodeType::Agent
             || !otherNodeRaw->getLinkedData()
@@ -552,40 +576,84 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
                 // the time that Avatar B flagged an IDENTITY DATA change, send IDENTITY DATA about Avatar B to Avatar A.
                 if (sourceAvatar->hasProcessedFirstIdentity()
                     && destinationNodeData->getLastBroadcastTime(sourceNode->getLocalID()) <= sourceNodeData->getIdentityChangeTimestamp()) {
-                    identityBytesSent += sendIdentityPacket(*identityPacketList, sourceNodeData, *destinationNode);
+                    if (identityBytesSent + traitBytesSent < maxTraitBytesPerFrame) {
+                        identityBytesSent += sendIdentityPacket(*identityPacketList, sourceNodeData, *destinationNode);
 
-                    // remember the last time we sent identity details about this other node to the receiver
-                    destinationNodeData->setLastBroadcastTime(sourceNode->getLocalID(), usecTimestampNow());
+                        // remember the last time we sent identity details about this other node to the receiver
+                        destinationNodeData->setLastBroadcastTime(sourceNode->getLocalID(), usecTimestampNow());
+                    } else {
+                        // the broadcast time is left alone, so it goes out on a later frame
+                        _stats.numIdentitiesDeferred++;
+                    }
                 }
             }
 
             QVector<JointData>& lastSentJointsForOther = destinationNodeData->getLastOtherAvatarSentJoints(sourceNode->getLocalID());
+            auto& encodeState = destinationNodeData->getLastOtherAvatarEncodeState(sourceNode->getLocalID());
 
-            const bool distanceAdjust = true;
-            const bool dropFaceTracking = false;
-            AvatarDataPacket::SendStatus sendStatus;
-            sendStatus.sendUUID = true;
-
-            do {
+            // most of the time this frame's encoding of the avatar, made by whichever slave got to it first, will do
+            QByteArray sharedBytes;
+            if (_sharedData->shareEncodings) {
                 auto startSerialize = chrono::high_resolution_clock::now();
-                QByteArray bytes = sourceAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
-                    sendStatus, dropFaceTracking, distanceAdjust, destinationPosition,
-                    &lastSentJointsForOther, avatarSpaceAvailable);
+                float distance = glm::distance(destinationPosition, sourceAvatar->getClientGlobalPosition());
+                sharedBytes = sourceNodeData->getEncodeCache().getEncoding(*sourceAvatar, detail, _sharedData->encodeFrame,
+                    sourceNodeData->getLastReceivedSequenceNumber(), distance, avatarPacketCapacity, encodeState,
+                    lastSentJointsForOther);
                 auto endSerialize = chrono::high_resolution_clock::now();
                 _stats.toByteArrayElapsedTime +=
                     (quint64)chrono::duration_cast<chrono::microseconds>(endSerialize - startSerialize).count();
+            }
+
+            if (!sharedBytes.isEmpty()) {
+                if (sharedBytes.size() > avatarSpaceAvailable) {
+                    // shared encodings aren't split, it goes in the next packet
+                    nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
+                    ++numPacketsSent;
+                    avatarPacket = NLPacket::create(PacketType::BulkAvatarData);
+                    avatarSpaceAvailable = avatarPacketCapacity;
+                }
 
-                avatarPacket->write(bytes);
-                avatarSpaceAvailable -= bytes.size();
-                numAvatarDataBytes += bytes.size();
-                if (!sendStatus || avatarSpaceAvailable < (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE) {
-                    // Weren't able to fit everything.
+                avatarPacket->write(sharedBytes);
+                avatarSpaceAvailable -= sharedBytes.size();
+                numAvatarDataBytes += sharedBytes.size();
+                if (avatarSpaceAvailable < (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE) {
                     nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
                     ++numPacketsSent;
                     avatarPacket = NLPacket::create(PacketType::BulkAvatarData);
                     avatarSpaceAvailable = avatarPacketCapacity;
                 }
-            } while (!sendStatus);
+                _stats.numSharedEncodingsSent++;
+            } else {
+                const bool distanceAdjust = true;
+                const bool dropFaceTracking = false;
+                AvatarDataPacket::SendStatus sendStatus;
+                sendStatus.sendUUID = true;
+
+                do {
+                    auto startSerialize = chrono::high_resolution_clock::now();
+                    QByteArray bytes = sourceAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
+                        sendStatus, dropFaceTracking, distanceAdjust, destinationPosition,
+                        &lastSentJointsForOther, avatarSpaceAvailable);
+                    auto endSerialize = chrono::high_resolution_clock::now();
+                    _stats.toByteArrayElapsedTime +=
+                        (quint64)chrono::duration_cast<chrono::microseconds>(endSerialize - startSerialize).count();
+
+                    avatarPacket->write(bytes);
+                    avatarSpaceAvailable -= bytes.size();
+                    numAvatarDataBytes += bytes.size();
+                    if (!sendStatus || avatarSpaceAvailable < (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE) {
+                        // Weren't able to fit everything.
+                        nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
+                        ++numPacketsSent;
+                        avatarPacket = NLPacket::create(PacketType::BulkAvatarData);
+                        avatarSpaceAvailable = avatarPacketCapacity;
+                    }
+                } while (!sendStatus);
+
+                sourceNodeData->getEncodeCache().ownEncodingSent(detail, _sharedData->encodeFrame,
+                    sourceNodeData->getLastReceivedSequenceNumber(), encodeState);
+                _stats.numOwnEncodingsSent++;
+            }
 
             if (detail != AvatarData::NoData) {
                 _stats.numOthersIncluded++;
@@ -607,8 +675,15 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
                 (quint64)chrono::duration_cast<chrono::microseconds>(endAvatarDataPacking - startAvatarDataPacking).count();
 
             if (!overBudget) {
-                // use helper to add any changed traits to our packet list
-                traitBytesSent += addChangedTraitsToBulkPacket(destinationNodeData, sourceNodeData, *traitsPacketList);
+                int maxTraitBytes = isLowerPriority ? maxOutOfViewTraitBytesPerFrame : maxTraitBytesPerFrame;
+                if (identityBytesSent + traitBytesSent < maxTraitBytes) {
+                    // use helper to add any changed traits to our packet list
+                    traitBytesSent += addChangedTraitsToBulkPacket(destinationNodeData, sourceNodeData, *traitsPacketList);
+                } else if (sourceNodeData->getLastReceivedTraitsChange() >
+                           destinationNodeData->getLastOtherAvatarTraitsSendPoint(sourceNode->getLocalID())) {
+                    // nothing is marked sent, so they go out on a later frame
+                    _stats.numTraitsDeferred++;
+                }
             }
             numAvatarsSent++;
             remainingAvatars--;
@@ -12,8 +12,13 @@
 #ifndef hifi_AvatarMixerSlave_h
 #define hifi_AvatarMixerSlave_h
 
+#include <vector>
+
 #include <NodeList.h>
 
+#include "AvatarEncodeCache.h"
+#include "AvatarMixerGrid.h"
+
 class AvatarMixerClientData;
 
 class AvatarMixerSlaveStats {
@@ -33,6 +38,11 @@ public:
     int numOthersIncluded { 0 };
     int overBudgetAvatars { 0 };
     int numHeroesIncluded { 0 };
+    int numOthersConsidered { 0 };
+    int numSharedEncodingsSent { 0 };
+    int numOwnEncodingsSent { 0 };
+    int numTraitsDeferred { 0 };
+    int numIdentitiesDeferred { 0 };
 
     quint64 ignoreCalculationElapsedTime { 0 };
     quint64 avatarDataPackingElapsedTime { 0 };
@@ -59,6 +69,11 @@ public:
         numOthersIncluded = 0;
         overBudgetAvatars = 0;
         numHeroesIncluded = 0;
+        numOthersConsidered = 0;
+        numSharedEncodingsSent = 0;
+        numOwnEncodingsSent = 0;
+        numTraitsDeferred = 0;
+        numIdentitiesDeferred = 0;
 
         ignoreCalculationElapsedTime = 0;
         avatarDataPackingElapsedTime = 0;
@@ -83,6 +98,11 @@ public:
         numOthersIncluded += rhs.numOthersIncluded;
         overBudgetAvatars += rhs.overBudgetAvatars;
         numHeroesIncluded += rhs.numHeroesIncluded;
+        numOthersConsidered += rhs.numOthersConsidered;
+        numSharedEncodingsSent += rhs.numSharedEncodingsSent;
+        numOwnEncodingsSent += rhs.numOwnEncodingsSent;
+        numTraitsDeferred += rhs.numTraitsDeferred;
+        numIdentitiesDeferred += rhs.numIdentitiesDeferred;
 
         ignoreCalculationElapsedTime += rhs.ignoreCalculationElapsedTime;
         avatarDataPackingElapsedTime += rhs.avatarDataPackingElapsedTime;
@@ -100,6 +120,9 @@ struct SlaveSharedData {
     QStringList skeletonURLWhitelist;
     QUrl skeletonReplacementURL;
     EntityTreePointer entityTree;
+    AvatarMixerGrid grid;
+    bool shareEncodings { true };
+    AvatarEncodeCache::Frame encodeFrame;
 };
 
 class AvatarMixerSlave {
@@ -141,6 +164,9 @@ private:
     float _maxKbpsPerNode { 0.0f };
     float _throttlingRatio { 0.0f };
 
+    // offsets into the frame's nodes, re-used between destinations
+    std::vector<int> _candidates;
+
     AvatarMixerSlaveStats _stats;
     SlaveSharedData* _sharedData;
 };
@@ -14,55 +14,6 @@
 #include <assert.h>
 #include <algorithm>
 
-void AvatarMixerSlaveThread::run() {
-    while (true) {
-        wait();
-
-        // iterate over all available nodes
-        SharedNodePointer node;
-        while (try_pop(node)) {
-            (this->*_function)(node);
-        }
-
-        bool stopping = _stop;
-        notify(stopping);
-        if (stopping) {
-            return;
-        }
-    }
-}
-
-void AvatarMixerSlaveThread::wait() {
-    {
-        Lock lock(_pool._mutex);
-        _pool._slaveCondition.wait(lock, [&] {
-            assert(_pool._numStarted <= _pool._numThreads);
-            return _pool._numStarted != _pool._numThreads;
-        });
-        ++_pool._numStarted;
-    }
-    if (_pool._configure) {
-        _pool._configure(*this);
-    }
-    _function = _pool._function;
-}
-
-void AvatarMixerSlaveThread::notify(bool stopping) {
-    {
-        Lock lock(_pool._mutex);
-        assert(_pool._numFinished < _pool._numThreads);
-        ++_pool._numFinished;
-        if (stopping) {
-            ++_pool._numStopped;
-        }
-    }
-    _pool._poolCondition.notify_one();
-}
-
-bool AvatarMixerSlaveThread::try_pop(SharedNodePointer& node) {
-    return _pool._queue.try_pop(node);
-}
-
 void AvatarMixerSlavePool::processIncomingPackets(ConstIter begin, ConstIter end) {
     _function = &AvatarMixerSlave::processIncomingPackets;
     _configure = [=](AvatarMixerSlave& slave) { 
@@ -85,31 +36,20 @@ void AvatarMixerSlavePool::run(ConstIter begin, ConstIter end) {
     _begin = begin;
     _end = end;
 
-    // fill the queue
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
-        _queue.push(node);
-    });
-
-    {
-        Lock lock(_mutex);
-
-        // run
-        _numStarted = _numFinished = 0;
-        _slaveCondition.notify_all();
-
-        // wait
-        _poolCondition.wait(lock, [&] {
-            assert(_numFinished <= _numThreads);
-            return _numFinished == _numThreads;
-        });
-
-        assert(_numStarted == _numThreads);
+    // configure every slave up front, any of them may pick up any node
+    for (auto& slave : _slaves) {
+        _configure(*slave);
     }
 
-    assert(_queue.empty());
+    int numNodes = (int)std::distance(_begin, _end);
+    _scheduler.run(numNodes, [&](int workerIndex, int first, int last) {
+        AvatarMixerSlave& slave = *_slaves[workerIndex];
+        std::for_each(_begin + first, _begin + last, [&](const SharedNodePointer& node) {
+            (slave.*_function)(node);
+        });
+    });
 }
 
-
 void AvatarMixerSlavePool::each(std::function<void(AvatarMixerSlave& slave)> functor) {
     for (auto& slave : _slaves) {
         functor(*slave.get());
@@ -141,49 +81,17 @@ void AvatarMixerSlavePool::resize(int numThreads) {
 
     qDebug("%s: set %d threads (was %d)", __FUNCTION__, numThreads, _numThreads);
 
-    Lock lock(_mutex);
+    // stop the workers before touching the slaves they use
+    _scheduler.setNumThreads(numThreads);
 
     if (numThreads > _numThreads) {
-        // start new slaves
         for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AvatarMixerSlaveThread(*this, _slaveSharedData);
-            slave->start();
-            _slaves.emplace_back(slave);
+            _slaves.emplace_back(new AvatarMixerSlave(_slaveSharedData));
         }
     } else if (numThreads < _numThreads) {
-        auto extraBegin = _slaves.begin() + numThreads;
-
-        // mark slaves to stop...
-        auto slave = extraBegin;
-        while (slave != _slaves.end()) {
-            (*slave)->_stop = true;
-            ++slave;
-        }
-
-        // ...cycle them until they do stop...
-        _numStopped = 0;
-        while (_numStopped != (_numThreads - numThreads)) {
-            _numStarted = _numFinished = _numStopped;
-            _slaveCondition.notify_all();
-            _poolCondition.wait(lock, [&] {
-                assert(_numFinished <= _numThreads);
-                return _numFinished == _numThreads;
-            });
-        }
-
-        // ...wait for threads to finish...
-        slave = extraBegin;
-        while (slave != _slaves.end()) {
-            QThread* thread = reinterpret_cast<QThread*>(slave->get());
-            static const int MAX_THREAD_WAIT_TIME = 10;
-            thread->wait(MAX_THREAD_WAIT_TIME);
-            ++slave;
-        }
-
-        // ...and erase them
-        _slaves.erase(extraBegin, _slaves.end());
+        _slaves.erase(_slaves.begin() + numThreads, _slaves.end());
     }
 
-    _numThreads = _numStarted = _numFinished = numThreads;
+    _numThreads = numThreads;
     assert(_numThreads == (int)_slaves.size());
 }
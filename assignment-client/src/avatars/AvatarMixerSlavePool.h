@@ -12,57 +12,26 @@
 #ifndef hifi_AvatarMixerSlavePool_h
 #define hifi_AvatarMixerSlavePool_h
 
-#include <condition_variable>
-#include <mutex>
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include <QThread>
 
-#include <TBBHelpers.h>
 #include <NodeList.h>
+#include <WorkStealingScheduler.h>
 
 #include "AvatarMixerSlave.h"
 
-class AvatarMixerSlavePool;
-
-class AvatarMixerSlaveThread : public QThread, public AvatarMixerSlave {
-    Q_OBJECT
-    using ConstIter = NodeList::const_iterator;
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
-
-public:
-    AvatarMixerSlaveThread(AvatarMixerSlavePool& pool, SlaveSharedData* slaveSharedData) :
-        AvatarMixerSlave(slaveSharedData), _pool(pool) {};
-
-    void run() override final;
-
-private:
-    friend class AvatarMixerSlavePool;
-
-    void wait();
-    void notify(bool stopping);
-    bool try_pop(SharedNodePointer& node);
-
-    AvatarMixerSlavePool& _pool;
-    void (AvatarMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
-    bool _stop { false };
-};
-
 // Slave pool for avatar mixers
+//   Nodes are handed out in chunks by a WorkStealingScheduler, with one AvatarMixerSlave per worker thread.
 //   AvatarMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
 class AvatarMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
-    using Mutex = std::mutex;
-    using Lock = std::unique_lock<Mutex>;
-    using ConditionVariable = std::condition_variable;
-
 public:
     using ConstIter = NodeList::const_iterator;
 
     AvatarMixerSlavePool(SlaveSharedData* slaveSharedData, int numThreads = QThread::idealThreadCount()) :
         _slaveSharedData(slaveSharedData) { setNumThreads(numThreads); }
-    ~AvatarMixerSlavePool() { resize(0); }
 
     // Jobs the slave pool can do...
     void processIncomingPackets(ConstIter begin, ConstIter end);
@@ -79,29 +48,20 @@ private:
     void run(ConstIter begin, ConstIter end);
     void resize(int numThreads);
 
-    std::vector<std::unique_ptr<AvatarMixerSlaveThread>> _slaves;
-
-    friend void AvatarMixerSlaveThread::wait();
-    friend void AvatarMixerSlaveThread::notify(bool stopping);
-    friend bool AvatarMixerSlaveThread::try_pop(SharedNodePointer& node);
+    std::vector<std::unique_ptr<AvatarMixerSlave>> _slaves;
 
-    // synchronization state
-    Mutex _mutex;
-    ConditionVariable _slaveCondition;
-    ConditionVariable _poolCondition;
     void (AvatarMixerSlave::*_function)(const SharedNodePointer& node);
     std::function<void(AvatarMixerSlave&)> _configure;
     int _numThreads { 0 };
-    int _numStarted { 0 }; // guarded by _mutex
-    int _numFinished { 0 }; // guarded by _mutex
-    int _numStopped { 0 }; // guarded by _mutex
 
     // frame state
-    Queue _queue;
     ConstIter _begin;
     ConstIter _end;
 
     SlaveSharedData* _slaveSharedData;
+
+    // declared last so the workers are stopped before the slaves they use are destroyed
+    WorkStealingScheduler _scheduler { "AvatarMixerSlave" };
 };
 
 #endif // hifi_AvatarMixerSlavePool_h
@@ -455,6 +455,27 @@ QString EntityServer::serverSubclassStats() {
     }
     statsString += "\r\n\r\n";
 
+    auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
+    if (entityEditFilters) {
+        statsString += "<b>Entity Edit Filter Statistics</b>\r\n";
+        statsString += "----- Zone ID (null is the global filter) ----    -- Kind --    "
+                       "------ Evaluations ------    ------ Rejections -------    -- Average Time --\r\n";
+
+        auto allFilterStats = entityEditFilters->getFilterStats();
+        for (const auto& filterStats : allFilterStats) {
+            statsString += filterStats.entityID.toString();
+            statsString += filterStats.isNative ? "    native  " : "    script  ";
+            statsString += QString("%1").arg(locale.toString((uint)filterStats.evaluations).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("%1").arg(locale.toString((uint)filterStats.rejections).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("%1 usecs").arg(locale.toString((uint)filterStats.averageTime).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += "\r\n";
+        }
+        if (allFilterStats.isEmpty()) {
+            statsString += "    no filters... \r\n";
+        }
+        statsString += "\r\n\r\n";
+    }
+
     return statsString;
 }
 
@@ -33,6 +33,17 @@ void EntityTreeHeadlessViewer::init() {
     }
 }
 
+void EntityTreeHeadlessViewer::setSimulation(EntitySimulationPointer simulation) {
+    if (_tree) {
+        // the tree clears the old simulation's entities as it lets go of it
+        std::static_pointer_cast<EntityTree>(_tree)->setSimulation(simulation);
+    }
+    if (_simulation) {
+        _simulation->setEntityTree(nullptr);  // Break shared_ptr cycle.
+    }
+    _simulation = simulation;
+}
+
 void EntityTreeHeadlessViewer::update() {
     if (_tree) {
         EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
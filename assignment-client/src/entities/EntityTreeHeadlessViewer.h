@@ -49,6 +49,9 @@ public:
 
     virtual void init() override;
 
+    // replaces the SimpleEntitySimulation init() installs, call after init()
+    void setSimulation(EntitySimulationPointer simulation);
+
 protected:
     virtual OctreePointer createTree() override {
         EntityTreePointer newTree = EntityTreePointer(new EntityTree(true));
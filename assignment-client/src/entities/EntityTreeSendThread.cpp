@@ -31,8 +31,10 @@ EntityTreeSendThread::EntityTreeSendThread(OctreeServer* myServer, const SharedN
 void EntityTreeSendThread::resetState() {
     qCDebug(entities) << "Clearing known EntityTreeSendThread state for" << _nodeUuid;
 
-    _knownState.clear();
-    _traversal.reset();
+    runOnNextPass([this] {
+        _knownState.clear();
+        _traversal.reset();
+    });
 }
 
 void EntityTreeSendThread::preDistributionProcessing() {
@@ -415,20 +417,24 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
 
 void EntityTreeSendThread::editingEntityPointer(const EntityItemPointer& entity) {
     if (entity) {
-        if (!_sendQueue.contains(entity.get()) && _knownState.find(entity.get()) != _knownState.end()) {
-            const auto& view = _traversal.getCurrentView();
-            float priority = view.computePriority(entity);
-
-            // We can force a removal from _knownState if the current view is used and entity is out of view
-            if (priority == PrioritizedEntity::DO_NOT_SEND) {
-                _sendQueue.emplace(entity, PrioritizedEntity::FORCE_REMOVE, true);
-            } else if (priority == PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY) {
-                _sendQueue.emplace(entity, PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY, true);
+        runOnNextPass([this, entity] {
+            if (!_sendQueue.contains(entity.get()) && _knownState.find(entity.get()) != _knownState.end()) {
+                const auto& view = _traversal.getCurrentView();
+                float priority = view.computePriority(entity);
+
+                // We can force a removal from _knownState if the current view is used and entity is out of view
+                if (priority == PrioritizedEntity::DO_NOT_SEND) {
+                    _sendQueue.emplace(entity, PrioritizedEntity::FORCE_REMOVE, true);
+                } else if (priority == PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY) {
+                    _sendQueue.emplace(entity, PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY, true);
+                }
             }
-        }
+        });
     }
 }
 
 void EntityTreeSendThread::deletingEntityPointer(EntityItem* entity) {
-    _knownState.erase(entity);
+    runOnNextPass([this, entity] {
+        _knownState.erase(entity);
+    });
 }
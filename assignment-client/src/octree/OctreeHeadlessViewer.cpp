@@ -21,6 +21,8 @@ void OctreeHeadlessViewer::queryOctree() {
     if (_hasViewFrustum) {
         ConicalViewFrustums views { _viewFrustum };
         _octreeQuery.setConicalViews(views);
+    } else if (!_conicalViews.empty()) {
+        _octreeQuery.setConicalViews(_conicalViews);
     } else {
         _octreeQuery.clearConicalViews();
     }
@@ -22,6 +22,9 @@ class OctreeHeadlessViewer : public OctreeProcessor {
 public:
     OctreeQuery& getOctreeQuery() { return _octreeQuery; }
 
+    // the views queried with when no camera has been set, none asks for everything
+    void setConicalViews(const ConicalViewFrustums& views) { _conicalViews = views; }
+
     static int parseOctreeStats(QSharedPointer<ReceivedMessage> message, SharedNodePointer sourceNode);
     static void trackIncomingOctreePacket(const QByteArray& packet, const SharedNodePointer& sendingNode, bool wasStatsPacket);
 
@@ -128,6 +131,7 @@ private:
 
     bool _hasViewFrustum { false };
     ViewFrustum _viewFrustum;
+    ConicalViewFrustums _conicalViews;
 };
 
 #endif // hifi_OctreeHeadlessViewer_h
@@ -0,0 +1,274 @@
+//
+//  OctreeSendScheduler.cpp
+//  assignment-client/src/octree
+//
+//  Created by Roxanne Skelly on 2019-06-22.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeSendScheduler.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+#include <QtCore/QThread>
+
+#include <NumericalConstants.h>
+
+#include "OctreeSendThread.h"
+#include "OctreeServerConsts.h"
+
+// a pass never gets less than this, however many clients share the workers
+static const int MIN_PASS_BUDGET_USECS = 1000;
+
+static const auto SEND_INTERVAL = std::chrono::microseconds(OCTREE_SEND_INTERVAL_USECS);
+static const auto SEND_RATE_WINDOW = std::chrono::seconds(1);
+
+template <typename Duration>
+static quint64 toUsecs(Duration duration) {
+    return (quint64)std::max<qint64>(0, std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+class OctreeSendScheduler::Worker : public QThread {
+public:
+    Worker(OctreeSendScheduler& scheduler, int index) : _scheduler(scheduler) {
+        setObjectName(QString("%1 Send Worker %2").arg(scheduler._name).arg(index));
+    }
+
+    void run() override final { _scheduler.work(); }
+
+private:
+    OctreeSendScheduler& _scheduler;
+};
+
+OctreeSendScheduler::OctreeSendScheduler(const QString& name, int numThreads) : _name(name) {
+    setNumThreads(numThreads);
+}
+
+OctreeSendScheduler::~OctreeSendScheduler() {
+    stopWorkers();
+}
+
+void OctreeSendScheduler::setNumThreads(int numThreads) {
+    int maxThreads = QThread::idealThreadCount();
+    if (maxThreads == -1) {
+        // idealThreadCount returns -1 if cores cannot be detected
+        static const int MAX_THREADS_IF_UNKNOWN = 4;
+        maxThreads = MAX_THREADS_IF_UNKNOWN;
+    }
+
+    if (numThreads <= 0) {
+        numThreads = maxThreads;
+    } else if (numThreads > maxThreads) {
+        qWarning("%s: clamped to %d (was %d)", __FUNCTION__, maxThreads, numThreads);
+        numThreads = maxThreads;
+    }
+
+    if (numThreads == getNumThreads()) {
+        return;
+    }
+
+    qDebug("%s: set %d threads (was %d)", __FUNCTION__, numThreads, getNumThreads());
+
+    stopWorkers();
+
+    _isStopping = false;
+    for (int i = 0; i < numThreads; ++i) {
+        _workers.emplace_back(new Worker(*this, i));
+        _workers.back()->start();
+    }
+}
+
+void OctreeSendScheduler::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _queueCondition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker->wait();
+    }
+    _workers.clear();
+}
+
+void OctreeSendScheduler::add(OctreeSendThread* client) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto& task = _tasks[client];
+        if (task) {
+            return;
+        }
+
+        task.reset(new Task());
+        task->client = client;
+        task->nodeUUID = client->getNodeUuid();
+        task->windowStart = Clock::now();
+        schedule(*task, task->windowStart);
+    }
+    _queueCondition.notify_one();
+}
+
+void OctreeSendScheduler::remove(OctreeSendThread* client) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    auto it = _tasks.find(client);
+    if (it == _tasks.end()) {
+        return;
+    }
+
+    Task& task = *it->second;
+    task.isRemoved = true;
+    if (task.isQueued) {
+        _queue.erase(task.queuePosition);
+        task.isQueued = false;
+    }
+
+    _passCondition.wait(lock, [&] { return !task.isRunning; });
+    _tasks.erase(it);
+}
+
+void OctreeSendScheduler::schedule(Task& task, Clock::time_point deadline) {
+    task.queuePosition = _queue.emplace(deadline, &task);
+    task.isQueued = true;
+}
+
+int OctreeSendScheduler::getPassBudget() const {
+    // every client gets an even share of the workers over a send interval
+    int numClients = std::max(1, (int)_tasks.size());
+    int budget = (int)((qint64)OCTREE_SEND_INTERVAL_USECS * getNumThreads() / numClients);
+    return std::max(MIN_PASS_BUDGET_USECS, std::min(OCTREE_SEND_INTERVAL_USECS, budget));
+}
+
+void OctreeSendScheduler::work() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_isStopping) {
+        if (_queue.empty()) {
+            _queueCondition.wait(lock);
+            continue;
+        }
+
+        auto next = _queue.begin();
+        Clock::time_point deadline = next->first;
+        if (deadline > Clock::now()) {
+            _queueCondition.wait_until(lock, deadline);
+            continue;
+        }
+
+        Task& task = *next->second;
+        _queue.erase(next);
+        task.isQueued = false;
+        task.isRunning = true;
+        int budget = getPassBudget();
+
+        lock.unlock();
+
+        Clock::time_point start = Clock::now();
+        bool keepSending = task.client->process(budget);
+        Clock::time_point end = Clock::now();
+
+        lock.lock();
+
+        task.isRunning = false;
+        passDone(task, start, end, toUsecs(start - deadline), budget);
+
+        if (task.isRemoved) {
+            _passCondition.notify_all();
+        } else if (keepSending) {
+            // the next pass is due an interval after this one started, or right away if this one ran long
+            schedule(task, start + SEND_INTERVAL);
+        }
+        // otherwise the client is gone, and stays unscheduled until it is removed
+    }
+}
+
+void OctreeSendScheduler::passDone(Task& task, Clock::time_point start, Clock::time_point end, quint64 queueLatency,
+                                   int budget) {
+    quint64 passTime = toUsecs(end - start);
+
+    ++_numPasses;
+    if (passTime > (quint64)budget) {
+        ++_numOverBudget;
+    }
+    _averageQueueLatency.updateAverage((float)queueLatency);
+    _maxQueueLatency = std::max(_maxQueueLatency, queueLatency);
+
+    ++task.numPasses;
+    task.averageQueueLatency.updateAverage((float)queueLatency);
+    task.maxQueueLatency = std::max(task.maxQueueLatency, queueLatency);
+    task.averagePassTime.updateAverage((float)passTime);
+
+    task.windowPackets += task.client->getPacketsSentLastPass();
+    task.windowBytes += task.client->getBytesSentLastPass();
+
+    auto windowLength = end - task.windowStart;
+    if (windowLength >= SEND_RATE_WINDOW) {
+        float seconds = (float)toUsecs(windowLength) / USECS_PER_SECOND;
+        task.packetsPerSecond = task.windowPackets / seconds;
+        task.bytesPerSecond = task.windowBytes / seconds;
+        task.windowStart = end;
+        task.windowPackets = 0;
+        task.windowBytes = 0;
+    }
+}
+
+OctreeSendScheduler::Stats OctreeSendScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Stats stats;
+    stats.numThreads = getNumThreads();
+    stats.numClients = (int)_tasks.size();
+    stats.passBudget = getPassBudget();
+    stats.numPasses = _numPasses;
+    stats.numOverBudget = _numOverBudget;
+    stats.averageQueueLatency = _averageQueueLatency.getAverage();
+    stats.maxQueueLatency = _maxQueueLatency;
+    return stats;
+}
+
+std::vector<OctreeSendScheduler::ClientStats> OctreeSendScheduler::getClientStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::vector<ClientStats> clientStats;
+    clientStats.reserve(_tasks.size());
+    for (auto& it : _tasks) {
+        const Task& task = *it.second;
+
+        ClientStats stats;
+        stats.nodeUUID = task.nodeUUID;
+        stats.numPasses = task.numPasses;
+        stats.averageQueueLatency = task.averageQueueLatency.getAverage();
+        stats.maxQueueLatency = task.maxQueueLatency;
+        stats.averagePassTime = task.averagePassTime.getAverage();
+        stats.packetsPerSecond = task.packetsPerSecond;
+        stats.bytesPerSecond = task.bytesPerSecond;
+        clientStats.push_back(stats);
+    }
+
+    std::sort(clientStats.begin(), clientStats.end(), [](const ClientStats& a, const ClientStats& b) {
+        return a.nodeUUID < b.nodeUUID;
+    });
+    return clientStats;
+}
+
+void OctreeSendScheduler::resetStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _numPasses = 0;
+    _numOverBudget = 0;
+    _averageQueueLatency.reset();
+    _maxQueueLatency = 0;
+
+    for (auto& it : _tasks) {
+        Task& task = *it.second;
+        task.numPasses = 0;
+        task.averageQueueLatency.reset();
+        task.maxQueueLatency = 0;
+        task.averagePassTime.reset();
+    }
+}
@@ -0,0 +1,132 @@
+//
+//  OctreeSendScheduler.h
+//  assignment-client/src/octree
+//
+//  Created by Roxanne Skelly on 2019-06-22.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendScheduler_h
+#define hifi_OctreeSendScheduler_h
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+#include <SimpleMovingAverage.h>
+
+class OctreeSendThread;
+
+// Runs the send passes of every client of an octree server on a fixed set of worker threads, instead of a thread
+// per client.
+//
+//   Each client is a task with a deadline, the time its next pass is due. Workers take the task with the earliest
+//   deadline once it is due, so a client whose pass ran late goes after the clients that were due before it rather
+//   than ahead of everyone. Each pass is given a budget, an even share of the workers' time over a send interval,
+//   and stops sending when it runs out. The client's traversal picks up where it left off on its next pass.
+//
+//   A client is run by one worker at a time, and remove() waits for its pass to finish if one is running.
+class OctreeSendScheduler {
+public:
+    struct ClientStats {
+        QUuid nodeUUID;
+        quint64 numPasses { 0 };
+        float averageQueueLatency { 0.0f };     // usecs between a pass being due and a worker starting it
+        quint64 maxQueueLatency { 0 };
+        float averagePassTime { 0.0f };         // usecs
+        float packetsPerSecond { 0.0f };
+        float bytesPerSecond { 0.0f };
+    };
+
+    struct Stats {
+        int numThreads { 0 };
+        int numClients { 0 };
+        int passBudget { 0 };                   // usecs
+        quint64 numPasses { 0 };
+        quint64 numOverBudget { 0 };
+        float averageQueueLatency { 0.0f };     // usecs
+        quint64 maxQueueLatency { 0 };
+    };
+
+    OctreeSendScheduler(const QString& name, int numThreads = 0);
+    ~OctreeSendScheduler();
+
+    // stops and restarts the workers, must not be called while clients are scheduled
+    //   numThreads <= 0 picks one per core
+    void setNumThreads(int numThreads);
+    int getNumThreads() const { return (int)_workers.size(); }
+
+    // schedules the client's first pass for now
+    void add(OctreeSendThread* client);
+
+    // stops scheduling the client, must not be called from one of its passes
+    void remove(OctreeSendThread* client);
+
+    Stats getStats() const;
+    std::vector<ClientStats> getClientStats() const;
+    void resetStats();
+
+private:
+    class Worker;
+    friend class Worker;
+
+    struct Task;
+    using Clock = std::chrono::steady_clock;
+    using Queue = std::multimap<Clock::time_point, Task*>;
+
+    struct Task {
+        OctreeSendThread* client { nullptr };
+        QUuid nodeUUID;
+
+        Queue::iterator queuePosition;
+        bool isQueued { false };
+        bool isRunning { false };
+        bool isRemoved { false };
+
+        quint64 numPasses { 0 };
+        SimpleMovingAverage averageQueueLatency;
+        quint64 maxQueueLatency { 0 };
+        SimpleMovingAverage averagePassTime;
+
+        // the send rate is measured over windows of about a second
+        Clock::time_point windowStart;
+        quint64 windowPackets { 0 };
+        quint64 windowBytes { 0 };
+        float packetsPerSecond { 0.0f };
+        float bytesPerSecond { 0.0f };
+    };
+
+    void work();
+    void schedule(Task& task, Clock::time_point deadline);
+    void passDone(Task& task, Clock::time_point start, Clock::time_point end, quint64 queueLatency, int budget);
+    int getPassBudget() const;
+    void stopWorkers();
+
+    QString _name;
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _queueCondition;
+    std::condition_variable _passCondition;
+    bool _isStopping { false };
+
+    Queue _queue;
+    std::unordered_map<OctreeSendThread*, std::unique_ptr<Task>> _tasks;
+
+    quint64 _numPasses { 0 };
+    quint64 _numOverBudget { 0 };
+    SimpleMovingAverage _averageQueueLatency;
+    quint64 _maxQueueLatency { 0 };
+};
+
+#endif // hifi_OctreeSendScheduler_h
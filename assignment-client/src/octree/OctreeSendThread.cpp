@@ -11,13 +11,9 @@
 
 #include "OctreeSendThread.h"
 
-#include <chrono>
-#include <thread>
-
 #include <NodeList.h>
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
-#include <PerfStat.h>
 
 #include "OctreeServer.h"
 #include "OctreeServerConsts.h"
@@ -33,7 +29,7 @@ OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePoint
 {
     QString safeServerName("Octree");
 
-    // set our QThread object name so we can identify this thread while debugging
+    // set our object name so we can identify this client while debugging
     setObjectName(QString("Octree Send Thread (%1)").arg(uuidStringWithoutCurlyBraces(_nodeUuid)));
 
     if (_myServer) {
@@ -66,14 +62,29 @@ void OctreeSendThread::setIsShuttingDown() {
 }
 
 
-bool OctreeSendThread::process() {
+bool OctreeSendThread::process(int budgetUsecs) {
     if (_isShuttingDown) {
+        emit finished();
         return false; // exit early if we're shutting down
     }
 
     OctreeServer::didProcess(this);
 
-    quint64  start = usecTimestampNow();
+    quint64 start = usecTimestampNow();
+    _passEnd = start + budgetUsecs;
+
+    _truePacketsSent = 0;
+    _trueBytesSent = 0;
+
+    // catch up on whatever came in since the last pass
+    std::vector<std::function<void()>> nextPass;
+    {
+        std::lock_guard<std::mutex> lock(_nextPassMutex);
+        nextPass.swap(_nextPass);
+    }
+    for (auto& function : nextPass) {
+        function();
+    }
 
     // we'd better have a server at this point, or we're in trouble
     assert(_myServer);
@@ -93,37 +104,24 @@ bool OctreeSendThread::process() {
                 packetDistributor(node, nodeData, viewFrustumChanged);
             }
         } else {
+            emit finished();
             return false; // exit early if we're shutting down
         }
     }
 
     if (_isShuttingDown) {
+        emit finished();
         return false; // exit early if we're shutting down
     }
 
-    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
-    if (isStillRunning()) {
-        // dynamically sleep until we need to fire off the next set of octree elements
-        int elapsed = (usecTimestampNow() - start);
-        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
-
-        if (usecToSleep <= 0) {
-            const int MIN_USEC_TO_SLEEP = 1;
-            usecToSleep = MIN_USEC_TO_SLEEP;
-        }
-
-        {
-            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
-            std::this_thread::sleep_for(std::chrono::microseconds(usecToSleep));
-        }
-
-    }
+    return true;  // keep running till they terminate us
+}
 
-    return isStillRunning();  // keep running till they terminate us
+void OctreeSendThread::runOnNextPass(std::function<void()> function) {
+    std::lock_guard<std::mutex> lock(_nextPassMutex);
+    _nextPass.push_back(std::move(function));
 }
 
-AtomicUIntStat OctreeSendThread::_usleepTime { 0 };
-AtomicUIntStat OctreeSendThread::_usleepCalls { 0 };
 AtomicUIntStat OctreeSendThread::_totalBytes { 0 };
 AtomicUIntStat OctreeSendThread::_totalWastedBytes { 0 };
 AtomicUIntStat OctreeSendThread::_totalPackets { 0 };
@@ -440,7 +438,8 @@ bool OctreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, Octre
 
     bool somethingToSend = true; // assume we have something
     bool hadSomething = hasSomethingToSend(nodeData);
-    while (somethingToSend && _packetsSentThisInterval < maxPacketsPerInterval && !nodeData->isShuttingDown()) {
+    while (somethingToSend && _packetsSentThisInterval < maxPacketsPerInterval && !nodeData->isShuttingDown() &&
+           !isOverBudget()) {
         float compressAndWriteElapsedUsec = OctreeServer::SKIP_TIME;
         float packetSendingElapsedUsec = OctreeServer::SKIP_TIME;
 
@@ -503,7 +502,7 @@ bool OctreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, Octre
     }
 
     if (somethingToSend && _myServer->wantsVerboseDebug()) {
-        qCDebug(octree) << "Hit PPS Limit, packetsSentThisInterval =" << _packetsSentThisInterval
+        qCDebug(octree) << "Hit PPS Limit or pass budget, packetsSentThisInterval =" << _packetsSentThisInterval
                         << "  maxPacketsPerInterval = " << maxPacketsPerInterval
                         << "  clientMaxPacketsPerInterval = " << clientMaxPacketsPerInterval;
     }
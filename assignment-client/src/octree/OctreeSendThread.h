@@ -5,7 +5,7 @@
 //  Created by Brad Hefta-Gaub on 8/21/13.
 //  Copyright 2013 High Fidelity, Inc.
 //
-//  Threaded or non-threaded object for sending octree data packets to a client
+//  Object for sending octree data packets to a client, one pass at a time
 //
 //  Distributed under the Apache License, Version 2.0.
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
@@ -15,10 +15,15 @@
 #define hifi_OctreeSendThread_h
 
 #include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QObject>
 
-#include <GenericThread.h>
 #include <Node.h>
 #include <OctreePacketData.h>
+#include <SharedUtil.h>
 #include "OctreeQueryNode.h"
 
 class OctreeQueryNode;
@@ -26,8 +31,9 @@ class OctreeServer;
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
-/// Threaded processor for sending octree packets to a single client
-class OctreeSendThread : public GenericThread {
+/// Sends octree packets to a single client. Its passes are run by the server's OctreeSendScheduler, one at a time
+/// on any of the scheduler's workers, so the object itself lives on the server's thread.
+class OctreeSendThread : public QObject {
     Q_OBJECT
 public:
     OctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node);
@@ -38,6 +44,13 @@ public:
 
     QUuid getNodeUuid() const { return _nodeUuid; }
 
+    /// Runs one send pass, which stops sending once budgetUsecs have gone by. Returns false once the client is gone
+    /// and no more passes should be run.
+    bool process(int budgetUsecs);
+
+    int getPacketsSentLastPass() const { return _truePacketsSent; }
+    int getBytesSentLastPass() const { return _trueBytesSent; }
+
     static AtomicUIntStat _totalBytes;
     static AtomicUIntStat _totalWastedBytes;
     static AtomicUIntStat _totalPackets;
@@ -45,12 +58,17 @@ public:
     static AtomicUIntStat _totalSpecialBytes;
     static AtomicUIntStat _totalSpecialPackets;
 
-    static AtomicUIntStat _usleepTime;
-    static AtomicUIntStat _usleepCalls;
+signals:
+    /// Emitted from the last pass, once the client is gone
+    void finished();
 
 protected:
-    /// Implements generic processing behavior for this thread.
-    virtual bool process() override;
+    /// Queues work to run at the start of the next pass. Slots that touch the traversal state go through here, since
+    /// a pass may be running on a worker when they are called.
+    void runOnNextPass(std::function<void()> function);
+
+    /// True once the current pass has used up its budget
+    bool isOverBudget() const { return usecTimestampNow() >= _passEnd; }
 
     virtual bool traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData,
             bool viewFrustumChanged, bool isFullScene);
@@ -73,7 +91,11 @@ private:
     int _truePacketsSent { 0 }; // available for debug stats
     int _trueBytesSent { 0 }; // available for debug stats
     int _packetsSentThisInterval { 0 }; // used for bandwidth throttle condition
-    bool _isShuttingDown { false };
+    std::atomic<bool> _isShuttingDown { false };
+    quint64 _passEnd { 0 };
+
+    std::mutex _nextPassMutex;
+    std::vector<std::function<void()>> _nextPass;
 };
 
 #endif // hifi_OctreeSendThread_h
@@ -137,6 +137,8 @@ void OctreeServer::resetSendingStats() {
     _longProcessWait = 0;
     _shortProcessWait = 0;
     _noProcessWait = 0;
+
+    _sendScheduler.resetStats();
 }
 
 void OctreeServer::trackEncodeTime(float time) {
@@ -612,6 +614,41 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString().sprintf("                         sending ratio:      %5.2f%%\r\n",
                                          (double)sendingToInsidePercent);
 
+        // send scheduler
+        {
+            auto schedulerStats = _sendScheduler.getStats();
+            float overBudgetPercent = schedulerStats.numPasses == 0 ? 0.0f
+                        : ((float)schedulerStats.numOverBudget / (float)schedulerStats.numPasses) * AS_PERCENT;
+
+            statsString += QString("\r\n");
+            statsString += QString("                     Send Threads: %1 threads\r\n")
+                .arg(locale.toString(schedulerStats.numThreads).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("                Clients Scheduled: %1 clients\r\n")
+                .arg(locale.toString(schedulerStats.numClients).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("                 Pass Time Budget: %1 usecs\r\n")
+                .arg(locale.toString(schedulerStats.passBudget).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString().sprintf("       Average send queue latency:    %9.2f usecs     max: %12llu usecs\r\n",
+                                             (double)schedulerStats.averageQueueLatency,
+                                             (unsigned long long)schedulerStats.maxQueueLatency);
+            statsString += QString().sprintf("           Passes over budget:                          (%6.2f%%) samples: %12llu \r\n",
+                                             (double)overBudgetPercent, (unsigned long long)schedulerStats.numPasses);
+
+            auto clientStats = _sendScheduler.getClientStats();
+            if (!clientStats.empty()) {
+                statsString += QString("\r\n  %1   queue latency (avg/max)   pass time        send rate\r\n")
+                    .arg("client", -36);
+                for (auto& stats : clientStats) {
+                    statsString += QString().sprintf("  %s %9.2f / %9llu usecs %9.2f usecs %8.1f pps %9.1f kbps\r\n",
+                                                     qPrintable(uuidStringWithoutCurlyBraces(stats.nodeUUID)),
+                                                     (double)stats.averageQueueLatency,
+                                                     (unsigned long long)stats.maxQueueLatency,
+                                                     (double)stats.averagePassTime,
+                                                     (double)stats.packetsPerSecond,
+                                                     (double)(stats.bytesPerSecond * BITS_IN_BYTE / BYTES_PER_KILOBYTE));
+                }
+            }
+        }
+
 
 
         statsString += QString("\r\n");
@@ -876,9 +913,9 @@ void OctreeServer::parsePayload() {
 OctreeServer::UniqueSendThread OctreeServer::createSendThread(const SharedNodePointer& node) {
     auto sendThread = newSendThread(node);
 
-    // we want to be notified when the thread finishes
-    connect(sendThread.get(), &GenericThread::finished, this, &OctreeServer::removeSendThread);
-    sendThread->initialize(true);
+    // we want to be notified when the client is done sending
+    connect(sendThread.get(), &OctreeSendThread::finished, this, &OctreeServer::removeSendThread);
+    _sendScheduler.add(sendThread.get());
 
     return sendThread;
 }
@@ -886,6 +923,8 @@ OctreeServer::UniqueSendThread OctreeServer::createSendThread(const SharedNodePo
 void OctreeServer::removeSendThread() {
     // If the object has been deleted since the event was queued, sender() will return nullptr
     if (auto sendThread = qobject_cast<OctreeSendThread*>(sender())) {
+        _sendScheduler.remove(sendThread);
+
         // This deletes the unique_ptr, so sendThread is destructed after that line
         _sendThreads.erase(sendThread->getNodeUuid());
     }
@@ -902,7 +941,8 @@ void OctreeServer::handleOctreeQueryPacket(QSharedPointer<ReceivedMessage> messa
         if (it == _sendThreads.end()) {
             _sendThreads.emplace(senderNode->getUUID(), createSendThread(senderNode));
         } else if (it->second->isShuttingDown()) {
-            _sendThreads.erase(it); // Remove right away and wait on thread to be
+            _sendScheduler.remove(it->second.get()); // Remove right away, waiting on its pass to be done
+            _sendThreads.erase(it);
 
             _sendThreads.emplace(senderNode->getUUID(), createSendThread(senderNode));
         }
@@ -1061,6 +1101,9 @@ void OctreeServer::readConfiguration() {
         readOptionBool(QString("persistFileDownload"), settingsSectionObject, _persistFileDownload);
         qDebug() << "persistFileDownload=" << _persistFileDownload;
 
+        readOptionBool(QString("persistJournal"), settingsSectionObject, _persistJournal);
+        qDebug() << "persistJournal=" << _persistJournal;
+
     } else {
         qDebug("persistFilename= DISABLED");
     }
@@ -1096,6 +1139,12 @@ void OctreeServer::readConfiguration() {
     qDebug("packetsPerSecondTotalMax=%d _packetsTotalPerInterval=%d",
                     packetsPerSecondTotalMax, _packetsTotalPerInterval);
 
+    // Check to see if the user wants a particular number of send threads, shared by all clients
+    int sendThreads = 0;
+    readOptionInt(QString("sendThreads"), settingsSectionObject, sendThreads);
+    _sendScheduler.setNumThreads(sendThreads);
+    qDebug("sendThreads=%d", _sendScheduler.getNumThreads());
+
 
     readAdditionalConfiguration(settingsSectionObject);
 }
@@ -1186,13 +1235,17 @@ void OctreeServer::domainSettingsRequestComplete() {
 
         // now set up PersistThread
         _persistManager = new OctreePersistThread(_tree, _persistAbsoluteFilePath, _persistInterval, _debugTimestampNow,
-                                                 _persistAsFileType);
+                                                 _persistAsFileType, _persistJournal);
         _persistManager->moveToThread(&_persistThread);
         connect(&_persistThread, &QThread::finished, _persistManager, &QObject::deleteLater);
         connect(&_persistThread, &QThread::started, _persistManager, &OctreePersistThread::start);
         connect(_persistManager, &OctreePersistThread::loadCompleted, this, [this]() {
             beginRunning();
         });
+        connect(_persistManager, &OctreePersistThread::loadFailed, this, [this]() {
+            qCritical() << "Couldn't load the persisted octree data. Stopping assignment.";
+            setFinished(true);
+        });
         _persistThread.start();
     } else {
         beginRunning();
@@ -1204,7 +1257,7 @@ void OctreeServer::beginRunning() {
 
     // we need to ask the DS about agents so we can ping/reply with them
     nodeList->addSetOfNodeTypesToNodeInterestSet({ NodeType::Agent, NodeType::EntityScriptServer,
-        NodeType::AvatarMixer });
+        NodeType::AvatarMixer, NodeType::PhysicsServer });
 
     beforeRun(); // after payload has been processed
 
@@ -1294,8 +1347,11 @@ void OctreeServer::aboutToFinish() {
         sendThread.setIsShuttingDown();
     }
 
-    // Clear will destruct all the unique_ptr to OctreeSendThreads which will call the GenericThread's dtor
-    // which waits on the thread to be done before returning
+    // Stop scheduling them, which waits on any pass that is running to be done
+    for (auto& it : _sendThreads) {
+        _sendScheduler.remove(it.second.get());
+    }
+
     _sendThreads.clear(); // Cleans up all the send threads.
 
     if (_persistManager) {
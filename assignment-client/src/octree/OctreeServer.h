@@ -23,6 +23,7 @@
 #include <ThreadedAssignment.h>
 
 #include "OctreePersistThread.h"
+#include "OctreeSendScheduler.h"
 #include "OctreeSendThread.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
@@ -195,6 +196,7 @@ protected:
 
     std::chrono::milliseconds _persistInterval;
     bool _persistFileDownload;
+    bool _persistJournal { false };
     int _maxBackupVersions;
 
     time_t _started;
@@ -202,6 +204,7 @@ protected:
     QString _safeServerName;
     
     SendThreads _sendThreads;
+    OctreeSendScheduler _sendScheduler { "Octree" };
 
     static int _clientCount;
     static SimpleMovingAverage _averageLoopTime;
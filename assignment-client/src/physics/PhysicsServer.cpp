@@ -0,0 +1,446 @@
+//
+//  PhysicsServer.cpp
+//  assignment-client/src/physics
+//
+//  Created by Roxanne Skelly on 2019-06-26.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PhysicsServer.h"
+
+#include <QtCore/QJsonObject>
+
+#include <EntityMotionState.h>
+#include <GLMHelpers.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <OctreeConstants.h>
+#include <PhysicsHelpers.h>
+#include <SimulationOwner.h>
+#include <shared/ConicalViewFrustum.h>
+
+#include "../entities/AssignmentParentFinder.h"
+#include "PhysicsServerDynamicFactory.h"
+
+static const QString PHYSICS_SERVER_LOGGING_NAME = "physics-server";
+
+static const int DEFAULT_SIMULATION_RATE = 90;
+static const int MIN_SIMULATION_RATE = 10;
+static const int MAX_SIMULATION_RATE = 240;
+static const float DEFAULT_REGION_MARGIN = 10.0f;
+
+// the query asks for everything in the regions, whatever its size
+static const int MIN_BOUNDARY_LEVEL_ADJUST = -20;
+
+PhysicsServer::PhysicsServer(ReceivedMessage& message) :
+    ThreadedAssignment(message),
+    _regionMargin(DEFAULT_REGION_MARGIN),
+    _simulationRate(DEFAULT_SIMULATION_RATE)
+{
+    DependencyManager::registerInheritance<EntityDynamicFactoryInterface, PhysicsServerDynamicFactory>();
+    DependencyManager::set<PhysicsServerDynamicFactory>();
+
+    DependencyManager::registerInheritance<SpatialParentFinder, AssignmentParentFinder>();
+
+    auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
+    packetReceiver.registerListenerForTypes({ PacketType::OctreeStats, PacketType::EntityData, PacketType::EntityErase },
+                                            this, "handleOctreePacket");
+}
+
+void PhysicsServer::run() {
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    ThreadedAssignment::commonInit(PHYSICS_SERVER_LOGGING_NAME, NodeType::PhysicsServer);
+
+    DomainHandler& domainHandler = nodeList->getDomainHandler();
+    connect(&domainHandler, &DomainHandler::settingsReceived, this, &PhysicsServer::handleSettings);
+
+    connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &PhysicsServer::nodeKilled);
+    connect(nodeList.data(), &LimitedNodeList::uuidChanged, this, &PhysicsServer::setSessionUUID);
+    setSessionUUID(nodeList->getSessionUUID());
+
+    nodeList->addSetOfNodeTypesToNodeInterestSet({ NodeType::EntityServer });
+
+    // we hold the entities in our regions above anything a collision bumps a client to
+    EntityMotionState::setVolunteerPriority(PHYSICS_SERVER_SIMULATION_PRIORITY);
+
+    _entityEditSender.initialize(false);
+
+    _entityViewer.init();
+    _entityViewer.getOctreeQuery().setOctreeSizeScale(DEFAULT_OCTREE_SIZE_SCALE);
+    _entityViewer.getOctreeQuery().setBoundaryLevelAdjust(MIN_BOUNDARY_LEVEL_ADJUST);
+
+    auto tree = _entityViewer.getTree();
+    DependencyManager::set<AssignmentParentFinder>(tree);
+
+    _space = std::make_shared<workload::Space>();
+
+    ObjectMotionState::setShapeManager(&_shapeManager);
+    // nothing else steps in this process, solve on every core
+    PhysicsEngine::setNumSolverThreads(0);
+    _physicsEngine = std::make_shared<PhysicsEngine>(Vectors::ZERO);
+    _physicsEngine->init();
+
+    _entitySimulation = std::make_shared<PhysicalEntitySimulation>();
+    _entitySimulation->init(tree, _physicsEngine, &_entityEditSender);
+    _entitySimulation->setWorkloadSpace(_space);
+    _entityViewer.setSimulation(_entitySimulation);
+
+    // entities only become physical once they have a place in the space, see updateSpace()
+    connect(tree.get(), &EntityTree::addingEntityPointer, this, &PhysicsServer::addingEntity, Qt::DirectConnection);
+
+    updateViews();
+
+    _simulationTimer = new QTimer(this);
+    _simulationTimer->setTimerType(Qt::PreciseTimer);
+    connect(_simulationTimer, &QTimer::timeout, this, &PhysicsServer::simulate);
+    _simulationTimer->start(MSECS_PER_SECOND / _simulationRate);
+}
+
+void PhysicsServer::handleSettings() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    DomainHandler& domainHandler = nodeList->getDomainHandler();
+    const QJsonObject& settingsObject = domainHandler.getSettingsObject();
+
+    static const QString PHYSICS_SERVER_SETTINGS_KEY = "physics_server";
+    if (!settingsObject.contains(PHYSICS_SERVER_SETTINGS_KEY)) {
+        qWarning() << "Received settings from the domain-server with no physics-server section.";
+        return;
+    }
+
+    auto physicsServerSettings = settingsObject[PHYSICS_SERVER_SETTINGS_KEY].toObject();
+
+    static const QString SIMULATION_RATE_OPTION = "simulation_rate";
+    static const QString REGION_MARGIN_OPTION = "region_margin";
+    static const QString REGIONS_OPTION = "regions";
+
+    if (physicsServerSettings.contains(SIMULATION_RATE_OPTION)) {
+        _simulationRate = glm::clamp(physicsServerSettings[SIMULATION_RATE_OPTION].toInt(),
+                                     MIN_SIMULATION_RATE, MAX_SIMULATION_RATE);
+    }
+    if (physicsServerSettings.contains(REGION_MARGIN_OPTION)) {
+        _regionMargin = std::max(0.0f, (float)physicsServerSettings[REGION_MARGIN_OPTION].toDouble());
+    }
+
+    _regions.clear();
+    if (physicsServerSettings[REGIONS_OPTION].isObject()) {
+        const QJsonObject& regions = physicsServerSettings[REGIONS_OPTION].toObject();
+
+        const QString X = "x";
+        const QString Y = "y";
+        const QString Z = "z";
+        const QString RADIUS = "radius";
+
+        auto regionNames = regions.keys();
+        _regions.reserve(regionNames.length());
+        foreach (const QString& regionName, regionNames) {
+            QJsonObject regionObject = regions[regionName].toObject();
+
+            if (regionObject.contains(X) && regionObject.contains(Y) && regionObject.contains(Z) &&
+                regionObject.contains(RADIUS)) {
+
+                glm::vec3 center;
+                float radius;
+                bool ok, allOk = true;
+                center.x = regionObject.value(X).toString().toFloat(&ok);
+                allOk &= ok;
+                center.y = regionObject.value(Y).toString().toFloat(&ok);
+                allOk &= ok;
+                center.z = regionObject.value(Z).toString().toFloat(&ok);
+                allOk &= ok;
+                radius = regionObject.value(RADIUS).toString().toFloat(&ok);
+                allOk &= ok && radius > 0.0f;
+
+                if (allOk) {
+                    _regions.push_back({ regionName, center, radius });
+                    qDebug() << "Added physics region:" << regionName << "(center:" << center << ", radius:" << radius << ")";
+                }
+            }
+        }
+    }
+
+    if (_regions.empty()) {
+        qDebug() << "No physics regions, simulating the whole domain";
+    }
+
+    updateViews();
+
+    if (_simulationTimer) {
+        _simulationTimer->start(MSECS_PER_SECOND / _simulationRate);
+    }
+}
+
+void PhysicsServer::updateViews() {
+    ConicalViewFrustums queryViews;
+    workload::Views views;
+
+    if (_regions.empty()) {
+        // no query views asks the entity server for everything
+        workload::View view;
+        const float DOMAIN_RADIUS = (float)TREE_SCALE;
+        float distances[] = { DOMAIN_RADIUS, DOMAIN_RADIUS, DOMAIN_RADIUS, DOMAIN_RADIUS, DOMAIN_RADIUS, DOMAIN_RADIUS };
+        workload::View::updateRegionsFromBackFrontDistances(view, distances);
+        views.push_back(view);
+    } else {
+        for (auto& region : _regions) {
+            // R1 is owned, R2 is simulated alongside it, R3 is where entities are dropped from physics
+            float r1 = region.radius;
+            float r2 = region.radius + _regionMargin;
+            float r3 = region.radius + 2.0f * _regionMargin;
+
+            workload::View view;
+            view.origin = region.center;
+            float distances[] = { r1, r1, r2, r2, r3, r3 };
+            workload::View::updateRegionsFromBackFrontDistances(view, distances);
+            views.push_back(view);
+
+            ConicalViewFrustum queryView;
+            queryView.setPositionAndSimpleRadius(region.center, r3);
+            queryViews.push_back(queryView);
+        }
+    }
+
+    _entityViewer.setConicalViews(queryViews);
+    if (_space) {
+        _space->setViews(views);
+    }
+}
+
+void PhysicsServer::setSessionUUID(const QUuid& sessionUUID) {
+    Physics::setSessionUUID(sessionUUID);
+}
+
+void PhysicsServer::addingEntity(EntityItem* entity) {
+    std::unique_lock<std::mutex> lock(_spaceLock);
+    _entitiesToAddToSpace.push_back(entity->getEntityItemID());
+}
+
+void PhysicsServer::handleSpaceUpdate(std::pair<int32_t, glm::vec4> proxyUpdate) {
+    std::unique_lock<std::mutex> lock(_spaceLock);
+    _spaceUpdates.emplace_back(proxyUpdate.first, proxyUpdate.second);
+}
+
+void PhysicsServer::updateSpace() {
+    auto tree = _entityViewer.getTree();
+
+    std::vector<EntityItemID> entitiesToAdd;
+    workload::Transaction transaction;
+    {
+        std::unique_lock<std::mutex> lock(_spaceLock);
+        entitiesToAdd.swap(_entitiesToAddToSpace);
+        transaction.update(_spaceUpdates);
+        _spaceUpdates.clear();
+    }
+
+    for (auto& entityID : entitiesToAdd) {
+        auto entity = tree->findEntityByEntityItemID(entityID);
+        if (!entity || entity->getSpaceIndex() != -1) {
+            continue;
+        }
+
+        auto spaceIndex = _space->allocateID();
+        workload::Sphere sphere(entity->getWorldPosition(), entity->getBoundingRadius());
+        SpatiallyNestablePointer nestable = std::static_pointer_cast<SpatiallyNestable>(entity);
+        transaction.reset(spaceIndex, sphere, workload::Owner(nestable));
+        entity->setSpaceIndex(spaceIndex);
+
+        // emitted from wherever the entity moves, which is this thread, keep it direct
+        connect(entity.get(), &EntityItem::spaceUpdate, this, &PhysicsServer::handleSpaceUpdate, Qt::DirectConnection);
+    }
+
+    std::vector<int32_t> staleProxies;
+    tree->swapStaleProxies(staleProxies);
+    transaction.remove(staleProxies);
+
+    _space->enqueueTransaction(transaction);
+    _space->enqueueFrame();
+    _space->processTransactionQueue();
+
+    // entities crossing into or out of the regions join or leave the simulation
+    std::vector<workload::Space::Change> changes;
+    _space->categorizeAndGetChanges(changes);
+    for (auto& change : changes) {
+        auto nestable = _space->getOwner(change.proxyId).get<SpatiallyNestablePointer>();
+        if (nestable && nestable->getNestableType() == NestableType::Entity) {
+            _entitySimulation->changeEntity(std::static_pointer_cast<EntityItem>(nestable));
+        }
+    }
+}
+
+void PhysicsServer::simulate() {
+    auto tree = _entityViewer.getTree();
+    if (!tree || !_entitySimulation || Physics::getSessionUUID().isNull()) {
+        return;
+    }
+
+    _entityViewer.queryOctree();
+
+    updateSpace();
+
+    quint64 start = usecTimestampNow();
+    stepSimulation();
+    quint64 stepTime = usecTimestampNow() - start;
+
+    ++_numSteps;
+    _totalStepTime += stepTime;
+    _maxStepTime = std::max(_maxStepTime, stepTime);
+
+    // everything this step changed goes out together, the sender packs the edits
+    if (_entityEditSender.serversExist()) {
+        _entityEditSender.releaseQueuedMessages();
+        _entityEditSender.process();
+    }
+}
+
+void PhysicsServer::stepSimulation() {
+    auto tree = _entityViewer.getTree();
+
+    const VectorOfMotionStates& motionStatesToRemove = _entitySimulation->getObjectsToRemoveFromPhysics();
+    _physicsEngine->removeObjects(motionStatesToRemove);
+    _entitySimulation->deleteObjectsRemovedFromPhysics();
+
+    {
+        VectorOfMotionStates motionStates;
+        tree->withReadLock([&] {
+            _entitySimulation->getObjectsToAddToPhysics(motionStates);
+            _physicsEngine->addObjects(motionStates);
+        });
+    }
+    {
+        VectorOfMotionStates motionStates;
+        tree->withReadLock([&] {
+            _entitySimulation->getObjectsToChange(motionStates);
+            VectorOfMotionStates stillNeedChange = _physicsEngine->changeObjects(motionStates);
+            _entitySimulation->setObjectsToChange(stillNeedChange);
+        });
+    }
+
+    _entitySimulation->applyDynamicChanges();
+
+    _physicsEngine->forEachDynamic([&](EntityDynamicPointer dynamic) {
+        dynamic->prepareForPhysicsSimulation();
+    });
+
+    tree->withWriteLock([&] {
+        _physicsEngine->stepSimulation();
+    });
+
+    if (_physicsEngine->hasOutgoingChanges()) {
+        // grab the collision events before handleChangedMotionStates(), while we know which objects we own
+        auto& collisionEvents = _physicsEngine->getCollisionEvents();
+
+        tree->withWriteLock([&] {
+            _entitySimulation->handleChangedMotionStates(_physicsEngine->getChangedMotionStates());
+            _entitySimulation->handleDeactivatedMotionStates(_physicsEngine->getDeactivatedMotionStates());
+        });
+
+        _entitySimulation->handleCollisionEvents(collisionEvents);
+    }
+
+    // moves the kinematic and non-physical entities
+    _entityViewer.update();
+}
+
+void PhysicsServer::nodeKilled(SharedNodePointer killedNode) {
+    _entityEditSender.nodeKilled(killedNode);
+
+    if (killedNode->getType() == NodeType::EntityServer) {
+        // the entity server will send everything again when it comes back
+        clear();
+    }
+}
+
+void PhysicsServer::clear() {
+    {
+        std::unique_lock<std::mutex> lock(_spaceLock);
+        _entitiesToAddToSpace.clear();
+        _spaceUpdates.clear();
+    }
+
+    _entityViewer.clear();
+
+    if (_space) {
+        _space->clear();
+    }
+}
+
+void PhysicsServer::sendStatsPacket() {
+    QJsonObject statsObject;
+
+    QJsonObject physicsObject;
+    physicsObject["regions"] = (int)_regions.size();
+    physicsObject["simulation_rate"] = _simulationRate;
+    physicsObject["solver_threads"] = PhysicsEngine::getNumSolverThreads();
+    if (_physicsEngine) {
+        physicsObject["rigid_bodies"] = _physicsEngine->getNumCollisionObjects();
+    }
+    if (_entitySimulation) {
+        physicsObject["owned_entities"] = _entitySimulation->getNumOwnedEntities();
+        physicsObject["pending_bids"] = _entitySimulation->getNumPendingBids();
+    }
+    if (_space) {
+        physicsObject["tracked_entities"] = (int)_space->getNumObjects();
+    }
+    physicsObject["steps"] = _numSteps;
+    physicsObject["avg_step_time_us"] = _numSteps > 0 ? (double)_totalStepTime / _numSteps : 0.0;
+    physicsObject["max_step_time_us"] = (double)_maxStepTime;
+    statsObject["physics"] = physicsObject;
+
+    _numSteps = 0;
+    _totalStepTime = 0;
+    _maxStepTime = 0;
+
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
+}
+
+void PhysicsServer::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    auto packetType = message->getType();
+
+    if (packetType == PacketType::OctreeStats) {
+
+        int statsMessageLength = OctreeHeadlessViewer::parseOctreeStats(message, senderNode);
+        if (message->getSize() > statsMessageLength) {
+            // pull out the piggybacked packet and create a new QSharedPointer<NLPacket> for it
+            int piggyBackedSizeWithHeader = message->getSize() - statsMessageLength;
+
+            auto buffer = std::unique_ptr<char[]>(new char[piggyBackedSizeWithHeader]);
+            memcpy(buffer.get(), message->getRawMessage() + statsMessageLength, piggyBackedSizeWithHeader);
+
+            auto newPacket = NLPacket::fromReceivedPacket(std::move(buffer), piggyBackedSizeWithHeader, message->getSenderSockAddr());
+            message = QSharedPointer<ReceivedMessage>::create(*newPacket);
+        } else {
+            return; // bail since no piggyback data
+        }
+
+        packetType = message->getType();
+    } // fall through to piggyback message
+
+    if (packetType == PacketType::EntityData) {
+        _entityViewer.processDatagram(*message, senderNode);
+    } else if (packetType == PacketType::EntityErase) {
+        _entityViewer.processEraseMessage(*message, senderNode);
+    }
+}
+
+void PhysicsServer::aboutToFinish() {
+    if (_simulationTimer) {
+        _simulationTimer->stop();
+    }
+
+    // the entity server frees what we owned once our updates stop, clients bid for it from there
+    clear();
+
+    _entityViewer.setSimulation(nullptr);
+    _entitySimulation.reset();
+    _physicsEngine.reset();
+    ObjectMotionState::setShapeManager(nullptr);
+
+    _entityEditSender.releaseQueuedMessages();
+    _entityEditSender.process();
+
+    DependencyManager::destroy<PhysicsServerDynamicFactory>();
+    DependencyManager::destroy<AssignmentParentFinder>();
+}
@@ -0,0 +1,91 @@
+//
+//  PhysicsServer.h
+//  assignment-client/src/physics
+//
+//  Created by Roxanne Skelly on 2019-06-26.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PhysicsServer_h
+#define hifi_PhysicsServer_h
+
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QTimer>
+
+#include <EntityEditPacketSender.h>
+#include <PhysicalEntitySimulation.h>
+#include <PhysicsEngine.h>
+#include <ShapeManager.h>
+#include <ThreadedAssignment.h>
+#include <workload/Space.h>
+
+#include "../entities/EntityTreeHeadlessViewer.h"
+
+// Simulates the physical entities of the domain's regions and holds their simulation ownership, at a priority no
+// collision bumps a client past and that the entity-server never lets a tie take, so clients follow its results
+// rather than bidding against each other.
+//
+//   Entities within a region are simulated and owned. Those within the region margin are simulated so owned
+//   entities can collide with them, but are left to whoever owns them. Grabs still take an entity over while they
+//   last, the server bids for it again once the client lets it go.
+class PhysicsServer : public ThreadedAssignment {
+    Q_OBJECT
+public:
+    PhysicsServer(ReceivedMessage& message);
+
+    virtual void aboutToFinish() override;
+
+public slots:
+    void run() override;
+    void nodeKilled(SharedNodePointer killedNode);
+    void sendStatsPacket() override;
+
+private slots:
+    void handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleSettings();
+    void setSessionUUID(const QUuid& sessionUUID);
+    void simulate();
+
+private:
+    struct Region {
+        QString name;
+        glm::vec3 center;
+        float radius;
+    };
+
+    void addingEntity(EntityItem* entity);
+    void handleSpaceUpdate(std::pair<int32_t, glm::vec4> proxyUpdate);
+    void updateViews();
+    void updateSpace();
+    void stepSimulation();
+    void clear();
+
+    EntityTreeHeadlessViewer _entityViewer;
+    EntityEditPacketSender _entityEditSender;
+
+    ShapeManager _shapeManager;
+    PhysicsEnginePointer _physicsEngine;
+    PhysicalEntitySimulationPointer _entitySimulation;
+
+    workload::SpacePointer _space;
+    std::mutex _spaceLock;
+    workload::Transaction::Updates _spaceUpdates;
+    std::vector<EntityItemID> _entitiesToAddToSpace;
+
+    std::vector<Region> _regions;
+    float _regionMargin;
+    int _simulationRate;
+    QTimer* _simulationTimer { nullptr };
+
+    // since the last stats packet
+    int _numSteps { 0 };
+    quint64 _totalStepTime { 0 };
+    quint64 _maxStepTime { 0 };
+};
+
+#endif // hifi_PhysicsServer_h
@@ -0,0 +1,87 @@
+//
+//  PhysicsServerDynamicFactory.cpp
+//  assignment-client/src/physics
+//
+//  Created by Roxanne Skelly on 2019-06-26.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PhysicsServerDynamicFactory.h"
+
+#include <ObjectActionOffset.h>
+#include <ObjectActionTractor.h>
+#include <ObjectActionTravelOriented.h>
+#include <ObjectConstraintHinge.h>
+#include <ObjectConstraintSlider.h>
+#include <ObjectConstraintBallSocket.h>
+#include <ObjectConstraintConeTwist.h>
+
+#include "../AssignmentDynamic.h"
+
+EntityDynamicPointer physicsServerDynamicFactory(EntityDynamicType type, const QUuid& id, EntityItemPointer ownerEntity) {
+    switch (type) {
+        case DYNAMIC_TYPE_NONE:
+            return EntityDynamicPointer();
+        case DYNAMIC_TYPE_OFFSET:
+            return std::make_shared<ObjectActionOffset>(id, ownerEntity);
+        case DYNAMIC_TYPE_SPRING:
+        case DYNAMIC_TYPE_TRACTOR:
+            return std::make_shared<ObjectActionTractor>(id, ownerEntity);
+        case DYNAMIC_TYPE_TRAVEL_ORIENTED:
+            return std::make_shared<ObjectActionTravelOriented>(id, ownerEntity);
+        case DYNAMIC_TYPE_HINGE:
+            return std::make_shared<ObjectConstraintHinge>(id, ownerEntity);
+        case DYNAMIC_TYPE_SLIDER:
+            return std::make_shared<ObjectConstraintSlider>(id, ownerEntity);
+        case DYNAMIC_TYPE_BALL_SOCKET:
+            return std::make_shared<ObjectConstraintBallSocket>(id, ownerEntity);
+        case DYNAMIC_TYPE_CONE_TWIST:
+            return std::make_shared<ObjectConstraintConeTwist>(id, ownerEntity);
+        case DYNAMIC_TYPE_HOLD:
+        case DYNAMIC_TYPE_FAR_GRAB:
+            // the grabbing client owns the entity while these last, keep the arguments for the entity server
+            return std::make_shared<AssignmentDynamic>(type, id, ownerEntity);
+    }
+
+    qDebug() << "Unknown entity dynamic type";
+    return EntityDynamicPointer();
+}
+
+EntityDynamicPointer PhysicsServerDynamicFactory::factory(EntityDynamicType type,
+                                                         const QUuid& id,
+                                                         EntityItemPointer ownerEntity,
+                                                         QVariantMap arguments) {
+    EntityDynamicPointer dynamic = physicsServerDynamicFactory(type, id, ownerEntity);
+    if (dynamic) {
+        bool ok = dynamic->updateArguments(arguments);
+        if (ok) {
+            if (dynamic->lifetimeIsOver()) {
+                return nullptr;
+            }
+            return dynamic;
+        }
+    }
+    return nullptr;
+}
+
+EntityDynamicPointer PhysicsServerDynamicFactory::factoryBA(EntityItemPointer ownerEntity, QByteArray data) {
+    QDataStream serializedDynamicDataStream(data);
+    EntityDynamicType type;
+    QUuid id;
+
+    serializedDynamicDataStream >> type;
+    serializedDynamicDataStream >> id;
+
+    EntityDynamicPointer dynamic = physicsServerDynamicFactory(type, id, ownerEntity);
+
+    if (dynamic) {
+        dynamic->deserialize(data);
+        if (dynamic->lifetimeIsOver()) {
+            return nullptr;
+        }
+    }
+    return dynamic;
+}
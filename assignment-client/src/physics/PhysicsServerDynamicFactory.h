@@ -0,0 +1,30 @@
+//
+//  PhysicsServerDynamicFactory.h
+//  assignment-client/src/physics
+//
+//  Created by Roxanne Skelly on 2019-06-26.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PhysicsServerDynamicFactory_h
+#define hifi_PhysicsServerDynamicFactory_h
+
+#include "EntityDynamicFactoryInterface.h"
+
+// Makes the dynamics the physics-server simulates. Actions tied to an avatar (hold, far-grab) only live in the
+// grabbing client's simulation, the server keeps an inert AssignmentDynamic for those.
+class PhysicsServerDynamicFactory : public EntityDynamicFactoryInterface {
+public:
+    PhysicsServerDynamicFactory() : EntityDynamicFactoryInterface() { }
+    virtual ~PhysicsServerDynamicFactory() { }
+    virtual EntityDynamicPointer factory(EntityDynamicType type,
+                                        const QUuid& id,
+                                        EntityItemPointer ownerEntity,
+                                        QVariantMap arguments) override;
+    virtual EntityDynamicPointer factoryBA(EntityItemPointer ownerEntity, QByteArray data) override;
+};
+
+#endif // hifi_PhysicsServerDynamicFactory_h
@@ -13,6 +13,8 @@
 
 #include <mutex>
 
+#include <QtCore/QThread>
+
 #include <AudioConstants.h>
 #include <AudioInjectorManager.h>
 #include <ClientServerUtils.h>
@@ -127,7 +129,7 @@ void EntityScriptServer::handleEntityScriptGetStatusPacket(QSharedPointer<Receiv
         replyPacketList->writePrimitive(messageID);
 
         EntityScriptDetails details;
-        if (_entitiesScriptEngine->getEntityScriptDetails(entityID, details)) {
+        if (_entityScripts && _entityScripts->getEntityScriptDetails(entityID, details)) {
             replyPacketList->writePrimitive(true);
             replyPacketList->writePrimitive(details.status);
             replyPacketList->writeString(details.errorInfo);
@@ -156,6 +158,9 @@ void EntityScriptServer::handleSettings() {
 
     auto entityScriptServerSettings = settingsObject[ENTITY_SCRIPT_SERVER_SETTINGS_KEY].toObject();
 
+    static const QString NUM_SCRIPT_ENGINES_OPTION = "num_script_engines";
+    setNumScriptEngines(entityScriptServerSettings[NUM_SCRIPT_ENGINES_OPTION].toInt(1));
+
     static const QString MAX_ENTITY_PPS_OPTION = "max_total_entity_pps";
     static const QString ENTITY_PPS_PER_SCRIPT = "entity_pps_per_script";
 
@@ -172,7 +177,7 @@ void EntityScriptServer::handleSettings() {
 }
 
 void EntityScriptServer::updateEntityPPS() {
-    int numRunningScripts = _entitiesScriptEngine->getNumRunningEntityScripts();
+    int numRunningScripts = _entityScripts ? _entityScripts->getNumRunningEntityScripts() : 0;
     int pps;
     if (std::numeric_limits<int>::max() / _entityPPSPerScript < numRunningScripts) {
         qWarning() << QString("Integer multiplication would overflow, clamping to maxint: %1 * %2").arg(numRunningScripts).arg(_entityPPSPerScript);
@@ -233,7 +238,7 @@ void EntityScriptServer::pushLogs() {
 
 void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
 
-    if (_entitiesScriptEngine && _entityViewer.getTree() && !_shuttingDown) {
+    if (_entityScripts && _entityViewer.getTree() && !_shuttingDown) {
         auto entityID = QUuid::fromRfc4122(receivedMessage->read(NUM_BYTES_RFC4122_UUID));
 
         auto method = receivedMessage->readString();
@@ -247,7 +252,7 @@ void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<Recei
             params << paramString;
         }
 
-        _entitiesScriptEngine->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
+        _entityScripts->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
     }
 }
 
@@ -434,62 +439,141 @@ void EntityScriptServer::selectAudioFormat(const QString& selectedCodecName) {
 }
 
 void EntityScriptServer::resetEntitiesScriptEngine() {
-    auto engineName = QString("about:Entities %1").arg(++_entitiesScriptEngineCount);
-    auto newEngine = scriptEngineFactory(ScriptEngine::ENTITY_SERVER_SCRIPT, NO_SCRIPT, engineName);
-
-    auto webSocketServerConstructorValue = newEngine->newFunction(WebSocketServerClass::constructor);
-    newEngine->globalObject().setProperty("WebSocketServer", webSocketServerConstructorValue);
+    std::vector<ScriptEnginePointer> newEngines;
+    for (int i = 0; i < _numScriptEngines; ++i) {
+        auto engineName = QString("about:Entities %1").arg(++_entitiesScriptEngineCount);
+        auto newEngine = scriptEngineFactory(ScriptEngine::ENTITY_SERVER_SCRIPT, NO_SCRIPT, engineName);
+
+        auto webSocketServerConstructorValue = newEngine->newFunction(WebSocketServerClass::constructor);
+        newEngine->globalObject().setProperty("WebSocketServer", webSocketServerConstructorValue);
+
+        newEngine->registerGlobalObject("SoundCache", DependencyManager::get<SoundCacheScriptingInterface>().data());
+
+        // connect this script engines printedMessage signal to the global ScriptEngines these various messages
+        auto scriptEngines = DependencyManager::get<ScriptEngines>().data();
+        connect(newEngine.data(), &ScriptEngine::printedMessage, scriptEngines, &ScriptEngines::onPrintedMessage);
+        connect(newEngine.data(), &ScriptEngine::errorMessage, scriptEngines, &ScriptEngines::onErrorMessage);
+        connect(newEngine.data(), &ScriptEngine::warningMessage, scriptEngines, &ScriptEngines::onWarningMessage);
+        connect(newEngine.data(), &ScriptEngine::infoMessage, scriptEngines, &ScriptEngines::onInfoMessage);
+
+        // the engines share the tree, one of them is enough to keep it queried and updated
+        if (i == 0) {
+            connect(newEngine.data(), &ScriptEngine::update, this, [this] {
+                _entityViewer.queryOctree();
+                _entityViewer.getTree()->update();
+            });
+        }
 
-    newEngine->registerGlobalObject("SoundCache", DependencyManager::get<SoundCacheScriptingInterface>().data());
+        connect(newEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
+                this, &EntityScriptServer::updateEntityPPS);
 
-    // connect this script engines printedMessage signal to the global ScriptEngines these various messages
-    auto scriptEngines = DependencyManager::get<ScriptEngines>().data();
-    connect(newEngine.data(), &ScriptEngine::printedMessage, scriptEngines, &ScriptEngines::onPrintedMessage);
-    connect(newEngine.data(), &ScriptEngine::errorMessage, scriptEngines, &ScriptEngines::onErrorMessage);
-    connect(newEngine.data(), &ScriptEngine::warningMessage, scriptEngines, &ScriptEngines::onWarningMessage);
-    connect(newEngine.data(), &ScriptEngine::infoMessage, scriptEngines, &ScriptEngines::onInfoMessage);
+        newEngine->runInThread();
+        newEngines.push_back(newEngine);
+    }
 
-    connect(newEngine.data(), &ScriptEngine::update, this, [this] {
-        _entityViewer.queryOctree();
-        _entityViewer.getTree()->update();
-    });
+    if (_entityScripts) {
+        for (int i = 0; i < _entityScripts->getNumShards(); ++i) {
+            disconnect(_entityScripts->getEngine(i).data(), &ScriptEngine::entityScriptDetailsUpdated,
+                       this, &EntityScriptServer::updateEntityPPS);
+        }
+    }
 
+    _entityScripts = QSharedPointer<EntityScriptShards>::create(newEngines);
+    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(
+        qSharedPointerCast<EntitiesScriptEngineProvider>(_entityScripts));
+}
 
-    newEngine->runInThread();
-    auto newEngineSP = qSharedPointerCast<EntitiesScriptEngineProvider>(newEngine);
-    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(newEngineSP);
+void EntityScriptServer::stopEntitiesScriptEngines() {
+    if (!_entityScripts) {
+        return;
+    }
 
-    if (_entitiesScriptEngine) {
-        disconnect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-                   this, &EntityScriptServer::updateEntityPPS);
+    // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
+    for (int i = 0; i < _entityScripts->getNumShards(); ++i) {
+        auto& engine = _entityScripts->getEngine(i);
+        engine->unloadAllEntityScripts();
+        engine->stop();
     }
 
-    _entitiesScriptEngine.swap(newEngine);
-    connect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-            this, &EntityScriptServer::updateEntityPPS);
+    // stop them all before waiting, so they wind down together
+    for (int i = 0; i < _entityScripts->getNumShards(); ++i) {
+        _entityScripts->getEngine(i)->waitTillDoneRunning();
+    }
 }
 
+void EntityScriptServer::setNumScriptEngines(int numScriptEngines) {
+    int maxScriptEngines = QThread::idealThreadCount();
+    if (maxScriptEngines == -1) {
+        // idealThreadCount returns -1 if cores cannot be detected
+        static const int MAX_SCRIPT_ENGINES_IF_UNKNOWN = 4;
+        maxScriptEngines = MAX_SCRIPT_ENGINES_IF_UNKNOWN;
+    }
 
-void EntityScriptServer::clear() {
-    // unload and stop the engine
-    if (_entitiesScriptEngine) {
-        // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
-        _entitiesScriptEngine->unloadAllEntityScripts();
-        _entitiesScriptEngine->stop();
-        _entitiesScriptEngine->waitTillDoneRunning();
+    if (numScriptEngines <= 0) {
+        numScriptEngines = maxScriptEngines;
+    } else if (numScriptEngines > maxScriptEngines) {
+        qCWarning(entity_script_server) << "Clamping script engines to" << maxScriptEngines << "(was" << numScriptEngines << ")";
+        numScriptEngines = maxScriptEngines;
+    }
+
+    if (numScriptEngines == _numScriptEngines) {
+        return;
+    }
+
+    qCDebug(entity_script_server) << "Running entity scripts on" << numScriptEngines << "script engines (was"
+        << _numScriptEngines << ")";
+    _numScriptEngines = numScriptEngines;
+
+    if (!_entityScripts || _shuttingDown) {
+        // run() hasn't started the engines yet
+        return;
+    }
+
+    // entities change shards with the engine count, so restart every script on its new engine
+    stopEntitiesScriptEngines();
+    resetEntitiesScriptEngine();
+
+    auto tree = _entityViewer.getTree();
+    if (!tree) {
+        return;
+    }
+
+    QVector<EntityItemID> entitiesWithScripts;
+    tree->withReadLock([&] {
+        tree->recurseTreeWithOperation([&](const OctreeElementPointer& element, void*) {
+            auto entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+            entityTreeElement->forEachEntity([&](const EntityItemPointer& entity) {
+                if (!entity->getServerScripts().isEmpty()) {
+                    entitiesWithScripts.push_back(entity->getEntityItemID());
+                }
+            });
+            return true;
+        });
+    });
+
+    for (auto& entityID : entitiesWithScripts) {
+        checkAndCallPreload(entityID);
     }
+}
+
+void EntityScriptServer::clear() {
+    // unload and stop the engines
+    stopEntitiesScriptEngines();
 
     _entityViewer.clear();
 
-    // reset the engine
+    // reset the engines
     if (!_shuttingDown) {
         resetEntitiesScriptEngine();
     }
 }
 
 void EntityScriptServer::shutdownScriptEngine() {
-    if (_entitiesScriptEngine) {
-        _entitiesScriptEngine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
+    if (_entityScripts) {
+        for (int i = 0; i < _entityScripts->getNumShards(); ++i) {
+            // disconnect all slots/signals from the script engine, except essential
+            _entityScripts->getEngine(i)->disconnectNonEssentialSignals();
+        }
     }
     _shuttingDown = true;
 
@@ -498,7 +582,7 @@ void EntityScriptServer::shutdownScriptEngine() {
     auto scriptEngines = DependencyManager::get<ScriptEngines>();
     scriptEngines->shutdownScripting();
 
-    _entitiesScriptEngine.clear();
+    _entityScripts.clear();
 
     auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
     // our entity tree is going to go away so tell that to the EntityScriptingInterface
@@ -516,8 +600,8 @@ void EntityScriptServer::addingEntity(const EntityItemID& entityID) {
 }
 
 void EntityScriptServer::deletingEntity(const EntityItemID& entityID) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+    if (_entityViewer.getTree() && !_shuttingDown && _entityScripts) {
+        _entityScripts->unloadEntityScript(entityID);
     }
 }
 
@@ -528,27 +612,50 @@ void EntityScriptServer::entityServerScriptChanging(const EntityItemID& entityID
 }
 
 void EntityScriptServer::checkAndCallPreload(const EntityItemID& entityID, bool forceRedownload) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
+    if (_entityViewer.getTree() && !_shuttingDown && _entityScripts) {
 
         EntityItemPointer entity = _entityViewer.getTree()->findEntityByEntityItemID(entityID);
         EntityScriptDetails details;
-        bool isRunning = _entitiesScriptEngine->getEntityScriptDetails(entityID, details);
+        bool isRunning = _entityScripts->getEntityScriptDetails(entityID, details);
         if (entity && (forceRedownload || !isRunning || details.scriptText != entity->getServerScripts())) {
             if (isRunning) {
-                _entitiesScriptEngine->unloadEntityScript(entityID, true);
+                _entityScripts->unloadEntityScript(entityID);
             }
 
             QString scriptUrl = entity->getServerScripts();
             if (!scriptUrl.isEmpty()) {
                 scriptUrl = DependencyManager::get<ResourceManager>()->normalizeURL(scriptUrl);
-                _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, forceRedownload);
+                _entityScripts->loadEntityScript(entityID, scriptUrl, forceRedownload);
             }
         }
     }
 }
 
 void EntityScriptServer::sendStatsPacket() {
+    QJsonObject statsObject;
+
+    if (_entityScripts) {
+        QJsonObject scriptEnginesObject;
+
+        auto shardStats = _entityScripts->getStats();
+        for (size_t i = 0; i < shardStats.size(); ++i) {
+            auto& stats = shardStats[i];
+
+            QJsonObject engineStats;
+            engineStats["running_scripts"] = stats.numRunningScripts;
+            engineStats["cpu_time_ms"] = (double)stats.cpuTime / USECS_PER_MSEC;
+            engineStats["cpu_usage_percent"] = stats.cpuUsage * 100.0f;
+            engineStats["backlog"] = stats.backlog;
+            engineStats["event_latency_us"] = (double)stats.eventLatency;
+            scriptEnginesObject[QString::number(i)] = engineStats;
+        }
+        statsObject["script_engines"] = scriptEnginesObject;
+
+        // sampled now, reported with the next stats packet
+        _entityScripts->sample();
+    }
 
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
 void EntityScriptServer::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
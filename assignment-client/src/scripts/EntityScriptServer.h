@@ -23,6 +23,7 @@
 #include <ScriptEngine.h>
 #include <ThreadedAssignment.h>
 #include "../entities/EntityTreeHeadlessViewer.h"
+#include "EntityScriptShards.h"
 
 class EntityScriptServer : public ThreadedAssignment {
     Q_OBJECT
@@ -61,6 +62,8 @@ private:
     void selectAudioFormat(const QString& selectedCodecName);
 
     void resetEntitiesScriptEngine();
+    void stopEntitiesScriptEngines();
+    void setNumScriptEngines(int numScriptEngines);
     void clear();
     void shutdownScriptEngine();
 
@@ -74,7 +77,8 @@ private:
     bool _shuttingDown { false };
 
     static int _entitiesScriptEngineCount;
-    ScriptEnginePointer _entitiesScriptEngine;
+    int _numScriptEngines { 1 };
+    QSharedPointer<EntityScriptShards> _entityScripts;
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
 
@@ -0,0 +1,158 @@
+//
+//  EntityScriptShards.cpp
+//  assignment-client/src/scripts
+//
+//  Created by Roxanne Skelly on 2019-06-25.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityScriptShards.h"
+
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+// CPU time of the calling thread
+static quint64 getThreadCPUTime() {
+#ifdef Q_OS_WIN
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    ULARGE_INTEGER kernel, user;
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+    // FILETIMEs count 100ns intervals
+    return (kernel.QuadPart + user.QuadPart) / 10;
+#else
+    timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+        return 0;
+    }
+    return (quint64)time.tv_sec * USECS_PER_SECOND + (quint64)time.tv_nsec / NSECS_PER_USEC;
+#endif
+}
+
+EntityScriptShards::EntityScriptShards(std::vector<ScriptEnginePointer> engines) {
+    _shards.reserve(engines.size());
+    for (auto& engine : engines) {
+        auto shard = std::make_shared<Shard>();
+        shard->engine = engine;
+        _shards.push_back(shard);
+    }
+}
+
+int EntityScriptShards::shardForEntity(const EntityItemID& entityID, int numShards) {
+    // qHash of a QUuid is unseeded, so an entity lands on the same shard every time
+    return numShards > 1 ? (int)(qHash(static_cast<const QUuid&>(entityID)) % (uint)numShards) : 0;
+}
+
+const EntityScriptShards::ShardPointer& EntityScriptShards::getShard(const EntityItemID& entityID) const {
+    return _shards[shardForEntity(entityID, getNumShards())];
+}
+
+const ScriptEnginePointer& EntityScriptShards::getEngineForEntity(const EntityItemID& entityID) const {
+    return getShard(entityID)->engine;
+}
+
+void EntityScriptShards::post(const ShardPointer& shard, std::function<void()> call) {
+    if (QThread::currentThread() == shard->engine->thread()) {
+        // a script calling into its own engine, keep that synchronous
+        call();
+        return;
+    }
+
+    ++shard->backlog;
+    QTimer::singleShot(0, shard->engine.data(), [shard, call] {
+        --shard->backlog;
+        call();
+    });
+}
+
+void EntityScriptShards::loadEntityScript(const EntityItemID& entityID, const QString& entityScript,
+                                          bool forceRedownload) {
+    auto& shard = getShard(entityID);
+    ScriptEngine* engine = shard->engine.data();
+    post(shard, [engine, entityID, entityScript, forceRedownload] {
+        engine->loadEntityScript(entityID, entityScript, forceRedownload);
+    });
+}
+
+void EntityScriptShards::unloadEntityScript(const EntityItemID& entityID) {
+    auto& shard = getShard(entityID);
+    ScriptEngine* engine = shard->engine.data();
+    post(shard, [engine, entityID] {
+        engine->unloadEntityScript(entityID, true);
+    });
+}
+
+bool EntityScriptShards::getEntityScriptDetails(const EntityItemID& entityID, EntityScriptDetails& details) const {
+    return getEngineForEntity(entityID)->getEntityScriptDetails(entityID, details);
+}
+
+int EntityScriptShards::getNumRunningEntityScripts() const {
+    int numRunningScripts = 0;
+    for (auto& shard : _shards) {
+        numRunningScripts += shard->engine->getNumRunningEntityScripts();
+    }
+    return numRunningScripts;
+}
+
+void EntityScriptShards::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                                const QStringList& params, const QUuid& remoteCallerID) {
+    auto& shard = getShard(entityID);
+    ScriptEngine* engine = shard->engine.data();
+    post(shard, [engine, entityID, methodName, params, remoteCallerID] {
+        engine->callEntityScriptMethod(entityID, methodName, params, remoteCallerID);
+    });
+}
+
+QFuture<QVariant> EntityScriptShards::getLocalEntityScriptDetails(const EntityItemID& entityID) {
+    return getEngineForEntity(entityID)->getLocalEntityScriptDetails(entityID);
+}
+
+void EntityScriptShards::sample() {
+    quint64 postedAt = usecTimestampNow();
+    for (auto& shard : _shards) {
+        QTimer::singleShot(0, shard->engine.data(), [shard, postedAt] {
+            quint64 now = usecTimestampNow();
+            quint64 cpuTime = getThreadCPUTime();
+
+            quint64 lastCPUTime = shard->cpuTime;
+            if (shard->lastSampleTime != 0 && now > shard->lastSampleTime && cpuTime >= lastCPUTime) {
+                shard->cpuUsage = (float)(cpuTime - lastCPUTime) / (float)(now - shard->lastSampleTime);
+            }
+            shard->cpuTime = cpuTime;
+            shard->lastSampleTime = now;
+            shard->eventLatency = now > postedAt ? now - postedAt : 0;
+        });
+    }
+}
+
+std::vector<EntityScriptShards::ShardStats> EntityScriptShards::getStats() const {
+    std::vector<ShardStats> stats;
+    stats.reserve(_shards.size());
+    for (auto& shard : _shards) {
+        ShardStats shardStats;
+        shardStats.numRunningScripts = shard->engine->getNumRunningEntityScripts();
+        shardStats.cpuTime = shard->cpuTime;
+        shardStats.cpuUsage = shard->cpuUsage;
+        shardStats.backlog = shard->backlog;
+        shardStats.eventLatency = shard->eventLatency;
+        stats.push_back(shardStats);
+    }
+    return stats;
+}
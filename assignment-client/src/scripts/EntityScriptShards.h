@@ -0,0 +1,80 @@
+//
+//  EntityScriptShards.h
+//  assignment-client/src/scripts
+//
+//  Created by Roxanne Skelly on 2019-06-25.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityScriptShards_h
+#define hifi_EntityScriptShards_h
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <EntitiesScriptEngineProvider.h>
+#include <ScriptEngine.h>
+
+// The script engines of the entity script server. Each engine runs on its own thread and owns the scripts of the
+// entities whose ID hashes to it, so a slow script only holds up the scripts that share its engine.
+//
+//   Everything aimed at an entity's script (loads, unloads, method calls from clients or from other scripts) is
+//   routed to the engine that owns the entity, and runs there in the order it was routed. Messages need no routing,
+//   each script subscribes from its own engine and hears them there.
+class EntityScriptShards : public EntitiesScriptEngineProvider {
+public:
+    struct ShardStats {
+        int numRunningScripts { 0 };
+        quint64 cpuTime { 0 };              // usecs the engine's thread has run for
+        float cpuUsage { 0.0f };            // fraction of a core, between the last two samples
+        int backlog { 0 };                  // routed calls the engine has yet to run
+        quint64 eventLatency { 0 };         // usecs the last sample waited for the engine to get to it
+    };
+
+    EntityScriptShards(std::vector<ScriptEnginePointer> engines);
+
+    static int shardForEntity(const EntityItemID& entityID, int numShards);
+
+    int getNumShards() const { return (int)_shards.size(); }
+    const ScriptEnginePointer& getEngine(int shard) const { return _shards[shard]->engine; }
+    const ScriptEnginePointer& getEngineForEntity(const EntityItemID& entityID) const;
+
+    void loadEntityScript(const EntityItemID& entityID, const QString& entityScript, bool forceRedownload);
+    void unloadEntityScript(const EntityItemID& entityID);
+    bool getEntityScriptDetails(const EntityItemID& entityID, EntityScriptDetails& details) const;
+    int getNumRunningEntityScripts() const;
+
+    // EntitiesScriptEngineProvider
+    void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                const QStringList& params = QStringList(), const QUuid& remoteCallerID = QUuid()) override;
+    QFuture<QVariant> getLocalEntityScriptDetails(const EntityItemID& entityID) override;
+
+    // asks each engine to sample its CPU time and latency, the results show up in getStats() once it has
+    void sample();
+    std::vector<ShardStats> getStats() const;
+
+private:
+    struct Shard {
+        ScriptEnginePointer engine;
+        std::atomic<int> backlog { 0 };
+
+        // written from the engine's thread
+        std::atomic<quint64> cpuTime { 0 };
+        std::atomic<float> cpuUsage { 0.0f };
+        std::atomic<quint64> eventLatency { 0 };
+        quint64 lastSampleTime { 0 };
+    };
+    using ShardPointer = std::shared_ptr<Shard>;
+
+    const ShardPointer& getShard(const EntityItemID& entityID) const;
+    void post(const ShardPointer& shard, std::function<void()> call);
+
+    std::vector<ShardPointer> _shards;
+};
+
+#endif // hifi_EntityScriptShards_h
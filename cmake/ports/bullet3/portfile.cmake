@@ -42,6 +42,7 @@ vcpkg_configure_cmake(
         -DBUILD_UNIT_TESTS=OFF
         -DBUILD_SHARED_LIBS=ON
         -DINSTALL_LIBS=ON
+        -DBULLET2_MULTITHREADING=ON
 )
 
 vcpkg_install_cmake()
@@ -51,7 +51,7 @@ QUuid DomainGatekeeper::assignmentUUIDForPendingAssignment(const QUuid& tempUUID
 
 const NodeSet STATICALLY_ASSIGNED_NODES = NodeSet() << NodeType::AudioMixer << NodeType::AvatarMixer
         << NodeType::EntityServer << NodeType::AssetServer << NodeType::MessagesMixer
-        << NodeType::EntityScriptServer;
+        << NodeType::EntityScriptServer << NodeType::PhysicsServer;
 
 void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessage> message) {
     if (message->getSize() == 0) {
@@ -75,7 +75,8 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
     }
 
     static const NodeSet VALID_NODE_TYPES {
-        NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::AssetServer, NodeType::EntityServer, NodeType::Agent, NodeType::MessagesMixer, NodeType::EntityScriptServer
+        NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::AssetServer, NodeType::EntityServer, NodeType::Agent, NodeType::MessagesMixer, NodeType::EntityScriptServer,
+        NodeType::PhysicsServer
     };
 
     if (!VALID_NODE_TYPES.contains(nodeConnection.nodeType)) {
@@ -84,6 +85,17 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
         return;
     }
 
+    // nodes without our packet authentication method could not verify anything we send them, nor we anything from them
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+    if (limitedNodeList->getAuthenticatePackets() &&
+        !(nodeConnection.supportedAuthMethods & (1 << limitedNodeList->getAuthenticationMethod()))) {
+        qDebug() << "Refusing connection from" << nodeConnection.senderSockAddr
+            << "- it does not support packet authentication method" << limitedNodeList->getAuthenticationMethod();
+        sendConnectionDeniedPacket("This domain verifies packets with a hash your client does not support.",
+            message->getSenderSockAddr(), DomainHandler::ConnectionRefusedReason::ProtocolMismatch);
+        return;
+    }
+
     // check if this connect request matches an assignment in the queue
     auto pendingAssignment = _pendingAssignedNodes.find(nodeConnection.connectUUID);
 
@@ -305,7 +317,12 @@ void DomainGatekeeper::updateNodePermissions() {
             userPerms = setPermissionsForUser(isLocalUser, verifiedUsername, connectingAddr.getAddress(), hardwareAddress, machineFingerprint);
         }
 
+        // only the permission bits are sent to other nodes
+        bool permissionsChanged = node->getPermissions().permissions != userPerms.permissions;
         node->setPermissions(userPerms);
+        if (permissionsChanged) {
+            _server->markDomainListChanged(node);
+        }
 
         if (!userPerms.can(NodePermissions::Permission::canConnectToDomain)) {
             qDebug() << "node" << node->getUUID() << "no longer has permission to connect.";
@@ -659,6 +659,7 @@ bool DomainServer::isPacketVerified(const udt::Packet& packet) {
 void DomainServer::setupNodeListAndAssignments() {
     const QString CUSTOM_LOCAL_PORT_OPTION = "metaverse.local_port";
     static const QString ENABLE_PACKET_AUTHENTICATION = "metaverse.enable_packet_verification";
+    static const QString PACKET_AUTHENTICATION_METHOD = "metaverse.packet_verification_method";
 
     QVariant localPortValue = _settingsManager.valueOrDefaultValueForKeyPath(CUSTOM_LOCAL_PORT_OPTION);
     int domainServerPort = localPortValue.toInt();
@@ -728,6 +729,15 @@ void DomainServer::setupNodeListAndAssignments() {
     bool isAuthEnabled = _settingsManager.valueOrDefaultValueForKeyPath(ENABLE_PACKET_AUTHENTICATION).toBool();
     nodeList->setAuthenticatePackets(isAuthEnabled);
 
+    QString authMethodName = _settingsManager.valueOrDefaultValueForKeyPath(PACKET_AUTHENTICATION_METHOD).toString();
+    if (authMethodName == "sha256") {
+        nodeList->setAuthenticationMethod(HMACAuth::SHA256);
+    } else if (authMethodName == "blake2s") {
+        nodeList->setAuthenticationMethod(HMACAuth::BLAKE2S256);
+    } else {
+        nodeList->setAuthenticationMethod(HMACAuth::MD5);
+    }
+
     connect(nodeList.data(), &LimitedNodeList::nodeAdded, this, &DomainServer::nodeAdded);
     connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &DomainServer::nodeKilled);
 
@@ -1030,6 +1040,11 @@ void DomainServer::populateDefaultStaticAssignmentsExcludingTypes(const QSet<Ass
                 continue;
             }
 
+            // the physics-server takes simulation ownership away from clients, so it is opt-in
+            if (defaultedType == Assignment::PhysicsServerType && !isPhysicsServerEnabled()) {
+                continue;
+            }
+
             // type has not been set from a command line or config file config, use the default
             // by clearing whatever exists and writing a single default assignment with no payload
             Assignment* newAssignment = new Assignment(Assignment::CreateCommand, (Assignment::Type) defaultedType);
@@ -1042,9 +1057,17 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     QDataStream packetStream(message->getMessage());
     NodeConnectionData nodeRequestData = NodeConnectionData::fromDataStream(packetStream, message->getSenderSockAddr(), false);
 
+    // the version of the domain list the node has, it is sent what changed since
+    quint32 lastDomainListVersion = 0;
+    packetStream >> lastDomainListVersion;
+
     // update this node's sockets in case they have changed
-    sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
-    sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+    if (sendingNode->getPublicSocket() != nodeRequestData.publicSockAddr ||
+        sendingNode->getLocalSocket() != nodeRequestData.localSockAddr) {
+        sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
+        sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+        markDomainListChanged(sendingNode);
+    }
 
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
 
@@ -1062,12 +1085,16 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     }
 
     // update the NodeInterestSet in case there have been any changes
-    nodeData->setNodeInterestSet(safeInterestSet);
+    if (safeInterestSet != nodeData->getNodeInterestSet()) {
+        // the node has none of the nodes it is newly interested in, it starts over from a full list
+        nodeData->setNodeInterestSet(safeInterestSet);
+        nodeData->setNeedsFullDomainList();
+    }
 
     // update the connecting hostname in case it has changed
     nodeData->setPlaceName(nodeRequestData.placeName);
 
-    sendDomainListToNode(sendingNode, message->getSenderSockAddr());
+    sendDomainListToNode(sendingNode, message->getSenderSockAddr(), lastDomainListVersion);
 }
 
 bool DomainServer::isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
@@ -1145,58 +1172,118 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
         newNode->setIsReplicated(true);
     }
 
+    markDomainListChanged(newNode);
+
     // send out this node to our other connected nodes
     broadcastNewNode(newNode);
 }
 
-void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr) {
+void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr,
+                                        quint32 lastDomainListVersion) {
     const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID +
         NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID + 4;
 
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+
+    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+
+    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
+    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+
+    // a node that has a version of the list we still have the changes since is sent only the nodes that changed,
+    // anything else is sent the full list
+    nodeData->setReportedDomainListVersion(lastDomainListVersion);
+    quint32 oldestDeltaVersion = _domainListVersion - (quint32)_domainListChanges.size();
+    bool isDelta = !nodeData->needsFullDomainList() && lastDomainListVersion != 0 &&
+        lastDomainListVersion >= oldestDeltaVersion && lastDomainListVersion <= _domainListVersion;
+
+    // a node that isn't authenticated is sent none of the other nodes, so it will need all of them once it is
+    if (!nodeData->isAuthenticated()) {
+        nodeData->setNeedsFullDomainList();
+    } else if (nodeData->needsFullDomainList()) {
+        nodeData->setFullDomainListSent(_domainListVersion);
+    }
+
+    std::vector<SharedNodePointer> nodesToSend;
+    std::vector<QUuid> removedNodes;
+
+    // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
+    if (nodeInterestSet.size() > 0 && nodeData->isAuthenticated()) {
+        if (isDelta) {
+            // the last change to each node is the one that counts
+            QHash<QUuid, NodeType_t> changedNodes;
+            auto firstChange = _domainListChanges.cbegin() + (lastDomainListVersion - oldestDeltaVersion);
+            for (auto it = firstChange; it != _domainListChanges.cend(); ++it) {
+                changedNodes.insert(it->nodeUUID, it->nodeType);
+            }
+            changedNodes.remove(node->getUUID());
+
+            for (auto it = changedNodes.cbegin(); it != changedNodes.cend(); ++it) {
+                if (!nodeInterestSet.contains(it.value())) {
+                    continue;
+                }
+
+                auto otherNode = limitedNodeList->nodeWithUUID(it.key());
+                if (otherNode) {
+                    nodesToSend.push_back(otherNode);
+                } else {
+                    removedNodes.push_back(it.key());
+                }
+            }
+        } else {
+            // if this authenticated node has any interest types, send back those nodes as well
+            limitedNodeList->eachNode([this, &node, &nodesToSend](const SharedNodePointer& otherNode) {
+                if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
+                    nodesToSend.push_back(otherNode);
+                }
+            });
+        }
+    }
+
     // setup the extended header for the domain list packets
     // this data is at the beginning of each of the domain list packets
     QByteArray extendedHeader(NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES, 0);
     QDataStream extendedHeaderStream(&extendedHeader, QIODevice::WriteOnly);
 
-    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
-
     extendedHeaderStream << limitedNodeList->getSessionUUID();
     extendedHeaderStream << limitedNodeList->getSessionLocalID();
     extendedHeaderStream << node->getUUID();
     extendedHeaderStream << node->getLocalID();
     extendedHeaderStream << node->getPermissions();
     extendedHeaderStream << limitedNodeList->getAuthenticatePackets();
+    extendedHeaderStream << (quint8)limitedNodeList->getAuthenticationMethod();
+
+    // the packets are unreliable, the node counts the entries to know when it has the whole list
+    extendedHeaderStream << _domainListVersion;
+    extendedHeaderStream << isDelta;
+    extendedHeaderStream << lastDomainListVersion;
+    extendedHeaderStream << (quint32)(nodesToSend.size() + removedNodes.size());
     auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
     // always send the node their own UUID back
     QDataStream domainListStream(domainListPackets.get());
 
-    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
-
-    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
-    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+    for (auto& otherNode : nodesToSend) {
+        // since we're about to add a node to the packet we start a segment
+        domainListPackets->startSegment();
 
-    if (nodeInterestSet.size() > 0) {
+        domainListStream << (quint8)DomainListEntry::Node;
 
-        // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
-        if (nodeData->isAuthenticated()) {
-            // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([this, node, &domainListPackets, &domainListStream](const SharedNodePointer& otherNode) {
-                if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
+        // don't send avatar nodes to other avatars, that will come from avatar mixer
+        domainListStream << *otherNode.data();
 
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
+        // pack the secret that these two nodes will use to communicate with each other
+        domainListStream << connectionSecretForNodes(node, otherNode);
 
-                    // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
+        // we've added the node we wanted so end the segment now
+        domainListPackets->endSegment();
+    }
 
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
-                }
-            });
-        }
+    for (auto& removedNodeUUID : removedNodes) {
+        domainListPackets->startSegment();
+        domainListStream << (quint8)DomainListEntry::Removed;
+        domainListStream << removedNodeUUID;
+        domainListPackets->endSegment();
     }
 
     // send an empty list to the node, in case there were no other nodes
@@ -1206,6 +1293,17 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
     limitedNodeList->sendPacketList(std::move(domainListPackets), *node);
 }
 
+void DomainServer::markDomainListChanged(const SharedNodePointer& node) {
+    // enough changes for a node to miss a few check-ins in a busy domain before it needs the full list again
+    static const size_t MAX_DOMAIN_LIST_CHANGES = 1024;
+
+    ++_domainListVersion;
+    _domainListChanges.push_back({ node->getUUID(), node->getType() });
+    if (_domainListChanges.size() > MAX_DOMAIN_LIST_CHANGES) {
+        _domainListChanges.pop_front();
+    }
+}
+
 QUuid DomainServer::connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
     DomainServerNodeData* nodeAData = static_cast<DomainServerNodeData*>(nodeA->getLinkedData());
     DomainServerNodeData* nodeBData = static_cast<DomainServerNodeData*>(nodeB->getLinkedData());
@@ -2999,7 +3097,10 @@ void DomainServer::updateReplicatedNodes() {
                 qDebug() << "Setting node to replicated:"
                     << otherNode->getPermissions().getVerifiedUserName() << otherNode->getUUID();
             }
-            otherNode->setIsReplicated(shouldReplicate);
+            if (isReplicated != shouldReplicate) {
+                otherNode->setIsReplicated(shouldReplicate);
+                markDomainListChanged(otherNode);
+            }
         }
     );
 }
@@ -3023,6 +3124,11 @@ bool DomainServer::isAssetServerEnabled() {
     return _settingsManager.valueOrDefaultValueForKeyPath(ASSET_SERVER_ENABLED_KEYPATH).toBool();
 }
 
+bool DomainServer::isPhysicsServerEnabled() {
+    static const QString PHYSICS_SERVER_ENABLED_KEYPATH = "physics_server.enabled";
+    return _settingsManager.valueOrDefaultValueForKeyPath(PHYSICS_SERVER_ENABLED_KEYPATH).toBool();
+}
+
 void DomainServer::nodeAdded(SharedNodePointer node) {
     // we don't use updateNodeWithData, so add the DomainServerNodeData to the node here
     node->setLinkedData(std::unique_ptr<DomainServerNodeData> { new DomainServerNodeData() });
@@ -3032,6 +3138,9 @@ void DomainServer::nodeKilled(SharedNodePointer node) {
     // if this peer connected via ICE then remove them from our ICE peers hash
     _gatekeeper.cleanupICEPeerForNode(node->getUUID());
 
+    // nodes that were sent this one are sent its removal with their next delta
+    markDomainListChanged(node);
+
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
 
     if (nodeData) {
@@ -12,6 +12,8 @@
 #ifndef hifi_DomainServer_h
 #define hifi_DomainServer_h
 
+#include <deque>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QHash>
 #include <QtCore/QJsonObject>
@@ -76,6 +78,7 @@ public:
     static const QString REPLACEMENT_FILE_EXTENSION;
 
     bool isAssetServerEnabled();
+    bool isPhysicsServerEnabled();
 
 public slots:
     /// Called by NodeList to inform us a node has been added
@@ -171,7 +174,10 @@ private:
     void handleKillNode(SharedNodePointer nodeToKill);
     void broadcastNodeDisconnect(const SharedNodePointer& disconnnectedNode);
 
-    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr);
+    // sends the node the changes since lastDomainListVersion, or the full list if it can't be sent those
+    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr,
+                              quint32 lastDomainListVersion = 0);
+    void markDomainListChanged(const SharedNodePointer& node);
 
     bool isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
 
@@ -266,6 +272,15 @@ private:
 
     DomainType _type { DomainType::NonMetaverse };
 
+    // The domain list goes up a version with every change to what other nodes are sent of a node. The nodes changed by
+    // the most recent versions are kept, so a node that has seen one of them only needs to be sent those that changed.
+    struct DomainListChange {
+        QUuid nodeUUID;
+        NodeType_t nodeType;
+    };
+    quint32 _domainListVersion { 1 };
+    std::deque<DomainListChange> _domainListChanges;
+
     friend class DomainGatekeeper;
     friend class DomainMetadata;
 
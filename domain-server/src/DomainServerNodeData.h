@@ -72,6 +72,17 @@ public:
 
     bool hasCheckedIn() const { return _hasCheckedIn; }
     void setHasCheckedIn(bool hasCheckedIn) { _hasCheckedIn = hasCheckedIn; }
+
+    // set until the node reports having the version of a full domain list it was sent - the lists are unreliable,
+    // so one that was lost or only partly arrived is sent again rather than deltas the node can't apply
+    bool needsFullDomainList() const { return _needsFullDomainList; }
+    void setNeedsFullDomainList() { _needsFullDomainList = true; _fullDomainListVersion = 0; }
+    void setFullDomainListSent(quint32 version) { _fullDomainListVersion = version; }
+    void setReportedDomainListVersion(quint32 version) {
+        if (_fullDomainListVersion != 0 && version >= _fullDomainListVersion) {
+            _needsFullDomainList = false;
+        }
+    }
     
 private:
     QJsonObject overrideValuesIfNeeded(const QJsonObject& newStats);
@@ -99,6 +110,9 @@ private:
     bool _wasAssigned { false };
 
     bool _hasCheckedIn { false };
+
+    bool _needsFullDomainList { true };
+    quint32 _fullDomainListVersion { 0 }; // of the last full list sent while _needsFullDomainList, 0 for none
 };
 
 #endif // hifi_DomainServerNodeData_h
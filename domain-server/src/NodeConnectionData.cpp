@@ -35,6 +35,9 @@ NodeConnectionData NodeConnectionData::fromDataStream(QDataStream& dataStream, c
 
         // now the machine fingerprint
         dataStream >> newHeader.machineFingerprint;
+
+        // and the packet authentication methods it supports
+        dataStream >> newHeader.supportedAuthMethods;
     }
     
     dataStream >> newHeader.nodeType
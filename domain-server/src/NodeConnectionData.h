@@ -30,6 +30,7 @@ public:
     QString placeName;
     QString hardwareAddress;
     QUuid machineFingerprint;
+    quint32 supportedAuthMethods { 0 }; // a bit for each HMACAuth::AuthMethod the node can verify packets with
 
     QByteArray protocolVersion;
 };
@@ -117,7 +117,7 @@ void InboundAudioStream::perSecondCallbackForUpdatingStats() {
     _unplayedMs.currentIntervalComplete();
 }
 
-int InboundAudioStream::parseData(ReceivedMessage& message) {
+int InboundAudioStream::parseData(ReceivedPacket& message) {
     // parse sequence number and track it
     quint16 sequence;
     message.readPrimitive(&sequence);
@@ -56,7 +56,7 @@ public:
     virtual void resetStats();
     void clearBuffer();
 
-    virtual int parseData(ReceivedMessage& packet) override;
+    virtual int parseData(ReceivedPacket& packet) override;
 
     int popFrames(int maxFrames, bool allOrNothing);
     int popSamples(int maxSamples, bool allOrNothing);
@@ -14,6 +14,7 @@
 #include <QUrl>
 
 #include <ResourceManager.h>
+#include <SharedUtil.h>
 
 QList<EntityItemID> EntityEditFilters::getZonesByPosition(glm::vec3& position) {
     QList<EntityItemID> zones;
@@ -42,7 +43,8 @@ QList<EntityItemID> EntityEditFilters::getZonesByPosition(glm::vec3& position) {
 }
 
 bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut,
-        bool& wasChanged, EntityTree::FilterType filterType, EntityItemID& itemID, EntityItemPointer& existingEntity) {
+        bool& wasChanged, EntityTree::FilterType filterType, EntityItemID& itemID, EntityItemPointer& existingEntity,
+        const QUuid& senderID) {
     
     // get the ids of all the zones (plus the global entity edit filter) that the position
     // lies within
@@ -72,97 +74,144 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
                 return true; // accept the message
             }
 
-            auto oldProperties = propertiesIn.getDesiredProperties();
-            auto specifiedProperties = propertiesIn.getChangedProperties();
-            propertiesIn.setDesiredProperties(specifiedProperties);
-            QScriptValue inputValues = propertiesIn.copyToScriptValue(filterData.engine, false, true, true);
-            propertiesIn.setDesiredProperties(oldProperties);
-
-            auto in = QJsonValue::fromVariant(inputValues.toVariant()); // grab json copy now, because the inputValues might be side effected by the filter.
-
-            QScriptValueList args;
-            args << inputValues;
-            args << filterType;
-
-            // get the current properties for then entity and include them for the filter call
-            if (existingEntity && filterData.wantsOriginalProperties) {
-                auto currentProperties = existingEntity->getProperties(filterData.includedOriginalProperties);
-                QScriptValue currentValues = currentProperties.copyToScriptValue(filterData.engine, false, true, true);
-                args << currentValues;
+            quint64 startFilter = usecTimestampNow();
+            bool accepted = filterData.nativeFilter ?
+                filterNatively(filterData, id, propertiesIn, propertiesOut, wasChanged, filterType, existingEntity, senderID) :
+                filterWithScript(filterData, id, propertiesIn, propertiesOut, wasChanged, filterType, existingEntity);
+            filterData.stats->totalTime += usecTimestampNow() - startFilter;
+            filterData.stats->evaluations++;
+            if (!accepted) {
+                filterData.stats->rejections++;
+                return false;
             }
+        }
+    }
+    // if we made it here, 
+    return true;
+}
+
+bool EntityEditFilters::filterNatively(const FilterData& filterData, const EntityItemID& zoneID, EntityItemProperties& propertiesIn,
+        EntityItemProperties& propertiesOut, bool& wasChanged, EntityTree::FilterType filterType,
+        EntityItemPointer& existingEntity, const QUuid& senderID) {
+    NativeEntityEditFilter::Edit edit;
+    edit.filterType = filterType;
+    edit.senderID = senderID;
+    edit.existingEntity = existingEntity;
+    if (filterData.nativeFilter->wantsZoneBoundingBox() && !zoneID.isInvalidID()) {
+        auto zoneEntity = _tree->findEntityByEntityItemID(zoneID);
+        if (zoneEntity) {
+            edit.zoneBoundingBox = zoneEntity->getAABox(edit.hasZoneBoundingBox);
+        }
+    }
+    return filterData.nativeFilter->filter(edit, propertiesIn, propertiesOut, wasChanged);
+}
 
+bool EntityEditFilters::filterWithScript(FilterData& filterData, const EntityItemID& zoneID, EntityItemProperties& propertiesIn,
+        EntityItemProperties& propertiesOut, bool& wasChanged, EntityTree::FilterType filterType,
+        EntityItemPointer& existingEntity) {
+    auto oldProperties = propertiesIn.getDesiredProperties();
+    auto specifiedProperties = propertiesIn.getChangedProperties();
+    propertiesIn.setDesiredProperties(specifiedProperties);
+    QScriptValue inputValues = propertiesIn.copyToScriptValue(filterData.engine, false, true, true);
+    propertiesIn.setDesiredProperties(oldProperties);
+
+    auto in = QJsonValue::fromVariant(inputValues.toVariant()); // grab json copy now, because the inputValues might be side effected by the filter.
+
+    QScriptValueList args;
+    args << inputValues;
+    args << filterType;
+
+    // get the current properties for then entity and include them for the filter call
+    if (existingEntity && filterData.wantsOriginalProperties) {
+        auto currentProperties = existingEntity->getProperties(filterData.includedOriginalProperties);
+        QScriptValue currentValues = currentProperties.copyToScriptValue(filterData.engine, false, true, true);
+        args << currentValues;
+    }
 
-            // get the zone properties
-            if (filterData.wantsZoneProperties) {
-                auto zoneEntity = _tree->findEntityByEntityItemID(id);
-                if (zoneEntity) {
-                    auto zoneProperties = zoneEntity->getProperties(filterData.includedZoneProperties);
-                    QScriptValue zoneValues = zoneProperties.copyToScriptValue(filterData.engine, false, true, true);
-
-                    if (filterData.wantsZoneBoundingBox) {
-                        bool success = true;
-                        AABox aaBox = zoneEntity->getAABox(success);
-                        if (success) {
-                            QScriptValue boundingBox = filterData.engine->newObject();
-                            QScriptValue bottomRightNear = vec3ToScriptValue(filterData.engine, aaBox.getCorner());
-                            QScriptValue topFarLeft = vec3ToScriptValue(filterData.engine, aaBox.calcTopFarLeft());
-                            QScriptValue center = vec3ToScriptValue(filterData.engine, aaBox.calcCenter());
-                            QScriptValue boundingBoxDimensions = vec3ToScriptValue(filterData.engine, aaBox.getDimensions());
-                            boundingBox.setProperty("brn", bottomRightNear);
-                            boundingBox.setProperty("tfl", topFarLeft);
-                            boundingBox.setProperty("center", center);
-                            boundingBox.setProperty("dimensions", boundingBoxDimensions);
-                            zoneValues.setProperty("boundingBox", boundingBox);
-                        }
-                    }
 
-                    // If this is an add or delete, or original properties weren't requested
-                    // there won't be original properties in the args, but zone properties need
-                    // to be the fourth parameter, so we need to pad the args accordingly
-                    int EXPECTED_ARGS = 3;
-                    if (args.length() < EXPECTED_ARGS) {
-                        args << QScriptValue();
-                    }
-                    assert(args.length() == EXPECTED_ARGS); // we MUST have 3 args by now!
-                    args << zoneValues;
+    // get the zone properties
+    if (filterData.wantsZoneProperties) {
+        auto zoneEntity = _tree->findEntityByEntityItemID(zoneID);
+        if (zoneEntity) {
+            auto zoneProperties = zoneEntity->getProperties(filterData.includedZoneProperties);
+            QScriptValue zoneValues = zoneProperties.copyToScriptValue(filterData.engine, false, true, true);
+
+            if (filterData.wantsZoneBoundingBox) {
+                bool success = true;
+                AABox aaBox = zoneEntity->getAABox(success);
+                if (success) {
+                    QScriptValue boundingBox = filterData.engine->newObject();
+                    QScriptValue bottomRightNear = vec3ToScriptValue(filterData.engine, aaBox.getCorner());
+                    QScriptValue topFarLeft = vec3ToScriptValue(filterData.engine, aaBox.calcTopFarLeft());
+                    QScriptValue center = vec3ToScriptValue(filterData.engine, aaBox.calcCenter());
+                    QScriptValue boundingBoxDimensions = vec3ToScriptValue(filterData.engine, aaBox.getDimensions());
+                    boundingBox.setProperty("brn", bottomRightNear);
+                    boundingBox.setProperty("tfl", topFarLeft);
+                    boundingBox.setProperty("center", center);
+                    boundingBox.setProperty("dimensions", boundingBoxDimensions);
+                    zoneValues.setProperty("boundingBox", boundingBox);
                 }
             }
 
-            QScriptValue result = filterData.filterFn.call(_nullObjectForFilter, args);
-
-            if (filterData.uncaughtExceptions()) {
-                return false;
+            // If this is an add or delete, or original properties weren't requested
+            // there won't be original properties in the args, but zone properties need
+            // to be the fourth parameter, so we need to pad the args accordingly
+            int EXPECTED_ARGS = 3;
+            if (args.length() < EXPECTED_ARGS) {
+                args << QScriptValue();
             }
+            assert(args.length() == EXPECTED_ARGS); // we MUST have 3 args by now!
+            args << zoneValues;
+        }
+    }
 
-            if (result.isObject()) {
-                // make propertiesIn reflect the changes, for next filter...
-                propertiesIn.copyFromScriptValue(result, false);
+    QScriptValue result = filterData.filterFn.call(_nullObjectForFilter, args);
 
-                // and update propertiesOut too.  TODO: this could be more efficient...
-                propertiesOut.copyFromScriptValue(result, false);
-                // Javascript objects are == only if they are the same object. To compare arbitrary values, we need to use JSON.
-                auto out = QJsonValue::fromVariant(result.toVariant());
-                wasChanged |= (in != out);
-            } else if (result.isBool()) {
+    if (filterData.uncaughtExceptions()) {
+        return false;
+    }
 
-                // if the filter returned false, then it's authoritative
-                if (!result.toBool()) {
-                    return false;
-                }
+    if (result.isObject()) {
+        // make propertiesIn reflect the changes, for next filter...
+        propertiesIn.copyFromScriptValue(result, false);
 
-                // otherwise, assume it wants to pass all properties
-                propertiesOut = propertiesIn;
-                wasChanged = false;
-                
-            } else {
-                return false;
-            }
+        // and update propertiesOut too.  TODO: this could be more efficient...
+        propertiesOut.copyFromScriptValue(result, false);
+        // Javascript objects are == only if they are the same object. To compare arbitrary values, we need to use JSON.
+        auto out = QJsonValue::fromVariant(result.toVariant());
+        wasChanged |= (in != out);
+    } else if (result.isBool()) {
+
+        // if the filter returned false, then it's authoritative
+        if (!result.toBool()) {
+            return false;
         }
+
+        // otherwise, assume it wants to pass all properties
+        propertiesOut = propertiesIn;
+        wasChanged = false;
+        
+    } else {
+        return false;
     }
-    // if we made it here, 
     return true;
 }
 
+QVector<EntityEditFilters::FilterStats> EntityEditFilters::getFilterStats() {
+    QVector<FilterStats> result;
+    QReadLocker readLock(&_lock);
+    for (auto it = _filterDataMap.constBegin(); it != _filterDataMap.constEnd(); ++it) {
+        FilterStats stats;
+        stats.entityID = it.key();
+        stats.isNative = (bool)it.value().nativeFilter;
+        stats.evaluations = it.value().stats->evaluations;
+        stats.rejections = it.value().stats->rejections;
+        stats.averageTime = stats.evaluations == 0 ? 0 : it.value().stats->totalTime / stats.evaluations;
+        result.push_back(stats);
+    }
+    return result;
+}
+
 void EntityEditFilters::removeFilter(EntityItemID entityID) {
     QWriteLocker writeLock(&_lock);
     FilterData filterData = _filterDataMap.value(entityID);
@@ -254,6 +303,30 @@ void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
         const QString urlString = scriptRequest->getUrl().toString();
         auto scriptContents = scriptRequest->getData();
         qInfo() << "Downloaded script:" << scriptContents;
+        if (NativeEntityEditFilter::isNativeFilter(scriptContents)) {
+            QString error;
+            auto nativeFilter = NativeEntityEditFilter::compile(scriptContents, error);
+            if (nativeFilter) {
+                FilterData filterData;
+                filterData.nativeFilter = nativeFilter;
+                filterData.wantsToFilterAdd = nativeFilter->wantsToFilterAdd();
+                filterData.wantsToFilterEdit = nativeFilter->wantsToFilterEdit();
+                filterData.wantsToFilterPhysics = nativeFilter->wantsToFilterPhysics();
+                filterData.wantsToFilterDelete = nativeFilter->wantsToFilterDelete();
+
+                _lock.lockForWrite();
+                _filterDataMap.insert(entityID, filterData);
+                _lock.unlock();
+
+                qDebug() << "native filter processed for entity id " << entityID;
+
+                emit filterAdded(entityID, true);
+                return;
+            }
+            qCritical() << "Invalid entity edit filter" << urlString << error;
+            emit filterAdded(entityID, false);
+            return;
+        }
         QScriptProgram program(scriptContents, urlString);
         if (hasCorrectSyntax(program)) {
             // create a QScriptEngine for this script
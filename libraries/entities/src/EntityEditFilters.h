@@ -17,11 +17,14 @@
 #include <QScriptEngine>
 #include <glm/glm.hpp>
 
+#include <atomic>
 #include <functional>
+#include <memory>
 
 #include "EntityItemID.h"
 #include "EntityItemProperties.h"
 #include "EntityTree.h"
+#include "NativeEntityEditFilter.h"
 
 class EntityEditFilters : public QObject, public Dependency {
     Q_OBJECT
@@ -43,9 +46,27 @@ public:
         std::function<bool()> uncaughtExceptions;
         QScriptEngine* engine;
         bool rejectAll;
+
+        // set instead of the engine for filters written in the native filter format
+        NativeEntityEditFilter::Pointer nativeFilter;
+
+        struct Stats {
+            std::atomic<quint64> evaluations { 0 };
+            std::atomic<quint64> rejections { 0 };
+            std::atomic<quint64> totalTime { 0 };
+        };
+        std::shared_ptr<Stats> stats { std::make_shared<Stats>() };
         
         FilterData(): engine(nullptr), rejectAll(false) {};
-        bool valid() { return (rejectAll || (engine != nullptr && filterFn.isFunction() && uncaughtExceptions)); }
+        bool valid() { return (rejectAll || nativeFilter || (engine != nullptr && filterFn.isFunction() && uncaughtExceptions)); }
+    };
+
+    struct FilterStats {
+        EntityItemID entityID;
+        bool isNative { false };
+        quint64 evaluations { 0 };
+        quint64 rejections { 0 };
+        quint64 averageTime { 0 }; // usecs
     };
 
     EntityEditFilters() {};
@@ -55,7 +76,10 @@ public:
     void removeFilter(EntityItemID entityID);
 
     bool filter(glm::vec3& position, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, 
-                EntityTree::FilterType filterType, EntityItemID& entityID, EntityItemPointer& existingEntity);
+                EntityTree::FilterType filterType, EntityItemID& entityID, EntityItemPointer& existingEntity,
+                const QUuid& senderID = QUuid());
+
+    QVector<FilterStats> getFilterStats();
 
 signals:
     void filterAdded(EntityItemID id, bool success);
@@ -65,6 +89,12 @@ private slots:
     
 private:
     QList<EntityItemID> getZonesByPosition(glm::vec3& position);
+    bool filterWithScript(FilterData& filterData, const EntityItemID& zoneID, EntityItemProperties& propertiesIn,
+                          EntityItemProperties& propertiesOut, bool& wasChanged, EntityTree::FilterType filterType,
+                          EntityItemPointer& existingEntity);
+    bool filterNatively(const FilterData& filterData, const EntityItemID& zoneID, EntityItemProperties& propertiesIn,
+                        EntityItemProperties& propertiesOut, bool& wasChanged, EntityTree::FilterType filterType,
+                        EntityItemPointer& existingEntity, const QUuid& senderID);
 
     EntityTreePointer _tree {};
     bool _rejectAll {false};
@@ -197,9 +197,37 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         requestedProperties = entityTreeElementExtraEncodeData->entities.value(getEntityItemID());
     }
 
+    // Every client that wants all of an unchanged entity is sent the same bytes, so they are only encoded for the
+    // first one. A partial entity is encoded as usual, as is anything not meant for a client.
+    bool useEncodeCache = params.nodeData &&
+        !(entityTreeElementExtraEncodeData && entityTreeElementExtraEncodeData->entities.contains(getEntityItemID()));
+    EncodeCache encodeCacheKey;
+    if (useEncodeCache) {
+        encodeCacheKey = getEncodeCacheKey(requestedProperties);
+
+        QByteArray encoded;
+        {
+            std::lock_guard<std::mutex> lock(_encodeCacheMutex);
+            if (_encodeCache.isSameVersion(encodeCacheKey)) {
+                encoded = _encodeCache.data;
+            }
+        }
+
+        if (!encoded.isEmpty() && encoded.size() <= packetData->getBytesAvailable()) {
+            LevelDetails entityLevel = packetData->startLevel();
+            if (packetData->appendRawData(encoded)) {
+                packetData->endLevel(entityLevel);
+                params.trackSend(getID(), encodeCacheKey.lastEdited);
+                return OctreeElement::COMPLETED;
+            }
+            packetData->discardLevel(entityLevel);
+        }
+    }
+
     EntityPropertyFlags propertiesDidntFit = requestedProperties;
 
     LevelDetails entityLevel = packetData->startLevel();
+    int startOfEntity = packetData->getUncompressedByteOffset();
 
     quint64 lastEdited = getLastEdited();
 
@@ -368,6 +396,15 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
             assert(newPropertyFlagsLength == oldPropertyFlagsLength); // should not have grown
         }
 
+        if (useEncodeCache && appendState == OctreeElement::COMPLETED) {
+            int endOfEntity = packetData->getUncompressedByteOffset();
+            encodeCacheKey.data = QByteArray((const char*)packetData->getUncompressedData(startOfEntity),
+                                             endOfEntity - startOfEntity);
+
+            std::lock_guard<std::mutex> lock(_encodeCacheMutex);
+            _encodeCache = encodeCacheKey;
+        }
+
         packetData->endLevel(entityLevel);
     } else {
         packetData->discardLevel(entityLevel);
@@ -388,6 +425,25 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     return appendState;
 }
 
+bool EntityItem::EncodeCache::isSameVersion(const EncodeCache& other) const {
+    return version == other.version && lastEdited == other.lastEdited && lastUpdated == other.lastUpdated &&
+        lastSimulated == other.lastSimulated && changedOnServer == other.changedOnServer && properties == other.properties;
+}
+
+EntityItem::EncodeCache EntityItem::getEncodeCacheKey(const EntityPropertyFlags& properties) const {
+    // the version is read first, a change made while the key is read then leaves it behind the entity
+    EncodeCache key;
+    key.version = _encodeCacheVersion;
+    withReadLock([&] {
+        key.lastEdited = _lastEdited;
+        key.lastUpdated = _lastUpdated;
+        key.lastSimulated = _lastSimulated;
+        key.changedOnServer = _changedOnServer;
+    });
+    key.properties = properties;
+    return key;
+}
+
 // TODO: My goal is to get rid of this concept completely. The old code (and some of the current code) used this
 // result to calculate if a packet being sent to it was potentially bad or corrupt. I've adjusted this to now
 // only consider the minimum header bytes as being required. But it would be preferable to completely eliminate
@@ -2727,6 +2783,11 @@ void EntityItem::markAsChangedOnServer() {
     withWriteLock([&] {
         _changedOnServer = usecTimestampNow();
     });
+
+    EntityTreeElementPointer element = getElement();
+    if (element && element->getTree()) {
+        element->getTree()->markJournalDirty(getEntityItemID());
+    }
 }
 
 quint64 EntityItem::getLastChangedOnServer() const {
@@ -3166,6 +3227,7 @@ void EntityItem::markDirtyFlags(uint32_t mask) {
         mask &= Simulation::DIRTY_FLAGS;
         _flags |= mask;
     });
+    invalidateEncodeCache();
 }
 
 void EntityItem::clearDirtyFlags(uint32_t mask) {
@@ -3220,6 +3282,13 @@ void EntityItem::deregisterChangeHandler(const ChangeHandlerId& changeHandlerId)
 }
 
 void EntityItem::somethingChangedNotification() {
+    invalidateEncodeCache();
+
+    EntityTreeElementPointer element = getElement();
+    if (element && element->getTree()) {
+        element->getTree()->bumpReadSnapshotEpoch();
+    }
+
     auto id = getEntityItemID();
     withReadLock([&] {
         for (const auto& handler : _changeHandlers.values()) {
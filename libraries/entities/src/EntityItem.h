@@ -12,7 +12,9 @@
 #ifndef hifi_EntityItem_h
 #define hifi_EntityItem_h
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <stdint.h>
 
 #include <glm/glm.hpp>
@@ -135,6 +137,9 @@ public:
     virtual OctreeElement::AppendState appendEntityData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                                         EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData) const;
 
+    /// Drops the encoding appendEntityData() keeps for clients, for changes that leave the entity's timestamps alone
+    void invalidateEncodeCache() { ++_encodeCacheVersion; }
+
     virtual void appendSubclassData(OctreePacketData* packetData, EncodeBitstreamParams& params,
                                     EntityTreeElementExtraEncodeDataPointer entityTreeElementExtraEncodeData,
                                     EntityPropertyFlags& requestedProperties,
@@ -593,6 +598,25 @@ protected:
     quint64 _created { 0 };
     quint64 _changedOnServer { 0 };
 
+    // The last complete encoding of the entity for a client, which is appended as is for every other client asking
+    // for the same properties, until a timestamp moves or the cache is invalidated.
+    struct EncodeCache {
+        quint64 lastEdited { 0 };
+        quint64 lastUpdated { 0 };
+        quint64 lastSimulated { 0 };
+        quint64 changedOnServer { 0 };
+        uint32_t version { 0 };
+        EntityPropertyFlags properties;
+        QByteArray data;
+
+        bool isSameVersion(const EncodeCache& other) const;
+    };
+    EncodeCache getEncodeCacheKey(const EntityPropertyFlags& properties) const;
+
+    mutable std::mutex _encodeCacheMutex;
+    mutable EncodeCache _encodeCache;
+    std::atomic<uint32_t> _encodeCacheVersion { 0 };
+
     mutable AABox _cachedAABox;
     mutable AACube _maxAACube;
     mutable AACube _minAACube;
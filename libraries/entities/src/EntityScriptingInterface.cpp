@@ -1139,9 +1139,7 @@ QVector<QUuid> EntityScriptingInterface::findEntities(const glm::vec3& center, f
     QVector<QUuid> result;
     if (_entityTree) {
         unsigned int searchFilter = PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES) | PickFilter::getBitMask(PickFilter::FlagBit::AVATAR_ENTITIES);
-        _entityTree->withReadLock([&] {
-            _entityTree->evalEntitiesInSphere(center, radius, PickFilter(searchFilter), result);
-        });
+        _entityTree->getReadSnapshot()->evalEntitiesInSphere(center, radius, PickFilter(searchFilter), result);
     }
     return result;
 }
@@ -1152,10 +1150,8 @@ QVector<QUuid> EntityScriptingInterface::findEntitiesInBox(const glm::vec3& corn
     QVector<QUuid> result;
     if (_entityTree) {
         unsigned int searchFilter = PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES) | PickFilter::getBitMask(PickFilter::FlagBit::AVATAR_ENTITIES);
-        _entityTree->withReadLock([&] {
-            AABox box(corner, dimensions);
-            _entityTree->evalEntitiesInBox(box, PickFilter(searchFilter), result);
-        });
+        AABox box(corner, dimensions);
+        _entityTree->getReadSnapshot()->evalEntitiesInBox(box, PickFilter(searchFilter), result);
     }
     return result;
 }
@@ -1191,9 +1187,7 @@ QVector<QUuid> EntityScriptingInterface::findEntitiesInFrustum(QVariantMap frust
 
         if (_entityTree) {
             unsigned int searchFilter = PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES) | PickFilter::getBitMask(PickFilter::FlagBit::AVATAR_ENTITIES);
-            _entityTree->withReadLock([&] {
-                _entityTree->evalEntitiesInFrustum(viewFrustum, PickFilter(searchFilter), result);
-            });
+            _entityTree->getReadSnapshot()->evalEntitiesInFrustum(viewFrustum, PickFilter(searchFilter), result);
         }
     }
 
@@ -1206,9 +1200,7 @@ QVector<QUuid> EntityScriptingInterface::findEntitiesByType(const QString entity
     QVector<QUuid> result;
     if (_entityTree) {
         unsigned int searchFilter = PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES) | PickFilter::getBitMask(PickFilter::FlagBit::AVATAR_ENTITIES);
-        _entityTree->withReadLock([&] {
-            _entityTree->evalEntitiesInSphereWithType(center, radius, type, PickFilter(searchFilter), result);
-        });
+        _entityTree->getReadSnapshot()->evalEntitiesInSphereWithType(center, radius, type, PickFilter(searchFilter), result);
     }
     return result;
 }
@@ -1216,10 +1208,8 @@ QVector<QUuid> EntityScriptingInterface::findEntitiesByType(const QString entity
 QVector<QUuid> EntityScriptingInterface::findEntitiesByName(const QString entityName, const glm::vec3& center, float radius, bool caseSensitiveSearch) const {
     QVector<QUuid> result;
     if (_entityTree) {
-        _entityTree->withReadLock([&] {
-            unsigned int searchFilter = PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES) | PickFilter::getBitMask(PickFilter::FlagBit::AVATAR_ENTITIES);
-            _entityTree->evalEntitiesInSphereWithName(center, radius, entityName, caseSensitiveSearch, PickFilter(searchFilter), result);
-        });
+        unsigned int searchFilter = PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES) | PickFilter::getBitMask(PickFilter::FlagBit::AVATAR_ENTITIES);
+        _entityTree->getReadSnapshot()->evalEntitiesInSphereWithName(center, radius, entityName, caseSensitiveSearch, PickFilter(searchFilter), result);
     }
     return result;
 }
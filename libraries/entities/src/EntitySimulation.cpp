@@ -138,6 +138,8 @@ void EntitySimulation::sortEntitiesThatMoved() {
             prepareEntityForDelete(entity);
         } else {
             moveOperator.addEntityToMoveList(entity, newCube);
+            // the motion has to reach the journal too, it isn't an edit
+            _entityTree->markJournalDirty(entity->getEntityItemID());
             ++itemItr;
         }
     }
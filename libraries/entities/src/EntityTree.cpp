@@ -10,6 +10,7 @@
 //
 
 #include "EntityTree.h"
+#include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
 #include <QtCore/QQueue>
 #include <openssl/err.h>
@@ -42,6 +43,8 @@
 
 static const quint64 DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER = USECS_PER_MSEC * 50;
 const float EntityTree::DEFAULT_MAX_TMP_ENTITY_LIFETIME = 60 * 60; // 1 hour
+const quint64 EntityTree::DEFAULT_READ_SNAPSHOT_TOLERANCE = 0;
+const quint64 EntityTree::FRAME_READ_SNAPSHOT_TOLERANCE = USECS_PER_MSEC * 16; // about a frame at 60Hz
 
 EntityTree::EntityTree(bool shouldReaverage) :
     Octree(shouldReaverage)
@@ -138,6 +141,7 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
     localMap.swap(_entityMap);
     this->withWriteLock([&] {
         foreach(EntityItemPointer entity, localMap) {
+            markJournalDirty(entity->getEntityItemID());
             EntityTreeElementPointer element = entity->getElement();
             if (element) {
                 element->cleanupEntities();
@@ -322,6 +326,8 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
     // find and hook up any entities with this entity as a (previously) missing parent
     fixupNeedsParentFixups();
 
+    markJournalDirty(entity->getEntityItemID());
+
     emit addingEntity(entity->getEntityItemID());
     emit addingEntityPointer(entity.get());
 }
@@ -381,6 +387,7 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
                 UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, queryCube);
                 recurseTreeWithOperator(&theOperator);
                 if (entity->setProperties(tempProperties)) {
+                    markJournalDirty(entity->getEntityItemID());
                     emit editingEntityPointer(entity);
                 }
                 _isDirty = true;
@@ -421,12 +428,14 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
                         // the sender is trying to steal ownership from another simulator
                         // so we apply the rules for ownership change:
                         // (1) higher priority wins
-                        // (2) equal priority wins if ownership filter has expired
+                        // (2) equal priority wins if ownership filter has expired, unless a physics-server owns it
                         // (3) VOLUNTEER priority is promoted to RECRUIT
                         uint8_t oldPriority = entity->getSimulationPriority();
                         uint8_t newPriority = properties.getSimulationOwner().getPriority();
+                        auto ownerNode = DependencyManager::get<NodeList>()->nodeWithUUID(entity->getSimulatorID());
+                        bool ownerKeepsTies = ownerNode && ownerNode->getType() == NodeType::PhysicsServer;
                         if (newPriority > oldPriority ||
-                             (newPriority == oldPriority && properties.getSimulationOwner().hasExpired())) {
+                             (newPriority == oldPriority && !ownerKeepsTies && properties.getSimulationOwner().hasExpired())) {
                             simulationBlocked = false;
                             if (properties.getSimulationOwner().getPriority() == VOLUNTEER_SIMULATION_PRIORITY) {
                                 properties.setSimulationPriority(RECRUIT_SIMULATION_PRIORITY);
@@ -478,6 +487,7 @@ bool EntityTree::updateEntity(EntityItemPointer entity, const EntityItemProperti
         UpdateEntityOperator theOperator(getThisPointer(), containingElement, entity, newQueryAACube);
         recurseTreeWithOperator(&theOperator);
         if (entity->setProperties(properties)) {
+            markJournalDirty(entity->getEntityItemID());
             emit editingEntityPointer(entity);
         }
 
@@ -761,6 +771,7 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
         }
 
         theEntity->die();
+        markJournalDirty(theEntity->getEntityItemID());
 
         if (getIsServer()) {
             {
@@ -1194,6 +1205,37 @@ void EntityTree::evalEntitiesInFrustum(const ViewFrustum& frustum, PickFilter se
     foundEntities.swap(args.entities);
 }
 
+EntityTreeSnapshot::Pointer EntityTree::getReadSnapshot() {
+    EntityTreeSnapshot::Pointer snapshot = std::atomic_load(&_readSnapshot);
+    if (snapshot && (snapshot->getEpoch() == _readSnapshotEpoch ||
+                     usecTimestampNow() - snapshot->getCaptureTime() < _readSnapshotTolerance)) {
+        // have update() publish the next changes ahead of our next query
+        _hasReadSnapshotReaders = true;
+        return snapshot;
+    }
+    return publishReadSnapshot();
+}
+
+EntityTreeSnapshot::Pointer EntityTree::publishReadSnapshot() {
+    // cleared before capturing, so a query against an older snapshot while we capture still counts
+    _hasReadSnapshotReaders = false;
+    EntityTreeSnapshot::Pointer snapshot;
+    withReadLock([&] {
+        // take the epoch before capturing, so anything that changes while we capture leaves the snapshot stale
+        uint64_t epoch = _readSnapshotEpoch;
+        snapshot = EntityTreeSnapshot::capture(*this, epoch);
+    });
+
+    // several readers may have captured at once, never replace a newer snapshot with an older one
+    EntityTreeSnapshot::Pointer current = std::atomic_load(&_readSnapshot);
+    while (!current || current->getEpoch() <= snapshot->getEpoch()) {
+        if (std::atomic_compare_exchange_weak(&_readSnapshot, &current, snapshot)) {
+            break;
+        }
+    }
+    return snapshot;
+}
+
 EntityItemPointer EntityTree::findEntityByID(const QUuid& id) const {
     EntityItemID entityID(id);
     return findEntityByEntityItemID(entityID);
@@ -1380,13 +1422,13 @@ void EntityTree::fixupTerseEditLogging(EntityItemProperties& properties, QList<Q
 }
 
 
-bool EntityTree::filterProperties(EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType) {
+bool EntityTree::filterProperties(EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType, const QUuid& senderID) {
     bool accepted = true;
     auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
     if (entityEditFilters) {
         auto position = existingEntity ? existingEntity->getWorldPosition() : propertiesIn.getPosition();
         auto entityID = existingEntity ? existingEntity->getEntityItemID() : EntityItemID();
-        accepted = entityEditFilters->filter(position, propertiesIn, propertiesOut, wasChanged, filterType, entityID, existingEntity);
+        accepted = entityEditFilters->filter(position, propertiesIn, propertiesOut, wasChanged, filterType, entityID, existingEntity, senderID);
     }
 
     return accepted;
@@ -1808,7 +1850,7 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                 bool wasChanged = false;
                 // Having (un)lock rights bypasses the filter, unless it's a physics result.
                 FilterType filterType = isPhysics ? FilterType::Physics : (isAdd ? FilterType::Add : FilterType::Edit);
-                bool allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType);
+                bool allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType, senderNode->getUUID());
                 if (!allowed) {
                     auto timestamp = properties.getLastEdited();
                     properties = EntityItemProperties();
@@ -2132,6 +2174,14 @@ void EntityTree::update(bool simulate) {
             }
         }
     });
+
+    // publish the frame's changes if anything queried since the last snapshot, so the next query doesn't wait on a capture
+    if (_hasReadSnapshotReaders) {
+        EntityTreeSnapshot::Pointer snapshot = std::atomic_load(&_readSnapshot);
+        if (!snapshot || snapshot->getEpoch() != _readSnapshotEpoch) {
+            publishReadSnapshot();
+        }
+    }
 }
 
 quint64 EntityTree::getAdjustedConsiderSince(quint64 sinceTime) {
@@ -2202,7 +2252,7 @@ bool EntityTree::shouldEraseEntity(EntityItemID entityID, const SharedNodePointe
     EntityItemProperties dummyProperties;
     bool wasChanged = false;
 
-    bool allowed = (sourceNode->isAllowedEditor()) || filterProperties(existingEntity, dummyProperties, dummyProperties, wasChanged, filterType);
+    bool allowed = (sourceNode->isAllowedEditor()) || filterProperties(existingEntity, dummyProperties, dummyProperties, wasChanged, filterType, sourceNode->getUUID());
     auto endFilter = usecTimestampNow();
 
     _totalFilterTime += endFilter - startFilter;
@@ -2930,6 +2980,216 @@ bool EntityTree::writeToJSON(QString& jsonString, const OctreeElementPointer& el
     return true;
 }
 
+// journal records are encoded a batch of entities at a time under the tree's read lock, so a large tree doesn't hold
+// up edits for the length of a snapshot
+static const int JOURNAL_ENCODE_BATCH_SIZE = 256;
+
+// big enough for every property but the rare huge one, which spills into a second chunk
+static const int JOURNAL_ENCODE_BUFFER_SIZE = 64 * 1024;
+
+void EntityTree::setJournaling(bool isJournaling) {
+    _isJournaling = isJournaling;
+    if (!isJournaling) {
+        std::lock_guard<std::mutex> lock(_journalDirtyIDsLock);
+        _journalDirtyIDs.clear();
+    }
+}
+
+void EntityTree::markJournalDirty(const EntityItemID& entityID) {
+    if (_isJournaling) {
+        std::lock_guard<std::mutex> lock(_journalDirtyIDsLock);
+        _journalDirtyIDs.insert(entityID);
+    }
+}
+
+QByteArray EntityTree::encodeJournalRecord(const EntityItemPointer& entity) {
+    EntityItemProperties properties = entity->getProperties();
+    properties.markAllChanged();
+
+    // the record is the creation time (which the edit encoding leaves out) followed by the edit packets that
+    // together carry every property of the entity
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << (quint64)entity->getCreated();
+
+    EntityPropertyFlags requestedProperties = properties.getChangedProperties();
+    EntityPropertyFlags didntFitProperties;
+    OctreeElement::AppendState encodeResult = OctreeElement::PARTIAL;
+    while (encodeResult == OctreeElement::PARTIAL) {
+        QByteArray buffer(JOURNAL_ENCODE_BUFFER_SIZE, 0);
+        encodeResult = EntityItemProperties::encodeEntityEditPacket(PacketType::EntityAdd, entity->getEntityItemID(),
+                                                                    properties, buffer, requestedProperties,
+                                                                    didntFitProperties);
+        if (encodeResult == OctreeElement::NONE) {
+            qCWarning(entities) << "Some properties of" << entity->getEntityItemID() << "are too large to journal";
+            break;
+        }
+        stream << buffer;
+        requestedProperties = didntFitProperties;
+    }
+
+    return data;
+}
+
+bool EntityTree::decodeJournalRecord(const QByteArray& data, EntityItemProperties& properties) {
+    QDataStream stream(data);
+    quint64 created;
+    stream >> created;
+
+    bool isFirstChunk = true;
+    while (!stream.atEnd()) {
+        QByteArray buffer;
+        stream >> buffer;
+        if (stream.status() != QDataStream::Ok) {
+            return false;
+        }
+
+        int processedBytes = 0;
+        EntityItemID entityID;
+        EntityItemProperties chunkProperties;
+        if (!EntityItemProperties::decodeEntityEditPacket(reinterpret_cast<const unsigned char*>(buffer.constData()),
+                                                          buffer.size(), processedBytes, entityID, chunkProperties)) {
+            return false;
+        }
+
+        if (isFirstChunk) {
+            properties = chunkProperties;
+            isFirstChunk = false;
+        } else {
+            properties.merge(chunkProperties);
+        }
+    }
+
+    properties.setCreated(created);
+    return !isFirstChunk;
+}
+
+void EntityTree::takeJournalRecords(OctreeJournal::Records& records) {
+    QVector<EntityItemID> dirtyIDs;
+    {
+        std::lock_guard<std::mutex> lock(_journalDirtyIDsLock);
+        dirtyIDs.reserve(_journalDirtyIDs.size());
+        for (const auto& entityID : _journalDirtyIDs) {
+            dirtyIDs.push_back(entityID);
+        }
+        _journalDirtyIDs.clear();
+    }
+
+    records.reserve(records.size() + dirtyIDs.size());
+    for (int begin = 0; begin < dirtyIDs.size(); begin += JOURNAL_ENCODE_BATCH_SIZE) {
+        int end = std::min(begin + JOURNAL_ENCODE_BATCH_SIZE, dirtyIDs.size());
+        withReadLock([&] {
+            for (int i = begin; i < end; ++i) {
+                EntityItemPointer entity = findEntityByEntityItemID(dirtyIDs[i]);
+
+                // anything we can't find anymore has been deleted, or erased along with the rest of the tree
+                if (entity && !entity->isDead()) {
+                    records.push_back({ OctreeJournal::RecordType::Upsert, dirtyIDs[i], encodeJournalRecord(entity) });
+                } else {
+                    records.push_back({ OctreeJournal::RecordType::Delete, dirtyIDs[i], QByteArray() });
+                }
+            }
+        });
+    }
+}
+
+QByteArray EntityTree::getJournalTreeData() const {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << (quint32)_namedPaths.size();
+    for (const auto& namedPath : _namedPaths) {
+        stream << namedPath.first << namedPath.second;
+    }
+    return data;
+}
+
+bool EntityTree::writeJournalSnapshot(const std::function<bool(const OctreeJournal::Record&)>& writeRecord) {
+    QVector<EntityItemPointer> entities;
+    {
+        QReadLocker locker(&_entityMapLock);
+        entities.reserve(_entityMap.size());
+        foreach (EntityItemPointer entity, _entityMap) {
+            entities.push_back(entity);
+        }
+    }
+
+    OctreeJournal::Records batch;
+    for (int begin = 0; begin < entities.size(); begin += JOURNAL_ENCODE_BATCH_SIZE) {
+        int end = std::min(begin + JOURNAL_ENCODE_BATCH_SIZE, entities.size());
+
+        batch.clear();
+        withReadLock([&] {
+            for (int i = begin; i < end; ++i) {
+                const EntityItemPointer& entity = entities[i];
+
+                // same as the JSON persist, entities that lost their parent aren't kept
+                if (entity->isDead() || !entity->isParentIDValid()) {
+                    continue;
+                }
+                batch.push_back({ OctreeJournal::RecordType::Upsert, entity->getEntityItemID(), encodeJournalRecord(entity) });
+            }
+        });
+
+        // the file writes happen outside of the lock
+        for (const auto& record : batch) {
+            if (!writeRecord(record)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool EntityTree::readFromJournal(const OctreeJournal::Contents& contents) {
+    _persistID = contents.id;
+    _persistDataVersion = contents.dataVersion;
+
+    _namedPaths.clear();
+    QDataStream stream(contents.treeData);
+    quint32 numNamedPaths = 0;
+    stream >> numNamedPaths;
+    for (quint32 i = 0; i < numNamedPaths && stream.status() == QDataStream::Ok; ++i) {
+        QString namedPathName;
+        QString namedPathViewPoint;
+        stream >> namedPathName >> namedPathViewPoint;
+        _namedPaths[namedPathName] = namedPathViewPoint;
+    }
+
+    QMap<QUuid, QVector<QUuid>> cloneIDs;
+
+    bool success = true;
+    for (const auto& record : contents.records) {
+        EntityItemProperties properties;
+        if (!decodeJournalRecord(record.data, properties)) {
+            qCDebug(entities) << "couldn't decode journaled Entity:" << record.id;
+            success = false;
+            continue;
+        }
+
+        EntityItemPointer entity = addEntity(record.id, properties);
+        if (!entity) {
+            qCDebug(entities) << "adding Entity failed:" << record.id << properties.getType();
+            success = false;
+            continue;
+        }
+
+        const QUuid& cloneOriginID = entity->getCloneOriginID();
+        if (!cloneOriginID.isNull()) {
+            cloneIDs[cloneOriginID].push_back(entity->getEntityItemID());
+        }
+    }
+
+    for (const auto& entityID : cloneIDs.keys()) {
+        auto entity = findEntityByID(entityID);
+        if (entity) {
+            entity->setCloneIDs(cloneIDs.value(entityID));
+        }
+    }
+
+    return success;
+}
+
 void EntityTree::resetClientEditStats() {
     _treeResetTime = usecTimestampNow();
     _maxEditDelta = 0;
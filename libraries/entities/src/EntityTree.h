@@ -12,6 +12,9 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <atomic>
+#include <mutex>
+
 #include <QSet>
 #include <QVector>
 
@@ -21,6 +24,7 @@
 #include "AddEntityOperator.h"
 #include "EntityTreeElement.h"
 #include "DeleteEntityOperator.h"
+#include "EntityTreeSnapshot.h"
 #include "MovingEntitiesOperator.h"
 
 class EntityTree;
@@ -141,6 +145,19 @@ public:
     void evalEntitiesInBox(const AABox& box, PickFilter searchFilter, QVector<QUuid>& foundEntities);
     void evalEntitiesInFrustum(const ViewFrustum& frustum, PickFilter searchFilter, QVector<QUuid>& foundEntities);
 
+    // Read snapshots - an immutable view of the tree the evalEntitiesIn* queries can run against without the tree lock.
+    // Anything that changes the entities or their layout bumps the epoch, and getReadSnapshot() only hands out a
+    // snapshot older than the current epoch if it was captured less than the read snapshot tolerance ago. The default
+    // tolerance is 0, so a caller always sees its own edits. Every capture copies the whole tree under the read lock,
+    // readers that can live with results up to a frame old may opt into FRAME_READ_SNAPSHOT_TOLERANCE to keep a busy
+    // edit stream from making each query capture. update() publishes the frame's changes when something has queried
+    // since the last snapshot.
+    EntityTreeSnapshot::Pointer getReadSnapshot();
+    void bumpReadSnapshotEpoch() { _readSnapshotEpoch++; }
+    uint64_t getReadSnapshotEpoch() const { return _readSnapshotEpoch; }
+    void setReadSnapshotTolerance(quint64 usecs) { _readSnapshotTolerance = usecs; }
+    quint64 getReadSnapshotTolerance() const { return _readSnapshotTolerance; }
+
     void addNewlyCreatedHook(NewlyCreatedEntityHook* hook);
     void removeNewlyCreatedHook(NewlyCreatedEntityHook* hook);
 
@@ -198,6 +215,15 @@ public:
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) override;
     virtual bool readFromMap(QVariantMap& entityDescription) override;
+
+    virtual bool supportsJournaling() const override { return true; }
+    virtual void setJournaling(bool isJournaling) override;
+    virtual void takeJournalRecords(OctreeJournal::Records& records) override;
+    virtual QByteArray getJournalTreeData() const override;
+    virtual bool writeJournalSnapshot(const std::function<bool(const OctreeJournal::Record&)>& writeRecord) override;
+    virtual bool readFromJournal(const OctreeJournal::Contents& contents) override;
+    // for changes made outside of edits, like the server-side simulation moving or stopping an entity
+    void markJournalDirty(const EntityItemID& entityID);
     virtual bool writeToJSON(QString& jsonString, const OctreeElementPointer& element) override;
 
 
@@ -251,6 +277,8 @@ public:
     void notifyNewCollisionSoundURL(const QString& newCollisionSoundURL, const EntityItemID& entityID);
 
     static const float DEFAULT_MAX_TMP_ENTITY_LIFETIME;
+    static const quint64 DEFAULT_READ_SNAPSHOT_TOLERANCE;
+    static const quint64 FRAME_READ_SNAPSHOT_TOLERANCE;
 
     QByteArray computeNonce(const QString& certID, const QString ownerKey);
     bool verifyNonce(const QString& certID, const QString& nonce, EntityItemID& id);
@@ -364,7 +392,7 @@ protected:
 
     float _maxTmpEntityLifetime { DEFAULT_MAX_TMP_ENTITY_LIFETIME };
 
-    bool filterProperties(EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType);
+    bool filterProperties(EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType, const QUuid& senderID);
     bool _hasEntityEditFilter{ false };
     QStringList _entityScriptSourceWhitelist;
 
@@ -390,8 +418,24 @@ private:
 
     std::map<QString, QString> _namedPaths;
 
+    // journaled persistence - the ids of the entities added, edited or deleted since the journal was last written
+    static QByteArray encodeJournalRecord(const EntityItemPointer& entity);
+    static bool decodeJournalRecord(const QByteArray& data, EntityItemProperties& properties);
+
+    std::atomic<bool> _isJournaling { false };
+    std::mutex _journalDirtyIDsLock;
+    QSet<EntityItemID> _journalDirtyIDs;
+
     void updateEntityQueryAACubeWorker(SpatiallyNestablePointer object, EntityEditPacketSender* packetSender,
                                        MovingEntitiesOperator& moveOperator, bool force, bool tellServer);
+
+    // read snapshots, _readSnapshot is only accessed through std::atomic_load/std::atomic_store
+    EntityTreeSnapshot::Pointer publishReadSnapshot();
+
+    EntityTreeSnapshot::Pointer _readSnapshot;
+    std::atomic<uint64_t> _readSnapshotEpoch { 1 };
+    std::atomic<quint64> _readSnapshotTolerance { DEFAULT_READ_SNAPSHOT_TOLERANCE };
+    std::atomic<bool> _hasReadSnapshotReaders { false };
 };
 
 void convertGrabUserDataToProperties(EntityItemProperties& properties);
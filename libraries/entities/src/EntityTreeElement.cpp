@@ -712,6 +712,9 @@ void EntityTreeElement::cleanupDomainAndNonOwnedEntities() {
         _entityItems = savedEntities;
     });
     bumpChangedContent();
+    if (_myTree) {
+        _myTree->bumpReadSnapshotEpoch();
+    }
 }
 
 void EntityTreeElement::cleanupEntities() {
@@ -727,6 +730,9 @@ void EntityTreeElement::cleanupEntities() {
         _entityItems.clear();
     });
     bumpChangedContent();
+    if (_myTree) {
+        _myTree->bumpReadSnapshotEpoch();
+    }
 }
 
 bool EntityTreeElement::removeEntityItem(EntityItemPointer entity, bool deletion) {
@@ -742,6 +748,9 @@ bool EntityTreeElement::removeEntityItem(EntityItemPointer entity, bool deletion
         assert(entity->_element.get() == this);
         entity->_element = NULL;
         bumpChangedContent();
+        if (_myTree) {
+            _myTree->bumpReadSnapshotEpoch();
+        }
         return true;
     }
     return false;
@@ -761,6 +770,9 @@ void EntityTreeElement::addEntityItem(EntityItemPointer entity) {
     });
     bumpChangedContent();
     entity->_element = getThisPointer();
+    if (_myTree) {
+        _myTree->bumpReadSnapshotEpoch();
+    }
 }
 
 // will average a "common reduced LOD view" from the the child elements...
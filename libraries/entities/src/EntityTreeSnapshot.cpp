@@ -0,0 +1,218 @@
+//
+//  EntityTreeSnapshot.cpp
+//  libraries/entities/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTreeSnapshot.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <GeometryUtil.h>
+#include <SharedUtil.h>
+
+#include "EntityTree.h"
+#include "EntityTreeElement.h"
+
+EntityTreeSnapshot::EntityTreeSnapshot(uint64_t epoch) :
+    _epoch(epoch),
+    _captureTime(usecTimestampNow())
+{
+}
+
+EntityTreeSnapshot::Pointer EntityTreeSnapshot::capture(EntityTree& tree, uint64_t epoch) {
+    std::shared_ptr<EntityTreeSnapshot> snapshot(new EntityTreeSnapshot(epoch));
+    snapshot->captureElement(tree.getRoot());
+    return snapshot;
+}
+
+int32_t EntityTreeSnapshot::captureElement(const EntityTreeElementPointer& element) {
+    int32_t nodeIndex = (int32_t)_nodes.size();
+    _nodes.emplace_back();
+
+    Node node;
+    node.cube = element->getAACube();
+    node.firstEntity = (uint32_t)_entities.size();
+    element->forEachEntity([&](const EntityItemPointer& entityItem) {
+        Entity entity;
+        entity.id = entityItem->getID();
+        entity.name = entityItem->getName();
+        entity.type = entityItem->getType();
+        entity.hostType = entityItem->getEntityHostType();
+        entity.visible = entityItem->isVisible();
+        entity.collidable = !entityItem->getCollisionless() && (entityItem->getShapeType() != SHAPE_TYPE_NONE);
+        entity.aaBox = entityItem->getAABox(entity.hasAABox);
+
+        glm::vec3 dimensions = entityItem->getRaycastDimensions();
+        entity.isSphere = entityItem->getShapeType() == SHAPE_TYPE_SPHERE &&
+            (dimensions.x == dimensions.y && dimensions.y == dimensions.z);
+        if (entity.isSphere) {
+            // same as EntityTreeElement::evalEntitiesInSphere, the true radius rather than the bounding radius
+            entity.trueRadius = dimensions.x / 2.0f;
+            entity.center = entityItem->getCenterPosition(entity.hasCenter);
+        } else {
+            entity.hasCenter = false;
+            glm::mat4 rotation = glm::mat4_cast(entityItem->getWorldOrientation());
+            glm::mat4 translation = glm::translate(entityItem->getWorldPosition());
+            entity.worldToEntityMatrix = glm::inverse(translation * rotation);
+            glm::vec3 corner = -(dimensions * entityItem->getRegistrationPoint());
+            entity.entityFrameBox = AABox(corner, dimensions);
+        }
+        _entities.push_back(entity);
+    });
+    node.numEntities = (uint32_t)_entities.size() - node.firstEntity;
+
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        EntityTreeElementPointer child = element->getChildAtIndex(i);
+        node.children[i] = child ? captureElement(child) : NO_CHILD;
+    }
+
+    // _nodes may have grown while capturing the children, so only write the node back at the end
+    _nodes[nodeIndex] = node;
+    return nodeIndex;
+}
+
+bool EntityTreeSnapshot::checkFilterSettings(const Entity& entity, PickFilter searchFilter) {
+    // keep this logic the same as in EntityTreeElement::checkFilterSettings
+    if ((!searchFilter.doesPickVisible() && entity.visible) || (!searchFilter.doesPickInvisible() && !entity.visible) ||
+        (!searchFilter.doesPickDomainEntities() && entity.hostType == entity::HostType::DOMAIN) ||
+        (!searchFilter.doesPickAvatarEntities() && entity.hostType == entity::HostType::AVATAR) ||
+        (!searchFilter.doesPickLocalEntities() && entity.hostType == entity::HostType::LOCAL)) {
+        return false;
+    }
+    if (entity.hostType != entity::HostType::LOCAL) {
+        if ((entity.collidable && !searchFilter.doesPickCollidable()) || (!entity.collidable && !searchFilter.doesPickNonCollidable())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool EntityTreeSnapshot::sphereTouches(const Entity& entity, const glm::vec3& center, float radius) {
+    // if the sphere doesn't intersect with our world frame AABox, we don't need to consider the more complex case
+    glm::vec3 penetration;
+    if (!entity.hasAABox || !entity.aaBox.findSpherePenetration(center, radius, penetration)) {
+        return false;
+    }
+    if (entity.isSphere) {
+        return findSphereSpherePenetration(center, radius, entity.center, entity.trueRadius, penetration) && entity.hasCenter;
+    }
+    glm::vec3 entityFrameSearchPosition = glm::vec3(entity.worldToEntityMatrix * glm::vec4(center, 1.0f));
+    return entity.entityFrameBox.findSpherePenetration(entityFrameSearchPosition, radius, penetration);
+}
+
+template <typename N, typename E>
+void EntityTreeSnapshot::recurse(int32_t nodeIndex, N&& nodeTest, E&& entityOperation) const {
+    const Node& node = _nodes[nodeIndex];
+    if (!nodeTest(node.cube)) {
+        // if this element doesn't touch the query, then none of its children can
+        return;
+    }
+    for (uint32_t i = node.firstEntity; i < node.firstEntity + node.numEntities; i++) {
+        entityOperation(_entities[i]);
+    }
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        if (node.children[i] != NO_CHILD) {
+            recurse(node.children[i], nodeTest, entityOperation);
+        }
+    }
+}
+
+void EntityTreeSnapshot::evalEntitiesInSphere(const glm::vec3& center, float radius, PickFilter searchFilter,
+                                              QVector<QUuid>& foundEntities) const {
+    foundEntities.clear();
+    if (_nodes.empty()) {
+        return;
+    }
+    recurse(0, [&](const AACube& cube) {
+        glm::vec3 penetration;
+        return cube.findSpherePenetration(center, radius, penetration);
+    }, [&](const Entity& entity) {
+        if (checkFilterSettings(entity, searchFilter) && sphereTouches(entity, center, radius)) {
+            foundEntities.push_back(entity.id);
+        }
+    });
+}
+
+void EntityTreeSnapshot::evalEntitiesInSphereWithType(const glm::vec3& center, float radius, EntityTypes::EntityType type,
+                                                      PickFilter searchFilter, QVector<QUuid>& foundEntities) const {
+    foundEntities.clear();
+    if (_nodes.empty()) {
+        return;
+    }
+    recurse(0, [&](const AACube& cube) {
+        glm::vec3 penetration;
+        return cube.findSpherePenetration(center, radius, penetration);
+    }, [&](const Entity& entity) {
+        if (entity.type == type && checkFilterSettings(entity, searchFilter) && sphereTouches(entity, center, radius)) {
+            foundEntities.push_back(entity.id);
+        }
+    });
+}
+
+void EntityTreeSnapshot::evalEntitiesInSphereWithName(const glm::vec3& center, float radius, const QString& name, bool caseSensitive,
+                                                      PickFilter searchFilter, QVector<QUuid>& foundEntities) const {
+    foundEntities.clear();
+    if (_nodes.empty()) {
+        return;
+    }
+    Qt::CaseSensitivity sensitivity = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    recurse(0, [&](const AACube& cube) {
+        glm::vec3 penetration;
+        return cube.findSpherePenetration(center, radius, penetration);
+    }, [&](const Entity& entity) {
+        if (checkFilterSettings(entity, searchFilter) && entity.name.compare(name, sensitivity) == 0 &&
+            sphereTouches(entity, center, radius)) {
+            foundEntities.push_back(entity.id);
+        }
+    });
+}
+
+void EntityTreeSnapshot::evalEntitiesInCube(const AACube& cube, PickFilter searchFilter, QVector<QUuid>& foundEntities) const {
+    foundEntities.clear();
+    if (_nodes.empty()) {
+        return;
+    }
+    recurse(0, [&](const AACube& nodeCube) {
+        return nodeCube.touches(cube);
+    }, [&](const Entity& entity) {
+        // If the entities AABox touches the search cube then consider it to be found
+        if (checkFilterSettings(entity, searchFilter) && entity.hasAABox && entity.aaBox.touches(cube)) {
+            foundEntities.push_back(entity.id);
+        }
+    });
+}
+
+void EntityTreeSnapshot::evalEntitiesInBox(const AABox& box, PickFilter searchFilter, QVector<QUuid>& foundEntities) const {
+    foundEntities.clear();
+    if (_nodes.empty()) {
+        return;
+    }
+    recurse(0, [&](const AACube& nodeCube) {
+        return nodeCube.touches(box);
+    }, [&](const Entity& entity) {
+        if (checkFilterSettings(entity, searchFilter) && entity.hasAABox && entity.aaBox.touches(box)) {
+            foundEntities.push_back(entity.id);
+        }
+    });
+}
+
+void EntityTreeSnapshot::evalEntitiesInFrustum(const ViewFrustum& frustum, PickFilter searchFilter, QVector<QUuid>& foundEntities) const {
+    foundEntities.clear();
+    if (_nodes.empty()) {
+        return;
+    }
+    recurse(0, [&](const AACube& nodeCube) {
+        return frustum.calculateCubeKeyholeIntersection(nodeCube) != ViewFrustum::OUTSIDE;
+    }, [&](const Entity& entity) {
+        if (checkFilterSettings(entity, searchFilter) && entity.hasAABox &&
+            (frustum.boxIntersectsFrustum(entity.aaBox) || frustum.boxIntersectsKeyhole(entity.aaBox))) {
+            foundEntities.push_back(entity.id);
+        }
+    });
+}
@@ -0,0 +1,99 @@
+//
+//  EntityTreeSnapshot.h
+//  libraries/entities/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeSnapshot_h
+#define hifi_EntityTreeSnapshot_h
+
+#include <memory>
+#include <vector>
+
+#include <QVector>
+
+#include <AABox.h>
+#include <AACube.h>
+#include <PickFilter.h>
+#include <ViewFrustum.h>
+
+#include "EntityItem.h"
+
+class EntityTree;
+
+// An immutable copy of the spatial layout of an EntityTree, and of the entity state the spatial queries look at,
+// taken at one epoch of the tree.  Once captured it is never modified, so any number of threads can query it
+// without the tree lock while the tree goes on being edited; the tree publishes a new snapshot when its epoch moves.
+//
+// The queries give the same results the matching EntityTree::evalEntitiesIn* calls would have given at capture time.
+class EntityTreeSnapshot {
+public:
+    using Pointer = std::shared_ptr<const EntityTreeSnapshot>;
+
+    // NOTE: assumes caller has handled locking
+    static Pointer capture(EntityTree& tree, uint64_t epoch);
+
+    uint64_t getEpoch() const { return _epoch; }
+    quint64 getCaptureTime() const { return _captureTime; }
+    size_t getEntityCount() const { return _entities.size(); }
+
+    void evalEntitiesInSphere(const glm::vec3& center, float radius, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+    void evalEntitiesInSphereWithType(const glm::vec3& center, float radius, EntityTypes::EntityType type, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+    void evalEntitiesInSphereWithName(const glm::vec3& center, float radius, const QString& name, bool caseSensitive, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+    void evalEntitiesInCube(const AACube& cube, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+    void evalEntitiesInBox(const AABox& box, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+    void evalEntitiesInFrustum(const ViewFrustum& frustum, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+
+private:
+    static const int32_t NO_CHILD { -1 };
+
+    // one octree element, its entities are _entities[firstEntity, firstEntity + numEntities)
+    struct Node {
+        AACube cube;
+        uint32_t firstEntity;
+        uint32_t numEntities;
+        int32_t children[NUMBER_OF_CHILDREN];
+    };
+
+    struct Entity {
+        QUuid id;
+        QString name;
+        EntityTypes::EntityType type;
+        entity::HostType hostType;
+        bool visible;
+        bool collidable;
+        bool hasAABox;
+        AABox aaBox;
+
+        // for the exact sphere tests
+        bool isSphere;
+        bool hasCenter;
+        glm::vec3 center;
+        float trueRadius;
+        glm::mat4 worldToEntityMatrix;
+        AABox entityFrameBox;
+    };
+
+    EntityTreeSnapshot(uint64_t epoch);
+
+    int32_t captureElement(const EntityTreeElementPointer& element);
+
+    static bool checkFilterSettings(const Entity& entity, PickFilter searchFilter);
+    static bool sphereTouches(const Entity& entity, const glm::vec3& center, float radius);
+
+    // visits the entities of every node the nodeTest accepts, descending only into accepted nodes
+    template <typename N, typename E>
+    void recurse(int32_t nodeIndex, N&& nodeTest, E&& entityOperation) const;
+
+    const uint64_t _epoch;
+    const quint64 _captureTime;
+    std::vector<Node> _nodes;
+    std::vector<Entity> _entities;
+};
+
+#endif // hifi_EntityTreeSnapshot_h
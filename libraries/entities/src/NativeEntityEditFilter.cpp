@@ -0,0 +1,427 @@
+//
+//  NativeEntityEditFilter.cpp
+//  libraries/entities/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NativeEntityEditFilter.h"
+
+#include <cfloat>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+// senders that haven't edited for this long lose their rate bucket, which is full again by then anyway
+static const quint64 RATE_BUCKET_EXPIRY = 60 * USECS_PER_SECOND;
+static const int RATE_BUCKET_PRUNE_SIZE = 1024;
+
+static bool vec3FromJson(const QJsonValue& value, glm::vec3& result) {
+    if (value.isArray()) {
+        QJsonArray array = value.toArray();
+        if (array.size() != 3 || !array[0].isDouble() || !array[1].isDouble() || !array[2].isDouble()) {
+            return false;
+        }
+        result = glm::vec3(array[0].toDouble(), array[1].toDouble(), array[2].toDouble());
+        return true;
+    }
+    if (value.isObject()) {
+        QJsonObject object = value.toObject();
+        if (object.size() != 3 || !object["x"].isDouble() || !object["y"].isDouble() || !object["z"].isDouble()) {
+            return false;
+        }
+        result = glm::vec3(object["x"].toDouble(), object["y"].toDouble(), object["z"].toDouble());
+        return true;
+    }
+    return false;
+}
+
+static bool propertyFlagsFromJson(const QJsonValue& value, EntityPropertyFlags& flags, QString& error) {
+    if (!value.isArray()) {
+        error = "property lists must be arrays of property names";
+        return false;
+    }
+    for (const auto& name : value.toArray()) {
+        EntityPropertyInfo propertyInfo;
+        if (!name.isString() || !EntityItemProperties::getPropertyInfo(name.toString(), propertyInfo)) {
+            error = QString("unknown property %1").arg(name.toString());
+            return false;
+        }
+        flags << propertyInfo.propertyEnum;
+    }
+    return true;
+}
+
+// reads a { "min": ..., "max": ... } object, either may be left out
+template <typename T, typename F>
+static bool rangeFromJson(const QJsonValue& value, F&& fromJson, bool& hasMin, T& min, bool& hasMax, T& max, QString& error) {
+    QJsonObject object = value.toObject();
+    hasMin = object.contains("min");
+    hasMax = object.contains("max");
+    if (!value.isObject() || object.size() != (int)hasMin + (int)hasMax || (!hasMin && !hasMax)) {
+        error = "ranges must be objects with a min and/or a max";
+        return false;
+    }
+    if ((hasMin && !fromJson(object["min"], min)) || (hasMax && !fromJson(object["max"], max))) {
+        error = "range limits are of the wrong type";
+        return false;
+    }
+    return true;
+}
+
+static bool maxLengthFromJson(const QJsonValue& value, float& maxLength, QString& error) {
+    QJsonObject object = value.toObject();
+    if (!value.isObject() || object.size() != 1 || !object["maxLength"].isDouble() || object["maxLength"].toDouble() < 0.0) {
+        error = "length clamps must be objects with a non-negative maxLength";
+        return false;
+    }
+    maxLength = (float)object["maxLength"].toDouble();
+    return true;
+}
+
+static bool floatFromJson(const QJsonValue& value, float& result) {
+    if (!value.isDouble()) {
+        return false;
+    }
+    result = (float)value.toDouble();
+    return true;
+}
+
+bool NativeEntityEditFilter::isNativeFilter(const QByteArray& contents) {
+    // a script can't be a lone JSON object, so anything that parses as one is meant for us
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(contents, &parseError);
+    return parseError.error == QJsonParseError::NoError && document.isObject();
+}
+
+NativeEntityEditFilter::Pointer NativeEntityEditFilter::compile(const QByteArray& contents, QString& error) {
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(contents, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        error = parseError.errorString();
+        return Pointer();
+    }
+
+    Pointer filter = std::make_shared<NativeEntityEditFilter>();
+    QJsonObject description = document.object();
+    for (auto it = description.constBegin(); it != description.constEnd(); ++it) {
+        bool compiled;
+        if (it.key() == "filterTypes") {
+            compiled = filter->compileFilterTypes(it.value(), error);
+        } else if (it.key() == "properties") {
+            compiled = filter->compileProperties(it.value(), error);
+        } else if (it.key() == "clamp") {
+            compiled = filter->compileClamps(it.value(), error);
+        } else if (it.key() == "rateLimit") {
+            compiled = filter->compileRateLimit(it.value(), error);
+        } else if (it.key() == "owner") {
+            compiled = filter->compileOwner(it.value(), error);
+        } else {
+            error = QString("unknown key %1").arg(it.key());
+            compiled = false;
+        }
+        if (!compiled) {
+            error = QString("%1: %2").arg(it.key(), error);
+            return Pointer();
+        }
+    }
+    return filter;
+}
+
+bool NativeEntityEditFilter::compileFilterTypes(const QJsonValue& value, QString& error) {
+    if (!value.isArray()) {
+        error = "must be an array";
+        return false;
+    }
+    _wantsToFilterAdd = _wantsToFilterEdit = _wantsToFilterPhysics = _wantsToFilterDelete = false;
+    for (const auto& filterType : value.toArray()) {
+        QString name = filterType.toString();
+        if (name == "add") {
+            _wantsToFilterAdd = true;
+        } else if (name == "edit") {
+            _wantsToFilterEdit = true;
+        } else if (name == "physics") {
+            _wantsToFilterPhysics = true;
+        } else if (name == "delete") {
+            _wantsToFilterDelete = true;
+        } else {
+            error = QString("unknown filter type %1").arg(name);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NativeEntityEditFilter::compileProperties(const QJsonValue& value, QString& error) {
+    QJsonObject object = value.toObject();
+    if (!value.isObject()) {
+        error = "must be an object";
+        return false;
+    }
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        EntityPropertyFlags flags;
+        if (!propertyFlagsFromJson(it.value(), flags, error)) {
+            return false;
+        }
+        if (it.key() == "allow") {
+            _checks.push_back([flags](const Edit&, const EntityItemProperties& properties) {
+                EntityPropertyFlags changed = properties.getChangedProperties();
+                for (int flag = (int)changed.firstFlag(); flag <= (int)changed.lastFlag(); flag++) {
+                    if (changed.getHasProperty((EntityPropertyList)flag) && !flags.getHasProperty((EntityPropertyList)flag)) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+        } else if (it.key() == "deny") {
+            _checks.push_back([flags](const Edit&, const EntityItemProperties& properties) {
+                EntityPropertyFlags changed = properties.getChangedProperties();
+                for (int flag = (int)changed.firstFlag(); flag <= (int)changed.lastFlag(); flag++) {
+                    if (changed.getHasProperty((EntityPropertyList)flag) && flags.getHasProperty((EntityPropertyList)flag)) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+        } else {
+            error = QString("unknown key %1").arg(it.key());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NativeEntityEditFilter::compileClamps(const QJsonValue& value, QString& error) {
+    QJsonObject object = value.toObject();
+    if (!value.isObject()) {
+        error = "must be an object";
+        return false;
+    }
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        const QString& name = it.key();
+        if (name == "position" && it.value().toString() == "zone") {
+            _wantsZoneBoundingBox = true;
+            _clamps.push_back([](const Edit& edit, EntityItemProperties& properties) {
+                if (!properties.positionChanged() || !edit.hasZoneBoundingBox) {
+                    return false;
+                }
+                glm::vec3 position = glm::clamp(properties.getPosition(), edit.zoneBoundingBox.getMinimumPoint(),
+                                                edit.zoneBoundingBox.getMaximumPoint());
+                if (position == properties.getPosition()) {
+                    return false;
+                }
+                properties.setPosition(position);
+                return true;
+            });
+        } else if (name == "position" || name == "dimensions") {
+            bool hasMin, hasMax;
+            glm::vec3 min(-FLT_MAX), max(FLT_MAX);
+            if (!rangeFromJson(it.value(), vec3FromJson, hasMin, min, hasMax, max, error)) {
+                return false;
+            }
+            if (name == "position") {
+                _clamps.push_back([min, max](const Edit&, EntityItemProperties& properties) {
+                    if (!properties.positionChanged()) {
+                        return false;
+                    }
+                    glm::vec3 position = glm::clamp(properties.getPosition(), min, max);
+                    if (position == properties.getPosition()) {
+                        return false;
+                    }
+                    properties.setPosition(position);
+                    return true;
+                });
+            } else {
+                _clamps.push_back([min, max](const Edit&, EntityItemProperties& properties) {
+                    if (!properties.dimensionsChanged()) {
+                        return false;
+                    }
+                    glm::vec3 dimensions = glm::clamp(properties.getDimensions(), min, max);
+                    if (dimensions == properties.getDimensions()) {
+                        return false;
+                    }
+                    properties.setDimensions(dimensions);
+                    return true;
+                });
+            }
+        } else if (name == "velocity" || name == "angularVelocity") {
+            float maxLength;
+            if (!maxLengthFromJson(it.value(), maxLength, error)) {
+                return false;
+            }
+            if (name == "velocity") {
+                _clamps.push_back([maxLength](const Edit&, EntityItemProperties& properties) {
+                    float length = glm::length(properties.getVelocity());
+                    if (!properties.velocityChanged() || length <= maxLength) {
+                        return false;
+                    }
+                    properties.setVelocity(properties.getVelocity() * (maxLength / length));
+                    return true;
+                });
+            } else {
+                _clamps.push_back([maxLength](const Edit&, EntityItemProperties& properties) {
+                    float length = glm::length(properties.getAngularVelocity());
+                    if (!properties.angularVelocityChanged() || length <= maxLength) {
+                        return false;
+                    }
+                    properties.setAngularVelocity(properties.getAngularVelocity() * (maxLength / length));
+                    return true;
+                });
+            }
+        } else if (name == "lifetime") {
+            bool hasMin, hasMax;
+            float min = 0.0f, max = FLT_MAX;
+            if (!rangeFromJson(it.value(), floatFromJson, hasMin, min, hasMax, max, error)) {
+                return false;
+            }
+            _clamps.push_back([hasMax, min, max](const Edit&, EntityItemProperties& properties) {
+                if (!properties.lifetimeChanged()) {
+                    return false;
+                }
+                float lifetime = properties.getLifetime();
+                if (lifetime == ENTITY_ITEM_IMMORTAL_LIFETIME) {
+                    if (!hasMax) {
+                        return false;
+                    }
+                    lifetime = max;
+                } else {
+                    lifetime = glm::clamp(lifetime, min, max);
+                }
+                if (lifetime == properties.getLifetime()) {
+                    return false;
+                }
+                properties.setLifetime(lifetime);
+                return true;
+            });
+        } else {
+            error = QString("can't clamp %1").arg(name);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NativeEntityEditFilter::compileRateLimit(const QJsonValue& value, QString& error) {
+    QJsonObject object = value.toObject();
+    QJsonValue editsPerSecond = object["editsPerSecond"];
+    QJsonValue burst = object.contains("burst") ? object["burst"] : editsPerSecond;
+    if (!value.isObject() || object.size() != 1 + (int)object.contains("burst") ||
+        !editsPerSecond.isDouble() || editsPerSecond.toDouble() <= 0.0 || !burst.isDouble() || burst.toDouble() < 1.0) {
+        error = "must be an object with a positive editsPerSecond and optionally a burst of at least 1";
+        return false;
+    }
+    _editsPerSecond = (float)editsPerSecond.toDouble();
+    _burst = (float)burst.toDouble();
+    _checks.push_back([this](const Edit& edit, const EntityItemProperties&) {
+        return takeRateToken(edit.senderID);
+    });
+    return true;
+}
+
+bool NativeEntityEditFilter::compileOwner(const QJsonValue& value, QString& error) {
+    QJsonObject object = value.toObject();
+    if (!value.isObject()) {
+        error = "must be an object";
+        return false;
+    }
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        if (!it.value().isBool()) {
+            error = QString("%1 must be true or false").arg(it.key());
+            return false;
+        }
+        if (!it.value().toBool()) {
+            continue;
+        }
+
+        if (it.key() == "simulation") {
+            _checks.push_back([](const Edit& edit, const EntityItemProperties& properties) {
+                if (!edit.existingEntity) {
+                    return true;
+                }
+                QUuid simulatorID = edit.existingEntity->getSimulatorID();
+                return simulatorID.isNull() || simulatorID == edit.senderID;
+            });
+        } else if (it.key() == "avatarEntities") {
+            _checks.push_back([](const Edit& edit, const EntityItemProperties& properties) {
+                if (edit.existingEntity) {
+                    return !edit.existingEntity->isAvatarEntity() || edit.existingEntity->getOwningAvatarID() == edit.senderID;
+                }
+                return properties.getEntityHostType() != entity::HostType::AVATAR || properties.getOwningAvatarID() == edit.senderID;
+            });
+        } else if (it.key() == "lastEditor") {
+            _checks.push_back([](const Edit& edit, const EntityItemProperties& properties) {
+                if (!edit.existingEntity) {
+                    return true;
+                }
+                QUuid lastEditedBy = edit.existingEntity->getLastEditedBy();
+                return lastEditedBy.isNull() || lastEditedBy == edit.senderID;
+            });
+        } else {
+            error = QString("unknown owner check %1").arg(it.key());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NativeEntityEditFilter::takeRateToken(const QUuid& senderID) {
+    if (senderID.isNull()) {
+        return true;
+    }
+
+    quint64 now = usecTimestampNow();
+    std::lock_guard<std::mutex> lock(_rateLock);
+    if (_rateBuckets.size() > RATE_BUCKET_PRUNE_SIZE) {
+        for (auto it = _rateBuckets.begin(); it != _rateBuckets.end();) {
+            if (now - it->lastRefill > RATE_BUCKET_EXPIRY) {
+                it = _rateBuckets.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    auto it = _rateBuckets.find(senderID);
+    if (it == _rateBuckets.end()) {
+        it = _rateBuckets.insert(senderID, { _burst, now });
+    } else {
+        float elapsed = (float)(now - it->lastRefill) / USECS_PER_SECOND;
+        it->tokens = std::min(_burst, it->tokens + elapsed * _editsPerSecond);
+        it->lastRefill = now;
+    }
+
+    if (it->tokens < 1.0f) {
+        return false;
+    }
+    it->tokens -= 1.0f;
+    return true;
+}
+
+bool NativeEntityEditFilter::filter(const Edit& edit, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut,
+                                    bool& wasChanged) {
+    for (const auto& check : _checks) {
+        if (!check(edit, propertiesIn)) {
+            return false;
+        }
+    }
+
+    bool clamped = false;
+    for (const auto& clamp : _clamps) {
+        clamped |= clamp(edit, propertiesIn);
+    }
+    if (clamped) {
+        // same as the script filters, which hand back every property they were given
+        if (&propertiesOut != &propertiesIn) {
+            propertiesOut = propertiesIn;
+        }
+        wasChanged = true;
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+//
+//  NativeEntityEditFilter.h
+//  libraries/entities/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NativeEntityEditFilter_h
+#define hifi_NativeEntityEditFilter_h
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QHash>
+#include <QJsonObject>
+#include <QUuid>
+
+#include <AABox.h>
+
+#include "EntityItemProperties.h"
+#include "EntityTree.h"
+
+// An entity edit filter described in JSON rather than JavaScript.  The description is compiled into a list of
+// native checks and clamps when the filter is loaded, so filtering an edit never touches a script engine.
+//
+//  {
+//      "filterTypes": [ "add", "edit", "physics", "delete" ],       // defaults to add, edit and physics
+//      "properties": {
+//          "allow": [ "position", "rotation", "velocity" ],        // edits of anything else are rejected
+//          "deny": [ "script", "serverScripts" ]                   // edits of any of these are rejected
+//      },
+//      "clamp": {
+//          "position": "zone",                                     // or { "min": [x, y, z], "max": [x, y, z] }
+//          "dimensions": { "min": [x, y, z], "max": [x, y, z] },
+//          "velocity": { "maxLength": 10 },
+//          "angularVelocity": { "maxLength": 10 },
+//          "lifetime": { "min": 0, "max": 3600 }                  // an immortal lifetime is clamped to max
+//      },
+//      "rateLimit": { "editsPerSecond": 30, "burst": 60 },         // per sender
+//      "owner": {
+//          "simulation": true,                                     // only the simulation owner, if any, may edit
+//          "avatarEntities": true,                                 // only the owning avatar may edit its entities
+//          "lastEditor": true                                      // only the last editor, if known, may edit
+//      }
+//  }
+//
+// A description with anything this format can't express fails to compile; write those filters in JavaScript.
+class NativeEntityEditFilter {
+public:
+    using Pointer = std::shared_ptr<NativeEntityEditFilter>;
+
+    static bool isNativeFilter(const QByteArray& contents);
+    static Pointer compile(const QByteArray& contents, QString& error);
+
+    bool wantsToFilterAdd() const { return _wantsToFilterAdd; }
+    bool wantsToFilterEdit() const { return _wantsToFilterEdit; }
+    bool wantsToFilterPhysics() const { return _wantsToFilterPhysics; }
+    bool wantsToFilterDelete() const { return _wantsToFilterDelete; }
+    bool wantsZoneBoundingBox() const { return _wantsZoneBoundingBox; }
+
+    struct Edit {
+        EntityTree::FilterType filterType;
+        QUuid senderID;
+        EntityItemPointer existingEntity;
+        bool hasZoneBoundingBox { false };
+        AABox zoneBoundingBox;
+    };
+
+    // same contract as the JavaScript filter function: false rejects the edit, otherwise propertiesIn and
+    // propertiesOut are clamped in place and wasChanged is set if anything was
+    bool filter(const Edit& edit, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged);
+
+private:
+    using Check = std::function<bool(const Edit&, const EntityItemProperties&)>;
+    using Clamp = std::function<bool(const Edit&, EntityItemProperties&)>;
+
+    bool compileFilterTypes(const QJsonValue& value, QString& error);
+    bool compileProperties(const QJsonValue& value, QString& error);
+    bool compileClamps(const QJsonValue& value, QString& error);
+    bool compileRateLimit(const QJsonValue& value, QString& error);
+    bool compileOwner(const QJsonValue& value, QString& error);
+
+    bool takeRateToken(const QUuid& senderID);
+
+    bool _wantsToFilterAdd { true };
+    bool _wantsToFilterEdit { true };
+    bool _wantsToFilterPhysics { true };
+    bool _wantsToFilterDelete { false };
+    bool _wantsZoneBoundingBox { false };
+
+    std::vector<Check> _checks;
+    std::vector<Clamp> _clamps;
+
+    // token bucket per sender
+    struct RateBucket {
+        float tokens;
+        quint64 lastRefill;
+    };
+    float _editsPerSecond { 0.0f };
+    float _burst { 0.0f };
+    std::mutex _rateLock;
+    QHash<QUuid, RateBucket> _rateBuckets;
+};
+
+#endif // hifi_NativeEntityEditFilter_h
@@ -100,6 +100,11 @@ const uint8_t SCRIPT_POKE_SIMULATION_PRIORITY = SCRIPT_GRAB_SIMULATION_PRIORITY
 // PERSONAL priority (needs a better name) is the level at which a simulation observer owns its own avatar
 // which really just means: things that collide with it will be bid at a priority level one lower
 const uint8_t PERSONAL_SIMULATION_PRIORITY = SCRIPT_GRAB_SIMULATION_PRIORITY;
+
+// A physics-server holds the objects in its regions at PHYSICS_SERVER priority, as high as anything a collision
+// bumps a client to. The entity-server never hands a physics-server's objects over on a tie, so collisions and
+// pokes leave them alone and only grabs take an object over while they last.
+const uint8_t PHYSICS_SERVER_SIMULATION_PRIORITY = PERSONAL_SIMULATION_PRIORITY - 1;
 const uint8_t AVATAR_ENTITY_SIMULATION_PRIORITY = PERSONAL_SIMULATION_PRIORITY;
 
 
@@ -13,7 +13,12 @@
 
 #include <glm/gtc/packing.hpp>
 
+#include <condition_variable>
+#include <mutex>
+
 #include <QtCore/QtGlobal>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QUrl>
 #include <QImage>
 #include <QRgb>
@@ -342,7 +347,122 @@ QImage processSourceImage(QImage&& srcImage, bool cubemap, BackendTarget target)
     return localCopy;
 }
 
+// Compression work is shared out over one pool for every texture being processed at once. A job runs on the thread
+// that asked for it and on whichever threads of the pool are free when it starts, so it never waits on a thread that is
+// busy with another texture, and a job started from inside another one (a face of a cube map, then the blocks of one
+// of its mips) just runs on the threads it was given.
+static int getDefaultCompressionThreads() {
+    int numThreads = QThread::idealThreadCount();
+    if (numThreads == -1) {
+        // idealThreadCount returns -1 if cores cannot be detected
+        static const int MAX_THREADS_IF_UNKNOWN = 4;
+        numThreads = MAX_THREADS_IF_UNKNOWN;
+    }
+    return numThreads;
+}
+
+static QThreadPool& getCompressionThreadPool() {
+    static QThreadPool* pool = [] {
+        auto pool = new QThreadPool();
+        pool->setMaxThreadCount(getDefaultCompressionThreads() - 1);
+        return pool;
+    }();
+    return *pool;
+}
+
+void setMaxCompressionThreads(int maxThreads) {
+    if (maxThreads <= 0) {
+        maxThreads = getDefaultCompressionThreads();
+    }
+
+    // the thread asking for the job is one of them
+    getCompressionThreadPool().setMaxThreadCount(std::max(0, maxThreads - 1));
+}
+
+int getMaxCompressionThreads() {
+    return getCompressionThreadPool().maxThreadCount() + 1;
+}
+
+class ParallelJob {
+public:
+    using Task = std::function<void(int)>;
+
+    ParallelJob(int count, const Task& task, const std::atomic<bool>& abortProcessing) :
+        _task(task), _count(count), _abortProcessing(abortProcessing) {}
+
+    void work() {
+        int numFinished = 0;
+        for (int i = _next++; i < _count; i = _next++) {
+            if (!_abortProcessing.load()) {
+                _task(i);
+            }
+            ++numFinished;
+        }
+
+        if (numFinished > 0) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _numFinished += numFinished;
+            if (_numFinished == _count) {
+                _doneCondition.notify_all();
+            }
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _doneCondition.wait(lock, [this] { return _numFinished == _count; });
+    }
+
+private:
+    Task _task;
+    const int _count;
+    const std::atomic<bool>& _abortProcessing;
+    std::atomic<int> _next { 0 };
+
+    std::mutex _mutex;
+    std::condition_variable _doneCondition;
+    int _numFinished { 0 };
+};
+
+class ParallelJobRunnable : public QRunnable {
+public:
+    ParallelJobRunnable(const std::shared_ptr<ParallelJob>& job) : _job(job) {}
+
+    // a helper that starts after the job is done finds no index left, and only holds on to it until then
+    void run() override { _job->work(); }
+
+private:
+    std::shared_ptr<ParallelJob> _job;
+};
+
+// runs task for each of [0, count) on the calling thread and the free threads of the pool, returns once all are done
+static void parallelFor(int count, const std::atomic<bool>& abortProcessing, const ParallelJob::Task& task) {
+    if (count <= 0) {
+        return;
+    }
+
+    auto job = std::make_shared<ParallelJob>(count, task, abortProcessing);
+
+    auto& pool = getCompressionThreadPool();
+    int numHelpers = std::min(count - 1, pool.maxThreadCount());
+    for (int i = 0; i < numHelpers; ++i) {
+        std::unique_ptr<ParallelJobRunnable> helper { new ParallelJobRunnable(job) };
+        if (!pool.tryStart(helper.get())) {
+            // every thread is busy, the rest of the job stays with the threads it has
+            break;
+        }
+        helper.release();
+    }
+
+    job->work();
+    job->wait();
+}
+
 #if defined(NVTT_API)
+// the faces of a cube map are compressed at the same time, and the texture's storage isn't safe to assign to from
+// several threads
+static std::mutex textureAssignMutex;
+
 struct OutputHandler : public nvtt::OutputHandler {
     OutputHandler(gpu::Texture* texture, int face) : _texture(texture), _face(face) {}
 
@@ -362,6 +482,7 @@ struct OutputHandler : public nvtt::OutputHandler {
     }
 
     virtual void endImage() override {
+        std::lock_guard<std::mutex> lock(textureAssignMutex);
         if (_face >= 0) {
             _texture->assignStoredMipFace(_miplevel, _face, _size, static_cast<const gpu::Byte*>(_data));
         } else {
@@ -429,20 +550,16 @@ struct MyErrorHandler : public nvtt::ErrorHandler {
     }
 };
 
-class SequentialTaskDispatcher : public nvtt::TaskDispatcher {
+class ParallelTaskDispatcher : public nvtt::TaskDispatcher {
 public:
-    SequentialTaskDispatcher(const std::atomic<bool>& abortProcessing) : _abortProcessing(abortProcessing) {};
+    ParallelTaskDispatcher(const std::atomic<bool>& abortProcessing) : _abortProcessing(abortProcessing) {};
 
     const std::atomic<bool>& _abortProcessing;
 
     virtual void dispatch(nvtt::Task* task, void* context, int count) override {
-        for (int i = 0; i < count; i++) {
-            if (!_abortProcessing.load()) {
-                task(context, i);
-            } else {
-                break;
-            }
-        }
+        parallelFor(count, _abortProcessing, [task, context](int i) {
+            task(context, i);
+        });
     }
 };
 
@@ -532,7 +649,7 @@ void generateHDRMips(gpu::Texture* texture, QImage&& image, BackendTarget target
     surface.setAlphaMode(alphaMode);
     surface.setWrapMode(wrapMode);
 
-    SequentialTaskDispatcher dispatcher(abortProcessing);
+    ParallelTaskDispatcher dispatcher(abortProcessing);
     nvtt::Compressor compressor;
     context.setTaskDispatcher(&dispatcher);
 
@@ -665,7 +782,7 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, BackendTarget target
         MyErrorHandler errorHandler;
         outputOptions.setErrorHandler(&errorHandler);
 
-        SequentialTaskDispatcher dispatcher(abortProcessing);
+        ParallelTaskDispatcher dispatcher(abortProcessing);
         nvtt::Compressor compressor;
         compressor.setTaskDispatcher(&dispatcher);
         compressor.process(inputOptions, compressionOptions, outputOptions);
@@ -702,7 +819,7 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, BackendTarget target
 
         const Etc::ErrorMetric errorMetric = Etc::ErrorMetric::RGBA;
         const float effort = 1.0f;
-        const int numEncodeThreads = 4;
+        const int numEncodeThreads = getMaxCompressionThreads();
         int encodingTime;
         const float MAX_COLOR = 255.0f;
 
@@ -727,6 +844,7 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, BackendTarget target
             mipMaps, &encodingTime
         );
 
+        std::lock_guard<std::mutex> lock(textureAssignMutex);
         for (int i = 0; i < numMips; i++) {
             if (mipMaps[i].paucEncodingBits.get()) {
                 if (face >= 0) {
@@ -1440,9 +1558,10 @@ gpu::TexturePointer TextureUsage::processCubeTextureColorFromImage(QImage&& srcI
             theTexture->overrideIrradiance(irradiance);
         }
 
-        for (uint8 face = 0; face < faces.size(); ++face) {
+        // the faces compress at the same time, each on the threads the others leave free
+        parallelFor((int)faces.size(), abortProcessing, [&](int face) {
             generateMips(theTexture.get(), std::move(faces[face]), target, abortProcessing, face);
-        }
+        });
     }
 
     return theTexture;
@@ -83,6 +83,11 @@ gpu::TexturePointer processCubeTextureColorFromImage(QImage&& srcImage, const st
 
 const QStringList getSupportedFormats();
 
+// The most threads compressing one texture can use, counting the thread that processes it. The threads beyond that one
+// come from a pool shared by every texture being compressed at once. 0 (the default) uses one per core.
+void setMaxCompressionThreads(int maxThreads);
+int getMaxCompressionThreads();
+
 gpu::TexturePointer processImage(std::shared_ptr<QIODevice> content, const std::string& url, ColorChannel sourceChannel,
                                  int maxNumPixels, TextureUsage::Type textureType,
                                  bool compress, gpu::BackendTarget target, const std::atomic<bool>& abortProcessing = false);
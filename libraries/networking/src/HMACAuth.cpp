@@ -12,66 +12,156 @@
 #include "HMACAuth.h"
 
 #include <openssl/opensslv.h>
-#include <openssl/hmac.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
 
 #include <QUuid>
 #include "NetworkLogging.h"
 #include <cassert>
+#include <cstring>
+
+#if OPENSSL_VERSION_NUMBER < 0x10100000
+#define EVP_MD_CTX_new EVP_MD_CTX_create
+#define EVP_MD_CTX_free EVP_MD_CTX_destroy
+#endif
+
+static_assert(HMACAuth::MAX_HASH_SIZE >= EVP_MAX_MD_SIZE, "HMACAuth::MAX_HASH_SIZE is too small");
+
+// largest digest block size we support (SHA-512 family), the HMAC pads are one block long
+static const int MAX_BLOCK_SIZE = 128;
+
+static const unsigned char INNER_PAD = 0x36;
+static const unsigned char OUTER_PAD = 0x5c;
+
+struct HMACAuth::KeyState {
+    KeyState() : inner(EVP_MD_CTX_new()), outer(EVP_MD_CTX_new()) {}
+    ~KeyState() {
+        EVP_MD_CTX_free(inner);
+        EVP_MD_CTX_free(outer);
+    }
+
+    // digest states after absorbing (key ^ ipad) and (key ^ opad) - never modified once the key is set
+    EVP_MD_CTX* inner;
+    EVP_MD_CTX* outer;
+};
+
+namespace {
+
+const EVP_MD* digestForMethod(HMACAuth::AuthMethod authMethod) {
+    switch (authMethod) {
+    case HMACAuth::MD5:
+        return EVP_md5();
+
+    case HMACAuth::SHA1:
+        return EVP_sha1();
+
+    case HMACAuth::SHA224:
+        return EVP_sha224();
+
+    case HMACAuth::SHA256:
+        return EVP_sha256();
+
+    case HMACAuth::RIPEMD160:
+        return EVP_ripemd160();
 
 #if OPENSSL_VERSION_NUMBER >= 0x10100000
-HMACAuth::HMACAuth(AuthMethod authMethod)
-    : _hmacContext(HMAC_CTX_new())
-    , _authMethod(authMethod) { }
+    case HMACAuth::BLAKE2S256:
+        return EVP_blake2s256();
+#endif
 
-HMACAuth::~HMACAuth()
-{
-    HMAC_CTX_free(_hmacContext);
+    default:
+        return nullptr;
+    }
 }
 
-#else
+// each thread keeps one scratch context, re-used for every hash it calculates
+class ScratchContext {
+public:
+    ScratchContext() : _context(EVP_MD_CTX_new()) {}
+    ~ScratchContext() { EVP_MD_CTX_free(_context); }
+
+    EVP_MD_CTX* get() { return _context; }
 
-HMACAuth::HMACAuth(AuthMethod authMethod)
-    : _hmacContext(new HMAC_CTX())
-    , _authMethod(authMethod) {
-    HMAC_CTX_init(_hmacContext);
+private:
+    EVP_MD_CTX* _context;
+};
+
+thread_local ScratchContext scratchContext;
+
+}
+
+HMACAuth::HMACAuth(AuthMethod authMethod) : _authMethod(authMethod) {
 }
 
 HMACAuth::~HMACAuth() {
-    HMAC_CTX_cleanup(_hmacContext);
-    delete _hmacContext;
+    delete _keyState.load();
+}
+
+bool HMACAuth::isSupported(AuthMethod authMethod) {
+    return digestForMethod(authMethod) != nullptr;
+}
+
+uint32_t HMACAuth::getSupportedMethods() {
+    uint32_t supportedMethods = 0;
+    for (int method = MD5; method <= BLAKE2S256; method++) {
+        if (isSupported((AuthMethod)method)) {
+            supportedMethods |= 1 << method;
+        }
+    }
+    return supportedMethods;
 }
-#endif
 
 bool HMACAuth::setKey(const char* keyValue, int keyLen) {
-    const EVP_MD* sslStruct = nullptr;
+    const EVP_MD* digest = digestForMethod(_authMethod);
+    if (!digest) {
+        return false;
+    }
 
-    switch (_authMethod) {
-    case MD5:
-        sslStruct = EVP_md5();
-        break;
+    int blockSize = EVP_MD_block_size(digest);
+    if (blockSize > MAX_BLOCK_SIZE) {
+        return false;
+    }
+
+    // keys longer than a block are hashed first, shorter ones are zero padded
+    unsigned char keyBlock[MAX_BLOCK_SIZE] = { 0 };
+    if (keyLen > blockSize) {
+        unsigned int hashedKeyLen;
+        if (!EVP_Digest(keyValue, keyLen, keyBlock, &hashedKeyLen, digest, nullptr)) {
+            return false;
+        }
+    } else {
+        memcpy(keyBlock, keyValue, keyLen);
+    }
 
-    case SHA1:
-        sslStruct = EVP_sha1();
-        break;
+    std::unique_ptr<KeyState> keyState { new KeyState() };
+    unsigned char pad[MAX_BLOCK_SIZE];
 
-    case SHA224:
-        sslStruct = EVP_sha224();
-        break;
+    for (int i = 0; i < blockSize; ++i) {
+        pad[i] = keyBlock[i] ^ INNER_PAD;
+    }
+    bool success = EVP_DigestInit_ex(keyState->inner, digest, nullptr) &&
+        EVP_DigestUpdate(keyState->inner, pad, blockSize);
 
-    case SHA256:
-        sslStruct = EVP_sha256();
-        break;
+    for (int i = 0; i < blockSize; ++i) {
+        pad[i] = keyBlock[i] ^ OUTER_PAD;
+    }
+    success = success && EVP_DigestInit_ex(keyState->outer, digest, nullptr) &&
+        EVP_DigestUpdate(keyState->outer, pad, blockSize);
 
-    case RIPEMD160:
-        sslStruct = EVP_ripemd160();
-        break;
+    OPENSSL_cleanse(keyBlock, sizeof(keyBlock));
+    OPENSSL_cleanse(pad, sizeof(pad));
 
-    default:
+    if (!success) {
+        qCWarning(networking) << "Error occured setting the HMACAuth key";
         return false;
     }
 
-    QMutexLocker lock(&_lock);
-    return (bool) HMAC_Init_ex(_hmacContext, keyValue, keyLen, sslStruct, nullptr);
+    std::lock_guard<std::mutex> lock(_setKeyMutex);
+    const KeyState* previousKeyState = _keyState.exchange(keyState.release());
+    if (previousKeyState) {
+        _retiredKeyStates.emplace_back(const_cast<KeyState*>(previousKeyState));
+    }
+    return true;
 }
 
 bool HMACAuth::setKey(const QUuid& uidKey) {
@@ -79,39 +169,42 @@ bool HMACAuth::setKey(const QUuid& uidKey) {
     return setKey(rfcBytes.constData(), rfcBytes.length());
 }
 
-bool HMACAuth::addData(const char* data, int dataLen) {
-    QMutexLocker lock(&_lock);
-    return (bool) HMAC_Update(_hmacContext, reinterpret_cast<const unsigned char*>(data), dataLen);
-}
+bool HMACAuth::calculateHash(HMACHash& hashResult, const char* data, int dataLen) const {
+    const KeyState* keyState = _keyState.load(std::memory_order_acquire);
+    if (!keyState) {
+        return false;
+    }
 
-HMACAuth::HMACHash HMACAuth::result() {
-    HMACHash hashValue(EVP_MAX_MD_SIZE);
+    EVP_MD_CTX* context = scratchContext.get();
+    unsigned char innerHash[EVP_MAX_MD_SIZE];
+    unsigned int innerHashLen;
     unsigned int hashLen;
-    QMutexLocker lock(&_lock);
-    
-    auto hmacResult = HMAC_Final(_hmacContext, &hashValue[0], &hashLen);
-    
-    if (hmacResult) {
-        hashValue.resize((size_t)hashLen);
-    } else {
-        // the HMAC_FINAL call failed - should not be possible to get into this state
-        qCWarning(networking) << "Error occured calling HMAC_Final";
-        assert(hmacResult);
+
+    // H((key ^ opad) || H((key ^ ipad) || data)), starting each half from its precomputed pad state
+    bool success = EVP_MD_CTX_copy_ex(context, keyState->inner) &&
+        EVP_DigestUpdate(context, data, dataLen) &&
+        EVP_DigestFinal_ex(context, innerHash, &innerHashLen) &&
+        EVP_MD_CTX_copy_ex(context, keyState->outer) &&
+        EVP_DigestUpdate(context, innerHash, innerHashLen) &&
+        EVP_DigestFinal_ex(context, hashResult.bytes.data(), &hashLen);
+
+    if (!success) {
+        // should not be possible to get into this state
+        qCWarning(networking) << "Error occured calculating HMACAuth hash";
+        assert(success);
+        hashResult.size = 0;
+        return false;
     }
 
-    // Clear state for possible reuse.
-    HMAC_Init_ex(_hmacContext, nullptr, 0, nullptr, nullptr);
-    return hashValue;
+    hashResult.size = (int)hashLen;
+    return true;
 }
 
-bool HMACAuth::calculateHash(HMACHash& hashResult, const char* data, int dataLen) {
-    QMutexLocker lock(&_lock);
-    if (!addData(data, dataLen)) {
-        qCWarning(networking) << "Error occured calling HMACAuth::addData()";
-        assert(false);
+bool HMACAuth::verifyHash(const char* expected, int expectedLen, const char* data, int dataLen) const {
+    HMACHash hashResult;
+    if (!calculateHash(hashResult, data, dataLen) || expectedLen > hashResult.size) {
         return false;
     }
 
-    hashResult = result();
-    return true;
+    return CRYPTO_memcmp(expected, hashResult.data(), expectedLen) == 0;
 }
@@ -12,36 +12,61 @@
 #ifndef hifi_HMACAuth_h
 #define hifi_HMACAuth_h
 
-#include <vector>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
-#include <QtCore/QMutex>
+#include <mutex>
+#include <vector>
 
 class QUuid;
 
+// Keyed HMAC over an OpenSSL digest.
+// setKey precomputes the inner and outer pad digest states once; calculateHash only copies them into a per-thread
+// context, so it takes no lock, never allocates, and may be called from any number of threads at once.
 class HMACAuth {
 public:
-    enum AuthMethod { MD5, SHA1, SHA224, SHA256, RIPEMD160 };
-    using HMACHash = std::vector<unsigned char>;
-    
+    enum AuthMethod { MD5, SHA1, SHA224, SHA256, RIPEMD160, BLAKE2S256 };
+
+    static const int MAX_HASH_SIZE = 64;
+
+    // fixed size digest, large enough for any AuthMethod
+    struct HMACHash {
+        std::array<unsigned char, MAX_HASH_SIZE> bytes;
+        int size { 0 };
+
+        const unsigned char* data() const { return bytes.data(); }
+    };
+
     explicit HMACAuth(AuthMethod authMethod = MD5);
     ~HMACAuth();
 
+    static bool isSupported(AuthMethod authMethod);
+    // a bit (1 << AuthMethod) for each method isSupported
+    static uint32_t getSupportedMethods();
+
+    AuthMethod getAuthMethod() const { return _authMethod; }
+    // the new method only applies to hashes calculated after the next setKey
+    void setAuthMethod(AuthMethod authMethod) { _authMethod = authMethod; }
+
     bool setKey(const char* keyValue, int keyLen);
     bool setKey(const QUuid& uidKey);
+
     // Calculate complete hash in one.
-    bool calculateHash(HMACHash& hashResult, const char* data, int dataLen);
+    bool calculateHash(HMACHash& hashResult, const char* data, int dataLen) const;
 
-    // Append to data to be hashed.
-    bool addData(const char* data, int dataLen);
-    // Get the resulting hash from calls to addData().
-    // Note that only one hash may be calculated at a time for each
-    // HMACAuth instance if this interface is used.
-    HMACHash result();
+    // Check the first expectedLen bytes of the hash of data against expected, in constant time.
+    bool verifyHash(const char* expected, int expectedLen, const char* data, int dataLen) const;
 
 private:
-    QMutex _lock { QMutex::Recursive };
-    struct hmac_ctx_st* _hmacContext;
-    AuthMethod _authMethod;
+    struct KeyState;
+
+    // Readers only ever load _keyState. Replaced states are retired rather than freed, since a reader on another
+    // thread may still be using one - the key only changes a handful of times over the life of a node.
+    std::atomic<const KeyState*> _keyState { nullptr };
+    std::vector<std::unique_ptr<KeyState>> _retiredKeyStates;
+    std::mutex _setKeyMutex;
+    std::atomic<AuthMethod> _authMethod;
 };
 
 #endif  // hifi_HMACAuth_h
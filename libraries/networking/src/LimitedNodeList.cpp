@@ -18,6 +18,7 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QMutex>
 #include <QtCore/QThread>
 #include <QtCore/QUrl>
 #include <QtNetwork/QTcpSocket>
@@ -49,7 +50,8 @@ const std::set<NodeType_t> SOLO_NODE_TYPES = {
     NodeType::AssetServer,
     NodeType::EntityServer,
     NodeType::MessagesMixer,
-    NodeType::EntityScriptServer
+    NodeType::EntityScriptServer,
+    NodeType::PhysicsServer
 };
 
 LimitedNodeList::LimitedNodeList(int socketListenPort, int dtlsListenPort) :
@@ -228,6 +230,24 @@ QUdpSocket& LimitedNodeList::getDTLSSocket() {
     return *_dtlsSocket;
 }
 
+void LimitedNodeList::setAuthenticationMethod(HMACAuth::AuthMethod authMethod) {
+    if (!HMACAuth::isSupported(authMethod)) {
+        // the domain-server refuses connections from nodes without its method, so this is only ever the domain-server's
+        // own setting - which it then hands out to every node
+        qCWarning(networking) << "Packet authentication method" << authMethod << "is not supported - using HMAC-MD5";
+        authMethod = HMACAuth::MD5;
+    }
+
+    if (_authenticationMethod.exchange(authMethod) != authMethod) {
+        qCDebug(networking) << "Packet authentication method is now" << authMethod;
+
+        // re-key the nodes we already know about with the new method
+        eachNode([authMethod](const SharedNodePointer& node) {
+            node->setConnectionSecret(node->getConnectionSecret(), authMethod);
+        });
+    }
+}
+
 bool LimitedNodeList::isPacketVerifiedWithSource(const udt::Packet& packet, Node* sourceNode) {
     // We track bandwidth when doing packet verification to avoid needing to do a node lookup
     // later when we already do it in packetSourceAndHashMatchAndTrackBandwidth. A node lookup
@@ -245,6 +265,10 @@ bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
         static QMultiHash<QUuid, PacketType> sourcedVersionDebugSuppressMap;
         static QMultiHash<HifiSockAddr, PacketType> versionDebugSuppressMap;
 
+        // packets can be verified on several udt receive workers at once
+        static QMutex versionDebugSuppressMutex;
+        QMutexLocker versionDebugSuppressLocker(&versionDebugSuppressMutex);
+
         bool hasBeenOutput = false;
         QString senderString;
         const HifiSockAddr& senderSockAddr = packet.getSenderSockAddr();
@@ -319,12 +343,16 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
     } else {
         NLPacket::LocalID sourceLocalID = Node::NULL_LOCAL_ID;
 
+        // holds on to the node we look up for the rest of the checks, this runs on the socket's receive threads and
+        // the node can be killed meanwhile
+        SharedNodePointer matchingNode;
+
         // check if we were passed a sourceNode hint or if we need to look it up
         if (!sourceNode) {
             // figure out which node this is from
             sourceLocalID = NLPacket::sourceIDInHeader(packet);
 
-            SharedNodePointer matchingNode = nodeWithLocalID(sourceLocalID);
+            matchingNode = nodeWithLocalID(sourceLocalID);
             sourceNode = matchingNode.data();
         }
 
@@ -346,21 +374,23 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
 
             if (verifiedPacket && verificationEnabled) {
 
-                QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
-                QByteArray expectedHash;
                 auto sourceNodeHMACAuth = sourceNode->getAuthenticateHash();
-                if (sourceNode->getAuthenticateHash()) {
-                    expectedHash = NLPacket::hashForPacketAndHMAC(packet, *sourceNodeHMACAuth);
-                }
 
-                // check if the HMAC-md5 hash in the header matches the hash we would expect
-                if (!sourceNodeHMACAuth || packetHeaderHash != expectedHash) {
+                // check if the HMAC hash in the header matches the hash we would expect
+                if (!sourceNodeHMACAuth || !NLPacket::verifyHashInHeader(packet, *sourceNodeHMACAuth)) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
+                    static QMutex hashDebugSuppressMutex;
+                    QMutexLocker hashDebugSuppressLocker(&hashDebugSuppressMutex);
 
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
+                        QByteArray expectedHash;
+                        if (sourceNodeHMACAuth) {
+                            expectedHash = NLPacket::hashForPacketAndHMAC(packet, *sourceNodeHMACAuth);
+                        }
+
                         qCDebug(networking) << "Packet hash mismatch on" << headerType << "- Sender" << sourceID;
                         qCDebug(networking) << "Packet len:" << packet.getDataSize() << "Expected hash:" <<
-                            expectedHash.toHex() << "Actual:" << packetHeaderHash.toHex();
+                            expectedHash.toHex() << "Actual:" << NLPacket::verificationHashInHeader(packet).toHex();
 
                         hashDebugSuppressMap.insert(sourceID, headerType);
                     }
@@ -491,6 +521,12 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
         fillPacketHeader(*nlPacket);
     }
 
+    if (packetList->hasDeferredPackets()) {
+        packetList->setDeferredPacketFinalizer([this](udt::Packet& packet) {
+            fillPacketHeader(static_cast<NLPacket&>(packet));
+        });
+    }
+
     return _nodeSocket.writePacketList(std::move(packetList), sockAddr);
 }
 
@@ -505,6 +541,14 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
             fillPacketHeader(*nlPacket, destinationNode.getAuthenticateHash());
         }
 
+        if (packetList->hasDeferredPackets()) {
+            // deferred packets are signed on the send queue's thread, hold on to the node (and its key) until then
+            SharedNodePointer node = nodeWithLocalID(destinationNode.getLocalID());
+            packetList->setDeferredPacketFinalizer([this, node](udt::Packet& packet) {
+                fillPacketHeader(static_cast<NLPacket&>(packet), node ? node->getAuthenticateHash() : nullptr);
+            });
+        }
+
         return _nodeSocket.writePacketList(std::move(packetList), *activeSocket);
     } else {
         qCDebug(networking) << "LimitedNodeList::sendPacketList called without active socket for node "
@@ -651,7 +695,7 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         matchingNode->setPublicSocket(publicSocket);
         matchingNode->setLocalSocket(localSocket);
         matchingNode->setPermissions(permissions);
-        matchingNode->setConnectionSecret(connectionSecret);
+        matchingNode->setConnectionSecret(connectionSecret, _authenticationMethod);
         matchingNode->setIsReplicated(isReplicated);
         matchingNode->setIsUpstream(isUpstream || NodeType::isUpstream(nodeType));
         matchingNode->setLocalID(localID);
@@ -687,7 +731,7 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
     Node* newNode = new Node(uuid, nodeType, publicSocket, localSocket);
     newNode->setIsReplicated(isReplicated);
     newNode->setIsUpstream(isUpstream || NodeType::isUpstream(nodeType));
-    newNode->setConnectionSecret(connectionSecret);
+    newNode->setConnectionSecret(connectionSecret, _authenticationMethod);
     newNode->setPermissions(permissions);
     newNode->setLocalID(localID);
 
@@ -748,10 +792,12 @@ void LimitedNodeList::addNewNode(NewNodeInfo info) {
 }
 
 void LimitedNodeList::delayNodeAdd(NewNodeInfo info) {
+    QWriteLocker locker(&_delayedNodeAddsLock);
     _delayedNodeAdds.push_back(info);
 }
 
 void LimitedNodeList::removeDelayedAdd(QUuid nodeUUID) {
+    QWriteLocker locker(&_delayedNodeAddsLock);
     auto it = std::find_if(_delayedNodeAdds.begin(), _delayedNodeAdds.end(), [&](auto info) {
         return info.uuid == nodeUUID;
     });
@@ -761,6 +807,7 @@ void LimitedNodeList::removeDelayedAdd(QUuid nodeUUID) {
 }
 
 bool LimitedNodeList::isDelayedNode(QUuid nodeUUID) {
+    QReadLocker locker(&_delayedNodeAddsLock);
     auto it = std::find_if(_delayedNodeAdds.begin(), _delayedNodeAdds.end(), [&](auto info) {
         return info.uuid == nodeUUID;
     });
@@ -770,14 +817,20 @@ bool LimitedNodeList::isDelayedNode(QUuid nodeUUID) {
 void LimitedNodeList::processDelayedAdds() {
     _nodesAddedInCurrentTimeSlice = 0;
 
-    auto nodesToAdd = glm::min(_delayedNodeAdds.size(), _maxConnectionRate);
-    auto firstNodeToAdd = _delayedNodeAdds.begin();
-    auto lastNodeToAdd = firstNodeToAdd + nodesToAdd;
+    std::vector<NewNodeInfo> nodesToAdd;
+    {
+        QWriteLocker locker(&_delayedNodeAddsLock);
+        auto numNodesToAdd = glm::min(_delayedNodeAdds.size(), _maxConnectionRate);
+        auto firstNodeToAdd = _delayedNodeAdds.begin();
+        auto lastNodeToAdd = firstNodeToAdd + numNodesToAdd;
+
+        nodesToAdd.assign(firstNodeToAdd, lastNodeToAdd);
+        _delayedNodeAdds.erase(firstNodeToAdd, lastNodeToAdd);
+    }
 
-    for (auto it = firstNodeToAdd; it != lastNodeToAdd; ++it) {
-        addNewNode(*it);
+    for (auto& info : nodesToAdd) {
+        addNewNode(info);
     }
-    _delayedNodeAdds.erase(firstNodeToAdd, lastNodeToAdd);
 }
 
 std::unique_ptr<NLPacket> LimitedNodeList::constructPingPacket(const QUuid& nodeId, PingType_t pingType) {
@@ -14,6 +14,7 @@
 
 #include <assert.h>
 #include <stdint.h>
+#include <atomic>
 #include <iterator>
 #include <memory>
 #include <set>
@@ -68,6 +69,12 @@ const QHostAddress DEFAULT_ASSIGNMENT_CLIENT_MONITOR_HOSTNAME = QHostAddress::Lo
 
 const QString USERNAME_UUID_REPLACEMENT_STATS_KEY = "$username";
 
+// each node in a DomainList is either sent in full or, in a delta, as removed
+enum class DomainListEntry : quint8 {
+    Node,
+    Removed
+};
+
 using ConnectionID = int64_t;
 const ConnectionID NULL_CONNECTION_ID { -1 };
 const ConnectionID INITIAL_CONNECTION_ID { 0 };
@@ -312,6 +319,10 @@ public:
     void setAuthenticatePackets(bool useAuthentication) { _useAuthentication = useAuthentication; }
     bool getAuthenticatePackets() const { return _useAuthentication; }
 
+    // the keyed hash used to verify sourced packets, picked by the domain-server and handed out in the DomainList
+    void setAuthenticationMethod(HMACAuth::AuthMethod authMethod);
+    HMACAuth::AuthMethod getAuthenticationMethod() const { return _authenticationMethod; }
+
     void setFlagTimeForConnectionStep(bool flag) { _flagTimeForConnectionStep = flag; }
     bool isFlagTimeForConnectionStep() { return _flagTimeForConnectionStep; }
 
@@ -425,6 +436,7 @@ protected:
     HifiSockAddr _stunSockAddr { STUN_SERVER_HOSTNAME, STUN_SERVER_PORT };
     bool _hasTCPCheckedLocalSocket { false };
     bool _useAuthentication { true };
+    std::atomic<HMACAuth::AuthMethod> _authenticationMethod { HMACAuth::MD5 };
 
     PacketReceiver* _packetReceiver;
 
@@ -469,6 +481,7 @@ private:
     size_t _maxConnectionRate { DEFAULT_MAX_CONNECTION_RATE };
     size_t _nodesAddedInCurrentTimeSlice { 0 };
     std::vector<NewNodeInfo> _delayedNodeAdds;
+    mutable QReadWriteLock _delayedNodeAddsLock; // packets can be verified from udt receive workers
 
     int _inboundPPS { 0 };
     int _outboundPPS { 0 };
@@ -11,6 +11,8 @@
 
 #include "NLPacket.h"
 
+#include <algorithm>
+
 #include "HMACAuth.h"
 
 int NLPacket::localHeaderSize(PacketType type) {
@@ -34,7 +36,7 @@ std::unique_ptr<NLPacket> NLPacket::create(PacketType type, qint64 size, bool is
     return packet;
 }
 
-std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(udt::PacketBuffer data, qint64 size,
                                                        const HifiSockAddr& senderSockAddr) {
     // Fail with null data
     Q_ASSERT(data);
@@ -89,7 +91,7 @@ NLPacket::NLPacket(const NLPacket& other) : Packet(other) {
     _sourceID = other._sourceID;
 }
 
-NLPacket::NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+NLPacket::NLPacket(udt::PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr) :
     Packet(std::move(data), size, senderSockAddr)
 {    
     // sanity check before we decrease the payloadSize with the payloadCapacity
@@ -152,7 +154,7 @@ QByteArray NLPacket::verificationHashInHeader(const udt::Packet& packet) {
     return QByteArray(packet.getData() + offset, NUM_BYTES_MD5_HASH);
 }
 
-QByteArray NLPacket::hashForPacketAndHMAC(const udt::Packet& packet, HMACAuth& hash) {
+QByteArray NLPacket::hashForPacketAndHMAC(const udt::Packet& packet, const HMACAuth& hash) {
     int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
         + NUM_BYTES_LOCALID + NUM_BYTES_MD5_HASH;
     
@@ -161,7 +163,18 @@ QByteArray NLPacket::hashForPacketAndHMAC(const udt::Packet& packet, HMACAuth& h
     if (!hash.calculateHash(hashResult, packet.getData() + offset, packet.getDataSize() - offset)) {
         return QByteArray();
     }
-    return QByteArray((const char*) hashResult.data(), (int) hashResult.size());
+
+    // longer digests are truncated to the size of the hash in the header
+    return QByteArray((const char*) hashResult.data(), std::min(hashResult.size, NUM_BYTES_MD5_HASH));
+}
+
+bool NLPacket::verifyHashInHeader(const udt::Packet& packet, const HMACAuth& hash) {
+    int hashOffset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) +
+        sizeof(PacketVersion) + NUM_BYTES_LOCALID;
+    int offset = hashOffset + NUM_BYTES_MD5_HASH;
+
+    return hash.verifyHash(packet.getData() + hashOffset, NUM_BYTES_MD5_HASH,
+                           packet.getData() + offset, packet.getDataSize() - offset);
 }
 
 void NLPacket::writeTypeAndVersion() {
@@ -216,14 +229,17 @@ void NLPacket::writeSourceID(LocalID sourceID) const {
     _sourceID = sourceID;
 }
 
-void NLPacket::writeVerificationHash(HMACAuth& hmacAuth) const {
+void NLPacket::writeVerificationHash(const HMACAuth& hmacAuth) const {
     Q_ASSERT(!PacketTypeEnum::getNonSourcedPackets().contains(_type) &&
              !PacketTypeEnum::getNonVerifiedPackets().contains(_type));
     
-    auto offset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
+    auto hashOffset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
                 + NUM_BYTES_LOCALID;
+    auto offset = hashOffset + NUM_BYTES_MD5_HASH;
 
-    QByteArray verificationHash = hashForPacketAndHMAC(*this, hmacAuth);
-    
-    memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
+    HMACAuth::HMACHash verificationHash;
+    if (hmacAuth.calculateHash(verificationHash, _packet.get() + offset, getDataSize() - offset)) {
+        // longer digests are truncated to the size of the hash in the header
+        memcpy(_packet.get() + hashOffset, verificationHash.data(), std::min(verificationHash.size, NUM_BYTES_MD5_HASH));
+    }
 }
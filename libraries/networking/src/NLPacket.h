@@ -51,7 +51,7 @@ public:
     static std::unique_ptr<NLPacket> create(PacketType type, qint64 size = -1,
                     bool isReliable = false, bool isPartOfMessage = false, PacketVersion version = 0);
     
-    static std::unique_ptr<NLPacket> fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+    static std::unique_ptr<NLPacket> fromReceivedPacket(udt::PacketBuffer data, qint64 size,
                                                         const HifiSockAddr& senderSockAddr);
 
     static std::unique_ptr<NLPacket> fromBase(std::unique_ptr<Packet> packet);
@@ -71,7 +71,9 @@ public:
     
     static LocalID sourceIDInHeader(const udt::Packet& packet);
     static QByteArray verificationHashInHeader(const udt::Packet& packet);
-    static QByteArray hashForPacketAndHMAC(const udt::Packet& packet, HMACAuth& hash);
+    static QByteArray hashForPacketAndHMAC(const udt::Packet& packet, const HMACAuth& hash);
+    // checks the verification hash in the header without copying it out or allocating
+    static bool verifyHashInHeader(const udt::Packet& packet, const HMACAuth& hash);
     
     PacketType getType() const { return _type; }
     void setType(PacketType type);
@@ -82,12 +84,12 @@ public:
     LocalID getSourceID() const { return _sourceID; }
     
     void writeSourceID(LocalID sourceID) const;
-    void writeVerificationHash(HMACAuth& hmacAuth) const;
+    void writeVerificationHash(const HMACAuth& hmacAuth) const;
 
 protected:
     
     NLPacket(PacketType type, qint64 size = -1, bool forceReliable = false, bool isPartOfMessage = false, PacketVersion version = 0);
-    NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr);
+    NLPacket(udt::PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr);
     
     NLPacket(const NLPacket& other);
     NLPacket(NLPacket&& other);
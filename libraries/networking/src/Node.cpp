@@ -38,6 +38,7 @@ static const QHash<NodeType_t, QString> TYPE_NAME_HASH {
     { NodeType::MessagesMixer, "Messages Mixer" },
     { NodeType::AssetServer, "Asset Server" },
     { NodeType::EntityScriptServer, "Entity Script Server" },
+    { NodeType::PhysicsServer, "Physics Server" },
     { NodeType::UpstreamAudioMixer, "Upstream Audio Mixer" },
     { NodeType::UpstreamAvatarMixer, "Upstream Avatar Mixer" },
     { NodeType::DownstreamAudioMixer, "Downstream Audio Mixer" },
@@ -113,15 +114,15 @@ void Node::updateClockSkewUsec(qint64 clockSkewSample) {
     _clockSkewUsec = (quint64)_clockSkewMovingPercentile.getValueAtPercentile();
 }
 
-Node::NodesIgnoredPair Node::parseIgnoreRequestMessage(QSharedPointer<ReceivedMessage> message) {
+Node::NodesIgnoredPair Node::parseIgnoreRequestMessage(ReceivedPacket& message) {
     bool addToIgnore;
-    message->readPrimitive(&addToIgnore);
+    message.readPrimitive(&addToIgnore);
 
     std::vector<QUuid> nodesIgnored;
 
-    while (message->getBytesLeftToRead()) {
+    while (message.getBytesLeftToRead()) {
         // parse out the UUID being ignored from the packet
-        QUuid ignoredUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        QUuid ignoredUUID = QUuid::fromRfc4122(message.readWithoutCopy(NUM_BYTES_RFC4122_UUID));
 
         if (addToIgnore) {
             addIgnoredNode(ignoredUUID);
@@ -207,13 +208,16 @@ QDebug operator<<(QDebug debug, const Node& node) {
     return debug.nospace();
 }
 
-void Node::setConnectionSecret(const QUuid& connectionSecret) {
-    if (_connectionSecret == connectionSecret) {
+void Node::setConnectionSecret(const QUuid& connectionSecret, HMACAuth::AuthMethod authMethod) {
+    if (_connectionSecret == connectionSecret && _authenticateHash && _authenticateHash->getAuthMethod() == authMethod) {
         return;
     }
 
     if (!_authenticateHash) {
-        _authenticateHash.reset(new HMACAuth());
+        _authenticateHash.reset(new HMACAuth(authMethod));
+    } else {
+        // the HMACAuth may be in use on other threads, so it is re-keyed in place rather than replaced
+        _authenticateHash->setAuthMethod(authMethod);
     }
 
     _connectionSecret = connectionSecret;
@@ -60,7 +60,7 @@ public:
     void setIsUpstream(bool isUpstream) { _isUpstream = isUpstream; }
 
     const QUuid& getConnectionSecret() const { return _connectionSecret; }
-    void setConnectionSecret(const QUuid& connectionSecret);
+    void setConnectionSecret(const QUuid& connectionSecret, HMACAuth::AuthMethod authMethod = HMACAuth::MD5);
     HMACAuth* getAuthenticateHash() const { return _authenticateHash.get(); }
 
     NodeData* getLinkedData() const { return _linkedData.get(); }
@@ -86,7 +86,7 @@ public:
 
     using NodesIgnoredPair = std::pair<std::vector<QUuid>, bool>;
 
-    NodesIgnoredPair parseIgnoreRequestMessage(QSharedPointer<ReceivedMessage> message);
+    NodesIgnoredPair parseIgnoreRequestMessage(ReceivedPacket& message);
     void addIgnoredNode(const QUuid& otherNodeID);
     void removeIgnoredNode(const QUuid& otherNodeID);
     bool isIgnoringNodeWithID(const QUuid& nodeID) const;
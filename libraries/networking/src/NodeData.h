@@ -27,7 +27,7 @@ class NodeData : public QObject {
 public:
     NodeData(const QUuid& nodeID = QUuid(), NetworkPeer::LocalID localID = NetworkPeer::NULL_LOCAL_ID);
     virtual ~NodeData() = default;
-    virtual int parseData(ReceivedMessage& message) { return 0; }
+    virtual int parseData(ReceivedPacket& message) { return 0; }
 
     const QUuid& getNodeID() const { return _nodeID; }
     NetworkPeer::LocalID getNodeLocalID() const { return _nodeLocalID; }
@@ -103,6 +103,9 @@ NodeList::NodeList(char newOwnerType, int socketListenPort, int dtlsListenPort)
     // anytime we get a new node we may need to re-send our set of ignored node IDs to it
     connect(this, &LimitedNodeList::nodeActivated, this, &NodeList::maybeSendIgnoreSetToNode);
 
+    // a node we drop on our own is one the domain-server still thinks we have, so ask it for a full list again
+    connect(this, &LimitedNodeList::nodeKilled, this, &NodeList::handleNodeKilled, Qt::DirectConnection);
+
     // setup our timer to send keepalive pings (it's started and stopped on domain connect/disconnect)
     _keepAlivePingTimer.setInterval(KEEPALIVE_PING_INTERVAL_MS); // 1s, Qt::CoarseTimer acceptable
     connect(&_keepAlivePingTimer, &QTimer::timeout, this, &NodeList::sendKeepAlivePings);
@@ -274,6 +277,11 @@ void NodeList::reset(bool skipDomainHandlerReset) {
     setSessionUUID(QUuid());
     setSessionLocalID(Node::NULL_LOCAL_ID);
 
+    // the next domain list has to be a full one
+    _domainListVersion = 0;
+    _pendingDomainList = std::make_tuple(0, false, 0);
+    _pendingDomainListEntries.clear();
+
     // if we setup the DTLS socket, also disconnect from the DTLS socket readyRead() so it can handle handshaking
     if (_dtlsSocket) {
         disconnect(_dtlsSocket, 0, this, 0);
@@ -282,10 +290,18 @@ void NodeList::reset(bool skipDomainHandlerReset) {
 
 void NodeList::addNodeTypeToInterestSet(NodeType_t nodeTypeToAdd) {
     _nodeTypesOfInterest << nodeTypeToAdd;
+    // deltas on our version would leave out the nodes of the new type
+    _domainListVersion = 0;
 }
 
 void NodeList::addSetOfNodeTypesToNodeInterestSet(const NodeSet& setOfNodeTypes) {
     _nodeTypesOfInterest.unite(setOfNodeTypes);
+    _domainListVersion = 0;
+}
+
+void NodeList::resetNodeInterestSet() {
+    _nodeTypesOfInterest.clear();
+    _domainListVersion = 0;
 }
 
 void NodeList::sendDomainServerCheckIn() {
@@ -407,6 +423,9 @@ void NodeList::sendDomainServerCheckIn() {
             // now add the machine fingerprint
             auto accountManager = DependencyManager::get<AccountManager>();
             packetStream << FingerprintUtils::getMachineFingerprint();
+
+            // and the packet authentication methods we can use, the domain-server refuses us if its own isn't one
+            packetStream << (quint32)HMACAuth::getSupportedMethods();
         }
 
         // pack our data to send to the domain-server including
@@ -414,6 +433,11 @@ void NodeList::sendDomainServerCheckIn() {
         packetStream << _ownerType.load() << publicSockAddr << localSockAddr << _nodeTypesOfInterest.toList();
         packetStream << DependencyManager::get<AddressManager>()->getPlaceName();
 
+        if (domainPacketType == PacketType::DomainListRequest) {
+            // the domain-server only sends what changed since the version of the list we have
+            packetStream << _domainListVersion.load();
+        }
+
         if (!domainIsConnected) {
             DataServerAccountInfo& accountInfo = accountManager->getAccountInfo();
             packetStream << accountInfo.getUsername();
@@ -689,10 +713,70 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     bool isAuthenticated;
     packetStream >> isAuthenticated;
     setAuthenticatePackets(isAuthenticated);
+    // Which keyed hash is used to authenticate?
+    quint8 authMethod;
+    packetStream >> authMethod;
+    setAuthenticationMethod((HMACAuth::AuthMethod)authMethod);
+
+    // a full list, or a delta on the version of the list named by baseVersion, spread over one or more packets
+    quint32 domainListVersion;
+    bool isDelta;
+    quint32 baseVersion;
+    quint32 numEntries;
+    packetStream >> domainListVersion >> isDelta >> baseVersion >> numEntries;
+
+    if (isDelta && domainListVersion < _domainListVersion) {
+        // a late delta, we already have every change it carries and maybe later ones to the same nodes
+        return;
+    }
+
+    auto pendingDomainList = std::make_tuple(domainListVersion, isDelta, baseVersion);
+    if (pendingDomainList != _pendingDomainList) {
+        if (std::get<0>(_pendingDomainList) != 0 && std::get<0>(_pendingDomainList) != _domainListVersion) {
+            // the list we were putting together never completed, some of its changes are lost for good
+            _domainListVersion = 0;
+        }
+        _pendingDomainList = pendingDomainList;
+        _pendingDomainListEntries.clear();
+    }
 
     // pull each node in the packet
     while (packetStream.device()->pos() < message->getSize()) {
-        parseNodeFromPacketStream(packetStream);
+        quint8 entry;
+        packetStream >> entry;
+
+        if ((DomainListEntry)entry == DomainListEntry::Removed) {
+            QUuid nodeUUID;
+            packetStream >> nodeUUID;
+            killNodeFromDomainList(nodeUUID);
+            removeDelayedAdd(nodeUUID);
+            _pendingDomainListEntries.insert(nodeUUID);
+        } else {
+            _pendingDomainListEntries.insert(parseNodeFromPacketStream(packetStream));
+        }
+    }
+
+    // once every packet of the list is in we are up to its version, a delta also needs every change before its base
+    bool hasBase = !isDelta || (_domainListVersion != 0 && baseVersion <= _domainListVersion);
+    if (hasBase && (quint32)_pendingDomainListEntries.size() >= numEntries) {
+        _domainListVersion = domainListVersion;
+    }
+}
+
+void NodeList::killNodeFromDomainList(const QUuid& nodeUUID) {
+    Q_ASSERT(QThread::currentThread() == thread());
+    _isKillingNodeFromDomainList = true;
+    killNodeWithUUID(nodeUUID);
+    _isKillingNodeFromDomainList = false;
+}
+
+void NodeList::handleNodeKilled(SharedNodePointer node) {
+    // nodes gone silent, killed by a peer or replaced on a connection reset are still in the domain-server's list,
+    // and deltas on our version would never add them back
+    // this is a direct connection, so kills on other threads must not read our flag as theirs
+    bool isKillFromDomainList = QThread::currentThread() == thread() && _isKillingNodeFromDomainList;
+    if (!isKillFromDomainList) {
+        _domainListVersion = 0;
     }
 }
 
@@ -708,11 +792,11 @@ void NodeList::processDomainServerRemovedNode(QSharedPointer<ReceivedMessage> me
     // read the UUID from the packet, remove it if it exists
     QUuid nodeUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
     qCDebug(networking) << "Received packet from domain-server to remove node with UUID" << uuidStringWithoutCurlyBraces(nodeUUID);
-    killNodeWithUUID(nodeUUID);
+    killNodeFromDomainList(nodeUUID);
     removeDelayedAdd(nodeUUID);
 }
 
-void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
+QUuid NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
     NewNodeInfo info;
 
     packetStream >> info.type
@@ -731,6 +815,8 @@ void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
     }
 
     addNewNode(info);
+
+    return info.uuid;
 }
 
 void NodeList::sendAssignment(Assignment& assignment) {
@@ -14,7 +14,9 @@
 
 #include <stdint.h>
 #include <iterator>
+#include <tuple>
 #include <assert.h>
+#include <atomic>
 
 #ifndef _WIN32
 #include <unistd.h> // not on windows, not needed for mac or windows
@@ -65,7 +67,7 @@ public:
     const NodeSet& getNodeInterestSet() const { return _nodeTypesOfInterest; }
     void addNodeTypeToInterestSet(NodeType_t nodeTypeToAdd);
     void addSetOfNodeTypesToNodeInterestSet(const NodeSet& setOfNodeTypes);
-    void resetNodeInterestSet() { _nodeTypesOfInterest.clear(); }
+    void resetNodeInterestSet();
 
     void setAssignmentServerSocket(const HifiSockAddr& serverSocket) { _assignmentServerSocket = serverSocket; }
     void sendAssignment(Assignment& assignment);
@@ -145,6 +147,8 @@ private slots:
 
     void maybeSendIgnoreSetToNode(SharedNodePointer node);
 
+    void handleNodeKilled(SharedNodePointer node);
+
 private:
     NodeList() : LimitedNodeList(INVALID_PORT, INVALID_PORT) { assert(false); } // Not implemented, needed for DependencyManager templates compile
     NodeList(char ownerType, int socketListenPort = INVALID_PORT, int dtlsListenPort = INVALID_PORT);
@@ -158,7 +162,8 @@ private:
 
     void sendDSPathQuery(const QString& newPath);
 
-    void parseNodeFromPacketStream(QDataStream& packetStream);
+    QUuid parseNodeFromPacketStream(QDataStream& packetStream);
+    void killNodeFromDomainList(const QUuid& nodeUUID);
 
     void pingPunchForInactiveNode(const SharedNodePointer& node);
 
@@ -174,6 +179,13 @@ private:
 
     bool _sendDomainServerCheckInEnabled { true };
 
+    // the version of the domain list we have every node of, reported in check-ins so the domain-server can send only
+    // what changed since, and the entries seen so far of the list being received, which can span several packets
+    std::atomic<quint32> _domainListVersion { 0 }; // also read by the check-in timer thread, reset by kills on any thread
+    std::tuple<quint32, bool, quint32> _pendingDomainList;
+    QSet<QUuid> _pendingDomainListEntries;
+    bool _isKillingNodeFromDomainList { false }; // kills the domain-server told us about keep our version, NodeList thread only
+
     mutable QReadWriteLock _ignoredSetLock;
     tbb::concurrent_unordered_set<QUuid, UUIDHasher> _ignoredNodeIDs;
     mutable QReadWriteLock _personalMutedSetLock;
@@ -174,10 +174,38 @@ void PacketReceiver::registerVerifiedListener(PacketType type, QObject* object,
             << "that will remove a previously registered listener";
     }
     
+    if (_packetHandlerMap.remove(type) > 0) {
+        qCWarning(networking) << "Registering a packet listener for packet type" << type
+            << "that will remove a previously registered packet handler";
+    }
+
     // add the mapping
     _messageListenerMap[type] = { QPointer<QObject>(object), slot, deliverPending };
 }
 
+void PacketReceiver::registerPacketHandler(PacketType type, QObject* owner, PacketHandler handler) {
+    Q_ASSERT_X(owner, "PacketReceiver::registerPacketHandler", "No owner to register");
+    Q_ASSERT_X(handler, "PacketReceiver::registerPacketHandler", "No handler to register");
+    QMutexLocker locker(&_packetListenerLock);
+
+    bool replacesListener = _messageListenerMap.remove(type) > 0;
+    if (replacesListener || _packetHandlerMap.contains(type)) {
+        qCWarning(networking) << "Registering a packet handler for packet type" << type
+            << "that will remove a previously registered listener";
+    }
+
+    qCDebug(networking) << "Registering a packet handler for packet type" << type;
+    _packetHandlerMap[type] = { QPointer<QObject>(owner), std::move(handler) };
+}
+
+void PacketReceiver::registerPacketHandlerForTypes(PacketTypeList types, QObject* owner, PacketHandler handler) {
+    Q_ASSERT_X(!types.empty(), "PacketReceiver::registerPacketHandlerForTypes", "No types to register");
+
+    for (PacketType type : types) {
+        registerPacketHandler(type, owner, handler);
+    }
+}
+
 void PacketReceiver::unregisterListener(QObject* listener) {
     Q_ASSERT_X(listener, "PacketReceiver::unregisterListener", "No listener to unregister");
     
@@ -194,6 +222,14 @@ void PacketReceiver::unregisterListener(QObject* listener) {
                 ++it;
             }
         }
+
+        for (auto it = _packetHandlerMap.begin(); it != _packetHandlerMap.end();) {
+            if (it.value().owner == listener) {
+                it = _packetHandlerMap.erase(it);
+            } else {
+                ++it;
+            }
+        }
     }
     
     QMutexLocker directConnectSetLocker(&_directConnectSetMutex);
@@ -206,10 +242,36 @@ void PacketReceiver::handleVerifiedPacket(std::unique_ptr<udt::Packet> packet) {
         return;
     }
     
-    auto nodeList = DependencyManager::get<LimitedNodeList>();
-    
     // setup an NLPacket from the packet we were passed
     auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+    Handler handler;
+    {
+        QMutexLocker packetListenerLocker(&_packetListenerLock);
+
+        auto it = _packetHandlerMap.find(nlPacket->getType());
+        if (it != _packetHandlerMap.end()) {
+            if (!it.value().owner) {
+                qCDebug(networking).nospace() << "Owner of the handler for packet " << nlPacket->getType()
+                    << " has been destroyed. Removing from handler map.";
+                _packetHandlerMap.erase(it);
+                return;
+            }
+            handler = it.value();
+        }
+    }
+
+    if (handler.function) {
+        SharedNodePointer matchingNode;
+        if (nlPacket->getSourceID() != Node::NULL_LOCAL_ID) {
+            matchingNode = DependencyManager::get<LimitedNodeList>()->nodeWithLocalID(nlPacket->getSourceID());
+        }
+
+        // no ReceivedMessage and no event - hand the packet itself straight to the handler on this thread
+        handler.function(std::make_shared<ReceivedPacket>(std::move(nlPacket)), matchingNode);
+        return;
+    }
+
     auto receivedMessage = QSharedPointer<ReceivedMessage>::create(*nlPacket);
 
     handleVerifiedMessage(receivedMessage, true);
@@ -258,71 +320,88 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
     if (receivedMessage->getSourceID() != Node::NULL_LOCAL_ID) {
         matchingNode = nodeList->nodeWithLocalID(receivedMessage->getSourceID());
     }
-    QMutexLocker packetListenerLocker(&_packetListenerLock);
-    
-    auto it = _messageListenerMap.find(receivedMessage->getType());
-    if (it != _messageListenerMap.end() && it->method.isValid()) {
-         
-        auto listener = it.value();
 
-        if ((listener.deliverPending && !justReceived) || (!listener.deliverPending && !receivedMessage->isComplete())) {
+    // only hold the listener lock for the lookup - messages can be dispatched from several udt receive workers at once
+    Listener listener;
+    {
+        QMutexLocker packetListenerLocker(&_packetListenerLock);
+
+        auto it = _messageListenerMap.find(receivedMessage->getType());
+        if (it == _messageListenerMap.end()) {
+            qCWarning(networking) << "No listener found for packet type" << receivedMessage->getType();
+
+            // insert a dummy listener so we don't print this again
+            _messageListenerMap.insert(receivedMessage->getType(), { nullptr, QMetaMethod(), false });
             return;
         }
-            
-        bool success = false;
 
-        Qt::ConnectionType connectionType;
-        // check if this is a directly connected listener
-        {
-            QMutexLocker directConnectLocker(&_directConnectSetMutex);
-            connectionType = _directlyConnectedObjects.contains(listener.object) ? Qt::DirectConnection : Qt::AutoConnection;
-        }
+        listener = it.value();
+    }
+
+    if (!listener.method.isValid()) {
+        return;
+    }
+
+    if ((listener.deliverPending && !justReceived) || (!listener.deliverPending && !receivedMessage->isComplete())) {
+        return;
+    }
 
-        QMetaMethod metaMethod = listener.method;
+    bool success = false;
 
-        static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
-        static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
+    Qt::ConnectionType connectionType;
+    // check if this is a directly connected listener
+    {
+        QMutexLocker directConnectLocker(&_directConnectSetMutex);
+        connectionType = _directlyConnectedObjects.contains(listener.object) ? Qt::DirectConnection : Qt::AutoConnection;
+    }
 
-        // one final check on the QPointer before we go to invoke
-        if (listener.object) {
-            if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
-                success = metaMethod.invoke(listener.object,
-                                            connectionType,
-                                            Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
-                                            Q_ARG(SharedNodePointer, matchingNode));
+    QMetaMethod metaMethod = listener.method;
 
-            } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
-                success = metaMethod.invoke(listener.object,
-                                            connectionType,
-                                            Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
-                                            Q_ARG(QSharedPointer<Node>, matchingNode));
+    static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
+    static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
+
+    // one final check on the QPointer before we go to invoke
+    if (listener.object) {
+        if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
+            success = metaMethod.invoke(listener.object,
+                                        connectionType,
+                                        Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
+                                        Q_ARG(SharedNodePointer, matchingNode));
+
+        } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
+            success = metaMethod.invoke(listener.object,
+                                        connectionType,
+                                        Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
+                                        Q_ARG(QSharedPointer<Node>, matchingNode));
 
-            } else {
-                success = metaMethod.invoke(listener.object,
-                                            connectionType,
-                                            Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
-            }
         } else {
-            qCDebug(networking).nospace() << "Listener for packet " << receivedMessage->getType()
-                << " has been destroyed. Removing from listener map.";
-            it = _messageListenerMap.erase(it);
-
-            // if it exists, remove the listener from _directlyConnectedObjects
-            {
-                QMutexLocker directConnectLocker(&_directConnectSetMutex);
-                _directlyConnectedObjects.remove(listener.object);
+            success = metaMethod.invoke(listener.object,
+                                        connectionType,
+                                        Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
+        }
+    } else {
+        qCDebug(networking).nospace() << "Listener for packet " << receivedMessage->getType()
+            << " has been destroyed. Removing from listener map.";
+
+        {
+            QMutexLocker packetListenerLocker(&_packetListenerLock);
+
+            // the listener may have been replaced while we weren't holding the lock
+            auto it = _messageListenerMap.find(receivedMessage->getType());
+            if (it != _messageListenerMap.end() && !it.value().object && it.value().method == listener.method) {
+                _messageListenerMap.erase(it);
             }
         }
 
-        if (!success) {
-            qCDebug(networking).nospace() << "Error delivering packet " << receivedMessage->getType() << " to listener "
-                << listener.object << "::" << qPrintable(listener.method.methodSignature());
+        // if it exists, remove the listener from _directlyConnectedObjects
+        {
+            QMutexLocker directConnectLocker(&_directConnectSetMutex);
+            _directlyConnectedObjects.remove(listener.object);
         }
+    }
 
-    } else if (it == _messageListenerMap.end()) {
-        qCWarning(networking) << "No listener found for packet type" << receivedMessage->getType();
-        
-        // insert a dummy listener so we don't print this again
-        _messageListenerMap.insert(receivedMessage->getType(), { nullptr, QMetaMethod(), false });
+    if (!success) {
+        qCDebug(networking).nospace() << "Error delivering packet " << receivedMessage->getType() << " to listener "
+            << listener.object << "::" << qPrintable(listener.method.methodSignature());
     }
 }
@@ -13,6 +13,8 @@
 #ifndef hifi_PacketReceiver_h
 #define hifi_PacketReceiver_h
 
+#include <atomic>
+#include <functional>
 #include <vector>
 #include <unordered_map>
 
@@ -25,7 +27,9 @@
 
 #include "NLPacket.h"
 #include "NLPacketList.h"
+#include "Node.h"
 #include "ReceivedMessage.h"
+#include "ReceivedPacket.h"
 #include "udt/PacketHeaders.h"
 
 class EntityEditPacketSender;
@@ -44,6 +48,7 @@ class PacketReceiver : public QObject {
     Q_OBJECT
 public:
     using PacketTypeList = std::vector<PacketType>;
+    using PacketHandler = std::function<void(ReceivedPacketPointer, SharedNodePointer)>;
     
     PacketReceiver(QObject* parent = 0);
     PacketReceiver(const PacketReceiver&) = delete;
@@ -57,6 +62,14 @@ public:
     // for the message is received.
     bool registerListener(PacketType type, QObject* listener, const char* slot, bool deliverPending = false);
     bool registerListenerForTypes(PacketTypeList types, QObject* listener, const char* slot);
+
+    // For unreliable single-packet types that are parsed once and dropped.  The handler gets a ReceivedPacket that
+    // views the packet without copying it, and is called directly on the thread that received the packet - there is
+    // no queued slot invocation, so the handler must be thread-safe.  It is dropped when the owner is destroyed
+    // or unregistered.
+    void registerPacketHandler(PacketType type, QObject* owner, PacketHandler handler);
+    void registerPacketHandlerForTypes(PacketTypeList types, QObject* owner, PacketHandler handler);
+
     void unregisterListener(QObject* listener);
     
     void handleVerifiedPacket(std::unique_ptr<udt::Packet> packet);
@@ -70,6 +83,11 @@ private:
         bool deliverPending;
     };
 
+    struct Handler {
+        QPointer<QObject> owner;
+        PacketHandler function;
+    };
+
     void handleVerifiedMessage(QSharedPointer<ReceivedMessage> message, bool justReceived);
 
     // these are brutal hacks for now - ideally GenericThread / ReceivedPacketProcessor
@@ -82,8 +100,9 @@ private:
 
     QMutex _packetListenerLock;
     QHash<PacketType, Listener> _messageListenerMap;
+    QHash<PacketType, Handler> _packetHandlerMap;
 
-    bool _shouldDropPackets = false;
+    std::atomic<bool> _shouldDropPackets { false };
     QMutex _directConnectSetMutex;
     QSet<QObject*> _directlyConnectedObjects;
 
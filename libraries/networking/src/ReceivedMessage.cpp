@@ -19,42 +19,36 @@ int sharedPtrReceivedMessageMetaTypeId = qRegisterMetaType<QSharedPointer<Receiv
 
 static const int HEAD_DATA_SIZE = 512;
 
-ReceivedMessage::ReceivedMessage(const NLPacketList& packetList)
-    : _data(packetList.getMessage()),
-      _headData(_data.mid(0, HEAD_DATA_SIZE)),
-      _numPackets(packetList.getNumPackets()),
-      _sourceID(packetList.getSourceID()),
-      _packetType(packetList.getType()),
-      _packetVersion(packetList.getVersion()),
-      _senderSockAddr(packetList.getSenderSockAddr())
+ReceivedMessage::ReceivedMessage(const NLPacketList& packetList) :
+    ReceivedPacket(packetList.getMessage(), packetList.getType(), packetList.getVersion(),
+                   packetList.getSenderSockAddr(), packetList.getSourceID()),
+    _headData(_data.mid(0, HEAD_DATA_SIZE)),
+    _numPackets(packetList.getNumPackets())
 {
 }
 
-ReceivedMessage::ReceivedMessage(NLPacket& packet)
-    : _data(packet.readAll()),
-      _headData(_data.mid(0, HEAD_DATA_SIZE)),
-      _numPackets(1),
-      _sourceID(packet.getSourceID()),
-      _packetType(packet.getType()),
-      _packetVersion(packet.getVersion()),
-      _senderSockAddr(packet.getSenderSockAddr()),
-      _isComplete(packet.getPacketPosition() == NLPacket::ONLY)
+ReceivedMessage::ReceivedMessage(NLPacket& packet) :
+    ReceivedPacket(packet.readAll(), packet.getType(), packet.getVersion(),
+                   packet.getSenderSockAddr(), packet.getSourceID()),
+    _headData(_data.mid(0, HEAD_DATA_SIZE)),
+    _numPackets(1),
+    _isComplete(packet.getPacketPosition() == NLPacket::ONLY)
 {
 }
 
 ReceivedMessage::ReceivedMessage(QByteArray byteArray, PacketType packetType, PacketVersion packetVersion,
                 const HifiSockAddr& senderSockAddr, NLPacket::LocalID sourceID) :
-    _data(byteArray),
+    ReceivedPacket(byteArray, packetType, packetVersion, senderSockAddr, sourceID),
     _headData(_data.mid(0, HEAD_DATA_SIZE)),
     _numPackets(1),
-    _sourceID(sourceID),
-    _packetType(packetType),
-    _packetVersion(packetVersion),
-    _senderSockAddr(senderSockAddr),
     _isComplete(true)
 {
 }
 
+ReceivedPacketPointer ReceivedMessage::toPacketPointer(QSharedPointer<ReceivedMessage> message) {
+    return ReceivedPacketPointer(message.data(), [message](ReceivedPacket*) {});
+}
+
 void ReceivedMessage::setFailed() {
     _failed = true;
     _isComplete = true;
@@ -82,58 +76,18 @@ void ReceivedMessage::appendPacket(NLPacket& packet) {
     }
 }
 
-qint64 ReceivedMessage::peek(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
-    return size;
-}
-
-qint64 ReceivedMessage::read(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
-    _position += size;
-    return size;
-}
-
 qint64 ReceivedMessage::readHead(char* data, qint64 size) {
     memcpy(data, _headData.constData() + _position, size);
     _position += size;
     return size;
 }
 
-QByteArray ReceivedMessage::peek(qint64 size) {
-    return _data.mid(_position, size);
-}
-
-QByteArray ReceivedMessage::read(qint64 size) {
-    auto data = _data.mid(_position, size);
-    _position += size;
-    return data;
-}
-
 QByteArray ReceivedMessage::readHead(qint64 size) {
     auto data = _headData.mid(_position, size);
     _position += size;
     return data;
 }
 
-QByteArray ReceivedMessage::readAll() {
-    return read(getBytesLeftToRead());
-}
-
-QString ReceivedMessage::readString() {
-    uint32_t size;
-    readPrimitive(&size);
-    //Q_ASSERT(size <= _size - _position);
-    auto string = QString::fromUtf8(_data.constData() + _position, size);
-    _position += size;
-    return string;
-}
-
-QByteArray ReceivedMessage::readWithoutCopy(qint64 size) {
-    QByteArray data { QByteArray::fromRawData(_data.constData() + _position, size) };
-    _position += size;
-    return data;
-}
-
 void ReceivedMessage::onComplete() {
     _isComplete = true;
     emit completed();
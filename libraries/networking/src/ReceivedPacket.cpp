@@ -0,0 +1,88 @@
+//
+//  ReceivedPacket.cpp
+//  libraries/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceivedPacket.h"
+
+#include <algorithm>
+
+ReceivedPacket::ReceivedPacket(std::unique_ptr<NLPacket> packet) :
+    _data(QByteArray::fromRawData(packet->getPayload(), packet->getPayloadSize())),
+    _sourceID(packet->getSourceID()),
+    _packetType(packet->getType()),
+    _packetVersion(packet->getVersion()),
+    _senderSockAddr(packet->getSenderSockAddr()),
+    _packet(std::move(packet))
+{
+}
+
+ReceivedPacket::ReceivedPacket(QByteArray data, PacketType packetType, PacketVersion packetVersion,
+                               const HifiSockAddr& senderSockAddr, NLPacket::LocalID sourceID) :
+    _data(data),
+    _sourceID(sourceID),
+    _packetType(packetType),
+    _packetVersion(packetVersion),
+    _senderSockAddr(senderSockAddr)
+{
+}
+
+QByteArray ReceivedPacket::copy(qint64 position, qint64 size) const {
+    if (!_packet) {
+        return _data.mid(position, size);
+    }
+
+    // mid() of raw data hands back the raw data itself when asked for all of it, so copy explicitly
+    size = std::max((qint64)0, std::min(size, _data.size() - position));
+    return QByteArray(_data.constData() + position, size);
+}
+
+QByteArray ReceivedPacket::getMessage() const {
+    return _packet ? copy(0, _data.size()) : _data;
+}
+
+qint64 ReceivedPacket::peek(char* data, qint64 size) {
+    memcpy(data, _data.constData() + _position, size);
+    return size;
+}
+
+qint64 ReceivedPacket::read(char* data, qint64 size) {
+    memcpy(data, _data.constData() + _position, size);
+    _position += size;
+    return size;
+}
+
+QByteArray ReceivedPacket::peek(qint64 size) {
+    return copy(_position, size);
+}
+
+QByteArray ReceivedPacket::read(qint64 size) {
+    auto data = copy(_position, size);
+    _position += size;
+    return data;
+}
+
+QByteArray ReceivedPacket::readAll() {
+    return read(getBytesLeftToRead());
+}
+
+QString ReceivedPacket::readString() {
+    uint32_t size;
+    readPrimitive(&size);
+    //Q_ASSERT(size <= _size - _position);
+    auto string = QString::fromUtf8(_data.constData() + _position, size);
+    _position += size;
+    return string;
+}
+
+QByteArray ReceivedPacket::readWithoutCopy(qint64 size) {
+    QByteArray data { QByteArray::fromRawData(_data.constData() + _position, size) };
+    _position += size;
+    return data;
+}
@@ -0,0 +1,96 @@
+//
+//  ReceivedPacket.h
+//  libraries/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReceivedPacket_h
+#define hifi_ReceivedPacket_h
+
+#include <atomic>
+#include <memory>
+
+#include <QByteArray>
+
+#include "NLPacket.h"
+
+// The read side of a received message.  On its own it is a view of a single NLPacket's payload - no QObject,
+// no copy of the data - for the unreliable single-packet streams that are parsed once and dropped.
+// ReceivedMessage extends it with reassembly of multi-packet messages and the progress/completed signals.
+class ReceivedPacket {
+public:
+    ReceivedPacket(std::unique_ptr<NLPacket> packet);
+    ReceivedPacket(const ReceivedPacket&) = delete;
+    ReceivedPacket& operator=(const ReceivedPacket&) = delete;
+
+    // for a packet view this is a copy, since the returned array could outlive the packet
+    QByteArray getMessage() const;
+    const char* getRawMessage() const { return _data.constData(); }
+
+    PacketType getType() const { return _packetType; }
+    PacketVersion getVersion() const { return _packetVersion; }
+
+    NLPacket::LocalID getSourceID() const { return _sourceID; }
+    const HifiSockAddr& getSenderSockAddr() const { return _senderSockAddr; }
+
+    qint64 getPosition() const { return _position; }
+
+    qint64 getSize() const { return _data.size(); }
+
+    qint64 getBytesLeftToRead() const { return _data.size() -  _position; }
+
+    void seek(qint64 position) { _position = position; }
+
+    qint64 peek(char* data, qint64 size);
+    qint64 read(char* data, qint64 size);
+
+    QByteArray peek(qint64 size);
+    QByteArray read(qint64 size);
+    QByteArray readAll();
+
+    QString readString();
+
+    // This will return a QByteArray referencing the underlying data _without_ refcounting that data.
+    // Be careful when using this method, only use it when the lifetime of the returned QByteArray will not
+    // exceed that of the ReceivedPacket.
+    QByteArray readWithoutCopy(qint64 size);
+
+    template<typename T> qint64 peekPrimitive(T* data);
+    template<typename T> qint64 readPrimitive(T* data);
+
+protected:
+    ReceivedPacket(QByteArray data, PacketType packetType, PacketVersion packetVersion,
+                   const HifiSockAddr& senderSockAddr, NLPacket::LocalID sourceID);
+
+    QByteArray _data;
+
+    std::atomic<qint64> _position { 0 };
+
+    NLPacket::LocalID _sourceID { NLPacket::NULL_LOCAL_ID };
+    PacketType _packetType;
+    PacketVersion _packetVersion;
+    HifiSockAddr _senderSockAddr;
+
+private:
+    QByteArray copy(qint64 position, qint64 size) const;
+
+    // set for a packet view, _data is raw data inside of it
+    std::unique_ptr<NLPacket> _packet;
+};
+
+using ReceivedPacketPointer = std::shared_ptr<ReceivedPacket>;
+
+template<typename T> qint64 ReceivedPacket::peekPrimitive(T* data) {
+    return peek(reinterpret_cast<char*>(data), sizeof(T));
+}
+
+template<typename T> qint64 ReceivedPacket::readPrimitive(T* data) {
+    return read(reinterpret_cast<char*>(data), sizeof(T));
+}
+
+#endif // hifi_ReceivedPacket_h
@@ -20,6 +20,7 @@
 #include <LogHandler.h>
 
 #include "NetworkLogging.h"
+#include "udt/PacketBufferPool.h"
 
 ThreadedAssignment::ThreadedAssignment(ReceivedMessage& message) :
     Assignment(message),
@@ -100,6 +101,11 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject statsObjec
     ioStats["outbound_kbps"] = nodeList->getOutboundKbps();
     ioStats["outbound_pps"] = nodeList->getOutboundPPS();
 
+    auto bufferPoolStats = udt::PacketBufferPool::getStats();
+    ioStats["buffer_pool_hits"] = (qint64)bufferPoolStats.hits;
+    ioStats["buffer_pool_misses"] = (qint64)bufferPoolStats.misses;
+    ioStats["buffer_pool_free"] = (qint64)bufferPoolStats.numFree;
+
     statsObject["io_stats"] = ioStats;
 
     QJsonObject assignmentStats;
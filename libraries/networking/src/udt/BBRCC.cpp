@@ -0,0 +1,333 @@
+//
+//  BBRCC.cpp
+//  libraries/networking/src/udt
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BBRCC.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore/QtGlobal>
+
+using namespace udt;
+using namespace std::chrono;
+
+// 2/ln(2) - the smallest gain that still doubles the delivery rate every round trip during startup
+static const double STARTUP_GAIN = 2.885;
+static const double DRAIN_GAIN = 1.0 / STARTUP_GAIN;
+static const double PROBE_BANDWIDTH_CONGESTION_WINDOW_GAIN = 2.0;
+
+// probe for more bandwidth for one min RTT, drain what that queued for the next, then cruise for six
+static const double PROBE_BANDWIDTH_GAINS[] = { 1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+static const int PROBE_BANDWIDTH_CYCLE_LENGTH = sizeof(PROBE_BANDWIDTH_GAINS) / sizeof(PROBE_BANDWIDTH_GAINS[0]);
+
+// startup is done once the delivery rate hasn't grown by a quarter for three round trips
+static const double FULL_BANDWIDTH_GROWTH = 1.25;
+static const int FULL_BANDWIDTH_ROUNDS = 3;
+
+static const auto MIN_RTT_WINDOW = seconds(10);
+static const auto PROBE_RTT_DURATION = milliseconds(200);
+
+static const int MIN_CONGESTION_WINDOW_PACKETS = 4;
+
+static const double PACKET_SIZE_ESTIMATION_ALPHA = 0.125;
+
+BBRCC::BBRCC() :
+    _pacingGain(STARTUP_GAIN),
+    _congestionWindowGain(STARTUP_GAIN)
+{
+    // unpaced and window limited until the first delivery rate sample
+    _packetSendPeriod = 0.0;
+
+    auto now = p_high_resolution_clock::now();
+    _deliveredTime = now;
+    _minRTTStamp = now;
+    _cycleStamp = now;
+}
+
+bool BBRCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point receiveTime) {
+    if (ack == _lastACK) {
+        ++_duplicateACKCount;
+        return needsFastRetransmit(ack);
+    }
+
+    _lastACK = ack;
+    _duplicateACKCount = 0;
+
+    // pop everything this ACK covers, keeping the newest for the RTT and delivery rate samples
+    bool canBeUsedForRTT = true;
+    bool foundACKedPacket = false;
+    SentPacketData ackedPacket;
+    int numACKedPackets = 0;
+
+    while (!_sentPacketDatas.empty() && _sentPacketDatas.front().sequenceNumber <= ack) {
+        auto& packet = _sentPacketDatas.front();
+
+        _delivered += packet.wireSize;
+        _bytesInFlight -= packet.wireSize;
+        canBeUsedForRTT = canBeUsedForRTT && !packet.wasResent;
+        ++numACKedPackets;
+
+        if (packet.sequenceNumber == ack) {
+            ackedPacket = packet;
+            foundACKedPacket = true;
+        }
+
+        _sentPacketDatas.pop_front();
+    }
+    _deliveredTime = receiveTime;
+
+    if (foundACKedPacket) {
+        if (canBeUsedForRTT) {
+            updateRTT(duration_cast<microseconds>(receiveTime - ackedPacket.timePoint).count(), receiveTime);
+        }
+        updateBandwidth(ackedPacket, receiveTime);
+    }
+
+    updateMode(receiveTime);
+    updateControlParameters(numACKedPackets);
+
+    return false;
+}
+
+bool BBRCC::needsFastRetransmit(SequenceNumber ack) {
+    // re-send ack + 1 if it has been out for longer than our estimated timeout, or on the third duplicate ACK
+    if (!_sentPacketDatas.empty() && _sentPacketDatas.front().sequenceNumber == ack + 1) {
+        auto sinceSend = duration_cast<microseconds>(p_high_resolution_clock::now()
+                                                     - _sentPacketDatas.front().timePoint).count();
+        if (sinceSend >= estimatedTimeout()) {
+            _duplicateACKCount = 0;
+            return true;
+        }
+    }
+
+    static const int RENO_FAST_RETRANSMIT_DUPLICATE_COUNT = 3;
+    if (_duplicateACKCount == RENO_FAST_RETRANSMIT_DUPLICATE_COUNT) {
+        _duplicateACKCount = 0;
+        return true;
+    }
+
+    return false;
+}
+
+void BBRCC::updateRTT(int rtt, p_high_resolution_clock::time_point now) {
+    const int MAX_RTT_SAMPLE_MICROSECONDS = 10000000;
+    rtt = std::min(std::max(rtt, 1), MAX_RTT_SAMPLE_MICROSECONDS);
+
+    // Jacobson's estimation, as TCPVegasCC does it, for the re-transmit timeout
+    if (_ewmaRTT == -1) {
+        _ewmaRTT = rtt;
+        _rttVariance = rtt / 2;
+    } else {
+        static const int RTT_ESTIMATION_ALPHA = 8;
+        static const int RTT_ESTIMATION_VARIANCE_ALPHA = 4;
+
+        _ewmaRTT = (_ewmaRTT * (RTT_ESTIMATION_ALPHA - 1) + rtt) / RTT_ESTIMATION_ALPHA;
+        _rttVariance = (_rttVariance * (RTT_ESTIMATION_VARIANCE_ALPHA - 1)
+                        + abs(rtt - _ewmaRTT)) / RTT_ESTIMATION_VARIANCE_ALPHA;
+    }
+
+    // the min RTT is only trusted for MIN_RTT_WINDOW, after which we go and measure it again in ProbeRTT
+    _isMinRTTExpired = now > _minRTTStamp + MIN_RTT_WINDOW;
+    if (rtt <= _minRTT || _isMinRTTExpired) {
+        _minRTT = rtt;
+        _minRTTStamp = now;
+    }
+}
+
+void BBRCC::updateBandwidth(const SentPacketData& packet, p_high_resolution_clock::time_point now) {
+    // a round trip ends when a packet sent after the last one started is ACKed
+    _isRoundStart = packet.delivered >= _nextRoundDelivered;
+    if (_isRoundStart) {
+        _nextRoundDelivered = _delivered;
+    }
+
+    // ProbeRTT is window limited on purpose - keep its rounds and samples out of the bandwidth filter
+    // or a short RTT would age every real sample out of it before we're done probing
+    if (_mode == Mode::ProbeRTT) {
+        return;
+    }
+
+    if (_isRoundStart) {
+        ++_roundCount;
+
+        auto& sample = _bandwidthSamples[_roundCount % BANDWIDTH_FILTER_ROUNDS];
+        sample.round = _roundCount;
+        sample.bandwidth = 0.0;
+    }
+
+    // the delivery rate over the time it took to ACK everything sent since this packet left
+    // anything shorter than the min RTT is ACK compression and would overestimate the bandwidth
+    auto interval = duration_cast<microseconds>(now - packet.deliveredTime).count();
+    if (interval <= 0 || interval < _minRTT) {
+        return;
+    }
+
+    double bandwidth = (double)(_delivered - packet.delivered) / interval;
+
+    auto& sample = _bandwidthSamples[_roundCount % BANDWIDTH_FILTER_ROUNDS];
+    sample.round = _roundCount;
+    sample.bandwidth = std::max(sample.bandwidth, bandwidth);
+}
+
+double BBRCC::getBottleneckBandwidth() const {
+    double bandwidth = 0.0;
+    for (auto& sample : _bandwidthSamples) {
+        if (sample.round > _roundCount - BANDWIDTH_FILTER_ROUNDS) {
+            bandwidth = std::max(bandwidth, sample.bandwidth);
+        }
+    }
+    return bandwidth;
+}
+
+int64_t BBRCC::getBandwidthDelayProduct() const {
+    if (_minRTT == std::numeric_limits<int>::max()) {
+        return 0;
+    }
+    return (int64_t)(getBottleneckBandwidth() * _minRTT);
+}
+
+void BBRCC::checkFullPipe() {
+    if (_isFullPipe || !_isRoundStart) {
+        return;
+    }
+
+    auto bandwidth = getBottleneckBandwidth();
+    if (bandwidth >= _fullBandwidth * FULL_BANDWIDTH_GROWTH) {
+        // still growing, check again in FULL_BANDWIDTH_ROUNDS
+        _fullBandwidth = bandwidth;
+        _fullBandwidthCount = 0;
+    } else if (++_fullBandwidthCount >= FULL_BANDWIDTH_ROUNDS) {
+        _isFullPipe = true;
+    }
+}
+
+void BBRCC::enterProbeBandwidth(p_high_resolution_clock::time_point now) {
+    _mode = Mode::ProbeBandwidth;
+    _congestionWindowGain = PROBE_BANDWIDTH_CONGESTION_WINDOW_GAIN;
+
+    // start cruising rather than at a random phase, so runs over an emulated link can be compared
+    _cycleIndex = 2;
+    _cycleStamp = now;
+    _pacingGain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+}
+
+void BBRCC::updateMode(p_high_resolution_clock::time_point now) {
+    checkFullPipe();
+
+    if (_mode == Mode::Startup && _isFullPipe) {
+        // drain the queue we built up finding the bandwidth
+        _mode = Mode::Drain;
+        _pacingGain = DRAIN_GAIN;
+        _congestionWindowGain = STARTUP_GAIN;
+    }
+
+    if (_mode == Mode::Drain && _bytesInFlight <= getBandwidthDelayProduct()) {
+        enterProbeBandwidth(now);
+    }
+
+    if (_mode == Mode::ProbeBandwidth && _minRTT != std::numeric_limits<int>::max()
+        && now - _cycleStamp > microseconds(_minRTT)) {
+        _cycleIndex = (_cycleIndex + 1) % PROBE_BANDWIDTH_CYCLE_LENGTH;
+        _cycleStamp = now;
+        _pacingGain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+    }
+
+    if (_mode != Mode::ProbeRTT && _isMinRTTExpired) {
+        // drop to a handful of packets in flight for long enough to see the propagation delay again
+        _mode = Mode::ProbeRTT;
+        _pacingGain = 1.0;
+        _congestionWindowGain = 1.0;
+        _isProbeRTTDoneStampSet = false;
+        _priorCongestionWindowSize = _congestionWindowSize;
+    }
+
+    if (_mode == Mode::ProbeRTT) {
+        if (!_isProbeRTTDoneStampSet) {
+            if (_bytesInFlight <= MIN_CONGESTION_WINDOW_PACKETS * _averagePacketSize) {
+                _probeRTTDoneStamp = now + PROBE_RTT_DURATION;
+                _isProbeRTTDoneStampSet = true;
+            }
+        } else if (now > _probeRTTDoneStamp) {
+            _minRTTStamp = now;
+            _isMinRTTExpired = false;
+            _congestionWindowSize = std::max(_congestionWindowSize, _priorCongestionWindowSize);
+
+            if (_isFullPipe) {
+                enterProbeBandwidth(now);
+            } else {
+                _mode = Mode::Startup;
+                _pacingGain = STARTUP_GAIN;
+                _congestionWindowGain = STARTUP_GAIN;
+            }
+        }
+    }
+}
+
+void BBRCC::updateControlParameters(int numACKedPackets) {
+    auto bandwidth = getBottleneckBandwidth();
+
+    if (bandwidth > 0.0) {
+        double packetSendPeriod = _averagePacketSize / (_pacingGain * bandwidth);
+
+        // during startup only ever speed up, a low sample there is most likely us not having sent enough yet
+        if (_isFullPipe || _packetSendPeriod == 0.0 || packetSendPeriod < _packetSendPeriod) {
+            setPacketSendPeriod(packetSendPeriod);
+        }
+    }
+
+    if (_mode == Mode::ProbeRTT) {
+        _congestionWindowSize = MIN_CONGESTION_WINDOW_PACKETS;
+        return;
+    }
+
+    auto bandwidthDelayProduct = getBandwidthDelayProduct();
+    if (bandwidthDelayProduct > 0) {
+        int targetWindowSize = (int)std::ceil(_congestionWindowGain * bandwidthDelayProduct / _averagePacketSize);
+
+        // grow towards the target as packets are ACKed, so the window never opens up faster than the pipe drains
+        if (_isFullPipe) {
+            _congestionWindowSize = std::min(_congestionWindowSize + numACKedPackets, targetWindowSize);
+        } else if (_congestionWindowSize < targetWindowSize) {
+            _congestionWindowSize += numACKedPackets;
+        }
+    } else {
+        _congestionWindowSize += numACKedPackets;
+    }
+
+    _congestionWindowSize = std::min(std::max(_congestionWindowSize, MIN_CONGESTION_WINDOW_PACKETS),
+                                     udt::MAX_PACKETS_IN_FLIGHT);
+}
+
+int BBRCC::estimatedTimeout() const {
+    return _ewmaRTT == -1 ? DEFAULT_SYN_INTERVAL : _ewmaRTT + _rttVariance * 4;
+}
+
+void BBRCC::onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    _sentPacketDatas.push_back({ seqNum, timePoint, _delivered, _deliveredTime, wireSize });
+    _bytesInFlight += wireSize;
+
+    _averagePacketSize += PACKET_SIZE_ESTIMATION_ALPHA * (wireSize - _averagePacketSize);
+}
+
+void BBRCC::onPacketReSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    // packets are sent in sequence number order, so the one we want is at its offset from the front
+    if (_sentPacketDatas.empty()) {
+        return;
+    }
+
+    auto offset = seqoff(_sentPacketDatas.front().sequenceNumber, seqNum);
+    if (offset >= 0 && offset < (int)_sentPacketDatas.size()) {
+        // mark it so it isn't used for an RTT sample, and restart its clock for the fast re-transmit timeout
+        auto& packet = _sentPacketDatas[offset];
+        packet.wasResent = true;
+        packet.timePoint = timePoint;
+    }
+}
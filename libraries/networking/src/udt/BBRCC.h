@@ -0,0 +1,123 @@
+//
+//  BBRCC.h
+//  libraries/networking/src/udt
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_BBRCC_h
+#define hifi_BBRCC_h
+
+#include <deque>
+#include <limits>
+
+#include "CongestionControl.h"
+#include "Constants.h"
+
+namespace udt {
+
+// Model-based congestion control, after BBR (https://queue.acm.org/detail.cfm?id=3022184)
+//   Rather than reacting to loss or queueing delay, this keeps a running estimate of the bottleneck bandwidth
+//   (windowed max of the delivery rate) and the round-trip propagation time (windowed min RTT), paces packets out
+//   at a gain of that bandwidth and caps the packets in flight at a gain of their product.
+//   Loss is not a congestion signal here - lost packets are re-sent through the usual fast re-transmit.
+class BBRCC : public CongestionControl {
+public:
+    BBRCC();
+
+    virtual bool onACK(SequenceNumber ackNum, p_high_resolution_clock::time_point receiveTime) override;
+    virtual void onTimeout() override {};
+
+    virtual void onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+    virtual void onPacketReSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+
+    virtual int estimatedTimeout() const override;
+
+    double getBottleneckBandwidth() const; // bytes per microsecond, 0 until the first delivery rate sample
+    int getMinRTT() const { return _minRTT; } // microseconds, max int until the first RTT sample
+    bool isProbingRTT() const { return _mode == Mode::ProbeRTT; }
+
+protected:
+    virtual void setInitialSendSequenceNumber(SequenceNumber seqNum) override { _lastACK = seqNum - 1; }
+
+private:
+    enum class Mode {
+        Startup,
+        Drain,
+        ProbeBandwidth,
+        ProbeRTT
+    };
+
+    struct SentPacketData {
+        SequenceNumber sequenceNumber;
+        p_high_resolution_clock::time_point timePoint;
+        int64_t delivered; // _delivered when this packet was sent
+        p_high_resolution_clock::time_point deliveredTime; // _deliveredTime when this packet was sent
+        int wireSize;
+        bool wasResent { false };
+    };
+
+    struct BandwidthSample {
+        int64_t round { -1 };
+        double bandwidth { 0.0 };
+    };
+
+    static const int BANDWIDTH_FILTER_ROUNDS = 10;
+
+    void updateRTT(int rtt, p_high_resolution_clock::time_point now);
+    void updateBandwidth(const SentPacketData& packet, p_high_resolution_clock::time_point now);
+    void checkFullPipe();
+    void updateMode(p_high_resolution_clock::time_point now);
+    void enterProbeBandwidth(p_high_resolution_clock::time_point now);
+    void updateControlParameters(int numACKedPackets);
+    bool needsFastRetransmit(SequenceNumber ack);
+
+    int64_t getBandwidthDelayProduct() const; // bytes, 0 until we have estimates for both
+
+    Mode _mode { Mode::Startup };
+    double _pacingGain;
+    double _congestionWindowGain;
+
+    std::deque<SentPacketData> _sentPacketDatas; // packets not yet ACKed, in sequence number order
+    int64_t _bytesInFlight { 0 };
+    double _averagePacketSize { (double)udt::MAX_PACKET_SIZE }; // EWMA of sent wire sizes, in bytes
+
+    SequenceNumber _lastACK; // Sequence number of last packet that was ACKed
+    int64_t _delivered { 0 }; // total bytes ACKed
+    p_high_resolution_clock::time_point _deliveredTime; // time the last bytes were ACKed
+
+    int64_t _roundCount { 0 }; // number of round trips so far
+    int64_t _nextRoundDelivered { 0 }; // _delivered that ends the current round trip
+    bool _isRoundStart { false };
+
+    BandwidthSample _bandwidthSamples[BANDWIDTH_FILTER_ROUNDS]; // max delivery rate per round, by round
+
+    bool _isFullPipe { false }; // set once startup stops finding more bandwidth
+    double _fullBandwidth { 0.0 };
+    int _fullBandwidthCount { 0 };
+
+    int _cycleIndex { 0 }; // position in the probe bandwidth gain cycle
+    p_high_resolution_clock::time_point _cycleStamp;
+
+    int _minRTT { std::numeric_limits<int>::max() }; // microseconds
+    p_high_resolution_clock::time_point _minRTTStamp;
+    bool _isMinRTTExpired { false };
+    p_high_resolution_clock::time_point _probeRTTDoneStamp;
+    bool _isProbeRTTDoneStampSet { false };
+    int _priorCongestionWindowSize { 0 }; // restored once ProbeRTT is done
+
+    int _ewmaRTT { -1 }; // Exponential weighted moving average RTT
+    int _rttVariance { 0 }; // Variance in collected RTT values
+
+    int _duplicateACKCount { 0 }; // Counter for duplicate ACKs received
+};
+
+}
+
+#endif // hifi_BBRCC_h
@@ -0,0 +1,160 @@
+//
+//  DatagramBatch.cpp
+//  libraries/networking/src/udt
+//
+//  Created by Roxanne Skelly on 2019-06-10.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DatagramBatch.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <LogHandler.h>
+
+#include "../NetworkLogging.h"
+#include "Constants.h"
+
+using namespace udt;
+
+#if defined(Q_OS_LINUX)
+
+bool DatagramBatchReader::isSupported() {
+    return true;
+}
+
+DatagramBatchReader::DatagramBatchReader() {
+    memset(_headers.data(), 0, sizeof(_headers));
+}
+
+int DatagramBatchReader::read(qintptr socketDescriptor) {
+    for (int i = 0; i < MAX_DATAGRAM_BATCH_SIZE; ++i) {
+        // only slots whose buffer was handed off need a new one, the rest are re-used as is
+        if (!_buffers[i]) {
+            _buffers[i] = PacketBufferPool::acquire();
+        }
+
+        _iovecs[i].iov_base = _buffers[i].get();
+        _iovecs[i].iov_len = MAX_PACKET_SIZE;
+
+        auto& header = _headers[i].msg_hdr;
+        header.msg_name = &_addresses[i];
+        header.msg_namelen = sizeof(sockaddr_in);
+        header.msg_iov = &_iovecs[i];
+        header.msg_iovlen = 1;
+        header.msg_control = nullptr;
+        header.msg_controllen = 0;
+        header.msg_flags = 0;
+    }
+
+    int numRead = 0;
+    do {
+        numRead = recvmmsg((int)socketDescriptor, _headers.data(), MAX_DATAGRAM_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    } while (numRead == -1 && errno == EINTR);
+
+    if (numRead == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+
+        HIFI_FCDEBUG(networking(), "DatagramBatchReader::read failed -" << strerror(errno));
+        return -1;
+    }
+
+    for (int i = 0; i < numRead; ++i) {
+        if (_headers[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            // nothing we send is larger than MAX_PACKET_SIZE, drop the datagram
+            _sizes[i] = 0;
+        } else {
+            _sizes[i] = (int)_headers[i].msg_len;
+        }
+
+        _senders[i] = HifiSockAddr(reinterpret_cast<const sockaddr*>(&_addresses[i]));
+    }
+
+    return numRead;
+}
+
+bool DatagramBatchWriter::add(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
+    if (isFull()) {
+        return false;
+    }
+
+    auto& address = _addresses[_numQueued];
+    memset(&address, 0, sizeof(sockaddr_in));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(sockAddr.getAddress().toIPv4Address());
+    address.sin_port = htons(sockAddr.getPort());
+
+    _iovecs[_numQueued].iov_base = const_cast<char*>(data);
+    _iovecs[_numQueued].iov_len = size;
+
+    auto& header = _headers[_numQueued].msg_hdr;
+    header.msg_name = &address;
+    header.msg_namelen = sizeof(sockaddr_in);
+    header.msg_iov = &_iovecs[_numQueued];
+    header.msg_iovlen = 1;
+    header.msg_control = nullptr;
+    header.msg_controllen = 0;
+    header.msg_flags = 0;
+
+    ++_numQueued;
+    return true;
+}
+
+qint64 DatagramBatchWriter::flush(qintptr socketDescriptor) {
+    qint64 bytesWritten = 0;
+    int numSent = 0;
+
+    while (numSent < _numQueued) {
+        int result = sendmmsg((int)socketDescriptor, _headers.data() + numSent, _numQueued - numSent, MSG_DONTWAIT);
+
+        if (result == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            // when saturating a link this isn't an uncommon message - suppress it so it doesn't bomb the debug
+            HIFI_FCDEBUG(networking(), "DatagramBatchWriter::flush dropped" << (_numQueued - numSent)
+                         << "datagrams -" << strerror(errno));
+            break;
+        }
+
+        for (int i = numSent; i < numSent + result; ++i) {
+            bytesWritten += _headers[i].msg_len;
+        }
+        numSent += result;
+    }
+
+    bool failed = (numSent == 0 && _numQueued > 0);
+    _numQueued = 0;
+
+    return failed ? -1 : bytesWritten;
+}
+
+#else
+
+bool DatagramBatchReader::isSupported() {
+    return false;
+}
+
+DatagramBatchReader::DatagramBatchReader() {
+}
+
+int DatagramBatchReader::read(qintptr socketDescriptor) {
+    return -1;
+}
+
+bool DatagramBatchWriter::add(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
+    return false;
+}
+
+qint64 DatagramBatchWriter::flush(qintptr socketDescriptor) {
+    return -1;
+}
+
+#endif
@@ -0,0 +1,92 @@
+//
+//  DatagramBatch.h
+//  libraries/networking/src/udt
+//
+//  Created by Roxanne Skelly on 2019-06-10.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_DatagramBatch_h
+#define hifi_DatagramBatch_h
+
+#include <array>
+#include <memory>
+
+#include <QtCore/QtGlobal>
+
+#if defined(Q_OS_LINUX)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
+#include "../HifiSockAddr.h"
+#include "PacketBufferPool.h"
+
+namespace udt {
+
+static const int MAX_DATAGRAM_BATCH_SIZE = 64;
+
+// Reads pending datagrams from a non-blocking UDP socket descriptor with a single recvmmsg call per batch.
+// The receive buffers are kept between reads - a slot only draws a new one from the PacketBufferPool after its buffer
+// has been taken.
+class DatagramBatchReader {
+public:
+    // Batched I/O is only implemented on Linux - udt::Socket falls back to QUdpSocket elsewhere
+    static bool isSupported();
+
+    DatagramBatchReader();
+
+    // returns the number of datagrams read (0 if nothing was pending) or -1 if the read failed
+    int read(qintptr socketDescriptor);
+
+    int getSize(int index) const { return _sizes[index]; }
+    const HifiSockAddr& getSenderSockAddr(int index) const { return _senders[index]; }
+
+    // hands ownership of the buffer for a datagram from the last read to the caller
+    PacketBuffer takeBuffer(int index) { return std::move(_buffers[index]); }
+
+private:
+    std::array<PacketBuffer, MAX_DATAGRAM_BATCH_SIZE> _buffers;
+    std::array<int, MAX_DATAGRAM_BATCH_SIZE> _sizes;
+    std::array<HifiSockAddr, MAX_DATAGRAM_BATCH_SIZE> _senders;
+
+#if defined(Q_OS_LINUX)
+    std::array<mmsghdr, MAX_DATAGRAM_BATCH_SIZE> _headers;
+    std::array<iovec, MAX_DATAGRAM_BATCH_SIZE> _iovecs;
+    std::array<sockaddr_in, MAX_DATAGRAM_BATCH_SIZE> _addresses;
+#endif
+};
+
+// Collects outbound datagrams and writes them with a single sendmmsg call per batch.
+// The queued data is not copied, so it must stay valid until the next flush.
+class DatagramBatchWriter {
+public:
+    static bool isSupported() { return DatagramBatchReader::isSupported(); }
+
+    // returns false if the batch is full and must be flushed first
+    bool add(const char* data, qint64 size, const HifiSockAddr& sockAddr);
+
+    bool isEmpty() const { return _numQueued == 0; }
+    bool isFull() const { return _numQueued == MAX_DATAGRAM_BATCH_SIZE; }
+
+    // writes all queued datagrams and clears the batch, returning the number of bytes written or -1 on failure
+    qint64 flush(qintptr socketDescriptor);
+
+private:
+    int _numQueued { 0 };
+
+#if defined(Q_OS_LINUX)
+    std::array<mmsghdr, MAX_DATAGRAM_BATCH_SIZE> _headers;
+    std::array<iovec, MAX_DATAGRAM_BATCH_SIZE> _iovecs;
+    std::array<sockaddr_in, MAX_DATAGRAM_BATCH_SIZE> _addresses;
+#endif
+};
+
+} // namespace udt
+
+#endif // hifi_DatagramBatch_h
@@ -11,6 +11,8 @@
 
 #include "LossList.h"
 
+#include <algorithm>
+
 #include "ControlPacket.h"
 
 using namespace udt;
@@ -43,13 +45,17 @@ void LossList::append(SequenceNumber start, SequenceNumber end) {
     _length += seqlen(start, end);
 }
 
+LossList::Intervals::iterator LossList::findEndingAtOrAfter(SequenceNumber seq) {
+    return lower_bound(_lossList.begin(), _lossList.end(), seq, [](const Interval& interval, SequenceNumber seq) {
+        return interval.second < seq;
+    });
+}
+
 void LossList::insert(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::insert(SequenceNumber, SequenceNumber)", "Range start greater than range end");
     
-    auto it = find_if_not(_lossList.begin(), _lossList.end(), [&start](pair<SequenceNumber, SequenceNumber> pair){
-        return pair.second < start;
-    });
+    auto it = findEndingAtOrAfter(start);
     
     if (it == _lossList.end() || end < it->first) {
         // No overlap, simply insert
@@ -68,29 +74,28 @@ void LossList::insert(SequenceNumber start, SequenceNumber end) {
             it->second = end;
         }
         
-        auto it2 = it;
-        ++it2;
-        // For all ranges touching the current range
-        while (it2 != _lossList.end() && it->second >= it2->first - 1) {
+        // For all ranges touching the current range, merge them into it and erase them all at once
+        // (erasing from a deque invalidates iterators, so don't erase one at a time)
+        auto last = it + 1;
+        while (last != _lossList.end() && it->second >= last->first - 1) {
             // extend current range if necessary
-            if (it->second < it2->second) {
-                _length += seqlen(it->second + 1, it2->second);
-                it->second = it2->second;
+            if (it->second < last->second) {
+                _length += seqlen(it->second + 1, last->second);
+                it->second = last->second;
             }
             
             // Remove overlapping range
-            _length -= seqlen(it2->first, it2->second);
-            it2 = _lossList.erase(it2);
+            _length -= seqlen(last->first, last->second);
+            ++last;
         }
+        _lossList.erase(it + 1, last);
     }
 }
 
 bool LossList::remove(SequenceNumber seq) {
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&seq](pair<SequenceNumber, SequenceNumber> pair) {
-        return pair.first <= seq && seq <= pair.second;
-    });
+    auto it = findEndingAtOrAfter(seq);
     
-    if (it != end(_lossList)) {
+    if (it != _lossList.end() && it->first <= seq) {
         if (it->first == it->second) {
             _lossList.erase(it);
         } else if (seq == it->first) {
@@ -116,29 +121,26 @@ void LossList::remove(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::remove(SequenceNumber, SequenceNumber)", "Range start greater than range end");
     // Find the first segment sharing sequence numbers
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&start, &end](pair<SequenceNumber, SequenceNumber> pair) {
-        return (pair.first <= start && start <= pair.second) || (start <= pair.first && pair.first <= end);
-    });
+    auto it = findEndingAtOrAfter(start);
     
     // If we found one
-    if (it != _lossList.end()) {
+    if (it != _lossList.end() && it->first <= end) {
         
-        // While the end of the current segment is contained, either shorten it (first one only - sometimes)
-        // or remove it altogether since it is fully contained it the range
-        while (it != _lossList.end() && end >= it->second) {
-            if (start <= it->first) {
-                // Segment is contained, update new length and erase it.
-                _length -= seqlen(it->first, it->second);
-                it = _lossList.erase(it);
-            } else {
-                // Beginning of segment not contained, modify end of segment.
-                // Will only occur sometimes one the first loop
-                _length -= seqlen(start, it->second);
-                it->second = start - 1;
-                ++it;
-            }
+        // Beginning of the first segment not contained, shorten it
+        if (it->first < start && end >= it->second) {
+            _length -= seqlen(start, it->second);
+            it->second = start - 1;
+            ++it;
         }
         
+        // Remove every segment fully contained in the range
+        auto last = it;
+        while (last != _lossList.end() && end >= last->second) {
+            _length -= seqlen(last->first, last->second);
+            ++last;
+        }
+        it = _lossList.erase(it, last);
+        
         // There might be more to remove
         if (it != _lossList.end() && it->first <= end) {
             if (start <= it->first) {
@@ -163,7 +165,12 @@ SequenceNumber LossList::getFirstSequenceNumber() const {
 
 SequenceNumber LossList::popFirstSequenceNumber() {
     auto front = getFirstSequenceNumber();
-    remove(front);
+    if (_lossList.front().first == _lossList.front().second) {
+        _lossList.pop_front();
+    } else {
+        ++_lossList.front().first;
+    }
+    _length -= 1;
     return front;
 }
 
@@ -12,14 +12,17 @@
 #ifndef hifi_LossList_h
 #define hifi_LossList_h
 
-#include <list>
+#include <deque>
 
 #include "SequenceNumber.h"
 
 namespace udt {
 
 class ControlPacket;
-    
+
+// A set of lost sequence numbers stored as sorted, disjoint [first, second] intervals.  The intervals live in a
+// deque - appending at the back and popping from the front, which is what senders and receivers mostly do,
+// don't allocate per interval - and lookups are a binary search.
 class LossList {
 public:
     LossList() {}
@@ -30,7 +33,7 @@ public:
     void append(SequenceNumber seq);
     void append(SequenceNumber start, SequenceNumber end);
     
-    // inserts anywhere - MUCH slower
+    // inserts anywhere - slower
     void insert(SequenceNumber start, SequenceNumber end);
     
     bool remove(SequenceNumber seq);
@@ -44,7 +47,13 @@ public:
     void write(ControlPacket& packet, int maxPairs = -1);
     
 private:
-    std::list<std::pair<SequenceNumber, SequenceNumber>> _lossList;
+    using Interval = std::pair<SequenceNumber, SequenceNumber>;
+    using Intervals = std::deque<Interval>;
+
+    // the first interval that ends at or after seq
+    Intervals::iterator findEndingAtOrAfter(SequenceNumber seq);
+
+    Intervals _lossList;
     int _length { 0 };
 };
     
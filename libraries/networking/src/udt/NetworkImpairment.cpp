@@ -0,0 +1,108 @@
+//
+//  NetworkImpairment.cpp
+//  libraries/networking/src/udt
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NetworkImpairment.h"
+
+#include <algorithm>
+
+#include "../NetworkLogging.h"
+
+using namespace udt;
+using namespace std::chrono;
+
+static const double BITS_PER_BYTE = 8.0;
+static const double USECS_PER_SECOND = 1000000.0;
+
+NetworkImpairment::NetworkImpairment(const Settings& settings, ImpairedWriteFunction function) :
+    _settings(settings),
+    _function(function),
+    _linkFreeTime(p_high_resolution_clock::now()),
+    _generator(settings.seed)
+{
+    setObjectName("Networking: udt impairment");
+
+    qCDebug(networking) << "Impairing udt traffic - delay" << _settings.delayUsecs << "us, jitter" << _settings.jitterUsecs
+        << "us, loss" << _settings.lossRate << ", rate cap" << _settings.rateCapBitsPerSecond << "bps";
+}
+
+NetworkImpairment::~NetworkImpairment() {
+    stop();
+    wait();
+}
+
+void NetworkImpairment::queue(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
+    {
+        Lock lock(_mutex);
+
+        std::uniform_real_distribution<double> lossDistribution(0.0, 1.0);
+        if (_settings.lossRate > 0.0 && lossDistribution(_generator) < _settings.lossRate) {
+            return;
+        }
+
+        auto now = p_high_resolution_clock::now();
+        auto departureTime = now;
+
+        if (_settings.rateCapBitsPerSecond > 0) {
+            // tail drop once the link is more than the max queue behind
+            _linkFreeTime = std::max(_linkFreeTime, now);
+            if (_linkFreeTime - now > microseconds(_settings.maxQueueUsecs)) {
+                return;
+            }
+
+            auto serializationUsecs = (size * BITS_PER_BYTE * USECS_PER_SECOND) / _settings.rateCapBitsPerSecond;
+            _linkFreeTime += microseconds((int64_t)serializationUsecs);
+            departureTime = _linkFreeTime;
+        }
+
+        int delayUsecs = _settings.delayUsecs;
+        if (_settings.jitterUsecs > 0) {
+            std::uniform_int_distribution<int> jitterDistribution(0, _settings.jitterUsecs);
+            delayUsecs += jitterDistribution(_generator);
+        }
+
+        // the data may only be a view of a packet that is about to go away, so copy it
+        _datagrams.emplace(departureTime + microseconds(delayUsecs), Datagram { QByteArray(data, size), sockAddr });
+    }
+    _condition.notify_one();
+}
+
+void NetworkImpairment::run() {
+    Lock lock(_mutex);
+
+    while (!_stop) {
+        if (_datagrams.empty()) {
+            _condition.wait(lock);
+            continue;
+        }
+
+        auto it = _datagrams.begin();
+        if (p_high_resolution_clock::now() < it->first) {
+            // wake for the next release or for an earlier datagram queued meanwhile
+            _condition.wait_until(lock, it->first);
+            continue;
+        }
+
+        auto datagram = std::move(it->second);
+        _datagrams.erase(it);
+
+        lock.unlock();
+        _function(datagram.data, datagram.sockAddr);
+        lock.lock();
+    }
+}
+
+void NetworkImpairment::stop() {
+    {
+        Lock lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_one();
+}
@@ -0,0 +1,82 @@
+//
+//  NetworkImpairment.h
+//  libraries/networking/src/udt
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_NetworkImpairment_h
+#define hifi_NetworkImpairment_h
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QThread>
+
+#include <PortableHighResolutionClock.h>
+
+#include "../HifiSockAddr.h"
+
+namespace udt {
+
+using ImpairedWriteFunction = std::function<void(const QByteArray&, const HifiSockAddr&)>;
+
+// Emulates a worse network on the datagrams a udt::Socket sends
+//   Datagrams are dropped at the loss rate, serialized through a link at the rate cap (dropping from the tail once
+//   its queue is full) and then held for the delay plus up to the jitter - so jitter can re-order them, as it would
+//   on a real link. The random number generator is seeded from the settings, so runs can be compared.
+//   queue() is thread-safe, the write function is called from the impairment thread.
+class NetworkImpairment : public QThread {
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+
+public:
+    struct Settings {
+        int delayUsecs { 0 }; // added one way
+        int jitterUsecs { 0 }; // up to this much more, uniformly distributed
+        double lossRate { 0.0 }; // 0 to 1
+        int rateCapBitsPerSecond { -1 }; // -1 is uncapped
+        int maxQueueUsecs { 100000 }; // how far behind the rate capped link can get before it drops
+        uint32_t seed { 742272 };
+    };
+
+    NetworkImpairment(const Settings& settings, ImpairedWriteFunction function);
+    ~NetworkImpairment();
+
+    const Settings& getSettings() const { return _settings; }
+
+    void queue(const char* data, qint64 size, const HifiSockAddr& sockAddr);
+
+    void run() override final;
+    void stop();
+
+private:
+    struct Datagram {
+        QByteArray data;
+        HifiSockAddr sockAddr;
+    };
+
+    const Settings _settings;
+    ImpairedWriteFunction _function;
+
+    Mutex _mutex;
+    std::condition_variable _condition;
+    std::multimap<p_high_resolution_clock::time_point, Datagram> _datagrams; // by release time, guarded by _mutex
+    p_high_resolution_clock::time_point _linkFreeTime; // guarded by _mutex
+    std::mt19937 _generator; // guarded by _mutex
+    bool _stop { false }; // guarded by _mutex
+};
+
+} // namespace udt
+
+#endif // hifi_NetworkImpairment_h
@@ -0,0 +1,147 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Created by Roxanne Skelly on 2019-06-17.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "Constants.h"
+
+using namespace udt;
+
+namespace {
+
+// buffers moved between a thread cache and the depot at once
+const size_t TRANSFER_BATCH_SIZE = 64;
+// a thread cache holding this many buffers gives a batch back to the depot
+const size_t MAX_THREAD_CACHE_SIZE = 2 * TRANSFER_BATCH_SIZE;
+// past this the depot frees returned buffers instead of keeping them (~12MB of packets)
+const size_t MAX_DEPOT_SIZE = 8192;
+
+struct Depot {
+    std::mutex mutex;
+    std::vector<char*> buffers;
+
+    std::atomic<quint64> hits { 0 };
+    std::atomic<quint64> misses { 0 };
+
+    // moves up to count buffers from the depot to the back of destination
+    void take(std::vector<char*>& destination, size_t count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        count = std::min(count, buffers.size());
+        destination.insert(destination.end(), buffers.end() - count, buffers.end());
+        buffers.resize(buffers.size() - count);
+    }
+
+    // moves the last count buffers of source to the depot
+    void give(std::vector<char*>& source, size_t count) {
+        auto first = source.end() - count;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (first != source.end() && buffers.size() < MAX_DEPOT_SIZE) {
+                buffers.push_back(*first++);
+            }
+        }
+
+        // the depot is full, these go back to the heap
+        for (; first != source.end(); ++first) {
+            delete[] *first;
+        }
+        source.resize(source.size() - count);
+    }
+};
+
+// never destroyed - thread caches give their buffers back as their threads exit, which can be after static destruction
+Depot& depot() {
+    static Depot* depot = new Depot();
+    return *depot;
+}
+
+// set once this thread's cache is gone, packets destroyed later in thread or process exit bypass the pool
+thread_local bool isThreadCacheDestroyed { false };
+
+struct ThreadCache {
+    ThreadCache() { buffers.reserve(MAX_THREAD_CACHE_SIZE); }
+    ~ThreadCache() {
+        depot().give(buffers, buffers.size());
+        isThreadCacheDestroyed = true;
+    }
+
+    std::vector<char*> buffers;
+};
+
+thread_local ThreadCache threadCache;
+
+}
+
+void PacketBufferDeleter::operator()(char* buffer) const {
+    if (isPooled) {
+        PacketBufferPool::release(buffer);
+    } else {
+        delete[] buffer;
+    }
+}
+
+PacketBuffer PacketBufferPool::acquire() {
+    if (isThreadCacheDestroyed) {
+        depot().misses.fetch_add(1, std::memory_order_relaxed);
+        return PacketBuffer(new char[MAX_PACKET_SIZE]);
+    }
+
+    auto& buffers = threadCache.buffers;
+
+    if (buffers.empty()) {
+        depot().take(buffers, TRANSFER_BATCH_SIZE);
+    }
+
+    char* buffer;
+    if (!buffers.empty()) {
+        buffer = buffers.back();
+        buffers.pop_back();
+        depot().hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        buffer = new char[MAX_PACKET_SIZE];
+        depot().misses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return PacketBuffer(buffer, PacketBufferDeleter(true));
+}
+
+void PacketBufferPool::release(char* buffer) {
+    if (isThreadCacheDestroyed) {
+        delete[] buffer;
+        return;
+    }
+
+    auto& buffers = threadCache.buffers;
+
+    if (buffers.size() >= MAX_THREAD_CACHE_SIZE) {
+        depot().give(buffers, TRANSFER_BATCH_SIZE);
+    }
+
+    buffers.push_back(buffer);
+}
+
+PacketBufferPool::Stats PacketBufferPool::getStats() {
+    auto& pool = depot();
+
+    Stats stats;
+    stats.hits = pool.hits.load(std::memory_order_relaxed);
+    stats.misses = pool.misses.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        stats.numFree = pool.buffers.size();
+    }
+    return stats;
+}
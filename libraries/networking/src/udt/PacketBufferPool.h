@@ -0,0 +1,61 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Created by Roxanne Skelly on 2019-06-17.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketBufferPool_h
+#define hifi_PacketBufferPool_h
+
+#include <memory>
+
+#include <QtCore/QtGlobal>
+
+namespace udt {
+
+// Buffers drawn from the PacketBufferPool go back to it when released, any other buffer is deleted.
+// Converts implicitly from std::default_delete so a plain std::unique_ptr<char[]> can still be handed to a packet.
+struct PacketBufferDeleter {
+    PacketBufferDeleter() = default;
+    PacketBufferDeleter(const std::default_delete<char[]>&) {}
+    explicit PacketBufferDeleter(bool isPooled) : isPooled(isPooled) {}
+
+    void operator()(char* buffer) const;
+
+    bool isPooled { false };
+};
+
+using PacketBuffer = std::unique_ptr<char[], PacketBufferDeleter>;
+
+// Recycles MAX_PACKET_SIZE packet buffers so that creating and receiving packets doesn't hit the heap.
+// Each thread keeps a small cache of free buffers and trades them in batches with a shared depot, so a buffer
+// acquired on one thread (e.g. the socket thread) can be released on another (e.g. a mixer slave) cheaply.
+class PacketBufferPool {
+public:
+    struct Stats {
+        quint64 hits { 0 };      // buffers handed out from the pool
+        quint64 misses { 0 };    // buffers that had to be allocated
+        quint64 numFree { 0 };   // buffers waiting in the shared depot
+    };
+
+    // returns a buffer of MAX_PACKET_SIZE bytes, its contents are not initialized
+    static PacketBuffer acquire();
+
+    static Stats getStats();
+
+private:
+    friend struct PacketBufferDeleter;
+
+    static void release(char* buffer);
+};
+
+} // namespace udt
+
+#endif // hifi_PacketBufferPool_h
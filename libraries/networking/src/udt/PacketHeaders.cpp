@@ -27,7 +27,9 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::StunResponse:
             return 17;
         case PacketType::DomainList:
-            return static_cast<PacketVersion>(DomainListVersion::AuthenticationOptional);
+            return static_cast<PacketVersion>(DomainListVersion::DeltaUpdates);
+        case PacketType::DomainListRequest:
+            return static_cast<PacketVersion>(DomainListRequestVersion::HasLastDomainListVersion);
         case PacketType::EntityAdd:
         case PacketType::EntityClone:
         case PacketType::EntityEdit:
@@ -72,7 +74,7 @@ PacketVersion versionForPacketType(PacketType packetType) {
             return static_cast<PacketVersion>(DomainConnectionDeniedVersion::IncludesExtraInfo);
 
         case PacketType::DomainConnectRequest:
-            return static_cast<PacketVersion>(DomainConnectRequestVersion::AlwaysHasMachineFingerprint);
+            return static_cast<PacketVersion>(DomainConnectRequestVersion::HasSupportedAuthMethods);
 
         case PacketType::DomainServerAddedNode:
             return static_cast<PacketVersion>(DomainServerAddedNodeVersion::PermissionsGrid);
@@ -98,6 +100,9 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::BulkAvatarTraitsAck:
         case PacketType::BulkAvatarTraits:
             return static_cast<PacketVersion>(AvatarMixerPacketVersion::AvatarTraitsAck);
+        case PacketType::RequestAssignment:
+        case PacketType::CreateAssignment:
+            return static_cast<PacketVersion>(AssignmentVersion::HasPhysicsServer);
         default:
             return 22;
     }
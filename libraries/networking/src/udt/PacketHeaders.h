@@ -335,7 +335,8 @@ enum class DomainConnectRequestVersion : PacketVersion {
     HasProtocolVersions,
     HasMACAddress,
     HasMachineFingerprint,
-    AlwaysHasMachineFingerprint
+    AlwaysHasMachineFingerprint,
+    HasSupportedAuthMethods
 };
 
 enum class DomainConnectionDeniedVersion : PacketVersion {
@@ -354,7 +355,14 @@ enum class DomainListVersion : PacketVersion {
     PermissionsGrid,
     GetUsernameFromUUIDSupport,
     GetMachineFingerprintFromUUIDSupport,
-    AuthenticationOptional
+    AuthenticationOptional,
+    HMACAuthMethod,
+    DeltaUpdates
+};
+
+enum class DomainListRequestVersion : PacketVersion {
+    PreDeltaUpdates = 22,
+    HasLastDomainListVersion
 };
 
 enum class AudioVersion : PacketVersion {
@@ -384,4 +392,9 @@ enum class AvatarQueryVersion : PacketVersion {
     ConicalFrustums = 22
 };
 
+enum class AssignmentVersion : PacketVersion {
+    PrePhysicsServer = 22,
+    HasPhysicsServer
+};
+
 #endif // hifi_PacketHeaders_h
@@ -11,6 +11,8 @@
 
 #include "PacketList.h"
 
+#include <algorithm>
+
 #include "../NetworkLogging.h"
 
 #include <QDebug>
@@ -142,20 +144,102 @@ QByteArray PacketList::getMessage() const {
 
 void PacketList::preparePackets(MessageNumber messageNumber) {
     Q_ASSERT(_packets.size() > 0);
-    
-    if (_packets.size() == 1) {
+
+    _messageNumber = messageNumber;
+
+    // deferred packets are numbered as they are built, but they still count towards the positions of the others
+    size_t numPackets = _packets.size() + _numDeferredPackets;
+    if (numPackets == 1) {
         _packets.front()->writeMessageNumber(messageNumber, Packet::PacketPosition::ONLY, 0);
     } else {
-        const auto second = ++_packets.begin();
-        const auto last = --_packets.end();
         Packet::MessagePartNumber messagePartNumber = 0;
-        std::for_each(second, last, [&](const PacketPointer& packet) {
-            packet->writeMessageNumber(messageNumber, Packet::PacketPosition::MIDDLE, ++messagePartNumber);
-        });
-        
-        _packets.front()->writeMessageNumber(messageNumber, Packet::PacketPosition::FIRST, 0);
-        _packets.back()->writeMessageNumber(messageNumber, Packet::PacketPosition::LAST, ++messagePartNumber);
+        for (const auto& packet : _packets) {
+            Packet::PacketPosition position = Packet::PacketPosition::MIDDLE;
+            if (messagePartNumber == 0) {
+                position = Packet::PacketPosition::FIRST;
+            } else if (messagePartNumber == numPackets - 1) {
+                position = Packet::PacketPosition::LAST;
+            }
+            packet->writeMessageNumber(messageNumber, position, messagePartNumber++);
+        }
+    }
+
+    _nextMessagePartNumber = (Packet::MessagePartNumber)_packets.size();
+}
+
+bool PacketList::writeDeferred(qint64 size, DeferredReader reader) {
+    Q_ASSERT_X(_isReliable && _isOrdered, "PacketList::writeDeferred", "Only reliable ordered PacketLists can defer data");
+    Q_ASSERT_X(!hasDeferredPackets(), "PacketList::writeDeferred", "PacketList already has deferred data");
+
+    if (size <= 0) {
+        return true;
+    }
+
+    // top off the packet being written now, the message has to be contiguous - there is always at least one packet
+    // up front, preparePackets needs it
+    if (!_currentPacket) {
+        _currentPacket = createPacketWithExtendedHeader();
+    }
+    if (_currentPacket->bytesAvailableForWrite() > 0) {
+        qint64 headSize = std::min(size, _currentPacket->bytesAvailableForWrite());
+        qint64 position = _currentPacket->pos();
+        if (!reader(_currentPacket->getPayload() + position, 0, headSize)) {
+            qCWarning(networking) << "PacketList::writeDeferred failed to read deferred data";
+            return false;
+        }
+        _currentPacket->setPayloadSize(position + headSize);
+        _currentPacket->seek(position + headSize);
+
+        _deferredOffset = headSize;
+    }
+    closeCurrentPacket();
+
+    _deferredSize = size;
+    if (_deferredOffset < _deferredSize) {
+        _deferredPacketCapacity = createPacketWithExtendedHeader()->bytesAvailableForWrite();
+        _numDeferredPackets = (_deferredSize - _deferredOffset + _deferredPacketCapacity - 1) / _deferredPacketCapacity;
+        _deferredReader = reader;
+    }
+    return true;
+}
+
+std::unique_ptr<Packet> PacketList::takeDeferredPacket() {
+    Q_ASSERT(hasDeferredPackets());
+
+    auto packet = createPacketWithExtendedHeader();
+    qint64 position = packet->pos();
+    qint64 size = std::min(_deferredPacketCapacity, _deferredSize - _deferredOffset);
+    if (_deferredReader(packet->getPayload() + position, _deferredOffset, size)) {
+        packet->setPayloadSize(position + size);
+        packet->seek(position + size);
+
+        _deferredOffset += size;
+        --_numDeferredPackets;
+    } else {
+        // end the message here with an empty last packet, the receiver then has fewer bytes than the message said
+        // it would carry and fails it - rather than taking whatever we'd have put in their place as the data
+        qCWarning(networking) << "PacketList::takeDeferredPacket failed to read deferred data at" << _deferredOffset
+            << "- ending the message early";
+        packet->setPayloadSize(position);
+
+        _deferredOffset = _deferredSize;
+        _numDeferredPackets = 0;
+    }
+
+    auto packetPosition = hasDeferredPackets() ? Packet::PacketPosition::MIDDLE : Packet::PacketPosition::LAST;
+    packet->writeMessageNumber(_messageNumber, packetPosition, _nextMessagePartNumber++);
+
+    if (_deferredPacketFinalizer) {
+        _deferredPacketFinalizer(*packet);
     }
+
+    if (!hasDeferredPackets()) {
+        // let go of whatever the reader and finalizer were keeping alive
+        _deferredReader = DeferredReader();
+        _deferredPacketFinalizer = DeferredPacketFinalizer();
+    }
+
+    return packet;
 }
 
 const qint64 PACKET_LIST_WRITE_ERROR = -1;
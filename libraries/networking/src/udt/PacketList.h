@@ -12,6 +12,7 @@
 #ifndef hifi_PacketList_h
 #define hifi_PacketList_h
 
+#include <functional>
 #include <memory>
 
 #include "../ExtendedIODevice.h"
@@ -29,6 +30,10 @@ class PacketList : public ExtendedIODevice {
 public:
     using MessageNumber = uint32_t;
     using PacketPointer = std::unique_ptr<Packet>;
+
+    // reads size bytes found at offset in the deferred data straight into a packet's payload
+    using DeferredReader = std::function<bool(char* destination, qint64 offset, qint64 size)>;
+    using DeferredPacketFinalizer = std::function<void(Packet& packet)>;
     
     static std::unique_ptr<PacketList> create(PacketType packetType, QByteArray extendedHeader = QByteArray(),
                                               bool isReliable = false, bool isOrdered = false);
@@ -38,7 +43,7 @@ public:
     bool isReliable() const { return _isReliable; }
     bool isOrdered() const { return _isOrdered; }
     
-    size_t getNumPackets() const { return _packets.size() + (_currentPacket ? 1 : 0); }
+    size_t getNumPackets() const { return _packets.size() + (_currentPacket ? 1 : 0) + _numDeferredPackets; }
     size_t getDataSize() const;
     size_t getMessageSize() const;
     QByteArray getMessage() const;
@@ -59,7 +64,18 @@ public:
     virtual qint64 size() const override { return getDataSize(); }
     
     qint64 writeString(const QString& string);
-    
+
+    // Appends size bytes that are only read, through reader, as the send queue takes the packets that carry them. A
+    // large reliable message then costs a congestion window of memory instead of its whole size, and a slow receiver
+    // holds back the reads. Nothing can be written to the list afterwards.
+    // Returns false, deferring nothing, if the data that fits in the current packet can't be read. A read that fails
+    // later ends the message early, so the receiver gets fewer bytes than it was told and fails it.
+    bool writeDeferred(qint64 size, DeferredReader reader);
+    // called on every packet built from the deferred data, on the send queue's thread, before it goes out
+    void setDeferredPacketFinalizer(DeferredPacketFinalizer finalizer) { _deferredPacketFinalizer = finalizer; }
+    bool hasDeferredPackets() const { return _numDeferredPackets > 0; }
+    qint64 getDeferredBytesRemaining() const { return _deferredSize - _deferredOffset; }
+
 protected:
     PacketList(PacketType packetType, QByteArray extendedHeader = QByteArray(), bool isReliable = false, bool isOrdered = false);
     PacketList(PacketList&& other);
@@ -86,6 +102,9 @@ private:
     
     // Takes the first packet of the list and returns it.
     template<typename T> std::unique_ptr<T> takeFront();
+
+    // Builds the next packet from the deferred data, once the packets written up front have been taken
+    std::unique_ptr<Packet> takeDeferredPacket();
     
     // Creates a new packet, can be overriden to change return underlying type
     virtual std::unique_ptr<Packet> createPacket();
@@ -99,6 +118,14 @@ private:
     int _segmentStartIndex = -1;
     
     QByteArray _extendedHeader;
+
+    DeferredReader _deferredReader;
+    DeferredPacketFinalizer _deferredPacketFinalizer;
+    qint64 _deferredSize { 0 };
+    qint64 _deferredOffset { 0 };
+    qint64 _deferredPacketCapacity { 0 };
+    size_t _numDeferredPackets { 0 };
+    Packet::MessagePartNumber _nextMessagePartNumber { 0 };
 };
 
 template<typename T> std::unique_ptr<T> PacketList::takeFront() {
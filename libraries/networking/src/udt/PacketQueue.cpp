@@ -15,9 +15,22 @@
 
 using namespace udt;
 
+bool PacketQueue::PacketListChannel::isEmpty() const {
+    return packets.empty() && !(deferred && deferred->hasDeferredPackets());
+}
+
+PacketQueue::PacketPointer PacketQueue::PacketListChannel::takePacket() {
+    if (!packets.empty()) {
+        auto packet = std::move(packets.front());
+        packets.pop_front();
+        return packet;
+    }
+
+    // the packets written up front are gone, build the next one from the deferred data
+    return deferred->takeDeferredPacket();
+}
+
 PacketQueue::PacketQueue(MessageNumber messageNumber) : _currentMessageNumber(messageNumber) {
-    _channels.emplace_front(new std::list<PacketPointer>());
-    _currentChannel = _channels.begin();
 }
 
 MessageNumber PacketQueue::getNextMessageNumber() {
@@ -27,41 +40,66 @@ MessageNumber PacketQueue::getNextMessageNumber() {
 }
 
 bool PacketQueue::isEmpty() const {
-    LockGuard locker(_packetsLock);
+    return _mainChannel.empty() && _channels.empty() && !_hasPendingPackets;
+}
+
+void PacketQueue::takePendingPackets() {
+    {
+        LockGuard locker(_packetsLock);
+        _takenPackets.swap(_pendingPackets);
+        _takenChannels.swap(_pendingChannels);
+        _hasPendingPackets = false;
+    }
 
-    // Only the main channel and it is empty
-    return _channels.size() == 1 && _channels.front()->empty();
+    for (auto& packet : _takenPackets) {
+        _mainChannel.push_back(std::move(packet));
+    }
+    _takenPackets.clear();
+
+    for (auto& channel : _takenChannels) {
+        _channels.push_back(std::move(channel));
+    }
+    _takenChannels.clear();
 }
 
 PacketQueue::PacketPointer PacketQueue::takePacket() {
-    LockGuard locker(_packetsLock);
+    if (_hasPendingPackets) {
+        takePendingPackets();
+    }
 
-    if (isEmpty()) {
+    if (_mainChannel.empty() && _channels.empty()) {
         return PacketPointer();
     }
 
-    // handle the case where we are looking at the first channel and it is empty
-    if (_currentChannel == _channels.begin() && (*_currentChannel)->empty()) {
+    // handle the case where we are looking at the main channel and it is empty
+    if (_currentChannel == 0 && _mainChannel.empty()) {
         ++_currentChannel;
     }
 
     // at this point the current channel should always not be at the end and should also not be empty
-    Q_ASSERT(_currentChannel != _channels.end());
+    Q_ASSERT(_currentChannel <= _channels.size());
 
-    auto& channel = *_currentChannel;
+    PacketPointer packet;
 
-    Q_ASSERT(!channel->empty());
+    if (_currentChannel == 0) {
+        // Take front packet
+        packet = std::move(_mainChannel.front());
+        _mainChannel.pop_front();
+        ++_currentChannel;
+    } else {
+        auto channel = _channels.begin() + (_currentChannel - 1);
 
-    // Take front packet
-    auto packet = std::move(channel->front());
-    channel->pop_front();
+        Q_ASSERT(!(*channel)->isEmpty());
 
-    // Remove now empty channel (Don't remove the main channel)
-    if (channel->empty() && _currentChannel != _channels.begin()) {
-        // erase the current channel and slide the iterator to the next channel
-        _currentChannel = _channels.erase(_currentChannel);
-    } else {
-        ++_currentChannel;
+        // Take front packet
+        packet = (*channel)->takePacket();
+
+        // Remove now empty channel, which slides the index to the next channel
+        if ((*channel)->isEmpty()) {
+            _channels.erase(channel);
+        } else {
+            ++_currentChannel;
+        }
     }
 
     // push forward our number of channels taken from
@@ -71,9 +109,9 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
     // to respect our capped number of channels considered concurrently
     static const int MAX_CHANNELS_SENT_CONCURRENTLY = 16;
 
-    if (_currentChannel == _channels.end() || _channelsVisitedCount >= MAX_CHANNELS_SENT_CONCURRENTLY) {
+    if (_currentChannel > _channels.size() || _channelsVisitedCount >= MAX_CHANNELS_SENT_CONCURRENTLY) {
         _channelsVisitedCount = 0;
-        _currentChannel = _channels.begin();
+        _currentChannel = 0;
     }
 
     return packet;
@@ -81,15 +119,28 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
 
 void PacketQueue::queuePacket(PacketPointer packet) {
     LockGuard locker(_packetsLock);
-    _channels.front()->push_back(std::move(packet));
+    _pendingPackets.push_back(std::move(packet));
+    _hasPendingPackets = true;
 }
 
 void PacketQueue::queuePacketList(PacketListPointer packetList) {
+    Channel channel { new PacketListChannel() };
+
+    LockGuard locker(_packetsLock);
+
+    // message numbers are handed out under the lock so that ordered lists are queued in message number order
     if (packetList->isOrdered()) {
         packetList->preparePackets(getNextMessageNumber());
     }
 
-    LockGuard locker(_packetsLock);
-    _channels.emplace_back(new std::list<PacketPointer>());
-    _channels.back()->swap(packetList->_packets);
+    channel->packets.swap(packetList->_packets);
+
+    if (packetList->hasDeferredPackets()) {
+        channel->deferred = std::move(packetList);
+    }
+
+    if (!channel->isEmpty()) {
+        _pendingChannels.push_back(std::move(channel));
+        _hasPendingPackets = true;
+    }
 }
@@ -12,6 +12,8 @@
 #ifndef hifi_PacketQueue_h
 #define hifi_PacketQueue_h
 
+#include <atomic>
+#include <deque>
 #include <list>
 #include <vector>
 #include <memory>
@@ -24,21 +26,34 @@ namespace udt {
 class PacketList;
     
 using MessageNumber = uint32_t;
-    
+
+// Packets and packet lists waiting for a SendQueue's send thread.  Writers, on any thread, only append to a pending
+// batch under the lock; the send thread takes the whole batch in one swap and then round-robins its own channels
+// without locking, so the lock is never held while a packet is picked or built.
 class PacketQueue {
     using Mutex = std::recursive_mutex;
     using LockGuard = std::lock_guard<Mutex>;
     using PacketPointer = std::unique_ptr<Packet>;
     using PacketListPointer = std::unique_ptr<PacketList>;
     using RawChannel = std::list<PacketPointer>;
-    using Channel = std::unique_ptr<RawChannel>;
-    using Channels = std::list<Channel>;
+
+    // the packets of a packet list, and the list itself while it still has deferred packets to build
+    struct PacketListChannel {
+        RawChannel packets;
+        PacketListPointer deferred;
+
+        bool isEmpty() const;
+        PacketPointer takePacket();
+    };
+
+    using Channel = std::unique_ptr<PacketListChannel>;
     
 public:
     PacketQueue(MessageNumber messageNumber = 0);
     void queuePacket(PacketPointer packet);
     void queuePacketList(PacketListPointer packetList);
     
+    // send thread only
     bool isEmpty() const;
     PacketPointer takePacket();
     
@@ -48,14 +63,24 @@ public:
     
 private:
     MessageNumber getNextMessageNumber();
+    void takePendingPackets();
 
-    MessageNumber _currentMessageNumber { 0 };
+    std::atomic<MessageNumber> _currentMessageNumber { 0 };
     
-    mutable Mutex _packetsLock; // Protects the packets to be sent.
-    Channels _channels; // One channel per packet list + Main channel
+    mutable Mutex _packetsLock; // Protects the pending packets and lists
+    std::vector<PacketPointer> _pendingPackets;
+    std::vector<Channel> _pendingChannels;
+    std::atomic<bool> _hasPendingPackets { false };
 
-    Channels::iterator _currentChannel;
+    // owned by the send thread
+    std::deque<PacketPointer> _mainChannel;
+    std::vector<Channel> _channels; // One channel per packet list
+    size_t _currentChannel { 0 }; // 0 is the main channel, n is _channels[n - 1]
     unsigned int _channelsVisitedCount { 0 };
+
+    // swapped with the pending batch, so that taking it doesn't allocate
+    std::vector<PacketPointer> _takenPackets;
+    std::vector<Channel> _takenChannels;
 };
 
 }
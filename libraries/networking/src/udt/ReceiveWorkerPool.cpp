@@ -0,0 +1,116 @@
+//
+//  ReceiveWorkerPool.cpp
+//  libraries/networking/src/udt
+//
+//  Created by Roxanne Skelly on 2019-06-12.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceiveWorkerPool.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "../NetworkLogging.h"
+#include "Packet.h"
+
+using namespace udt;
+
+// the socket thread hands a worker its packets at least this often while it is reading a long run of datagrams
+static const size_t MAX_PENDING_PACKETS_PER_WORKER = 64;
+
+void ReceiveWorkerThread::run() {
+    std::vector<std::unique_ptr<Packet>> packets;
+
+    while (true) {
+        {
+            Lock lock(_mutex);
+            _condition.wait(lock, [&] { return _stop || !_queue.empty(); });
+
+            if (_stop) {
+                return;
+            }
+
+            packets.swap(_queue);
+        }
+
+        for (auto& packet : packets) {
+            _function(std::move(packet));
+        }
+        packets.clear();
+    }
+}
+
+void ReceiveWorkerThread::push(std::vector<std::unique_ptr<Packet>>& packets) {
+    {
+        Lock lock(_mutex);
+        if (_queue.empty()) {
+            _queue.swap(packets);
+        } else {
+            std::move(packets.begin(), packets.end(), std::back_inserter(_queue));
+            packets.clear();
+        }
+    }
+    _condition.notify_one();
+}
+
+void ReceiveWorkerThread::stop() {
+    {
+        Lock lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_one();
+}
+
+ReceiveWorkerPool::ReceiveWorkerPool(int numWorkers, ReceiveWorkerFunction function) {
+    // clamp to allowed size
+    int maxWorkers = QThread::idealThreadCount();
+    if (maxWorkers == -1) {
+        // idealThreadCount returns -1 if cores cannot be detected
+        static const int MAX_WORKERS_IF_UNKNOWN = 4;
+        maxWorkers = MAX_WORKERS_IF_UNKNOWN;
+    }
+    numWorkers = std::min(std::max(1, numWorkers), maxWorkers);
+
+    qCDebug(networking) << "Starting" << numWorkers << "udt receive workers";
+
+    _pending.resize(numWorkers);
+    for (int i = 0; i < numWorkers; ++i) {
+        auto worker = new ReceiveWorkerThread(function);
+        worker->setObjectName("UDT Receive Worker " + QString::number(i));
+        worker->start();
+        _workers.emplace_back(worker);
+    }
+}
+
+ReceiveWorkerPool::~ReceiveWorkerPool() {
+    for (auto& worker : _workers) {
+        worker->stop();
+    }
+
+    for (auto& worker : _workers) {
+        worker->wait();
+    }
+}
+
+void ReceiveWorkerPool::queue(std::unique_ptr<Packet> packet) {
+    auto index = std::hash<HifiSockAddr>()(packet->getSenderSockAddr()) % _workers.size();
+
+    auto& pending = _pending[index];
+    pending.push_back(std::move(packet));
+
+    if (pending.size() >= MAX_PENDING_PACKETS_PER_WORKER) {
+        _workers[index]->push(pending);
+    }
+}
+
+void ReceiveWorkerPool::flush() {
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        if (!_pending[i].empty()) {
+            _workers[i]->push(_pending[i]);
+        }
+    }
+}
@@ -0,0 +1,76 @@
+//
+//  ReceiveWorkerPool.h
+//  libraries/networking/src/udt
+//
+//  Created by Roxanne Skelly on 2019-06-12.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_ReceiveWorkerPool_h
+#define hifi_ReceiveWorkerPool_h
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QThread>
+
+namespace udt {
+
+class Packet;
+
+using ReceiveWorkerFunction = std::function<void(std::unique_ptr<Packet>)>;
+
+class ReceiveWorkerThread : public QThread {
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+
+public:
+    ReceiveWorkerThread(ReceiveWorkerFunction function) : _function(function) {}
+
+    void run() override final;
+
+    // moves the given packets onto the end of this worker's queue
+    void push(std::vector<std::unique_ptr<Packet>>& packets);
+    void stop();
+
+private:
+    ReceiveWorkerFunction _function;
+
+    Mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<std::unique_ptr<Packet>> _queue; // guarded by _mutex
+    bool _stop { false }; // guarded by _mutex
+};
+
+// Receive worker pool for udt::Socket
+//   Packets are handed to a worker by a hash of their sender, so the packets from one sender are always processed
+//   in order, by the same worker. queue() and flush() are not thread-safe and should only be called from the
+//   thread that reads the socket.
+class ReceiveWorkerPool {
+public:
+    ReceiveWorkerPool(int numWorkers, ReceiveWorkerFunction function);
+    ~ReceiveWorkerPool();
+
+    int numWorkers() const { return (int)_workers.size(); }
+
+    void queue(std::unique_ptr<Packet> packet);
+
+    // hands every queued packet to its worker
+    void flush();
+
+private:
+    std::vector<std::unique_ptr<ReceiveWorkerThread>> _workers;
+    std::vector<std::vector<std::unique_ptr<Packet>>> _pending;
+};
+
+} // namespace udt
+
+#endif // hifi_ReceiveWorkerPool_h
@@ -147,11 +147,9 @@ void SendQueue::ack(SequenceNumber ack) {
     }
     
     {
-        // remove any ACKed packets from the map of sent packets
-        QWriteLocker locker(&_sentLock);
-        for (auto seq = SequenceNumber { (uint32_t) _lastACKSequenceNumber }; seq <= ack; ++seq) {
-            _sentPackets.erase(seq);
-        }
+        // remove any ACKed packets from the window of sent packets
+        std::lock_guard<std::mutex> locker(_sentLock);
+        _sentPackets.release(ack);
     }
     
     {   // remove any sequence numbers equal to or lower than this ACK in the loss list
@@ -224,12 +222,9 @@ bool SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
 
     {
         // Insert the packet we have just sent in the sent list
-        QWriteLocker locker(&_sentLock);
-        auto& entry = _sentPackets[newPacket->getSequenceNumber()];
-        entry.first = 0; // No resend
-        entry.second.swap(newPacket);
+        std::lock_guard<std::mutex> locker(_sentLock);
+        _sentPackets.add(sequenceNumber, std::move(newPacket));
     }
-    Q_ASSERT_X(!newPacket, "SendQueue::sendNewPacketAndAddToSentList()", "Overriden packet in sent list");
 
     if (bytesWritten < 0) {
         // this is a short-circuit loss - we failed to put this packet on the wire
@@ -391,24 +386,23 @@ bool SendQueue::maybeResendPacket() {
             SequenceNumber resendNumber = _naks.popFirstSequenceNumber();
             naksLocker.unlock();
             
-            // pull the packet to re-send from the sent packets list
-            QReadLocker sentLocker(&_sentLock);
+            // pull the packet to re-send from the sent packets window
+            std::unique_lock<std::mutex> sentLocker(_sentLock);
             
             // see if we can find the packet to re-send
-            auto it = _sentPackets.find(resendNumber);
+            auto entry = _sentPackets.find(resendNumber);
 
-            if (it != _sentPackets.end()) {
+            if (entry) {
 
-                auto& entry = it->second;
                 // we found the packet - grab it
-                auto& resendPacket = *(entry.second);
-                ++entry.first; // Add 1 resend
+                auto& resendPacket = *(entry->packet);
+                ++entry->resends; // Add 1 resend
 
-                Packet::ObfuscationLevel level = (Packet::ObfuscationLevel)(entry.first < 2 ? 0 : (entry.first - 2) % 4);
+                Packet::ObfuscationLevel level = (Packet::ObfuscationLevel)(entry->resends < 2 ? 0 : (entry->resends - 2) % 4);
 
                 auto wireSize = resendPacket.getWireSize();
                 auto payloadSize = resendPacket.getPayloadSize();
-                auto sequenceNumber = it->first;
+                auto sequenceNumber = resendNumber;
 
                 if (level != Packet::NoObfuscation) {
 #ifdef UDT_CONNECTION_DEBUG
@@ -15,13 +15,10 @@
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
-#include <list>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
 
 #include <QtCore/QObject>
-#include <QtCore/QReadWriteLock>
 
 #include <PortableHighResolutionClock.h>
 
@@ -29,6 +26,7 @@
 
 #include "Constants.h"
 #include "PacketQueue.h"
+#include "SentPacketWindow.h"
 #include "SequenceNumber.h"
 #include "LossList.h"
 
@@ -129,9 +127,8 @@ private:
     mutable std::mutex _naksLock; // Protects the naks list.
     LossList _naks; // Sequence numbers of packets to resend
     
-    mutable QReadWriteLock _sentLock; // Protects the sent packet list
-    using PacketResendPair = std::pair<uint8_t, std::unique_ptr<Packet>>; // Number of resend + packet ptr
-    std::unordered_map<SequenceNumber, PacketResendPair> _sentPackets; // Packets waiting for ACK.
+    mutable std::mutex _sentLock; // Protects the sent packet window
+    SentPacketWindow _sentPackets; // Packets waiting for ACK.
     
     std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
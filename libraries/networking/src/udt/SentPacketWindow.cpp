@@ -0,0 +1,82 @@
+//
+//  SentPacketWindow.cpp
+//  libraries/networking/src/udt
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SentPacketWindow.h"
+
+#include <algorithm>
+
+using namespace udt;
+
+// enough for the default flow window without growing
+static const size_t INITIAL_WINDOW_CAPACITY = 256;
+
+SentPacketWindow::SentPacketWindow() : _entries(INITIAL_WINDOW_CAPACITY) {
+}
+
+void SentPacketWindow::add(SequenceNumber sequenceNumber, std::unique_ptr<Packet> packet) {
+    if (_size == 0) {
+        _firstSequenceNumber = sequenceNumber;
+    }
+
+    Q_ASSERT_X(sequenceNumber == _firstSequenceNumber + _size, "SentPacketWindow::add",
+               "Sequence number added out of order");
+
+    if ((size_t)_size == _entries.size()) {
+        grow();
+    }
+
+    auto& entry = at(_size);
+    entry.resends = 0;
+    entry.packet = std::move(packet);
+    ++_size;
+}
+
+void SentPacketWindow::release(SequenceNumber sequenceNumber) {
+    if (_size == 0) {
+        return;
+    }
+
+    int count = std::min(seqoff(_firstSequenceNumber, sequenceNumber) + 1, _size);
+    if (count <= 0) {
+        return;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        at(i).packet.reset();
+    }
+
+    _front = (_front + count) & (_entries.size() - 1);
+    _firstSequenceNumber += count;
+    _size -= count;
+}
+
+SentPacketWindow::Entry* SentPacketWindow::find(SequenceNumber sequenceNumber) {
+    if (_size == 0) {
+        return nullptr;
+    }
+
+    int offset = seqoff(_firstSequenceNumber, sequenceNumber);
+    if (offset < 0 || offset >= _size) {
+        return nullptr;
+    }
+
+    return &at(offset);
+}
+
+void SentPacketWindow::grow() {
+    std::vector<Entry> entries(_entries.size() * 2);
+    for (int i = 0; i < _size; ++i) {
+        entries[i] = std::move(at(i));
+    }
+
+    _entries.swap(entries);
+    _front = 0;
+}
@@ -0,0 +1,62 @@
+//
+//  SentPacketWindow.h
+//  libraries/networking/src/udt
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_SentPacketWindow_h
+#define hifi_SentPacketWindow_h
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Packet.h"
+#include "SequenceNumber.h"
+
+namespace udt {
+
+// The packets a SendQueue has sent and not had ACKed yet, in a ring buffer indexed by sequence number.
+// Packets are added in sequence number order and released from the front as they are ACKed, so finding a packet
+// to re-send is an index and nothing is allocated per packet once the ring has grown to the flow window.
+class SentPacketWindow {
+public:
+    struct Entry {
+        uint8_t resends { 0 };
+        std::unique_ptr<Packet> packet;
+    };
+
+    SentPacketWindow();
+
+    // sequenceNumber must follow the last one added, unless the window is empty
+    void add(SequenceNumber sequenceNumber, std::unique_ptr<Packet> packet);
+
+    // releases every packet up to and including sequenceNumber
+    void release(SequenceNumber sequenceNumber);
+
+    // null if the packet isn't in the window (i.e. it was ACKed)
+    Entry* find(SequenceNumber sequenceNumber);
+
+    int getSize() const { return _size; }
+    bool isEmpty() const { return _size == 0; }
+
+private:
+    Entry& at(int offset) { return _entries[(_front + offset) & (_entries.size() - 1)]; }
+    void grow();
+
+    std::vector<Entry> _entries; // size is always a power of two
+    size_t _front { 0 }; // index of the entry for _firstSequenceNumber
+    int _size { 0 };
+    SequenceNumber _firstSequenceNumber;
+};
+
+}
+
+#endif // hifi_SentPacketWindow_h
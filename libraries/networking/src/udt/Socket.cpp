@@ -15,12 +15,14 @@
 #include <sys/socket.h>
 #endif
 
+#include <QtCore/QProcessEnvironment>
 #include <QtCore/QThread>
 
 #include <shared/QtHelpers.h>
 #include <LogHandler.h>
 
 #include "../NetworkLogging.h"
+#include "BBRCC.h"
 #include "Connection.h"
 #include "ControlPacket.h"
 #include "Packet.h"
@@ -31,6 +33,10 @@
 
 using namespace udt;
 
+static const QString BATCHED_IO_ENV = "HIFI_UDT_BATCHED_IO";
+static const QString RECEIVE_WORKERS_ENV = "HIFI_UDT_RECEIVE_WORKERS";
+static const QString CONGESTION_CONTROL_ENV = "HIFI_UDT_CONGESTION_CONTROL";
+
 Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     QObject(parent),
     _readyReadBackupTimer(new QTimer(this)),
@@ -47,6 +53,48 @@ Socket::Socket(QObject* parent, bool shouldChangeSocketOptions) :
     const int READY_READ_BACKUP_CHECK_MSECS = 2 * 1000;
     connect(_readyReadBackupTimer, &QTimer::timeout, this, &Socket::checkForReadyReadBackup);
     _readyReadBackupTimer->start(READY_READ_BACKUP_CHECK_MSECS);
+
+    auto environment = QProcessEnvironment::systemEnvironment();
+    if (environment.contains(BATCHED_IO_ENV)) {
+        setBatchedIOEnabled(true);
+    }
+    if (environment.contains(RECEIVE_WORKERS_ENV)) {
+        setNumReceiveWorkers(environment.value(RECEIVE_WORKERS_ENV).toInt());
+    }
+    if (environment.value(CONGESTION_CONTROL_ENV).compare("bbr", Qt::CaseInsensitive) == 0) {
+        qCDebug(networking) << "Using BBR congestion control for udt connections";
+        setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory>(new CongestionControlFactory<BBRCC>()));
+    }
+}
+
+void Socket::setBatchedIOEnabled(bool enabled) {
+    if (enabled && !DatagramBatchReader::isSupported()) {
+        qCWarning(networking) << "Batched datagram I/O is not supported on this platform - using QUdpSocket";
+        return;
+    }
+
+    if (enabled != isBatchedIOEnabled()) {
+        _datagramBatchReader.reset(enabled ? new DatagramBatchReader() : nullptr);
+        qCDebug(networking) << "Batched datagram I/O is now" << (enabled ? "enabled" : "disabled");
+    }
+}
+
+void Socket::setNumReceiveWorkers(int numWorkers) {
+    if (QThread::currentThread() != thread()) {
+        BLOCKING_INVOKE_METHOD(this, "setNumReceiveWorkers", Q_ARG(int, numWorkers));
+        return;
+    }
+
+    // stop the current workers first, anything they had not processed yet is dropped
+    _receiveWorkerPool.reset();
+
+    if (numWorkers > 0) {
+        _receiveWorkerPool.reset(new ReceiveWorkerPool(numWorkers, [this](std::unique_ptr<Packet> packet) {
+            if ((!_packetFilterOperator || _packetFilterOperator(*packet)) && _packetHandler) {
+                _packetHandler(std::move(packet));
+            }
+        }));
+    }
 }
 
 void Socket::bind(const QHostAddress& address, quint16 port) {
@@ -123,6 +171,12 @@ qint64 Socket::writeBasePacket(const udt::BasePacket& packet, const HifiSockAddr
 qint64 Socket::writePacket(const Packet& packet, const HifiSockAddr& sockAddr) {
     Q_ASSERT_X(!packet.isReliable(), "Socket::writePacket", "Cannot send a reliable packet unreliably");
 
+    prepareUnreliablePacket(packet, sockAddr);
+
+    return writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
+}
+
+void Socket::prepareUnreliablePacket(const Packet& packet, const HifiSockAddr& sockAddr) {
     SequenceNumber sequenceNumber;
     {
         Lock lock(_unreliableSequenceNumbersMutex);
@@ -137,8 +191,6 @@ qint64 Socket::writePacket(const Packet& packet, const HifiSockAddr& sockAddr) {
 
     // write the correct sequence number to the Packet here
     packet.writeSequenceNumber(sequenceNumber);
-
-    return writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
 }
 
 qint64 Socket::writePacket(std::unique_ptr<Packet> packet, const HifiSockAddr& sockAddr) {
@@ -184,6 +236,10 @@ qint64 Socket::writePacketList(std::unique_ptr<PacketList> packetList, const Hif
         return 0;
     }
 
+    if (isBatchedIOEnabled() && !_networkImpairment) {
+        return writeUnreliablePacketListBatched(std::move(packetList), sockAddr);
+    }
+
     // Unerliable and Unordered
     qint64 totalBytesSent = 0;
     while (!packetList->_packets.empty()) {
@@ -193,6 +249,40 @@ qint64 Socket::writePacketList(std::unique_ptr<PacketList> packetList, const Hif
     return totalBytesSent;
 }
 
+qint64 Socket::writeUnreliablePacketListBatched(std::unique_ptr<PacketList> packetList, const HifiSockAddr& sockAddr) {
+    // the writer only references the packet data, so keep the packets alive until the list is flushed
+    std::vector<std::unique_ptr<Packet>> packets;
+    packets.reserve(packetList->getNumPackets());
+
+    DatagramBatchWriter writer;
+    qint64 totalBytesSent = 0;
+
+    auto flush = [&] {
+        auto bytesWritten = writer.flush(_udpSocket.socketDescriptor());
+        if (bytesWritten > 0) {
+            totalBytesSent += bytesWritten;
+        }
+        packets.clear();
+    };
+
+    while (!packetList->_packets.empty()) {
+        if (writer.isFull()) {
+            flush();
+        }
+
+        auto packet = packetList->takeFront<Packet>();
+        prepareUnreliablePacket(*packet, sockAddr);
+        writer.add(packet->getData(), packet->getDataSize(), sockAddr);
+        packets.push_back(std::move(packet));
+    }
+
+    if (!writer.isEmpty()) {
+        flush();
+    }
+
+    return totalBytesSent;
+}
+
 void Socket::writeReliablePacket(Packet* packet, const HifiSockAddr& sockAddr) {
     auto connection = findOrCreateConnection(sockAddr);
     if (connection) {
@@ -224,6 +314,12 @@ qint64 Socket::writeDatagram(const char* data, qint64 size, const HifiSockAddr&
 
 qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
 
+    if (_networkImpairment) {
+        // hand it to the impairment, which writes it out later (or never)
+        _networkImpairment->queue(datagram.constData(), datagram.size(), sockAddr);
+        return datagram.size();
+    }
+
     qint64 bytesWritten = _udpSocket.writeDatagram(datagram, sockAddr.getAddress(), sockAddr.getPort());
 
     if (bytesWritten < 0) {
@@ -329,6 +425,25 @@ void Socket::readPendingDatagrams() {
     const auto abortTime = system_clock::now() + MAX_PROCESS_TIME;
     int packetSizeWithHeader = -1;
 
+    if (_datagramBatchReader) {
+        readPendingDatagramBatches(abortTime);
+
+        // reading the descriptor directly leaves QUdpSocket's read notifier disabled once it has emitted readyRead,
+        // so always finish with one read through QUdpSocket - that re-arms it and picks up any late arrival
+        HifiSockAddr senderSockAddr;
+        auto buffer = PacketBufferPool::acquire();
+        auto sizeRead = _udpSocket.readDatagram(buffer.get(), MAX_PACKET_SIZE,
+                                                senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
+        if (sizeRead > 0) {
+            processDatagram(std::move(buffer), sizeRead, senderSockAddr, p_high_resolution_clock::now());
+        }
+
+        if (_receiveWorkerPool) {
+            _receiveWorkerPool->flush();
+        }
+        return;
+    }
+
     while (_udpSocket.hasPendingDatagrams() &&
            (packetSizeWithHeader = _udpSocket.pendingDatagramSize()) != -1) {
         if (system_clock::now() > abortTime) {
@@ -346,8 +461,9 @@ void Socket::readPendingDatagrams() {
         // setup a HifiSockAddr to read into
         HifiSockAddr senderSockAddr;
 
-        // setup a buffer to read the packet into
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+        // setup a buffer to read the packet into, from the pool unless the datagram is too large for one
+        auto buffer = (packetSizeWithHeader <= MAX_PACKET_SIZE) ?
+            PacketBufferPool::acquire() : PacketBuffer(new char[packetSizeWithHeader]);
 
         // pull the datagram
         auto sizeRead = _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
@@ -363,73 +479,128 @@ void Socket::readPendingDatagrams() {
             continue;
         }
 
-        auto it = _unfilteredHandlers.find(senderSockAddr);
+        processDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr, receiveTime);
+    }
+
+    if (_receiveWorkerPool) {
+        _receiveWorkerPool->flush();
+    }
+}
+
+void Socket::readPendingDatagramBatches(std::chrono::system_clock::time_point abortTime) {
+    int numRead = 0;
+
+    while ((numRead = _datagramBatchReader->read(_udpSocket.socketDescriptor())) > 0) {
+        // we're reading packets so re-start the readyRead backup timer
+        _readyReadBackupTimer->start();
+
+        // the whole batch was pulled by one call, so it shares a receive time
+        auto receiveTime = p_high_resolution_clock::now();
 
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                basePacket->setReceiveTime(receiveTime);
-                it->second(std::move(basePacket));
+        for (int i = 0; i < numRead; ++i) {
+            int sizeRead = _datagramBatchReader->getSize(i);
+            const auto& senderSockAddr = _datagramBatchReader->getSenderSockAddr(i);
+
+            // save information for this packet, in case it is the one that sticks readyRead
+            _lastPacketSizeRead = sizeRead;
+            _lastPacketSockAddr = senderSockAddr;
+
+            if (sizeRead > 0) {
+                processDatagram(_datagramBatchReader->takeBuffer(i), sizeRead, senderSockAddr, receiveTime);
             }
+        }
 
-            continue;
+        if (_receiveWorkerPool) {
+            _receiveWorkerPool->flush();
         }
 
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+        if (numRead < MAX_DATAGRAM_BATCH_SIZE || std::chrono::system_clock::now() > abortTime) {
+            // either the socket is drained or we've been running for too long
+            break;
+        }
+    }
+}
 
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            controlPacket->setReceiveTime(receiveTime);
+void Socket::processDatagram(PacketBuffer buffer, int size, const HifiSockAddr& senderSockAddr,
+                             p_high_resolution_clock::time_point receiveTime) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
 
-            // move this control packet to the matching connection, if there is one
-            auto connection = findOrCreateConnection(senderSockAddr, true);
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+            basePacket->setReceiveTime(receiveTime);
+            it->second(std::move(basePacket));
+        }
+
+        return;
+    }
+
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        controlPacket->setReceiveTime(receiveTime);
+
+        // move this control packet to the matching connection, if there is one
+        auto connection = findOrCreateConnection(senderSockAddr, true);
+
+        if (connection) {
+            connection->processControl(move(controlPacket));
+        }
+
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        packet->setReceiveTime(receiveTime);
+
+        // save the sequence number in case this is the packet that sticks readyRead
+        _lastReceivedSequenceNumber = packet->getSequenceNumber();
 
+        if (_receiveWorkerPool && !packet->isReliable() && !packet->isPartOfMessage()) {
+            // unreliable single packets are verified and dispatched by a receive worker - connections are owned by
+            // this thread, so the receive is recorded here, before verification
+            auto connection = findOrCreateConnection(senderSockAddr, true);
             if (connection) {
-                connection->processControl(move(controlPacket));
+                connection->recordReceivedUnreliablePackets(packet->getWireSize(), packet->getPayloadSize());
             }
 
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            packet->setReceiveTime(receiveTime);
-
-            // save the sequence number in case this is the packet that sticks readyRead
-            _lastReceivedSequenceNumber = packet->getSequenceNumber();
+            _receiveWorkerPool->queue(std::move(packet));
+            return;
+        }
 
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                auto connection = findOrCreateConnection(senderSockAddr, true);
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            auto connection = findOrCreateConnection(senderSockAddr, true);
 
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
 
-                    if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                                  packet->getDataSize(),
-                                                                                  packet->getPayloadSize())) {
-                        // the connection could not be created or indicated that we should not continue processing this packet
+                if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                                              packet->getDataSize(),
+                                                                              packet->getPayloadSize())) {
+                    // the connection could not be created or indicated that we should not continue processing this packet
 #ifdef UDT_CONNECTION_DEBUG
-                        qCDebug(networking) << "Can't process packet: version" << (unsigned int)NLPacket::versionInHeader(*packet)
-                            << ", type" << NLPacket::typeInHeader(*packet);
+                    qCDebug(networking) << "Can't process packet: version" << (unsigned int)NLPacket::versionInHeader(*packet)
+                        << ", type" << NLPacket::typeInHeader(*packet);
 #endif
-                        continue;
-                    }
-                } else if (connection) {
-                    connection->recordReceivedUnreliablePackets(packet->getWireSize(),
-                                                                packet->getPayloadSize());
+                    return;
                 }
+            } else if (connection) {
+                connection->recordReceivedUnreliablePackets(packet->getWireSize(),
+                                                            packet->getPayloadSize());
+            }
 
-                if (packet->isPartOfMessage()) {
-                    auto connection = findOrCreateConnection(senderSockAddr, true);
-                    if (connection) {
-                        connection->queueReceivedMessagePacket(std::move(packet));
-                    }
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+            if (packet->isPartOfMessage()) {
+                auto connection = findOrCreateConnection(senderSockAddr, true);
+                if (connection) {
+                    connection->queueReceivedMessagePacket(std::move(packet));
                 }
+            } else if (_packetHandler) {
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
             }
         }
     }
@@ -442,6 +613,16 @@ void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* r
     }
 }
 
+void Socket::setNetworkImpairment(const NetworkImpairment::Settings& settings) {
+    _networkImpairment.reset(new NetworkImpairment(settings, [this](const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+        qint64 bytesWritten = _udpSocket.writeDatagram(datagram, sockAddr.getAddress(), sockAddr.getPort());
+        if (bytesWritten < 0) {
+            HIFI_FCDEBUG(networking(), "Socket::writeDatagram" << _udpSocket.error());
+        }
+    }));
+    _networkImpairment->start();
+}
+
 void Socket::setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory) {
     // swap the current unique_ptr for the new factory
     _ccFactory.swap(ccFactory);
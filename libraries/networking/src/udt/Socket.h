@@ -14,6 +14,7 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <chrono>
 #include <functional>
 #include <unordered_map>
 #include <mutex>
@@ -26,6 +27,9 @@
 #include "../HifiSockAddr.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
+#include "DatagramBatch.h"
+#include "NetworkImpairment.h"
+#include "ReceiveWorkerPool.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -81,6 +85,20 @@ public:
     void addUnfilteredHandler(const HifiSockAddr& senderSockAddr, BasePacketHandler handler)
         { _unfilteredHandlers[senderSockAddr] = handler; }
     
+    // batched recvmmsg/sendmmsg I/O - only takes effect where DatagramBatchReader::isSupported()
+    void setBatchedIOEnabled(bool enabled);
+    bool isBatchedIOEnabled() const { return (bool)_datagramBatchReader; }
+
+    // verify and dispatch unreliable single packets on this many worker threads, 0 keeps them on the socket thread
+    // the packet filter and handler are then called from the workers, so they must be thread-safe
+    Q_INVOKABLE void setNumReceiveWorkers(int numWorkers);
+    int getNumReceiveWorkers() const { return _receiveWorkerPool ? _receiveWorkerPool->numWorkers() : 0; }
+
+    // emulate delay, jitter, loss and a rate cap on everything this socket sends - for comparing congestion control
+    // set this up before sending anything, it isn't safe to change while the send queues are writing
+    void setNetworkImpairment(const NetworkImpairment::Settings& settings);
+    void clearNetworkImpairment() { _networkImpairment.reset(); }
+
     void setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory);
     void setConnectionMaxBandwidth(int maxBandwidth);
 
@@ -109,6 +127,11 @@ private slots:
 
 private:
     void setSystemBufferSizes();
+    void readPendingDatagramBatches(std::chrono::system_clock::time_point abortTime);
+    void processDatagram(PacketBuffer buffer, int size, const HifiSockAddr& senderSockAddr,
+                         p_high_resolution_clock::time_point receiveTime);
+    qint64 writeUnreliablePacketListBatched(std::unique_ptr<PacketList> packetList, const HifiSockAddr& sockAddr);
+    void prepareUnreliablePacket(const Packet& packet, const HifiSockAddr& sockAddr);
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr, bool filterCreation = false);
     bool socketMatchesNodeOrDomain(const HifiSockAddr& sockAddr);
    
@@ -136,6 +159,8 @@ private:
 
     QTimer* _readyReadBackupTimer { nullptr };
 
+    std::unique_ptr<DatagramBatchReader> _datagramBatchReader;
+
     int _maxBandwidth { -1 };
 
     std::unique_ptr<CongestionControlVirtualFactory> _ccFactory { new CongestionControlFactory<TCPVegasCC>() };
@@ -146,6 +171,12 @@ private:
     SequenceNumber _lastReceivedSequenceNumber;
     HifiSockAddr _lastPacketSockAddr;
     
+    // declared after the udp socket so its thread is stopped before the socket it writes to is destroyed
+    std::unique_ptr<NetworkImpairment> _networkImpairment;
+
+    // declared last so the workers are stopped before anything they call into is destroyed
+    std::unique_ptr<ReceiveWorkerPool> _receiveWorkerPool;
+
     friend UDTTest;
 };
     
@@ -12,6 +12,7 @@
 #ifndef hifi_Octree_h
 #define hifi_Octree_h
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <stdint.h>
@@ -26,6 +27,7 @@
 
 #include "OctreeElement.h"
 #include "OctreeElementBag.h"
+#include "OctreeJournal.h"
 #include "OctreePacketData.h"
 #include "OctreeSceneStats.h"
 #include "OctreeUtils.h"
@@ -220,6 +222,16 @@ public:
     bool readJSONFromGzippedFile(QString qFileName);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    // Journaled persistence (see OctreeJournal) - trees that don't support it are always persisted whole
+    virtual bool supportsJournaling() const { return false; }
+    virtual void setJournaling(bool isJournaling) { }
+    // hands over a record for each element changed since the last call
+    virtual void takeJournalRecords(OctreeJournal::Records& records) { }
+    virtual QByteArray getJournalTreeData() const { return QByteArray(); }
+    // called from the compaction thread, only holds the tree lock for short stretches
+    virtual bool writeJournalSnapshot(const std::function<bool(const OctreeJournal::Record&)>& writeRecord) { return false; }
+    virtual bool readFromJournal(const OctreeJournal::Contents& contents) { return false; }
+
     uint64_t getOctreeElementsCount();
 
     bool getShouldReaverage() const { return _shouldReaverage; }
@@ -256,6 +268,8 @@ public:
     virtual quint64 getAverageLoggingTime() const { return 0;  }
     virtual quint64 getAverageFilterTime() const { return 0; }
 
+    QUuid getPersistID() const { return _persistID; }
+    int getPersistDataVersion() const { return _persistDataVersion; }
     void incrementPersistDataVersion() { _persistDataVersion++; }
 
 
@@ -0,0 +1,367 @@
+//
+//  OctreeJournal.cpp
+//  libraries/octree/src
+//
+//  Created by Roxanne Skelly on 2019-06-18.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeJournal.h"
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QtEndian>
+
+#include "OctreeLogging.h"
+
+static const quint32 JOURNAL_MAGIC = 0x4a465748;    // "HWFJ"
+static const quint32 SNAPSHOT_MAGIC = 0x53465748;   // "HWFS"
+static const quint32 FORMAT_VERSION = 1;
+
+static const int NUM_BYTES_RFC4122_UUID = 16;
+static const int RECORD_HEADER_SIZE = sizeof(quint32);
+static const int RECORD_CHECKSUM_SIZE = sizeof(quint16);
+static const int MIN_RECORD_PAYLOAD_SIZE = sizeof(quint8) + NUM_BYTES_RFC4122_UUID;
+
+// the snapshot is handed to the file in pieces about this big
+static const int SNAPSHOT_WRITE_SIZE = 1 << 20;
+
+template <typename T>
+static void appendLittleEndian(QByteArray& buffer, T value) {
+    T littleEndian = qToLittleEndian(value);
+    buffer.append(reinterpret_cast<const char*>(&littleEndian), sizeof(T));
+}
+
+template <typename T>
+static T readLittleEndian(const QByteArray& buffer, int offset) {
+    return qFromLittleEndian<T>(reinterpret_cast<const uchar*>(buffer.constData() + offset));
+}
+
+OctreeJournal::OctreeJournal(const QString& basePath) :
+    _basePath(basePath),
+    _journalFile(getJournalFilename())
+{
+}
+
+OctreeJournal::~OctreeJournal() {
+    abortSnapshot();
+}
+
+bool OctreeJournal::hasSnapshot() const {
+    return QFile::exists(getSnapshotFilename());
+}
+
+void OctreeJournal::appendRecord(QByteArray& buffer, const Record& record) {
+    quint32 payloadSize = (quint32)(MIN_RECORD_PAYLOAD_SIZE + record.data.size());
+    appendLittleEndian(buffer, payloadSize);
+
+    int payloadOffset = buffer.size();
+    buffer.append((char)record.type);
+    buffer.append(record.id.toRfc4122());
+    buffer.append(record.data);
+
+    appendLittleEndian(buffer, qChecksum(buffer.constData() + payloadOffset, payloadSize));
+}
+
+int OctreeJournal::readRecords(const QByteArray& data, int offset, Records& records, bool& isTorn) {
+    isTorn = false;
+
+    while (offset < data.size()) {
+        int remaining = data.size() - offset;
+        if (remaining < RECORD_HEADER_SIZE) {
+            isTorn = true;
+            break;
+        }
+
+        quint32 payloadSize = readLittleEndian<quint32>(data, offset);
+        if (payloadSize < (quint32)MIN_RECORD_PAYLOAD_SIZE ||
+            payloadSize > (quint32)(remaining - RECORD_HEADER_SIZE - RECORD_CHECKSUM_SIZE)) {
+            isTorn = true;
+            break;
+        }
+
+        int payloadOffset = offset + RECORD_HEADER_SIZE;
+        quint16 checksum = readLittleEndian<quint16>(data, payloadOffset + payloadSize);
+        if (checksum != qChecksum(data.constData() + payloadOffset, payloadSize)) {
+            isTorn = true;
+            break;
+        }
+
+        Record record;
+        record.type = (RecordType)data[payloadOffset];
+        record.id = QUuid::fromRfc4122(data.mid(payloadOffset + 1, NUM_BYTES_RFC4122_UUID));
+        record.data = data.mid(payloadOffset + MIN_RECORD_PAYLOAD_SIZE, payloadSize - MIN_RECORD_PAYLOAD_SIZE);
+        records.push_back(std::move(record));
+
+        offset = payloadOffset + payloadSize + RECORD_CHECKSUM_SIZE;
+    }
+
+    return offset;
+}
+
+QByteArray OctreeJournal::encodeVersion(int64_t dataVersion) {
+    QByteArray data;
+    appendLittleEndian(data, (qint64)dataVersion);
+    return data;
+}
+
+bool OctreeJournal::load(Contents& contents) {
+    contents = Contents();
+
+    QFile snapshotFile(getSnapshotFilename());
+    if (!snapshotFile.open(QIODevice::ReadOnly)) {
+        qCWarning(octree) << "Couldn't open snapshot" << snapshotFile.fileName() << snapshotFile.errorString();
+        return false;
+    }
+    QByteArray snapshot = snapshotFile.readAll();
+    snapshotFile.close();
+
+    // magic, format version, id, data version, tree data size
+    const int SNAPSHOT_HEADER_SIZE = 2 * sizeof(quint32) + NUM_BYTES_RFC4122_UUID + sizeof(qint64) + sizeof(quint32);
+    if (snapshot.size() < SNAPSHOT_HEADER_SIZE || readLittleEndian<quint32>(snapshot, 0) != SNAPSHOT_MAGIC) {
+        qCWarning(octree) << "Snapshot" << snapshotFile.fileName() << "is not a snapshot";
+        return false;
+    }
+
+    int offset = sizeof(quint32);
+    quint32 formatVersion = readLittleEndian<quint32>(snapshot, offset);
+    offset += sizeof(quint32);
+    if (formatVersion != FORMAT_VERSION) {
+        qCWarning(octree) << "Snapshot" << snapshotFile.fileName() << "has unknown format version" << formatVersion;
+        return false;
+    }
+
+    contents.id = QUuid::fromRfc4122(snapshot.mid(offset, NUM_BYTES_RFC4122_UUID));
+    offset += NUM_BYTES_RFC4122_UUID;
+    contents.dataVersion = readLittleEndian<qint64>(snapshot, offset);
+    offset += sizeof(qint64);
+    quint32 treeDataSize = readLittleEndian<quint32>(snapshot, offset);
+    offset += sizeof(quint32);
+    if (treeDataSize > (quint32)(snapshot.size() - offset)) {
+        qCWarning(octree) << "Snapshot" << snapshotFile.fileName() << "is truncated";
+        return false;
+    }
+    contents.treeData = snapshot.mid(offset, treeDataSize);
+    offset += treeDataSize;
+
+    Records records;
+    bool isTorn;
+    readRecords(snapshot, offset, records, isTorn);
+    snapshot.clear();
+    if (isTorn || records.empty() || records.back().type != RecordType::End) {
+        // snapshots are renamed into place once complete, so this one has been damaged since
+        qCWarning(octree) << "Snapshot" << snapshotFile.fileName() << "is incomplete";
+        return false;
+    }
+    records.pop_back();
+
+    // replay the journals, oldest first - a torn record is the tail of an append that never finished, so the journal
+    // is cut back to the last complete record and later appends don't end up behind the damage
+    for (const auto& filename : { getRotatedJournalFilename(), getJournalFilename() }) {
+        QFile journalFile(filename);
+        if (!journalFile.exists()) {
+            continue;
+        }
+        if (!journalFile.open(QIODevice::ReadWrite)) {
+            qCWarning(octree) << "Couldn't open journal" << filename << journalFile.errorString();
+            return false;
+        }
+
+        QByteArray journal = journalFile.readAll();
+        int validSize = 0;
+        if (journal.size() >= (int)sizeof(quint32) && readLittleEndian<quint32>(journal, 0) == JOURNAL_MAGIC) {
+            validSize = readRecords(journal, sizeof(quint32), records, isTorn);
+        } else {
+            isTorn = !journal.isEmpty();
+        }
+
+        if (isTorn) {
+            qCWarning(octree) << "Journal" << filename << "ends in an incomplete record, dropping"
+                << (journal.size() - validSize) << "bytes";
+            journalFile.resize(validSize);
+        }
+    }
+
+    // fold everything down to the latest state of each id, in the order the ids first appeared
+    QHash<QUuid, size_t> indices;
+    std::vector<bool> isAlive;
+    for (auto& record : records) {
+        switch (record.type) {
+            case RecordType::Upsert:
+            case RecordType::Delete: {
+                bool alive = record.type == RecordType::Upsert;
+                auto index = indices.find(record.id);
+                if (index == indices.end()) {
+                    indices.insert(record.id, contents.records.size());
+                    isAlive.push_back(alive);
+                    contents.records.push_back(std::move(record));
+                } else {
+                    isAlive[*index] = alive;
+                    contents.records[*index] = std::move(record);
+                }
+                break;
+            }
+            case RecordType::Version:
+                if (record.data.size() == sizeof(qint64)) {
+                    contents.dataVersion = readLittleEndian<qint64>(record.data, 0);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    size_t numAlive = 0;
+    for (size_t i = 0; i < contents.records.size(); ++i) {
+        if (isAlive[i]) {
+            contents.records[numAlive++] = std::move(contents.records[i]);
+        }
+    }
+    contents.records.resize(numAlive);
+
+    return true;
+}
+
+bool OctreeJournal::append(const Records& records) {
+    if (!_journalFile.isOpen()) {
+        if (!_journalFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qCWarning(octree) << "Couldn't open journal" << _journalFile.fileName() << _journalFile.errorString();
+            return false;
+        }
+    }
+
+    QByteArray buffer;
+    if (_journalFile.size() == 0) {
+        appendLittleEndian(buffer, JOURNAL_MAGIC);
+    }
+    for (const auto& record : records) {
+        appendRecord(buffer, record);
+    }
+
+    bool success = _journalFile.write(buffer) == buffer.size() && _journalFile.flush();
+    if (!success) {
+        qCWarning(octree) << "Failed to append to journal" << _journalFile.fileName() << _journalFile.errorString();
+    }
+    return success;
+}
+
+qint64 OctreeJournal::getJournalSize() const {
+    return _journalFile.isOpen() ? _journalFile.size() : QFileInfo(getJournalFilename()).size();
+}
+
+bool OctreeJournal::rotate() {
+    _journalFile.close();
+
+    if (!_journalFile.exists()) {
+        return true;
+    }
+
+    QFile rotatedFile(getRotatedJournalFilename());
+    if (!rotatedFile.exists()) {
+        // a successful rename points the QFile at the new name, the next append starts a new journal
+        bool success = _journalFile.rename(getRotatedJournalFilename());
+        _journalFile.setFileName(getJournalFilename());
+        return success;
+    }
+
+    // the last compaction never finished, keep its journal and move ours onto the end of it
+    if (!_journalFile.open(QIODevice::ReadOnly) || !rotatedFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(octree) << "Couldn't rotate journal" << _journalFile.fileName();
+        _journalFile.close();
+        return false;
+    }
+    QByteArray journal = _journalFile.readAll();
+    _journalFile.close();
+
+    QByteArray records = journal.mid(sizeof(quint32));
+    bool success = records.isEmpty() || rotatedFile.write(records) == records.size();
+    rotatedFile.close();
+    return success && _journalFile.remove();
+}
+
+bool OctreeJournal::beginSnapshot(const QUuid& id, int64_t dataVersion, const QByteArray& treeData) {
+    abortSnapshot();
+
+    _snapshotFile.setFileName(getSnapshotFilename());
+    if (!_snapshotFile.open(QIODevice::WriteOnly)) {
+        qCWarning(octree) << "Couldn't write snapshot" << _snapshotFile.fileName() << _snapshotFile.errorString();
+        return false;
+    }
+
+    _snapshotBuffer.clear();
+    appendLittleEndian(_snapshotBuffer, SNAPSHOT_MAGIC);
+    appendLittleEndian(_snapshotBuffer, FORMAT_VERSION);
+    _snapshotBuffer.append(id.toRfc4122());
+    appendLittleEndian(_snapshotBuffer, (qint64)dataVersion);
+    appendLittleEndian(_snapshotBuffer, (quint32)treeData.size());
+    _snapshotBuffer.append(treeData);
+    return true;
+}
+
+bool OctreeJournal::writeSnapshotRecord(const Record& record) {
+    appendRecord(_snapshotBuffer, record);
+    if (_snapshotBuffer.size() >= SNAPSHOT_WRITE_SIZE) {
+        bool success = _snapshotFile.write(_snapshotBuffer) == _snapshotBuffer.size();
+        _snapshotBuffer.clear();
+        return success;
+    }
+    return true;
+}
+
+bool OctreeJournal::commitSnapshot() {
+    appendRecord(_snapshotBuffer, { RecordType::End, QUuid(), QByteArray() });
+    bool success = _snapshotFile.write(_snapshotBuffer) == _snapshotBuffer.size();
+    _snapshotBuffer.clear();
+
+    // QSaveFile only replaces the previous snapshot once everything made it to disk
+    if (!success) {
+        _snapshotFile.cancelWriting();
+    }
+    if (!_snapshotFile.commit() || !success) {
+        qCWarning(octree) << "Failed to write snapshot" << _snapshotFile.fileName() << _snapshotFile.errorString();
+        return false;
+    }
+
+    // everything in the rotated journal is in the snapshot now
+    QFile::remove(getRotatedJournalFilename());
+    return true;
+}
+
+void OctreeJournal::abortSnapshot() {
+    if (_snapshotFile.isOpen()) {
+        _snapshotFile.cancelWriting();
+        _snapshotFile.commit();
+    }
+    _snapshotBuffer.clear();
+}
+
+void OctreeJournal::clear() {
+    abortSnapshot();
+    _journalFile.close();
+
+    QFile::remove(getJournalFilename());
+    QFile::remove(getRotatedJournalFilename());
+    QFile::remove(getSnapshotFilename());
+}
+
+bool OctreeJournal::moveAside(const QString& suffix) {
+    abortSnapshot();
+    _journalFile.close();
+
+    bool success = true;
+    for (const auto& filename : { getSnapshotFilename(), getRotatedJournalFilename(), getJournalFilename() }) {
+        QFile file(filename);
+        if (file.exists()) {
+            if (file.rename(filename + suffix)) {
+                qCDebug(octree) << "Moved" << filename << "to" << filename + suffix;
+            } else {
+                qCWarning(octree) << "Couldn't move" << filename << "to" << filename + suffix << file.errorString();
+                success = false;
+            }
+        }
+    }
+    return success;
+}
@@ -0,0 +1,104 @@
+//
+//  OctreeJournal.h
+//  libraries/octree/src
+//
+//  Created by Roxanne Skelly on 2019-06-18.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeJournal_h
+#define hifi_OctreeJournal_h
+
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+// Binary persistence for an octree, as a snapshot plus an append-only journal of the changes made since.
+//
+//   <base>.snapshot       the full contents at some data version, replaced atomically by each compaction
+//   <base>.journal        records appended as the tree changes
+//   <base>.journal.old    the journal being folded into the next snapshot while a compaction runs
+//
+//   Each record is framed as [length][type][id][data][checksum]. The payload of a record is owned by the tree (for
+//   entities it is the EntityItemProperties wire encoding), the journal only cares about the id it applies to. A
+//   record that was cut short by a crash fails its checksum and ends the replay, so a journal is never worse than
+//   its last complete append.
+//
+//   Appends and rotation belong to the persist thread, the snapshot is written by the compaction. The two never
+//   touch the same file.
+class OctreeJournal {
+public:
+    enum class RecordType : quint8 {
+        Upsert = 1,     // the complete state of an element
+        Delete,
+        Version,        // data is the data version of the tree once the preceding records are applied
+        End             // closes a snapshot, one without it was never finished
+    };
+
+    struct Record {
+        RecordType type;
+        QUuid id;
+        QByteArray data;
+    };
+    using Records = std::vector<Record>;
+
+    struct Contents {
+        QUuid id;
+        int64_t dataVersion { 0 };
+        QByteArray treeData;    // tree-wide state that doesn't belong to any element
+        Records records;        // the latest upsert for each id still alive, deletes have been folded away
+    };
+
+    OctreeJournal(const QString& basePath);
+    ~OctreeJournal();
+
+    QString getSnapshotFilename() const { return _basePath + ".snapshot"; }
+    QString getJournalFilename() const { return _basePath + ".journal"; }
+    QString getRotatedJournalFilename() const { return _basePath + ".journal.old"; }
+
+    bool hasSnapshot() const;
+
+    // reads the snapshot and replays the rotated and active journals on top of it
+    //   a journal ending in a torn record is cut back to its last complete one
+    bool load(Contents& contents);
+
+    // appends the records to the active journal in one write
+    bool append(const Records& records);
+    qint64 getJournalSize() const;
+
+    // moves the active journal aside so it can be folded into a snapshot - a rotated journal left behind by an
+    // unfinished compaction is kept, and the active one is added to its end
+    bool rotate();
+
+    // write a new snapshot, safe to call from another thread than the appends
+    bool beginSnapshot(const QUuid& id, int64_t dataVersion, const QByteArray& treeData);
+    bool writeSnapshotRecord(const Record& record);
+    bool commitSnapshot();      // replaces the snapshot and drops the rotated journal
+    void abortSnapshot();
+
+    // removes the snapshot and both journals
+    void clear();
+    // renames whichever of the snapshot and journals exist by appending the suffix, so they're kept but not loaded
+    bool moveAside(const QString& suffix);
+
+    static QByteArray encodeVersion(int64_t dataVersion);
+
+private:
+    static void appendRecord(QByteArray& buffer, const Record& record);
+    // returns the offset following the last complete record
+    static int readRecords(const QByteArray& data, int offset, Records& records, bool& isTorn);
+
+    QString _basePath;
+    QFile _journalFile;
+    QSaveFile _snapshotFile;
+    QByteArray _snapshotBuffer;
+};
+
+#endif // hifi_OctreeJournal_h
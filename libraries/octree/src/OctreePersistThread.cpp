@@ -38,13 +38,18 @@
 #include "OctreeDataUtils.h"
 
 constexpr std::chrono::seconds OctreePersistThread::DEFAULT_PERSIST_INTERVAL { 30 };
+constexpr std::chrono::minutes OctreePersistThread::DEFAULT_COMPACTION_INTERVAL { 10 };
 constexpr std::chrono::milliseconds TIME_BETWEEN_PROCESSING { 10 };
 
 constexpr int MAX_OCTREE_REPLACEMENT_BACKUP_FILES_COUNT { 20 };
 constexpr int64_t MAX_OCTREE_REPLACEMENT_BACKUP_FILES_SIZE_BYTES { 50 * 1000 * 1000 };
+static const QString FILENAME_TIMESTAMP_FORMAT = "yyyyMMdd-hhmmss";
+
+// a journal this large is compacted without waiting for the compaction interval
+constexpr qint64 MAX_JOURNAL_SIZE_BYTES { 64 * 1000 * 1000 };
 
 OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& filename, std::chrono::milliseconds persistInterval,
-                                         bool debugTimestampNow, QString persistAsFileType) :
+                                         bool debugTimestampNow, QString persistAsFileType, bool persistJournal) :
     _tree(tree),
     _filename(filename),
     _persistInterval(persistInterval),
@@ -53,11 +58,16 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     _loadTimeUSecs(0),
     _debugTimestampNow(debugTimestampNow),
     _lastTimeDebug(0),
-    _persistAsFileType(persistAsFileType)
+    _persistAsFileType(persistAsFileType),
+    _persistJournal(persistJournal),
+    _lastCompaction(std::chrono::steady_clock::now())
 {
     // in case the persist filename has an extension that doesn't match the file type
     QString sansExt = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS);
     _filename = sansExt + "." + _persistAsFileType;
+
+    // the journal lives next to the JSON file, it is read even when journaling is off so it can be converted back
+    _journal = std::unique_ptr<OctreeJournal>(new OctreeJournal(sansExt));
 }
 
 void OctreePersistThread::start() {
@@ -71,30 +81,53 @@ void OctreePersistThread::start() {
 
     auto packet = NLPacket::create(PacketType::OctreeDataFileRequest, -1, true, false);
 
-    OctreeUtils::RawOctreeData data;
-    qCDebug(octree) << "Reading octree data from" << _filename;
-    QFile file(_filename);
-    if (file.open(QIODevice::ReadOnly)) {
-        QByteArray jsonData(file.readAll());
-        file.close();
-        if (!gunzip(jsonData, _cachedJSONData)) {
-            _cachedJSONData = jsonData;
+    // a snapshot is always at least as recent as the JSON file, it was written from it in the first place
+    if (_journal->hasSnapshot()) {
+        qCDebug(octree) << "Reading octree data from" << _journal->getSnapshotFilename();
+        _hasJournalContents = _journal->load(_journalContents);
+        if (!_hasJournalContents) {
+            // the JSON file hasn't been written since journaling started, falling back to it would silently roll
+            // the domain back - leave everything as it is, so a transient error clears up and damage can be looked at
+            qCCritical(octree) << "Failed to load" << _journal->getSnapshotFilename() << "and its journals, not loading"
+                << "the older" << _filename << "in their place. Move them aside to start from" << _filename;
+            emit loadFailed();
+            return;
         }
+    }
 
-        if (data.readOctreeDataInfoFromData(_cachedJSONData)) {
-            qCDebug(octree) << "Current octree data: ID(" << data.id << ") DataVersion(" << data.version << ")";
-            packet->writePrimitive(true);
-            auto id = data.id.toRfc4122();
-            packet->write(id);
-            packet->writePrimitive(data.version);
+    OctreeUtils::RawOctreeData data;
+    if (_hasJournalContents) {
+        qCDebug(octree) << "Current octree data: ID(" << _journalContents.id << ") DataVersion("
+            << _journalContents.dataVersion << ")";
+        packet->writePrimitive(true);
+        auto id = _journalContents.id.toRfc4122();
+        packet->write(id);
+        packet->writePrimitive((OctreeUtils::Version)_journalContents.dataVersion);
+    } else {
+        qCDebug(octree) << "Reading octree data from" << _filename;
+        QFile file(_filename);
+        if (file.open(QIODevice::ReadOnly)) {
+            QByteArray jsonData(file.readAll());
+            file.close();
+            if (!gunzip(jsonData, _cachedJSONData)) {
+                _cachedJSONData = jsonData;
+            }
+
+            if (data.readOctreeDataInfoFromData(_cachedJSONData)) {
+                qCDebug(octree) << "Current octree data: ID(" << data.id << ") DataVersion(" << data.version << ")";
+                packet->writePrimitive(true);
+                auto id = data.id.toRfc4122();
+                packet->write(id);
+                packet->writePrimitive(data.version);
+            } else {
+                _cachedJSONData.clear();
+                qCWarning(octree) << "No octree data found";
+                packet->writePrimitive(false);
+            }
         } else {
-            _cachedJSONData.clear();
-            qCWarning(octree) << "No octree data found";
+            qCWarning(octree) << "Couldn't access file" << _filename << file.errorString();
             packet->writePrimitive(false);
         }
-    } else {
-        qCWarning(octree) << "Couldn't access file" << _filename << file.errorString();
-        packet->writePrimitive(false);
     }
 
     qCDebug(octree) << "Sending OctreeDataFileRequest to DS";
@@ -114,28 +147,40 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
     bool hasValidOctreeData { false };
     if (includesNewData) {
         _cachedJSONData.clear();
+
+        // the journal describes the data that is being replaced, keep it alongside the backup of the JSON file
+        _hasJournalContents = false;
+        _journalContents = OctreeJournal::Contents();
+        _journal->moveAside(".backup." + QDateTime::currentDateTime().toString(FILENAME_TIMESTAMP_FORMAT));
+
         replacementData = message->readAll();
         replaceData(replacementData);
         hasValidOctreeData = data.readOctreeDataInfoFromFile(_filename);
         qDebug() << "Got OctreeDataFileReply, new data sent";
     } else {
         qDebug() << "Got OctreeDataFileReply, current entity data is sufficient";
-        
-        OctreeUtils::RawEntityData data;
-        qCDebug(octree) << "Reading octree data from" << _filename;
-        if (data.readOctreeDataInfoFromData(_cachedJSONData)) {
+
+        if (_hasJournalContents) {
             hasValidOctreeData = true;
-            if (data.id.isNull()) {
-                qCDebug(octree) << "Current octree data has a null id, updating";
-                data.resetIdAndVersion();
-
-                QFile file(_filename);
-                if (file.open(QIODevice::WriteOnly)) {
-                    auto entityData = data.toGzippedByteArray();
-                    file.write(entityData);
-                    file.close();
-                } else {
-                    qCDebug(octree) << "Failed to update octree data";
+            data.id = _journalContents.id;
+            data.version = _journalContents.dataVersion;
+        } else {
+            OctreeUtils::RawEntityData data;
+            qCDebug(octree) << "Reading octree data from" << _filename;
+            if (data.readOctreeDataInfoFromData(_cachedJSONData)) {
+                hasValidOctreeData = true;
+                if (data.id.isNull()) {
+                    qCDebug(octree) << "Current octree data has a null id, updating";
+                    data.resetIdAndVersion();
+
+                    QFile file(_filename);
+                    if (file.open(QIODevice::WriteOnly)) {
+                        auto entityData = data.toGzippedByteArray();
+                        file.write(entityData);
+                        file.close();
+                    } else {
+                        qCDebug(octree) << "Failed to update octree data";
+                    }
                 }
             }
         }
@@ -153,7 +198,9 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
     _tree->withWriteLock([&] {
         PerformanceWarning warn(true, "Loading Octree File", true);
 
-        if (_cachedJSONData.isEmpty()) {
+        if (_hasJournalContents) {
+            persistentFileRead = _tree->readFromJournal(_journalContents);
+        } else if (_cachedJSONData.isEmpty()) {
             persistentFileRead = _tree->readFromFile(_filename.toLocal8Bit().constData());
         } else {
             QDataStream jsonStream(_cachedJSONData);
@@ -163,11 +210,41 @@ void OctreePersistThread::handleOctreeDataFileReply(QSharedPointer<ReceivedMessa
     });
 
     _cachedJSONData.clear();
+    _journalContents = OctreeJournal::Contents();
     quint64 loadDone = usecTimestampNow();
     _loadTimeUSecs = loadDone - loadStarted;
 
     _tree->clearDirtyBit(); // the tree is clean since we just loaded it
 
+    if (_persistJournal && _tree->supportsJournaling()) {
+        // only the changes made from here on belong in the journal
+        _tree->setJournaling(true);
+
+        if (!_hasJournalContents) {
+            // there was no snapshot, so the JSON we just loaded becomes the first one - the tree isn't live yet so it's
+            // written in place. Journals left without their snapshot can't be replayed on it, but aren't ours to drop.
+            qCDebug(octree) << "Writing initial snapshot to" << _journal->getSnapshotFilename();
+            _journal->moveAside(".orphaned." + QDateTime::currentDateTime().toString(FILENAME_TIMESTAMP_FORMAT));
+            if (!writeSnapshot(_tree->getPersistID(), _tree->getPersistDataVersion(), _tree->getJournalTreeData())) {
+                qCWarning(octree) << "Failed to write initial snapshot, journaling is disabled";
+                _tree->setJournaling(false);
+                _persistJournal = false;
+            }
+        }
+    } else {
+        _persistJournal = false;
+
+        if (_hasJournalContents) {
+            // journaling has been turned off, go back to the JSON file
+            qCDebug(octree) << "Converting journaled octree data to" << _filename;
+            if (_tree->writeToFile(_filename.toLocal8Bit().constData(), nullptr, _persistAsFileType)) {
+                _journal->clear();
+            } else {
+                qCWarning(octree) << "Failed to convert journaled octree data to" << _filename;
+            }
+        }
+    }
+
     unsigned long nodeCount = OctreeElement::getNodeCount();
     unsigned long internalNodeCount = OctreeElement::getInternalNodeCount();
     unsigned long leafNodeCount = OctreeElement::getLeafNodeCount();
@@ -227,7 +304,6 @@ bool OctreePersistThread::backupCurrentFile() {
     // first take the current models file and move it to a different filename, appended with the timestamp
     QFile currentFile { _filename };
     if (currentFile.exists()) {
-        static const QString FILENAME_TIMESTAMP_FORMAT = "yyyyMMdd-hhmmss";
         auto backupFileName = _filename + ".backup." + QDateTime::currentDateTime().toString(FILENAME_TIMESTAMP_FORMAT);
 
         if (currentFile.rename(backupFileName)) {
@@ -244,6 +320,10 @@ bool OctreePersistThread::backupCurrentFile() {
 void OctreePersistThread::process() {
     _tree->update();
 
+    if (_compaction.valid() && _compaction.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        finishCompaction();
+    }
+
     auto now = std::chrono::steady_clock::now();
     auto timeSinceLastPersist = now - _lastPersistCheck;
 
@@ -257,12 +337,22 @@ void OctreePersistThread::process() {
 
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
+    if (_compaction.valid()) {
+        _compaction.wait();
+        finishCompaction();
+    }
     persist();
     qCDebug(octree) << "Persist thread done with about to finish...";
 }
 
 QByteArray OctreePersistThread::getPersistFileContents() const {
     QByteArray fileContents;
+    if (_persistJournal) {
+        // the JSON file isn't kept up to date while journaling, export the tree as it is now
+        _tree->toJSON(&fileContents, nullptr, _persistAsFileType == "json.gz");
+        return fileContents;
+    }
+
     QFile file(_filename);
     if (file.open(QIODevice::ReadOnly)) {
         fileContents = file.readAll();
@@ -301,6 +391,13 @@ void OctreePersistThread::cleanupOldReplacementBackups() {
 }
 
 void OctreePersistThread::persist() {
+    if (_persistJournal) {
+        if (_initialLoadComplete) {
+            persistJournal();
+        }
+        return;
+    }
+
     if (_tree->isDirty() && _initialLoadComplete) {
 
         _tree->withWriteLock([&] {
@@ -323,6 +420,94 @@ void OctreePersistThread::persist() {
     }
 }
 
+void OctreePersistThread::persistJournal() {
+    OctreeJournal::Records records;
+    _tree->takeJournalRecords(records);
+    _tree->clearDirtyBit();
+
+    bool didAppend = true;
+    if (!records.empty()) {
+        auto numChanges = records.size();
+        _tree->incrementPersistDataVersion();
+        records.push_back({ OctreeJournal::RecordType::Version, QUuid(),
+                            OctreeJournal::encodeVersion(_tree->getPersistDataVersion()) });
+
+        didAppend = _journal->append(records);
+        if (didAppend) {
+            qCDebug(octree) << "Journaled" << numChanges << "changes to" << _journal->getJournalFilename();
+        } else {
+            qCWarning(octree) << "Failed to journal octree data to" << _journal->getJournalFilename();
+        }
+    }
+
+    if (_compaction.valid()) {
+        return;
+    }
+
+    // a failed append is only made good by the next snapshot, so don't wait for it
+    qint64 journalSize = _journal->getJournalSize();
+    auto timeSinceLastCompaction = std::chrono::steady_clock::now() - _lastCompaction;
+    if (!didAppend || journalSize > MAX_JOURNAL_SIZE_BYTES ||
+        (journalSize > 0 && timeSinceLastCompaction > DEFAULT_COMPACTION_INTERVAL)) {
+        startCompaction();
+    }
+}
+
+void OctreePersistThread::startCompaction() {
+    _lastCompaction = std::chrono::steady_clock::now();
+
+    // from here on the journal holds whatever has to be replayed on top of the new snapshot
+    if (!_journal->rotate()) {
+        qCWarning(octree) << "Failed to rotate journal" << _journal->getJournalFilename();
+        return;
+    }
+
+    _tree->withWriteLock([&] {
+        _tree->pruneTree();
+    });
+
+    QUuid id = _tree->getPersistID();
+    int64_t dataVersion = _tree->getPersistDataVersion();
+    QByteArray treeData = _tree->getJournalTreeData();
+    _compaction = std::async(std::launch::async, [this, id, dataVersion, treeData] {
+        return writeSnapshot(id, dataVersion, treeData);
+    });
+}
+
+void OctreePersistThread::finishCompaction() {
+    if (_compaction.get()) {
+        // the DS keeps a copy of the data for its content backups, refresh it along with the snapshot
+        sendLatestEntityDataToDS();
+    } else {
+        // the rotated journal is kept, the next compaction picks it up
+        qCWarning(octree) << "Failed to compact journal" << _journal->getRotatedJournalFilename();
+    }
+}
+
+bool OctreePersistThread::writeSnapshot(QUuid id, int64_t dataVersion, QByteArray treeData) {
+    quint64 snapshotStarted = usecTimestampNow();
+
+    if (!_journal->beginSnapshot(id, dataVersion, treeData)) {
+        return false;
+    }
+
+    bool success = _tree->writeJournalSnapshot([&](const OctreeJournal::Record& record) {
+        return _journal->writeSnapshotRecord(record);
+    });
+    if (!success) {
+        _journal->abortSnapshot();
+        return false;
+    }
+
+    if (!_journal->commitSnapshot()) {
+        return false;
+    }
+
+    qCDebug(octree) << "Wrote snapshot" << _journal->getSnapshotFilename() << "DataVersion(" << dataVersion << ") in"
+        << (usecTimestampNow() - snapshotStarted) / USECS_PER_MSEC << "ms";
+    return true;
+}
+
 void OctreePersistThread::sendLatestEntityDataToDS() {
     qDebug() << "Sending latest entity data to DS";
     auto nodeList = DependencyManager::get<NodeList>();
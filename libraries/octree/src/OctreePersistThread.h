@@ -14,9 +14,13 @@
 #ifndef hifi_OctreePersistThread_h
 #define hifi_OctreePersistThread_h
 
+#include <future>
+#include <memory>
+
 #include <QString>
 #include <GenericThread.h>
 #include "Octree.h"
+#include "OctreeJournal.h"
 
 class OctreePersistThread : public QObject {
     Q_OBJECT
@@ -31,12 +35,14 @@ public:
     };
 
     static const std::chrono::seconds DEFAULT_PERSIST_INTERVAL;
+    static const std::chrono::minutes DEFAULT_COMPACTION_INTERVAL;
 
     OctreePersistThread(OctreePointer tree,
                         const QString& filename,
                         std::chrono::milliseconds persistInterval = DEFAULT_PERSIST_INTERVAL,
                         bool debugTimestampNow = false,
-                        QString persistAsFileType = "json.gz");
+                        QString persistAsFileType = "json.gz",
+                        bool persistJournal = false);
 
     bool isInitialLoadComplete() const { return _initialLoadComplete; }
     quint64 getLoadElapsedTime() const { return _loadTimeUSecs; }
@@ -52,6 +58,7 @@ public slots:
 
 signals:
     void loadCompleted();
+    void loadFailed(); // the journaled data exists but couldn't be read, nothing was loaded in its place
 
 protected slots:
     void process();
@@ -65,6 +72,12 @@ protected:
     void replaceData(QByteArray data);
     void sendLatestEntityDataToDS();
 
+    // journaled persistence, see OctreeJournal
+    void persistJournal();
+    void startCompaction();
+    void finishCompaction();
+    bool writeSnapshot(QUuid id, int64_t dataVersion, QByteArray treeData); // runs on the compaction thread
+
 private:
     OctreePointer _tree;
     QString _filename;
@@ -79,6 +92,13 @@ private:
 
     QString _persistAsFileType;
     QByteArray _cachedJSONData;
+
+    bool _persistJournal;
+    std::unique_ptr<OctreeJournal> _journal;
+    OctreeJournal::Contents _journalContents;
+    bool _hasJournalContents { false };
+    std::chrono::steady_clock::time_point _lastCompaction;
+    std::future<bool> _compaction;
 };
 
 #endif // hifi_OctreePersistThread_h
@@ -31,7 +31,7 @@ public:
     OctreeQuery& operator=(const OctreeQuery&) = delete;
 
     int getBroadcastData(unsigned char* destinationBuffer);
-    int parseData(ReceivedMessage& message) override;
+    int parseData(ReceivedPacket& message) override;
 
     bool hasConicalViews() const { QMutexLocker lock(&_conicalViewsLock); return !_conicalViews.empty(); }
     void setConicalViews(ConicalViewFrustums views)
@@ -785,18 +785,24 @@ void EntityMotionState::computeCollisionGroupAndMask(int32_t& group, int32_t& ma
     _entity->computeCollisionGroupAndFinalMask(group, mask);
 }
 
+uint8_t EntityMotionState::_volunteerPriority { VOLUNTEER_SIMULATION_PRIORITY };
+
+void EntityMotionState::setVolunteerPriority(uint8_t priority) {
+    _volunteerPriority = glm::max(priority, VOLUNTEER_SIMULATION_PRIORITY);
+}
+
 bool EntityMotionState::shouldSendBid() const {
     // NOTE: this method is only ever called when the entity's simulation is NOT locally owned
     return _body->isActive()
         && (_region == workload::Region::R1)
         && _ownershipState != EntityMotionState::OwnershipState::Unownable
-        && glm::max(glm::max(VOLUNTEER_SIMULATION_PRIORITY, _bumpedPriority), _entity->getScriptSimulationPriority()) >= _entity->getSimulationPriority()
+        && glm::max(glm::max(_volunteerPriority, _bumpedPriority), _entity->getScriptSimulationPriority()) >= _entity->getSimulationPriority()
         && !_entity->getLocked();
 }
 
 uint8_t EntityMotionState::computeFinalBidPriority() const {
     return (_region == workload::Region::R1) ?
-        glm::max(glm::max(VOLUNTEER_SIMULATION_PRIORITY, _bumpedPriority), _entity->getScriptSimulationPriority()) : 0;
+        glm::max(glm::max(_volunteerPriority, _bumpedPriority), _entity->getScriptSimulationPriority()) : 0;
 }
 
 bool EntityMotionState::isLocallyOwned() const {
@@ -809,7 +815,7 @@ bool EntityMotionState::isLocallyOwnedOrShouldBe() const {
     if (_entity->getSimulatorID() == Physics::getSessionUUID()) {
         return true;
     } else {
-        return computeFinalBidPriority() > glm::max(VOLUNTEER_SIMULATION_PRIORITY, _entity->getSimulationPriority());
+        return computeFinalBidPriority() > glm::max(_volunteerPriority, _entity->getSimulationPriority());
     }
 }
 
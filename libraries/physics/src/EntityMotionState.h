@@ -89,6 +89,11 @@ public:
 
     bool shouldSendBid() const;
 
+    // the least priority this participant bids at and holds ownership with, VOLUNTEER unless it has been
+    // given authority over the simulation (a physics-server bids higher so clients don't compete with it)
+    static void setVolunteerPriority(uint8_t priority);
+    static uint8_t getVolunteerPriority() { return _volunteerPriority; }
+
     bool isLocallyOwned() const override;
     bool isLocallyOwnedOrShouldBe() const override; // aka shouldEmitCollisionEvents()
 
@@ -158,6 +163,8 @@ protected:
     uint8_t _bumpedPriority { 0 }; // the target simulation priority according to collision history
     uint8_t _region { workload::Region::INVALID };
 
+    static uint8_t _volunteerPriority;
+
     bool isServerlessMode();
 };
 
@@ -97,6 +97,9 @@ public:
     void sendOwnershipBids(uint32_t numSubsteps);
     void sendOwnedUpdates(uint32_t numSubsteps);
 
+    int getNumOwnedEntities() const { return (int)_owned.size(); }
+    int getNumPendingBids() const { return (int)_bids.size(); }
+
 private:
     SetOfEntities _entitiesToAddToPhysics;
     SetOfEntities _entitiesToRemoveFromPhysics;
@@ -12,6 +12,7 @@
 #include "PhysicsEngine.h"
 
 #include <functional>
+#include <mutex>
 
 #include <QFile>
 
@@ -19,6 +20,8 @@
 #include <PhysicsCollisionGroups.h>
 #include <Profile.h>
 #include <BulletCollision/CollisionShapes/btTriangleShape.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <LinearMath/btThreads.h>
 
 #include "CharacterController.h"
 #include "ObjectMotionState.h"
@@ -45,6 +48,33 @@ static bool flipNormalsMyAvatarVsBackfacingTriangles(btManifoldPoint& cp,
     return false;
 }
 
+static std::mutex taskSchedulerMutex;
+static btITaskScheduler* parallelTaskScheduler { nullptr };
+
+void PhysicsEngine::setNumSolverThreads(int numThreads) {
+    std::lock_guard<std::mutex> lock(taskSchedulerMutex);
+    if (numThreads != 1 && !parallelTaskScheduler) {
+        // null when Bullet was built without BT_THREADSAFE
+        parallelTaskScheduler = btCreateDefaultTaskScheduler();
+        if (!parallelTaskScheduler) {
+            qCWarning(physics) << "Bullet was built without multithreading, solving constraints on one thread";
+        }
+    }
+    if (numThreads != 1 && parallelTaskScheduler) {
+        int maxThreads = parallelTaskScheduler->getMaxNumThreads();
+        parallelTaskScheduler->setNumThreads(numThreads > 0 ? std::min(numThreads, maxThreads) : maxThreads);
+        btSetTaskScheduler(parallelTaskScheduler);
+    } else {
+        btSetTaskScheduler(btGetSequentialTaskScheduler());
+    }
+}
+
+int PhysicsEngine::getNumSolverThreads() {
+    std::lock_guard<std::mutex> lock(taskSchedulerMutex);
+    btITaskScheduler* scheduler = btGetTaskScheduler();
+    return scheduler ? scheduler->getNumThreads() : 1;
+}
+
 PhysicsEngine::PhysicsEngine(const glm::vec3& offset) :
         _originOffset(offset),
         _myAvatarController(nullptr) {
@@ -57,7 +87,8 @@ PhysicsEngine::~PhysicsEngine() {
     delete _collisionConfig;
     delete _collisionDispatcher;
     delete _broadphaseFilter;
-    delete _constraintSolver;
+    delete _constraintSolverPool;
+    delete _constraintSolverMt;
     delete _dynamicsWorld;
     delete _ghostPairCallback;
 }
@@ -67,8 +98,22 @@ void PhysicsEngine::init() {
         _collisionConfig = new btDefaultCollisionConfiguration();
         _collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
         _broadphaseFilter = new btDbvtBroadphase();
-        _constraintSolver = new btSequentialImpulseConstraintSolver;
-        _dynamicsWorld = new ThreadSafeDynamicsWorld(_collisionDispatcher, _broadphaseFilter, _constraintSolver, _collisionConfig);
+
+        // the multithreaded world needs a task scheduler even when it steps on one thread
+        if (!btGetTaskScheduler()) {
+            setNumSolverThreads(1);
+        }
+        // NOTE: collisions are still dispatched on the stepping thread, our contact callbacks aren't thread safe,
+        // and so are predictive contacts and transform integration (see ThreadSafeDynamicsWorld) since they use
+        // the plain dispatcher's manifold pool
+        int numSolverThreads = getNumSolverThreads();
+        bool multithreaded = numSolverThreads > 1;
+        _constraintSolverPool = new btConstraintSolverPoolMt(numSolverThreads);
+        if (multithreaded) {
+            _constraintSolverMt = new btSequentialImpulseConstraintSolverMt();
+        }
+        _dynamicsWorld = new ThreadSafeDynamicsWorld(_collisionDispatcher, _broadphaseFilter, _constraintSolverPool,
+                                                     _constraintSolverMt, _collisionConfig, multithreaded);
         _physicsDebugDraw.reset(new PhysicsDebugDraw());
 
         // hook up debug draw renderer
@@ -90,6 +90,12 @@ public:
     ~PhysicsEngine();
     void init();
 
+    /// \brief sets the threads each step's constraints are solved on, 0 for one per core, 1 to solve on the
+    /// stepping thread.  Bullet's task scheduler is shared by every engine in the process, and an engine picks
+    /// its solvers in init() so set this before then.
+    static void setNumSolverThreads(int numThreads);
+    static int getNumSolverThreads();
+
     uint32_t getNumSubsteps() const;
     int32_t getNumCollisionObjects() const;
 
@@ -165,7 +171,8 @@ private:
     btDefaultCollisionConfiguration* _collisionConfig = NULL;
     btCollisionDispatcher* _collisionDispatcher = NULL;
     btBroadphaseInterface* _broadphaseFilter = NULL;
-    btSequentialImpulseConstraintSolver* _constraintSolver = NULL;
+    btConstraintSolverPoolMt* _constraintSolverPool = NULL;
+    btConstraintSolver* _constraintSolverMt = NULL;
     ThreadSafeDynamicsWorld* _dynamicsWorld = NULL;
     btGhostPairCallback* _ghostPairCallback = NULL;
     std::unique_ptr<PhysicsDebugDraw> _physicsDebugDraw;
@@ -24,9 +24,36 @@
 ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
         btDispatcher* dispatcher,
         btBroadphaseInterface* pairCache,
-        btConstraintSolver* constraintSolver,
-        btCollisionConfiguration* collisionConfiguration)
-    :   btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration) {
+        btConstraintSolverPoolMt* solverPool,
+        btConstraintSolver* constraintSolverMt,
+        btCollisionConfiguration* collisionConfiguration,
+        bool multithreaded)
+    :   btDiscreteDynamicsWorldMt(dispatcher, pairCache, solverPool, constraintSolverMt, collisionConfiguration),
+        _multithreaded(multithreaded) {
+    if (!_multithreaded) {
+        // btDiscreteDynamicsWorldMt swapped in its own island manager, put the single-threaded one back so
+        // btDiscreteDynamicsWorld::solveConstraints() finds the islands it expects
+        m_islandManager->~btSimulationIslandManager();
+        btAlignedFree(m_islandManager);
+        void* mem = btAlignedAlloc(sizeof(btSimulationIslandManager), 16);
+        m_islandManager = new (mem) btSimulationIslandManager();
+    }
+}
+
+void ThreadSafeDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo) {
+    if (_multithreaded) {
+        btDiscreteDynamicsWorldMt::solveConstraints(solverInfo);
+    } else {
+        btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+    }
+}
+
+void ThreadSafeDynamicsWorld::createPredictiveContacts(btScalar timeStep) {
+    btDiscreteDynamicsWorld::createPredictiveContacts(timeStep);
+}
+
+void ThreadSafeDynamicsWorld::integrateTransforms(btScalar timeStep) {
+    btDiscreteDynamicsWorld::integrateTransforms(timeStep);
 }
 
 int ThreadSafeDynamicsWorld::stepSimulationWithSubstepCallback(btScalar timeStep, int maxSubSteps,
@@ -20,6 +20,7 @@
 
 #include <BulletDynamics/Dynamics/btRigidBody.h>
 #include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
 
 #include "ObjectMotionState.h"
 
@@ -27,15 +28,22 @@
 
 using SubStepCallback = std::function<void()>;
 
-ATTRIBUTE_ALIGNED16(class) ThreadSafeDynamicsWorld : public btDiscreteDynamicsWorld {
+// When built multithreaded the islands of a step are solved in parallel on Bullet's task scheduler, large islands
+// spread their constraints over the scheduler's threads too.  Otherwise the world steps exactly like a
+// btDiscreteDynamicsWorld, on the calling thread.
+ATTRIBUTE_ALIGNED16(class) ThreadSafeDynamicsWorld : public btDiscreteDynamicsWorldMt {
 public:
     BT_DECLARE_ALIGNED_ALLOCATOR();
 
     ThreadSafeDynamicsWorld(
             btDispatcher* dispatcher,
             btBroadphaseInterface* pairCache,
-            btConstraintSolver* constraintSolver,
-            btCollisionConfiguration* collisionConfiguration);
+            btConstraintSolverPoolMt* solverPool,
+            btConstraintSolver* constraintSolverMt,
+            btCollisionConfiguration* collisionConfiguration,
+            bool multithreaded);
+
+    bool isMultithreaded() const { return _multithreaded; }
 
     int getNumSubsteps() const { return _numSubsteps; }
     int stepSimulationWithSubstepCallback(btScalar timeStep, int maxSubSteps = 1,
@@ -55,6 +63,14 @@ public:
     void addChangedMotionState(ObjectMotionState* motionState) { _changedMotionStates.push_back(motionState); }
     virtual void debugDrawObject(const btTransform& worldTransform, const btCollisionShape* shape, const btVector3& color) override;
 
+protected:
+    virtual void solveConstraints(btContactSolverInfo& solverInfo) override;
+
+    // btDiscreteDynamicsWorldMt runs these in parallel, but with CCD they get and release contact manifolds
+    // from the dispatcher, whose pool isn't thread safe - so they stay on the stepping thread
+    virtual void createPredictiveContacts(btScalar timeStep) override;
+    virtual void integrateTransforms(btScalar timeStep) override;
+
 private:
     // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
     void synchronizeMotionState(btRigidBody* body);
@@ -66,6 +82,7 @@ private:
     SetOfMotionStates _activeStates;
     SetOfMotionStates _lastActiveStates;
     int _numSubsteps { 0 };
+    bool _multithreaded;
 };
 
 #endif // hifi_ThreadSafeDynamicsWorld_h
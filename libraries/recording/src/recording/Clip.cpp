@@ -13,6 +13,7 @@
 
 #include "impl/FileClip.h"
 #include "impl/BufferClip.h"
+#include "impl/ColumnarClip.h"
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -22,6 +23,10 @@
 using namespace recording;
 
 Clip::Pointer Clip::fromFile(const QString& filePath) {
+    if (ColumnarClip::isColumnarFile(filePath)) {
+        return ColumnarClip::fromFile(filePath);
+    }
+
     auto result = std::make_shared<FileClip>(filePath);
     if (result->frameCount() == 0) {
         return Clip::Pointer();
@@ -12,6 +12,7 @@
 
 #include <shared/QtHelpers.h>
 
+#include "impl/ColumnarClip.h"
 #include "impl/PointerClip.h"
 #include "Logging.h"
 
@@ -26,7 +27,11 @@ void NetworkClip::init(const QByteArray& clipData) {
 }
 
 void NetworkClipLoader::downloadFinished(const QByteArray& data) {
-    _clip->init(data);
+    if (ColumnarClip::isColumnar(reinterpret_cast<const uint8_t*>(data.constData()), data.size())) {
+        _columnarClip = ColumnarClip::fromBuffer(data, getURL().toString());
+    } else {
+        _clip->init(data);
+    }
     finishedLoading(true);
     emit clipLoaded();
 }
@@ -33,10 +33,11 @@ class NetworkClipLoader : public Resource {
     Q_OBJECT
 public:
     NetworkClipLoader(const QUrl& url);
-    NetworkClipLoader(const NetworkClipLoader& other) : Resource(other), _clip(other._clip) {}
+    NetworkClipLoader(const NetworkClipLoader& other) :
+        Resource(other), _clip(other._clip), _columnarClip(other._columnarClip) {}
 
     virtual void downloadFinished(const QByteArray& data) override;
-    ClipPointer getClip() { return _clip; }
+    ClipPointer getClip() { return _columnarClip ? _columnarClip : _clip; }
     bool completed() { return _failedToLoad || isLoaded(); }
 
 signals:
@@ -44,6 +45,7 @@ signals:
 
 private:
     const NetworkClip::Pointer _clip;
+    ClipPointer _columnarClip;
 };
 
 using NetworkClipLoaderPointer = QSharedPointer<NetworkClipLoader>;
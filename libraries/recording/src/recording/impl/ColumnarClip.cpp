@@ -0,0 +1,443 @@
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ColumnarClip.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <Finally.h>
+
+#include "../Frame.h"
+#include "../Logging.h"
+
+using namespace recording;
+
+// The file is laid out as
+//
+//   FileHeader
+//   frame type map, the binary JSON the record based format keeps in its header frame
+//   times       Frame::Time[frameCount], ascending
+//   sizes       uint32_t[frameCount]
+//   offsets     uint32_t[frameCount], of the frame's data within its chunk
+//   types       FrameType[frameCount]
+//   chunks      ChunkHeader[chunkCount], ascending by first frame
+//   chunk data
+//
+// with every section starting on an 8 byte boundary so the columns can be read in place.
+static const char MAGIC[4] = { 'H', 'F', 'C', 'C' };
+static const uint32_t FLAG_COMPRESSED = 1 << 0;
+static const size_t SECTION_ALIGNMENT = 8;
+
+static size_t align(size_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+struct Layout {
+    size_t typeMap;
+    size_t times;
+    size_t sizes;
+    size_t offsets;
+    size_t types;
+    size_t chunks;
+    size_t end;
+
+    Layout(const ColumnarClip::FileHeader& header) {
+        size_t frameCount = header.frameCount;
+        typeMap = align(sizeof(ColumnarClip::FileHeader));
+        times = align(typeMap + header.typeMapSize);
+        sizes = align(times + frameCount * sizeof(Frame::Time));
+        offsets = align(sizes + frameCount * sizeof(uint32_t));
+        types = align(offsets + frameCount * sizeof(uint32_t));
+        chunks = align(types + frameCount * sizeof(FrameType));
+        end = chunks + (size_t)header.chunkCount * sizeof(ColumnarClip::ChunkHeader);
+    }
+};
+
+bool ColumnarClip::isColumnar(const uint8_t* data, size_t size) {
+    return data && size >= sizeof(MAGIC) && memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool ColumnarClip::isColumnarFile(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray magic = file.read(sizeof(MAGIC));
+    return isColumnar(reinterpret_cast<const uint8_t*>(magic.constData()), magic.size());
+}
+
+ColumnarClip::Pointer ColumnarClip::fromFile(const QString& filePath) {
+    auto storage = std::make_shared<storage::FileStorage>(filePath);
+    if (!*storage) {
+        return Pointer();
+    }
+    auto result = std::make_shared<ColumnarClip>(storage, filePath);
+    return result->isValid() ? result : Pointer();
+}
+
+ColumnarClip::Pointer ColumnarClip::fromBuffer(const QByteArray& data, const QString& name) {
+    auto storage = std::make_shared<storage::MemoryStorage>(data.size(), reinterpret_cast<const uint8_t*>(data.constData()));
+    auto result = std::make_shared<ColumnarClip>(storage, name);
+    return result->isValid() ? result : Pointer();
+}
+
+ColumnarClip::ColumnarClip(const storage::StoragePointer& storage, const QString& name) :
+    _storage(storage),
+    _name(name)
+{
+    if (!parse()) {
+        qCWarning(recordingLog) << "Invalid columnar clip" << _name;
+        reset();
+    }
+    skipUnknownFrames();
+}
+
+bool ColumnarClip::parse() {
+    const uint8_t* data = _storage->data();
+    size_t size = _storage->size();
+    if (!isColumnar(data, size) || size < sizeof(FileHeader)) {
+        return false;
+    }
+
+    FileHeader header;
+    memcpy(&header, data, sizeof(FileHeader));
+    if (header.version != VERSION) {
+        qCWarning(recordingLog) << "Unsupported columnar clip version" << header.version;
+        return false;
+    }
+
+    Layout layout(header);
+    if (layout.end > size) {
+        return false;
+    }
+    if (reinterpret_cast<uintptr_t>(data) % alignof(uint32_t) != 0) {
+        // the storage is mapped or heap allocated, but don't read the columns misaligned if it ever isn't
+        qCWarning(recordingLog) << "Columnar clip storage is misaligned";
+        return false;
+    }
+
+    _compressed = (header.flags & FLAG_COMPRESSED) != 0;
+    _times = reinterpret_cast<const Frame::Time*>(data + layout.times);
+    _sizes = reinterpret_cast<const uint32_t*>(data + layout.sizes);
+    _offsets = reinterpret_cast<const uint32_t*>(data + layout.offsets);
+    _types = reinterpret_cast<const FrameType*>(data + layout.types);
+    _chunks = reinterpret_cast<const ChunkHeader*>(data + layout.chunks);
+    _chunkCount = header.chunkCount;
+
+    for (size_t i = 0; i < _chunkCount; ++i) {
+        const auto& chunk = _chunks[i];
+        if (chunk.fileOffset > size || chunk.storedSize > size - chunk.fileOffset || chunk.firstFrame > header.frameCount ||
+            (i > 0 && chunk.firstFrame < _chunks[i - 1].firstFrame)) {
+            return false;
+        }
+    }
+    if (header.frameCount > 0 && (_chunkCount == 0 || _chunks[0].firstFrame != 0)) {
+        return false;
+    }
+
+    // map the frame types the file was written with to the ones registered here, as the record based format does
+    QByteArray typeMapData = QByteArray::fromRawData(reinterpret_cast<const char*>(data + layout.typeMap), header.typeMapSize);
+    QJsonObject typeMap = QJsonDocument::fromBinaryData(typeMapData).object()[FRAME_TYPE_MAP].toObject();
+    auto currentFrameTypes = Frame::getFrameTypes();
+    for (const auto& frameTypeName : typeMap.keys()) {
+        if (!currentFrameTypes.contains(frameTypeName)) {
+            continue;
+        }
+        int storedType = typeMap[frameTypeName].toInt();
+        if (storedType < 0 || storedType >= Frame::TYPE_INVALID) {
+            continue;
+        }
+        if ((size_t)storedType >= _typeTranslation.size()) {
+            _typeTranslation.resize(storedType + 1, (FrameType)Frame::TYPE_INVALID);
+        }
+        _typeTranslation[storedType] = currentFrameTypes[frameTypeName];
+    }
+    if (_typeTranslation.empty()) {
+        qCWarning(recordingLog) << "Columnar clip has no frame types in common with this build";
+        return false;
+    }
+
+    _frameCount = header.frameCount;
+    return true;
+}
+
+void ColumnarClip::reset() {
+    _frameCount = 0;
+    _times = nullptr;
+    _types = nullptr;
+    _sizes = nullptr;
+    _offsets = nullptr;
+    _chunkCount = 0;
+    _chunks = nullptr;
+    _frameIndex = 0;
+    _chunkBacking.reset();
+    _chunkData = nullptr;
+}
+
+FrameType ColumnarClip::getFrameType(size_t index) const {
+    FrameType storedType = _types[index];
+    return storedType < _typeTranslation.size() ? _typeTranslation[storedType] : (FrameType)Frame::TYPE_INVALID;
+}
+
+// frames of types this build doesn't know are passed over, rather than dropped from the columns on load
+void ColumnarClip::skipUnknownFrames() const {
+    while (_frameIndex < _frameCount && getFrameType(_frameIndex) == Frame::TYPE_INVALID) {
+        ++_frameIndex;
+    }
+}
+
+bool ColumnarClip::loadChunk(size_t chunkIndex) const {
+    if (_chunkBacking && _chunkIndex == chunkIndex) {
+        return true;
+    }
+
+    const auto& chunk = _chunks[chunkIndex];
+    const uint8_t* stored = _storage->data() + chunk.fileOffset;
+    if (_compressed) {
+        auto raw = std::make_shared<QByteArray>(
+            qUncompress(QByteArray::fromRawData(reinterpret_cast<const char*>(stored), chunk.storedSize)));
+        if ((size_t)raw->size() != chunk.rawSize) {
+            qCWarning(recordingLog) << "Failed to decompress chunk" << chunkIndex << "of" << _name;
+            return false;
+        }
+        _chunkData = reinterpret_cast<const uint8_t*>(raw->constData());
+        _chunkBacking = raw;
+    } else {
+        if (chunk.rawSize != chunk.storedSize) {
+            return false;
+        }
+        _chunkData = stored;
+        _chunkBacking = _storage;
+    }
+    _chunkIndex = chunkIndex;
+    return true;
+}
+
+// Internal only function, needs no locking
+FrameConstPointer ColumnarClip::readFrame(size_t index) const {
+    if (index >= _frameCount) {
+        return FrameConstPointer();
+    }
+
+    // the chunk holding a frame is the last one starting at or before it
+    size_t chunkIndex = _chunkIndex;
+    if (!_chunkBacking || index < _chunks[chunkIndex].firstFrame ||
+        (chunkIndex + 1 < _chunkCount && index >= _chunks[chunkIndex + 1].firstFrame)) {
+        auto itr = std::upper_bound(_chunks, _chunks + _chunkCount, (uint32_t)index,
+            [](uint32_t frameIndex, const ChunkHeader& chunk)->bool {
+                return frameIndex < chunk.firstFrame;
+            }
+        );
+        chunkIndex = (itr - _chunks) - 1;
+    }
+    if (!loadChunk(chunkIndex)) {
+        return FrameConstPointer();
+    }
+
+    uint32_t offset = _offsets[index];
+    uint32_t size = _sizes[index];
+    if (offset > _chunks[chunkIndex].rawSize || size > _chunks[chunkIndex].rawSize - offset) {
+        qCWarning(recordingLog) << "Frame" << index << "of" << _name << "runs past its chunk";
+        return FrameConstPointer();
+    }
+
+    // nobody else holding the last frame means it can be reused
+    if (!_frame || _frame.use_count() > 1) {
+        _frame = std::make_shared<ViewFrame>();
+    }
+    _frame->type = getFrameType(index);
+    _frame->timeOffset = _times[index];
+    _frame->data = QByteArray::fromRawData(reinterpret_cast<const char*>(_chunkData + offset), size);
+    _frame->backing = _chunkBacking;
+    return _frame;
+}
+
+Clip::Pointer ColumnarClip::duplicate() const {
+    auto result = newClip();
+    Locker lock(_mutex);
+    for (size_t i = 0; i < _frameCount; ++i) {
+        if (getFrameType(i) == Frame::TYPE_INVALID) {
+            continue;
+        }
+        auto view = readFrame(i);
+        if (!view) {
+            continue;
+        }
+        // deep copy, the view's data doesn't outlive this clip
+        auto frame = std::make_shared<Frame>();
+        frame->type = view->type;
+        frame->timeOffset = view->timeOffset;
+        frame->data = QByteArray(view->data.constData(), view->data.size());
+        result->addFrame(frame);
+    }
+    return result;
+}
+
+float ColumnarClip::duration() const {
+    Locker lock(_mutex);
+    if (_frameCount == 0) {
+        return 0;
+    }
+    return Frame::frameTimeToSeconds(_times[_frameCount - 1]);
+}
+
+size_t ColumnarClip::frameCount() const {
+    Locker lock(_mutex);
+    return _frameCount;
+}
+
+void ColumnarClip::seekFrameTime(Frame::Time offset) {
+    Locker lock(_mutex);
+    _frameIndex = std::lower_bound(_times, _times + _frameCount, offset) - _times;
+    skipUnknownFrames();
+}
+
+Frame::Time ColumnarClip::positionFrameTime() const {
+    Locker lock(_mutex);
+    Frame::Time result = Frame::INVALID_TIME;
+    if (_frameIndex < _frameCount) {
+        result = _times[_frameIndex];
+    }
+    return result;
+}
+
+FrameConstPointer ColumnarClip::peekFrame() const {
+    Locker lock(_mutex);
+    return readFrame(_frameIndex);
+}
+
+FrameConstPointer ColumnarClip::nextFrame() {
+    Locker lock(_mutex);
+    FrameConstPointer result;
+    if (_frameIndex < _frameCount) {
+        result = readFrame(_frameIndex++);
+        skipUnknownFrames();
+    }
+    return result;
+}
+
+void ColumnarClip::skipFrame() {
+    Locker lock(_mutex);
+    if (_frameIndex < _frameCount) {
+        ++_frameIndex;
+        skipUnknownFrames();
+    }
+}
+
+void ColumnarClip::addFrame(FrameConstPointer) {
+    throw std::runtime_error("Columnar clips are read only, use duplicate to create a read/write clip");
+}
+
+bool ColumnarClip::write(QIODevice& output, const Clip::Pointer& clip, bool compressed) {
+    std::vector<Frame::Time> times;
+    std::vector<uint32_t> sizes;
+    std::vector<uint32_t> offsets;
+    std::vector<FrameType> types;
+    std::vector<ChunkHeader> chunks;
+    std::vector<QByteArray> chunkData;
+
+    QByteArray chunk;
+    uint32_t chunkFirstFrame = 0;
+    auto finishChunk = [&] {
+        if (times.size() == chunkFirstFrame) {
+            return;
+        }
+        ChunkHeader header;
+        header.fileOffset = 0;
+        header.rawSize = chunk.size();
+        header.firstFrame = chunkFirstFrame;
+        chunkData.push_back(compressed ? qCompress(chunk) : chunk);
+        header.storedSize = chunkData.back().size();
+        chunks.push_back(header);
+        chunk.clear();
+        chunkFirstFrame = (uint32_t)times.size();
+    };
+
+    clip->seek(0);
+    for (auto frame = clip->nextFrame(); frame; frame = clip->nextFrame()) {
+        if (frame->type == Frame::TYPE_INVALID || frame->type == Frame::TYPE_HEADER) {
+            continue;
+        }
+        if (!chunk.isEmpty() && (size_t)(chunk.size() + frame->data.size()) > CHUNK_SIZE) {
+            finishChunk();
+        }
+        times.push_back(frame->timeOffset);
+        types.push_back(frame->type);
+        sizes.push_back(frame->data.size());
+        offsets.push_back(chunk.size());
+        chunk.append(frame->data);
+    }
+    finishChunk();
+
+    if (times.empty()) {
+        return false;
+    }
+
+    auto frameTypes = Frame::getFrameTypes();
+    QJsonObject frameTypeObj;
+    for (const auto& frameTypeName : frameTypes.keys()) {
+        frameTypeObj[frameTypeName] = frameTypes[frameTypeName];
+    }
+    QJsonObject rootObject;
+    rootObject.insert(FRAME_TYPE_MAP, frameTypeObj);
+    QByteArray typeMapData = QJsonDocument(rootObject).toBinaryData();
+
+    FileHeader header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.flags = compressed ? FLAG_COMPRESSED : 0;
+    header.frameCount = (uint32_t)times.size();
+    header.chunkCount = (uint32_t)chunks.size();
+    header.typeMapSize = typeMapData.size();
+
+    Layout layout(header);
+    uint64_t chunkOffset = layout.end;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        chunks[i].fileOffset = chunkOffset;
+        chunkOffset += chunks[i].storedSize;
+    }
+
+    QByteArray tables(layout.end, 0);
+    char* tablesData = tables.data();
+    memcpy(tablesData, &header, sizeof(FileHeader));
+    memcpy(tablesData + layout.typeMap, typeMapData.constData(), typeMapData.size());
+    memcpy(tablesData + layout.times, times.data(), times.size() * sizeof(Frame::Time));
+    memcpy(tablesData + layout.sizes, sizes.data(), sizes.size() * sizeof(uint32_t));
+    memcpy(tablesData + layout.offsets, offsets.data(), offsets.size() * sizeof(uint32_t));
+    memcpy(tablesData + layout.types, types.data(), types.size() * sizeof(FrameType));
+    memcpy(tablesData + layout.chunks, chunks.data(), chunks.size() * sizeof(ChunkHeader));
+
+    if (output.write(tables) != tables.size()) {
+        return false;
+    }
+    for (const auto& data : chunkData) {
+        if (output.write(data) != data.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ColumnarClip::write(const QString& filePath, const Clip::Pointer& clip, bool compressed) {
+    if (0 == clip->frameCount()) {
+        return false;
+    }
+
+    QFile outputFile(filePath);
+    if (!outputFile.open(QFile::Truncate | QFile::WriteOnly)) {
+        return false;
+    }
+
+    Finally closer([&] { outputFile.close(); });
+    return write(outputFile, clip, compressed);
+}
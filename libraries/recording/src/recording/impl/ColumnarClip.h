@@ -0,0 +1,119 @@
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Impl_ColumnarClip_h
+#define hifi_Recording_Impl_ColumnarClip_h
+
+#include "../Clip.h"
+
+#include <vector>
+
+#include <shared/Storage.h>
+
+namespace recording {
+
+// A read only clip in the columnar format.  The frame times, types and data sizes are each stored as a column, so
+// seeking is a binary search of the times, and the frame data is packed into chunks that are compressed as a whole.
+//
+// Frames are views into the clip's storage (or into the chunk currently decompressed) rather than copies, and the
+// frame handed out last is reused once nothing else holds it, so playback doesn't allocate per frame.
+class ColumnarClip : public Clip {
+public:
+    using Pointer = std::shared_ptr<ColumnarClip>;
+
+    static const uint32_t VERSION = 1;
+    static const size_t CHUNK_SIZE = 64 * 1024;
+
+    static bool isColumnar(const uint8_t* data, size_t size);
+    static bool isColumnarFile(const QString& filePath);
+
+    // null if the data isn't a valid columnar clip
+    static Pointer fromFile(const QString& filePath);
+    static Pointer fromBuffer(const QByteArray& data, const QString& name);
+
+    static bool write(QIODevice& output, const Clip::Pointer& clip, bool compressed = true);
+    static bool write(const QString& filePath, const Clip::Pointer& clip, bool compressed = true);
+
+    ColumnarClip(const storage::StoragePointer& storage, const QString& name);
+
+    bool isValid() const { return _frameCount > 0; }
+
+    virtual QString getName() const override { return _name; }
+
+    virtual Clip::Pointer duplicate() const override;
+
+    virtual float duration() const override;
+    virtual size_t frameCount() const override;
+
+    virtual void seekFrameTime(Frame::Time offset) override;
+    virtual Frame::Time positionFrameTime() const override;
+
+    virtual FrameConstPointer peekFrame() const override;
+    virtual FrameConstPointer nextFrame() override;
+    virtual void skipFrame() override;
+    virtual void addFrame(FrameConstPointer) override;
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t flags;
+        uint32_t frameCount;
+        uint32_t chunkCount;
+        uint32_t typeMapSize;
+    };
+
+    struct ChunkHeader {
+        uint64_t fileOffset;
+        uint32_t storedSize;
+        uint32_t rawSize;
+        uint32_t firstFrame;
+        uint32_t padding { 0 };
+    };
+
+protected:
+    virtual void reset() override;
+
+private:
+    // a frame holding on to the bytes its data points into
+    struct ViewFrame : public Frame {
+        std::shared_ptr<const void> backing;
+    };
+
+    bool parse();
+    FrameType getFrameType(size_t index) const;
+    void skipUnknownFrames() const;
+    bool loadChunk(size_t chunkIndex) const;
+    FrameConstPointer readFrame(size_t index) const;
+
+    const storage::StoragePointer _storage;
+    const QString _name;
+
+    // columns, pointing into _storage
+    size_t _frameCount { 0 };
+    const Frame::Time* _times { nullptr };
+    const FrameType* _types { nullptr };
+    const uint32_t* _sizes { nullptr };
+    const uint32_t* _offsets { nullptr };
+    size_t _chunkCount { 0 };
+    const ChunkHeader* _chunks { nullptr };
+    bool _compressed { false };
+
+    // indexed by the frame type stored in the file
+    std::vector<FrameType> _typeTranslation;
+
+    mutable size_t _frameIndex { 0 };
+    mutable size_t _chunkIndex { 0 };
+    mutable std::shared_ptr<const void> _chunkBacking;
+    mutable const uint8_t* _chunkData { nullptr };
+    mutable std::shared_ptr<ViewFrame> _frame;
+};
+
+}
+
+#endif
@@ -50,6 +50,10 @@ extern "C" FILE * __cdecl __iob_func(void) {
 #include <cerrno>
 #endif
 
+#ifdef Q_OS_LINUX
+#include <sys/sysinfo.h>
+#endif
+
 #include <QtCore/QDebug>
 #include <QDateTime>
 #include <QElapsedTimer>
@@ -889,6 +893,38 @@ bool getMemoryInfo(MemoryInfo& info) {
     info.processPeakUsedMemoryBytes = pmc.PeakPagefileUsage;
 
     return true;
+#elif defined(Q_OS_LINUX)
+    struct sysinfo si;
+    if (sysinfo(&si) != 0) {
+        return false;
+    }
+
+    info.totalMemoryBytes = (uint64_t)si.totalram * si.mem_unit;
+    info.availMemoryBytes = (uint64_t)si.freeram * si.mem_unit;
+    info.usedMemoryBytes = info.totalMemoryBytes - info.availMemoryBytes;
+
+    // the resident set, which includes the pages of any mapped files we are touching
+    FILE* status = fopen("/proc/self/status", "r");
+    if (!status) {
+        return false;
+    }
+
+    bool foundRSS = false;
+    bool foundPeakRSS = false;
+    char line[256];
+    unsigned long long kilobytes;
+    while (fgets(line, sizeof(line), status)) {
+        if (sscanf(line, "VmRSS: %llu kB", &kilobytes) == 1) {
+            info.processUsedMemoryBytes = kilobytes * 1024;
+            foundRSS = true;
+        } else if (sscanf(line, "VmHWM: %llu kB", &kilobytes) == 1) {
+            info.processPeakUsedMemoryBytes = kilobytes * 1024;
+            foundPeakRSS = true;
+        }
+    }
+    fclose(status);
+
+    return foundRSS && foundPeakRSS;
 #endif
 
     return false;
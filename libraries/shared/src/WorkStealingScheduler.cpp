@@ -0,0 +1,256 @@
+//
+//  WorkStealingScheduler.cpp
+//  libraries/shared/src
+//
+//  Created by Roxanne Skelly on 2019-06-14.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "WorkStealingScheduler.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <thread>
+
+#include <QtCore/QThread>
+
+#if defined(Q_PROCESSOR_X86)
+#include <immintrin.h>
+#endif
+
+// each worker starts with this many chunks when the caller leaves the chunk size up to us
+static const int CHUNKS_PER_WORKER = 8;
+
+// how long an idle worker (or the scheduling thread) polls before yielding, and then before parking
+static const int NUM_SPINS_BEFORE_YIELD = 2000;
+static const int NUM_YIELDS_BEFORE_PARK = 16;
+
+static inline void spinPause() {
+#if defined(Q_PROCESSOR_X86)
+    _mm_pause();
+#endif
+}
+
+// a deque of chunk indices is the range [front, back), packed into one word so that the owner (popping the front)
+// and thieves (popping the back) agree on the last chunk with a single compare-and-swap
+static inline uint64_t packRange(uint32_t front, uint32_t back) {
+    return ((uint64_t)front << 32) | back;
+}
+
+static inline uint32_t rangeFront(uint64_t range) {
+    return (uint32_t)(range >> 32);
+}
+
+static inline uint32_t rangeBack(uint64_t range) {
+    return (uint32_t)range;
+}
+
+class WorkStealingScheduler::Worker : public QThread {
+public:
+    // a worker only picks up jobs published after it was created
+    Worker(WorkStealingScheduler& scheduler, int index) :
+        _scheduler(scheduler), _index(index), _generation(scheduler._generation.load()) {
+        setObjectName(QString("%1 Worker %2").arg(scheduler._name).arg(index));
+    }
+
+    void run() override final { _scheduler.work(_index, _generation); }
+
+    // keep each deque on its own cache line, thieves hammer them at the end of a job
+    alignas(64) std::atomic<uint64_t> chunks { 0 };
+
+private:
+    WorkStealingScheduler& _scheduler;
+    int _index;
+    uint32_t _generation;
+};
+
+WorkStealingScheduler::WorkStealingScheduler(const QString& name, int numThreads) : _name(name) {
+    setNumThreads(numThreads);
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+    stopWorkers();
+}
+
+void WorkStealingScheduler::setNumThreads(int numThreads) {
+    numThreads = std::max(0, numThreads);
+    if (numThreads == (int)_workers.size()) {
+        return;
+    }
+
+    stopWorkers();
+
+    _isStopping = false;
+    for (int i = 0; i < numThreads; ++i) {
+        _workers.emplace_back(new Worker(*this, i));
+    }
+    for (auto& worker : _workers) {
+        worker->start();
+    }
+}
+
+void WorkStealingScheduler::run(int numItems, const RangeFunction& function, int chunkSize) {
+    if (numItems <= 0) {
+        return;
+    }
+
+    int numWorkers = (int)_workers.size();
+    if (numWorkers == 0) {
+        // nothing to hand the range to, run it here as worker 0
+        function(0, 0, numItems);
+        return;
+    }
+
+    if (chunkSize <= 0) {
+        chunkSize = std::max(1, numItems / (numWorkers * CHUNKS_PER_WORKER));
+    }
+    int numChunks = (numItems + chunkSize - 1) / chunkSize;
+
+    _function = &function;
+    _numItems = numItems;
+    _chunkSize = chunkSize;
+
+    // deal out an even, contiguous share of the chunks to each worker
+    for (int i = 0; i < numWorkers; ++i) {
+        uint32_t front = (uint32_t)((int64_t)numChunks * i / numWorkers);
+        uint32_t back = (uint32_t)((int64_t)numChunks * (i + 1) / numWorkers);
+        _workers[i]->chunks.store(packRange(front, back), std::memory_order_relaxed);
+    }
+    _numBusy.store(numWorkers, std::memory_order_relaxed);
+
+    // publish the job - only take the lock if somebody has parked and needs waking
+    _generation.fetch_add(1);
+    if (_numParked.load() > 0) {
+        { std::lock_guard<std::mutex> lock(_mutex); }
+        _jobCondition.notify_all();
+    }
+
+    waitForWorkers();
+
+    _function = nullptr;
+}
+
+void WorkStealingScheduler::work(int workerIndex, uint32_t generation) {
+    while (true) {
+        waitForJob(generation);
+        if (_isStopping) {
+            return;
+        }
+
+        int chunk;
+        while (popFront(workerIndex, chunk) || steal(workerIndex, chunk)) {
+            runChunk(workerIndex, chunk);
+        }
+
+        // the last worker out wakes the scheduling thread if it gave up spinning
+        if (_numBusy.fetch_sub(1) == 1 && _isWaitingForWorkers.load()) {
+            { std::lock_guard<std::mutex> lock(_mutex); }
+            _doneCondition.notify_one();
+        }
+    }
+}
+
+bool WorkStealingScheduler::popFront(int workerIndex, int& chunk) {
+    auto& chunks = _workers[workerIndex]->chunks;
+    uint64_t range = chunks.load(std::memory_order_relaxed);
+    while (rangeFront(range) < rangeBack(range)) {
+        if (chunks.compare_exchange_weak(range, packRange(rangeFront(range) + 1, rangeBack(range)),
+                                         std::memory_order_relaxed)) {
+            chunk = (int)rangeFront(range);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingScheduler::steal(int thiefIndex, int& chunk) {
+    // deques only shrink during a job, so one empty pass over the victims means the job has run dry
+    int numWorkers = (int)_workers.size();
+    for (int i = 1; i < numWorkers; ++i) {
+        auto& chunks = _workers[(thiefIndex + i) % numWorkers]->chunks;
+        uint64_t range = chunks.load(std::memory_order_relaxed);
+        while (rangeFront(range) < rangeBack(range)) {
+            if (chunks.compare_exchange_weak(range, packRange(rangeFront(range), rangeBack(range) - 1),
+                                             std::memory_order_relaxed)) {
+                chunk = (int)rangeBack(range) - 1;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void WorkStealingScheduler::runChunk(int workerIndex, int chunk) {
+    int begin = chunk * _chunkSize;
+    int end = std::min(begin + _chunkSize, _numItems);
+    (*_function)(workerIndex, begin, end);
+}
+
+void WorkStealingScheduler::waitForJob(uint32_t& generation) {
+    // spin...
+    for (int i = 0; i < NUM_SPINS_BEFORE_YIELD; ++i) {
+        if (_generation.load(std::memory_order_acquire) != generation) {
+            generation = _generation.load();
+            return;
+        }
+        spinPause();
+    }
+
+    // ...then yield...
+    for (int i = 0; i < NUM_YIELDS_BEFORE_PARK; ++i) {
+        if (_generation.load(std::memory_order_acquire) != generation) {
+            generation = _generation.load();
+            return;
+        }
+        std::this_thread::yield();
+    }
+
+    // ...then park until the next job is published
+    std::unique_lock<std::mutex> lock(_mutex);
+    ++_numParked;
+    _jobCondition.wait(lock, [&] { return _generation.load() != generation; });
+    --_numParked;
+    generation = _generation.load();
+}
+
+void WorkStealingScheduler::waitForWorkers() {
+    for (int i = 0; i < NUM_SPINS_BEFORE_YIELD; ++i) {
+        if (_numBusy.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+        spinPause();
+    }
+
+    for (int i = 0; i < NUM_YIELDS_BEFORE_PARK; ++i) {
+        if (_numBusy.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _isWaitingForWorkers = true;
+    _doneCondition.wait(lock, [&] { return _numBusy.load() == 0; });
+    _isWaitingForWorkers = false;
+}
+
+void WorkStealingScheduler::stopWorkers() {
+    if (_workers.empty()) {
+        return;
+    }
+
+    _isStopping = true;
+    _generation.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+    }
+    _jobCondition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker->wait();
+    }
+    _workers.clear();
+}
@@ -0,0 +1,84 @@
+//
+//  WorkStealingScheduler.h
+//  libraries/shared/src
+//
+//  Created by Roxanne Skelly on 2019-06-14.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_WorkStealingScheduler_h
+#define hifi_WorkStealingScheduler_h
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QString>
+
+// Runs a range of work items across a fixed set of worker threads, returning once every item is done.
+//
+//   The range is cut into chunks and each worker starts with an even share of them in its own deque. A worker pops
+//   chunks from the front of its deque and, once that is empty, steals chunks from the back of the other deques,
+//   so a few expensive items no longer hold up a frame. Idle workers spin briefly before parking, which keeps the
+//   wake-up cost low when jobs are dispatched back to back (e.g. the packet and mix phases of a mixer frame).
+//
+//   Each worker has a stable index, so callers can keep per-worker state (stats, scratch buffers) without locking.
+//
+//   WorkStealingScheduler is not thread-safe! It should be instantiated and used from a single thread.
+class WorkStealingScheduler {
+public:
+    // called on a worker thread for each chunk of the range - [begin, end) are item indices
+    using RangeFunction = std::function<void(int workerIndex, int begin, int end)>;
+
+    WorkStealingScheduler(const QString& name, int numThreads = 0);
+    ~WorkStealingScheduler();
+
+    // stops and restarts the workers, must not be called while a job is running
+    void setNumThreads(int numThreads);
+    int getNumThreads() const { return (int)_workers.size(); }
+
+    // runs function over [0, numItems) and blocks until it has been called for every item
+    //   chunkSize <= 0 picks a chunk size that leaves each worker several chunks to trade
+    void run(int numItems, const RangeFunction& function, int chunkSize = 0);
+
+private:
+    class Worker;
+    friend class Worker;
+
+    void work(int workerIndex, uint32_t generation);
+    bool popFront(int workerIndex, int& chunk);
+    bool steal(int thiefIndex, int& chunk);
+    void runChunk(int workerIndex, int chunk);
+
+    void waitForJob(uint32_t& generation);
+    void waitForWorkers();
+    void stopWorkers();
+
+    QString _name;
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // job state, written by the scheduling thread before the generation is bumped
+    const RangeFunction* _function { nullptr };
+    int _numItems { 0 };
+    int _chunkSize { 1 };
+    bool _isStopping { false };
+
+    // synchronization state
+    std::atomic<uint32_t> _generation { 0 };
+    std::atomic<int> _numBusy { 0 };
+    std::atomic<int> _numParked { 0 };
+    std::atomic<bool> _isWaitingForWorkers { false };
+    std::mutex _mutex;
+    std::condition_variable _jobCondition;
+    std::condition_variable _doneCondition;
+};
+
+#endif // hifi_WorkStealingScheduler_h
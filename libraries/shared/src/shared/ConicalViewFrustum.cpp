@@ -149,3 +149,8 @@ void ConicalViewFrustum::setSimpleRadius(float radius) {
     _radius = radius;
     _farClip = radius / 2.0f;
 }
+
+void ConicalViewFrustum::setPositionAndSimpleRadius(const glm::vec3& position, float radius) {
+    _position = position;
+    setSimpleRadius(radius);
+}
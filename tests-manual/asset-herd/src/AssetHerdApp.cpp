@@ -0,0 +1,239 @@
+//
+//  AssetHerdApp.cpp
+//  tests-manual/asset-herd/src
+//
+//  Created by Roxanne Skelly on 2019-06-20.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetHerdApp.h"
+
+#include <algorithm>
+
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <AssetClient.h>
+#include <DependencyManager.h>
+#include <MappingRequest.h>
+#include <NetworkLogging.h>
+#include <NumericalConstants.h>
+#include <SharedLogging.h>
+#include <StatTracker.h>
+
+#define HIGH_FIDELITY_ASSET_HERD_USER_AGENT "Mozilla/5.0 (HighFidelityAssetHerd)"
+
+AssetHerdApp::AssetHerdApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Requests one asset N times concurrently over one connection to the asset server.\n"
+                                     "Asset server stats show how well the hot cache held up.");
+
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption herdSizeOption("n", "concurrent requests per wave, over one connection", "count", QString::number(_herdSize));
+    parser.addOption(herdSizeOption);
+
+    const QCommandLineOption wavesOption("w", "number of waves", "count", QString::number(_numWaves));
+    parser.addOption(wavesOption);
+
+    const QCommandLineOption intervalOption("i", "pause between waves", "msecs", QString::number(_waveIntervalMsecs));
+    parser.addOption(intervalOption);
+
+    const QCommandLineOption domainAddressOption("d", "domain-server address", "127.0.0.1");
+    parser.addOption(domainAddressOption);
+
+    const QCommandLineOption listenPortOption("listenPort", "listen port", QString::number(INVALID_PORT));
+    parser.addOption(listenPortOption);
+
+    parser.addPositionalArgument("url", "atp:/path/of/mapping or atp:<hash>");
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    // the herd is the noise, keep the wave reports readable
+    const_cast<QLoggingCategory*>(&networking())->setEnabled(QtDebugMsg, false);
+    const_cast<QLoggingCategory*>(&networking())->setEnabled(QtInfoMsg, false);
+    const_cast<QLoggingCategory*>(&shared())->setEnabled(QtDebugMsg, false);
+
+    QStringList posArgs = parser.positionalArguments();
+    if (posArgs.size() != 1) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    _url = QUrl(posArgs[0]);
+    if (_url.scheme() != "atp") {
+        qDebug() << "url should start with atp:";
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    _herdSize = std::max(1, parser.value(herdSizeOption).toInt());
+    _numWaves = std::max(1, parser.value(wavesOption).toInt());
+    _waveIntervalMsecs = std::max(0, parser.value(intervalOption).toInt());
+
+    if (parser.isSet(listenPortOption)) {
+        _listenPort = parser.value(listenPortOption).toInt();
+    }
+
+    _domainServerAddress = "127.0.0.1:40103";
+    if (parser.isSet(domainAddressOption)) {
+        _domainServerAddress = parser.value(domainAddressOption);
+    }
+
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+
+    DependencyManager::set<StatTracker>();
+    DependencyManager::set<AccountManager>([&]{ return QString(HIGH_FIDELITY_ASSET_HERD_USER_AGENT); });
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Agent, _listenPort);
+
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // setup a timer for domain-server check ins
+    _domainCheckInTimer = new QTimer(nodeList.data());
+    connect(_domainCheckInTimer, &QTimer::timeout, nodeList.data(), &NodeList::sendDomainServerCheckIn);
+    _domainCheckInTimer->start(DOMAIN_SERVER_CHECK_IN_MSECS);
+
+    // start the nodeThread so its event loop is running
+    // (must happen after the checkin timer is created with the nodelist as it's parent)
+    nodeList->startThread();
+
+    connect(nodeList.data(), &NodeList::nodeActivated, this, &AssetHerdApp::nodeActivated);
+    connect(nodeList.data(), &NodeList::packetVersionMismatch, this, &AssetHerdApp::notifyPacketVersionMismatch);
+    nodeList->addSetOfNodeTypesToNodeInterestSet(NodeSet() << NodeType::AssetServer);
+
+    // no local caching, every request has to reach the asset server
+    DependencyManager::set<AssetClient>();
+
+    DependencyManager::get<AddressManager>()->handleLookupString(_domainServerAddress, false);
+}
+
+AssetHerdApp::~AssetHerdApp() {
+    if (_domainCheckInTimer) {
+        QMetaObject::invokeMethod(_domainCheckInTimer, "deleteLater", Qt::QueuedConnection);
+    }
+}
+
+void AssetHerdApp::nodeActivated(SharedNodePointer node) {
+    if (_waitingForNode && node->getType() == NodeType::AssetServer) {
+        _waitingForNode = false;
+        lookupAsset();
+    }
+}
+
+void AssetHerdApp::notifyPacketVersionMismatch() {
+    qDebug() << "packet version mismatch";
+    finish(1);
+}
+
+void AssetHerdApp::lookupAsset() {
+    auto path = _url.path();
+
+    QRegExp hashRegex { AssetUtils::ASSET_HASH_REGEX_STRING };
+    if (hashRegex.exactMatch(path)) {
+        _hash = path;
+        startWave();
+        return;
+    }
+
+    auto request = DependencyManager::get<AssetClient>()->createGetMappingRequest(path);
+    connect(request, &GetMappingRequest::finished, this, [this](GetMappingRequest* request) {
+        if (request->getError() == GetMappingRequest::NoError) {
+            _hash = request->getHash();
+            startWave();
+        } else {
+            qDebug() << "Mapping lookup failed:" << request->getErrorString();
+            finish(1);
+        }
+        request->deleteLater();
+    });
+    request->start();
+}
+
+void AssetHerdApp::startWave() {
+    if (_wave == 0) {
+        qDebug() << "Requesting" << _hash << _herdSize << "times concurrently over one connection," << _numWaves << "waves";
+    }
+
+    _numPending = _herdSize;
+    _numFailed = 0;
+    _bytesReceived = 0;
+    _latenciesUsecs.clear();
+    _waveTimer.start();
+
+    for (int i = 0; i < _herdSize; ++i) {
+        auto request = new AssetRequest(_hash);
+        connect(request, &AssetRequest::finished, this, &AssetHerdApp::requestFinished);
+        request->start();
+    }
+}
+
+void AssetHerdApp::requestFinished(AssetRequest* request) {
+    _latenciesUsecs.push_back(_waveTimer.nsecsElapsed() / NSECS_PER_USEC);
+
+    if (request->getError() == AssetRequest::Error::NoError) {
+        _bytesReceived += request->getData().size();
+    } else {
+        ++_numFailed;
+    }
+    request->deleteLater();
+
+    if (--_numPending > 0) {
+        return;
+    }
+
+    reportWave();
+
+    if (++_wave < _numWaves) {
+        QTimer::singleShot(_waveIntervalMsecs, this, &AssetHerdApp::startWave);
+    } else {
+        finish(0);
+    }
+}
+
+void AssetHerdApp::reportWave() {
+    std::sort(_latenciesUsecs.begin(), _latenciesUsecs.end());
+    auto percentile = [&](float fraction) {
+        size_t index = std::min(_latenciesUsecs.size() - 1, (size_t)(fraction * _latenciesUsecs.size()));
+        return (float)_latenciesUsecs[index] / USECS_PER_MSEC;
+    };
+
+    float seconds = (float)_latenciesUsecs.back() / USECS_PER_SECOND;
+    float megabytesPerSecond = seconds > 0.0f ? (float)_bytesReceived / (1024.0f * 1024.0f) / seconds : 0.0f;
+
+    qDebug().nospace() << "wave " << (_wave + 1) << ": " << (_herdSize - _numFailed) << "/" << _herdSize << " ok, "
+        << "first " << percentile(0.0f) << "ms, p50 " << percentile(0.5f) << "ms, p95 " << percentile(0.95f) << "ms, "
+        << "last " << percentile(1.0f) << "ms, " << megabytesPerSecond << " MB/s";
+}
+
+void AssetHerdApp::finish(int exitCode) {
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // send the domain a disconnect packet, force stoppage of domain-server check-ins
+    nodeList->getDomainHandler().disconnect();
+    nodeList->setIsShuttingDown(true);
+
+    // tell the packet receiver we're shutting down, so it can drop packets
+    nodeList->getPacketReceiver().setShouldDropPackets(true);
+
+    // remove the NodeList from the DependencyManager
+    DependencyManager::destroy<NodeList>();
+
+    QCoreApplication::exit(exitCode);
+}
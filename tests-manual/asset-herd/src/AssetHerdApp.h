@@ -0,0 +1,65 @@
+//
+//  AssetHerdApp.h
+//  tests-manual/asset-herd/src
+//
+//  Created by Roxanne Skelly on 2019-06-20.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetHerdApp_h
+#define hifi_AssetHerdApp_h
+
+#include <vector>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QUrl>
+
+#include <AssetRequest.h>
+#include <NodeList.h>
+
+// Fires N concurrent requests for the same asset at an asset server and reports how long they took to be served.
+// They all share this one client's connection, so this exercises the server's per-asset caching and the send queue's
+// channels rather than N independent clients arriving at once - run several instances for that.
+class AssetHerdApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    AssetHerdApp(int argc, char* argv[]);
+    ~AssetHerdApp();
+
+private slots:
+    void nodeActivated(SharedNodePointer node);
+    void notifyPacketVersionMismatch();
+
+private:
+    void lookupAsset();
+    void startWave();
+    void requestFinished(AssetRequest* request);
+    void reportWave();
+    void finish(int exitCode);
+
+    QUrl _url;
+    QString _domainServerAddress;
+    int _listenPort { INVALID_PORT };
+
+    int _herdSize { 200 };
+    int _numWaves { 5 };
+    int _waveIntervalMsecs { 1000 };
+
+    AssetUtils::AssetHash _hash;
+    int _wave { 0 };
+    int _numPending { 0 };
+    int _numFailed { 0 };
+    qint64 _bytesReceived { 0 };
+    std::vector<qint64> _latenciesUsecs;
+    QElapsedTimer _waveTimer;
+
+    bool _waitingForNode { true };
+    QTimer* _domainCheckInTimer { nullptr };
+};
+
+#endif // hifi_AssetHerdApp_h
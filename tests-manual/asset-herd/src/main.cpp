@@ -0,0 +1,24 @@
+//
+//  main.cpp
+//  tests-manual/asset-herd/src
+//
+//  Created by Roxanne Skelly on 2019-06-20.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <BuildInfo.h>
+#include <SettingHandle.h>
+
+#include "AssetHerdApp.h"
+
+int main(int argc, char* argv[]) {
+    setupHifiApplication("Asset Herd Test");
+
+    Setting::init();
+
+    AssetHerdApp app(argc, argv);
+    return app.exec();
+}
@@ -0,0 +1,327 @@
+//
+//  DomainListSoakApp.cpp
+//  tests-manual/domain-list-soak/src
+//
+//  Created by Roxanne Skelly on 2019-06-23.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DomainListSoakApp.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QCommandLineParser>
+#include <QDataStream>
+#include <QLoggingCategory>
+
+#include <DomainHandler.h>
+#include <LimitedNodeList.h>
+#include <NetworkLogging.h>
+#include <NodeList.h>
+#include <NodePermissions.h>
+#include <NumericalConstants.h>
+#include <SharedLogging.h>
+
+// what interface asks to hear about
+static const QList<NodeType_t> AGENT_INTEREST_LIST {
+    NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::EntityServer, NodeType::AssetServer,
+    NodeType::MessagesMixer, NodeType::EntityScriptServer
+};
+
+DomainListSoakApp::DomainListSoakApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Keeps a crowd of simulated agents checking in with a domain-server.\n"
+                                     "Run it against a local domain-server with its assignment clients up.");
+
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption agentsOption("n", "simulated agents", "count", QString::number(_numAgents));
+    parser.addOption(agentsOption);
+
+    const QCommandLineOption churnOption("c", "agents that leave and come back each second", "count",
+                                         QString::number(_churnPerSecond));
+    parser.addOption(churnOption);
+
+    const QCommandLineOption durationOption("t", "length of the run", "seconds", QString::number(_durationSecs));
+    parser.addOption(durationOption);
+
+    const QCommandLineOption domainAddressOption("d", "domain-server address", "127.0.0.1");
+    parser.addOption(domainAddressOption);
+
+    const QCommandLineOption domainPortOption("p", "domain-server port", "port",
+                                              QString::number(DEFAULT_DOMAIN_SERVER_PORT));
+    parser.addOption(domainPortOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    // the crowd is the noise, keep the reports readable
+    const_cast<QLoggingCategory*>(&networking())->setEnabled(QtDebugMsg, false);
+    const_cast<QLoggingCategory*>(&networking())->setEnabled(QtInfoMsg, false);
+    const_cast<QLoggingCategory*>(&shared())->setEnabled(QtDebugMsg, false);
+
+    _numAgents = std::max(1, parser.value(agentsOption).toInt());
+    _churnPerSecond = std::max(0, std::min(_numAgents, parser.value(churnOption).toInt()));
+    _durationSecs = std::max(1, parser.value(durationOption).toInt());
+
+    QString domainAddress = "127.0.0.1";
+    if (parser.isSet(domainAddressOption)) {
+        domainAddress = parser.value(domainAddressOption);
+    }
+    _domainServerSockAddr = HifiSockAddr(domainAddress, parser.value(domainPortOption).toUShort());
+
+    qDebug() << "Connecting" << _numAgents << "agents to" << _domainServerSockAddr << "for" << _durationSecs
+        << "seconds," << _churnPerSecond << "leaving and coming back each second";
+
+    for (int i = 0; i < _numAgents; ++i) {
+        auto agent = std::unique_ptr<Agent>(new Agent());
+        agent->machineFingerprint = QUuid::createUuid();
+        agent->socket.reset(new udt::Socket());
+        agent->socket->bind(QHostAddress::AnyIPv4, 0);
+
+        Agent* agentPointer = agent.get();
+        agent->socket->setPacketHandler([this, agentPointer](std::unique_ptr<udt::Packet> packet) {
+            processPacket(*agentPointer, std::move(packet));
+        });
+
+        _agents.push_back(std::move(agent));
+    }
+
+    connect(&_checkInTimer, &QTimer::timeout, this, &DomainListSoakApp::checkIn);
+    _checkInTimer.start(DOMAIN_SERVER_CHECK_IN_MSECS);
+
+    connect(&_reportTimer, &QTimer::timeout, this, &DomainListSoakApp::report);
+    _reportTimer.start(MSECS_PER_SECOND);
+
+    _runTimer.start();
+    checkIn();
+}
+
+void DomainListSoakApp::checkIn() {
+    // the agents that leave this time come back on their next check-in, as new sessions
+    if (_runTimer.elapsed() > MSECS_PER_SECOND) {
+        for (int i = 0; i < _churnPerSecond; ++i) {
+            Agent& agent = *_agents[_nextChurn];
+            _nextChurn = (_nextChurn + 1) % _numAgents;
+
+            if (agent.isConnected) {
+                sendDisconnect(agent);
+            }
+        }
+    }
+
+    for (auto& agent : _agents) {
+        if (agent->isConnected) {
+            sendListRequest(*agent);
+        } else {
+            sendConnectRequest(*agent);
+        }
+    }
+}
+
+void DomainListSoakApp::sendConnectRequest(Agent& agent) {
+    auto packet = NLPacket::create(PacketType::DomainConnectRequest);
+    QDataStream packetStream(packet.get());
+
+    HifiSockAddr localSockAddr("127.0.0.1", agent.socket->localPort());
+
+    packetStream << QUuid();
+
+    QByteArray protocolVersionSig = protocolVersionsSignature();
+    packetStream.writeBytes(protocolVersionSig.constData(), protocolVersionSig.size());
+
+    packetStream << QString() << agent.machineFingerprint;
+    packetStream << (NodeType_t)NodeType::Agent << localSockAddr << localSockAddr << AGENT_INTEREST_LIST;
+    packetStream << QString() << QString();
+
+    sendPacket(agent, std::move(packet));
+}
+
+void DomainListSoakApp::sendListRequest(Agent& agent) {
+    auto packet = NLPacket::create(PacketType::DomainListRequest);
+    QDataStream packetStream(packet.get());
+
+    HifiSockAddr localSockAddr("127.0.0.1", agent.socket->localPort());
+
+    packetStream << (NodeType_t)NodeType::Agent << localSockAddr << localSockAddr << AGENT_INTEREST_LIST;
+    packetStream << QString();
+    packetStream << agent.domainListVersion;
+
+    sendPacket(agent, std::move(packet));
+}
+
+void DomainListSoakApp::sendDisconnect(Agent& agent) {
+    sendPacket(agent, NLPacket::create(PacketType::DomainDisconnectRequest, 0));
+
+    agent.sessionLocalID = Node::NULL_LOCAL_ID;
+    agent.isConnected = false;
+    agent.domainListVersion = 0;
+    agent.pendingDomainList = std::make_tuple(0, false, 0);
+    agent.pendingDomainListEntries.clear();
+    agent.nodes.clear();
+}
+
+void DomainListSoakApp::sendPacket(Agent& agent, std::unique_ptr<NLPacket> packet) {
+    if (!PacketTypeEnum::getNonSourcedPackets().contains(packet->getType())) {
+        packet->writeSourceID(agent.sessionLocalID);
+    }
+    agent.socket->writePacket(*packet, _domainServerSockAddr);
+}
+
+void DomainListSoakApp::processPacket(Agent& agent, std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+    switch (nlPacket->getType()) {
+        case PacketType::DomainList:
+            if (nlPacket->getVersion() != versionForPacketType(PacketType::DomainList)) {
+                qDebug() << "DomainList version mismatch, the domain-server is not running this build";
+                finish(1);
+                return;
+            }
+            processDomainList(agent, *nlPacket);
+            break;
+
+        case PacketType::DomainConnectionDenied:
+            ++_connectsDenied;
+            break;
+
+        default:
+            break;
+    }
+}
+
+void DomainListSoakApp::processDomainList(Agent& agent, NLPacket& packet) {
+    ++_listPackets;
+    _listBytes += packet.getWireSize();
+    _totalListBytes += packet.getWireSize();
+
+    QDataStream packetStream(QByteArray::fromRawData(packet.getPayload(), packet.getPayloadSize()));
+
+    QUuid domainUUID;
+    Node::LocalID domainLocalID;
+    QUuid sessionUUID;
+    Node::LocalID sessionLocalID;
+    NodePermissions permissions;
+    bool isAuthenticated;
+    quint8 authMethod;
+    packetStream >> domainUUID >> domainLocalID >> sessionUUID >> sessionLocalID >> permissions
+        >> isAuthenticated >> authMethod;
+
+    quint32 domainListVersion;
+    bool isDelta;
+    quint32 baseVersion;
+    quint32 numEntries;
+    packetStream >> domainListVersion >> isDelta >> baseVersion >> numEntries;
+
+    agent.sessionLocalID = sessionLocalID;
+    agent.isConnected = true;
+
+    if (isDelta) {
+        ++_deltaListPackets;
+    } else {
+        ++_fullListPackets;
+    }
+
+    if (isDelta && domainListVersion < agent.domainListVersion) {
+        return;
+    }
+
+    auto pendingDomainList = std::make_tuple(domainListVersion, isDelta, baseVersion);
+    if (pendingDomainList != agent.pendingDomainList) {
+        agent.pendingDomainList = pendingDomainList;
+        agent.pendingDomainListEntries.clear();
+    }
+
+    while (!packetStream.atEnd()) {
+        quint8 entry;
+        packetStream >> entry;
+
+        QUuid nodeUUID;
+        if ((DomainListEntry)entry == DomainListEntry::Removed) {
+            packetStream >> nodeUUID;
+            agent.nodes.remove(nodeUUID);
+        } else {
+            NodeType_t type;
+            HifiSockAddr publicSocket;
+            HifiSockAddr localSocket;
+            NodePermissions nodePermissions;
+            bool isReplicated;
+            Node::LocalID localID;
+            QUuid connectionSecret;
+            packetStream >> type >> nodeUUID >> publicSocket >> localSocket >> nodePermissions >> isReplicated
+                >> localID >> connectionSecret;
+            agent.nodes.insert(nodeUUID);
+        }
+
+        agent.pendingDomainListEntries.insert(nodeUUID);
+        ++_listEntries;
+    }
+
+    bool hasBase = !isDelta || (agent.domainListVersion != 0 && baseVersion <= agent.domainListVersion);
+    if (hasBase && (quint32)agent.pendingDomainListEntries.size() >= numEntries) {
+        agent.domainListVersion = domainListVersion;
+    }
+}
+
+void DomainListSoakApp::report() {
+    int numConnected = 0;
+    int minNodes = std::numeric_limits<int>::max();
+    int maxNodes = 0;
+    for (auto& agent : _agents) {
+        if (agent->isConnected) {
+            ++numConnected;
+            minNodes = std::min(minNodes, agent->nodes.size());
+            maxNodes = std::max(maxNodes, agent->nodes.size());
+        }
+    }
+    if (numConnected == 0) {
+        minNodes = 0;
+    }
+
+    // every agent should end up with the same nodes, whatever mix of full lists and deltas got them there
+    qDebug().nospace() << (_runTimer.elapsed() / MSECS_PER_SECOND) << "s: " << numConnected << "/" << _numAgents
+        << " connected, " << _listPackets << " list packets (" << _fullListPackets << " full, " << _deltaListPackets
+        << " delta), " << _listEntries << " entries, " << (_listBytes / 1024) << " KB, "
+        << "nodes per agent " << minNodes << "-" << maxNodes
+        << (_connectsDenied > 0 ? QString(", %1 connects denied").arg(_connectsDenied) : QString());
+
+    _listPackets = 0;
+    _listBytes = 0;
+    _fullListPackets = 0;
+    _deltaListPackets = 0;
+    _listEntries = 0;
+    _connectsDenied = 0;
+
+    if (_runTimer.elapsed() >= _durationSecs * MSECS_PER_SECOND) {
+        qDebug().nospace() << "done, " << (_totalListBytes / 1024) << " KB of domain lists, "
+            << (_totalListBytes / _durationSecs / _numAgents) << " bytes per agent per second";
+        finish(0);
+    }
+}
+
+void DomainListSoakApp::finish(int exitCode) {
+    _checkInTimer.stop();
+    _reportTimer.stop();
+
+    for (auto& agent : _agents) {
+        if (agent->isConnected) {
+            sendDisconnect(*agent);
+        }
+    }
+
+    QCoreApplication::exit(exitCode);
+}
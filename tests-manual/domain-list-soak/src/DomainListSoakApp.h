@@ -0,0 +1,86 @@
+//
+//  DomainListSoakApp.h
+//  tests-manual/domain-list-soak/src
+//
+//  Created by Roxanne Skelly on 2019-06-23.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DomainListSoakApp_h
+#define hifi_DomainListSoakApp_h
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QTimer>
+
+#include <HifiSockAddr.h>
+#include <NLPacket.h>
+#include <Node.h>
+#include <udt/Socket.h>
+
+// Connects a crowd of simulated agents to a domain-server, each on its own socket, and has them check in the way
+// interface does, with some of them leaving and coming back every second. Reports what the domain lists cost.
+class DomainListSoakApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    DomainListSoakApp(int argc, char* argv[]);
+
+private slots:
+    void checkIn();
+    void report();
+
+private:
+    struct Agent {
+        std::unique_ptr<udt::Socket> socket;
+        QUuid machineFingerprint;
+        Node::LocalID sessionLocalID { Node::NULL_LOCAL_ID };
+        bool isConnected { false };
+
+        // tracked the same way NodeList does
+        quint32 domainListVersion { 0 };
+        std::tuple<quint32, bool, quint32> pendingDomainList;
+        QSet<QUuid> pendingDomainListEntries;
+        QSet<QUuid> nodes;
+    };
+
+    void sendConnectRequest(Agent& agent);
+    void sendListRequest(Agent& agent);
+    void sendDisconnect(Agent& agent);
+    void sendPacket(Agent& agent, std::unique_ptr<NLPacket> packet);
+    void processPacket(Agent& agent, std::unique_ptr<udt::Packet> packet);
+    void processDomainList(Agent& agent, NLPacket& packet);
+    void finish(int exitCode);
+
+    HifiSockAddr _domainServerSockAddr;
+    int _numAgents { 300 };
+    int _churnPerSecond { 5 };
+    int _durationSecs { 60 };
+
+    std::vector<std::unique_ptr<Agent>> _agents;
+    int _nextChurn { 0 };
+
+    QTimer _checkInTimer;
+    QTimer _reportTimer;
+    QElapsedTimer _runTimer;
+
+    // since the last report
+    quint64 _listPackets { 0 };
+    quint64 _listBytes { 0 };
+    quint64 _fullListPackets { 0 };
+    quint64 _deltaListPackets { 0 };
+    quint64 _listEntries { 0 };
+    quint64 _connectsDenied { 0 };
+
+    // over the whole run
+    quint64 _totalListBytes { 0 };
+};
+
+#endif // hifi_DomainListSoakApp_h
@@ -0,0 +1,21 @@
+//
+//  main.cpp
+//  tests-manual/domain-list-soak/src
+//
+//  Created by Roxanne Skelly on 2019-06-23.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <BuildInfo.h>
+
+#include "DomainListSoakApp.h"
+
+int main(int argc, char* argv[]) {
+    setupHifiApplication("Domain List Soak Test");
+
+    DomainListSoakApp app(argc, argv);
+    return app.exec();
+}
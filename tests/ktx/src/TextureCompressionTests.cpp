@@ -0,0 +1,148 @@
+//
+//  TextureCompressionTests.cpp
+//  tests/ktx/src
+//
+//  Created by Roxanne Skelly on 2019-06-24.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureCompressionTests.h"
+
+#include <mutex>
+
+#include <QtCore/QElapsedTimer>
+#include <QtGui/QImage>
+
+#include <ktx/KTX.h>
+#include <gpu/Texture.h>
+#include <image/Image.h>
+#include <NumericalConstants.h>
+
+QTEST_GUILESS_MAIN(TextureCompressionTests)
+
+static QString getRootPath() {
+    static std::once_flag once;
+    static QString result;
+    std::call_once(once, [&] {
+        QFileInfo file(__FILE__);
+        QDir parent = file.absolutePath();
+        result = QDir::cleanPath(parent.currentPath() + "/../../..");
+    });
+    return result;
+}
+
+struct Sample {
+    QString name;
+    QImage image;
+    image::TextureUsage::TextureLoader loader;
+};
+
+// noise is the worst case for the block compressors, the gradient gives the alpha formats something to keep
+static QImage makeNoiseImage(int width, int height, bool withAlpha) {
+    QImage image(width, height, QImage::Format_ARGB32);
+    uint32_t seed = 12345;
+    for (int y = 0; y < height; ++y) {
+        QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            seed = seed * 1664525 + 1013904223;
+            int alpha = withAlpha ? (x * 255 / width) : 255;
+            line[x] = qRgba((seed >> 8) & 0xFF, (seed >> 16) & 0xFF, (seed >> 24) & 0xFF, alpha);
+        }
+    }
+    return image;
+}
+
+static std::vector<Sample> getSamples() {
+    using namespace image::TextureUsage;
+
+    std::vector<Sample> samples;
+
+    QImage cubeTexture(getRootPath() + "/scripts/developer/tests/cube_texture.png");
+    if (!cubeTexture.isNull()) {
+        samples.push_back({ "cube_texture.png (albedo)", cubeTexture, createAlbedoTextureFromImage });
+    }
+
+    samples.push_back({ "noise 2048 (albedo)", makeNoiseImage(2048, 2048, false), createAlbedoTextureFromImage });
+    samples.push_back({ "noise 2048 alpha (albedo)", makeNoiseImage(2048, 2048, true), createAlbedoTextureFromImage });
+    samples.push_back({ "noise 2048 (normal)", makeNoiseImage(2048, 2048, false), createNormalTextureFromNormalImage });
+
+    // a horizontal cross, each face compresses on its own
+    samples.push_back({ "noise 2048x1536 (cube)", makeNoiseImage(2048, 1536, false),
+                        createCubeTextureFromImageWithoutIrradiance });
+
+    return samples;
+}
+
+static gpu::TexturePointer compress(const Sample& sample) {
+    std::atomic<bool> abortProcessing { false };
+    QImage image = sample.image;
+    return sample.loader(std::move(image), sample.name.toStdString(), true, gpu::BackendTarget::GL45, abortProcessing);
+}
+
+static QByteArray serialize(const gpu::TexturePointer& texture) {
+    auto ktx = gpu::Texture::serialize(*texture);
+    if (!ktx) {
+        return QByteArray();
+    }
+    const auto& storage = ktx->getStorage();
+    return QByteArray(reinterpret_cast<const char*>(storage->data()), (int)storage->size());
+}
+
+void TextureCompressionTests::initTestCase() {
+}
+
+void TextureCompressionTests::cleanupTestCase() {
+    image::setMaxCompressionThreads(0);
+}
+
+void TextureCompressionTests::testDeterministic() {
+    const Sample sample { "noise 512 alpha", makeNoiseImage(512, 512, true),
+                          image::TextureUsage::createAlbedoTextureFromImage };
+    const Sample cubeSample { "noise 512x384 cube", makeNoiseImage(512, 384, false),
+                              image::TextureUsage::createCubeTextureFromImageWithoutIrradiance };
+
+    for (auto& testSample : { sample, cubeSample }) {
+        image::setMaxCompressionThreads(1);
+        auto sequential = compress(testSample);
+        QVERIFY(sequential);
+        QByteArray sequentialBytes = serialize(sequential);
+        QVERIFY(!sequentialBytes.isEmpty());
+
+        image::setMaxCompressionThreads(0);
+        auto parallel = compress(testSample);
+        QVERIFY(parallel);
+        QCOMPARE(serialize(parallel), sequentialBytes);
+    }
+}
+
+void TextureCompressionTests::benchmark() {
+    auto samples = getSamples();
+
+    for (int maxThreads : { 1, 0 }) {
+        image::setMaxCompressionThreads(maxThreads);
+
+        double totalMegapixels = 0.0;
+        double totalSeconds = 0.0;
+
+        for (auto& sample : samples) {
+            QElapsedTimer timer;
+            timer.start();
+            auto texture = compress(sample);
+            double seconds = (double)timer.nsecsElapsed() / NSECS_PER_SECOND;
+            QVERIFY(texture);
+
+            double megapixels = (double)sample.image.width() * sample.image.height() / 1.0e6;
+            totalMegapixels += megapixels;
+            totalSeconds += seconds;
+
+            qDebug().nospace() << "threads " << image::getMaxCompressionThreads() << ": " << sample.name << " "
+                << (seconds * MSECS_PER_SECOND) << "ms, " << (megapixels / seconds) << " MP/s";
+        }
+
+        qDebug().nospace() << "threads " << image::getMaxCompressionThreads() << ": all samples "
+            << (totalMegapixels / totalSeconds) << " MP/s";
+    }
+}
@@ -0,0 +1,31 @@
+//
+//  TextureCompressionTests.h
+//  tests/ktx/src
+//
+//  Created by Roxanne Skelly on 2019-06-24.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureCompressionTests_h
+#define hifi_TextureCompressionTests_h
+
+#include <QtTest/QtTest>
+
+class TextureCompressionTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // Test that a texture compresses to the same bytes on any number of threads
+    void testDeterministic();
+
+    // Report megapixels per second compressing the sample images on 1 thread and on one per core
+    void benchmark();
+};
+
+#endif // hifi_TextureCompressionTests_h
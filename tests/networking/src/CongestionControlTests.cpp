@@ -0,0 +1,218 @@
+//
+//  CongestionControlTests.cpp
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CongestionControlTests.h"
+
+#include <map>
+
+#include <udt/BBRCC.h>
+#include <udt/NetworkImpairment.h>
+
+QTEST_MAIN(CongestionControlTests)
+
+using namespace udt;
+using namespace std::chrono;
+
+// exposes what BBRCC hands the send queue
+class TestBBRCC : public BBRCC {
+public:
+    TestBBRCC(SequenceNumber initialSequenceNumber) {
+        setInitialSendSequenceNumber(initialSequenceNumber);
+        setSendCurrentSequenceNumber(initialSequenceNumber);
+    }
+
+    void setCurrentSequenceNumber(SequenceNumber seqNum) { setSendCurrentSequenceNumber(seqNum); }
+    double getPacketSendPeriod() const { return _packetSendPeriod; }
+    int getCongestionWindowSize() const { return _congestionWindowSize; }
+};
+
+// a bottleneck link with a fixed propagation delay and no loss, stepped in simulated time
+class SimulatedLink {
+public:
+    static const int PACKET_SIZE = 1400;
+    static const int STEP_USECS = 10;
+
+    SimulatedLink(double bytesPerUsec, int rttUsecs) : _bytesPerUsec(bytesPerUsec), _rttUsecs(rttUsecs) {}
+
+    void run(TestBBRCC& cc, int64_t untilUsecs, std::function<void(int64_t)> onStep = nullptr) {
+        for (; _now < untilUsecs; _now += STEP_USECS) {
+            auto timePoint = _start + microseconds(_now);
+
+            while (!_acks.empty() && _acks.begin()->first <= _now) {
+                auto ack = _acks.begin()->second;
+                _acks.erase(_acks.begin());
+
+                cc.setCurrentSequenceNumber(_sequenceNumber);
+                cc.onACK(ack, timePoint);
+                _lastACK = ack;
+            }
+
+            // send what the window and the pacing allow
+            while (seqlen(_lastACK, _sequenceNumber) - 1 < cc.getCongestionWindowSize() && _now >= _nextSendUsecs) {
+                ++_sequenceNumber;
+                cc.onPacketSent(PACKET_SIZE, _sequenceNumber, timePoint);
+
+                _linkFreeUsecs = std::max((double)_now, _linkFreeUsecs) + PACKET_SIZE / _bytesPerUsec;
+                _acks.emplace((int64_t)_linkFreeUsecs + _rttUsecs, _sequenceNumber);
+
+                _nextSendUsecs = std::max(_nextSendUsecs + cc.getPacketSendPeriod(), (double)_now - STEP_USECS);
+            }
+
+            if (onStep) {
+                onStep(_now);
+            }
+        }
+    }
+
+private:
+    double _bytesPerUsec;
+    int _rttUsecs;
+
+    p_high_resolution_clock::time_point _start { p_high_resolution_clock::now() };
+    int64_t _now { 0 };
+    double _linkFreeUsecs { 0.0 };
+    double _nextSendUsecs { 0.0 };
+
+    SequenceNumber _sequenceNumber;
+    SequenceNumber _lastACK;
+    std::multimap<int64_t, SequenceNumber> _acks; // by arrival time
+};
+
+const double LINK_BYTES_PER_USEC = 12.5; // 100 Mb/s
+const int LINK_RTT_USECS = 20000;
+
+void CongestionControlTests::bbrConvergenceTest() {
+    TestBBRCC cc { SequenceNumber() };
+    SimulatedLink link { LINK_BYTES_PER_USEC, LINK_RTT_USECS };
+
+    link.run(cc, duration_cast<microseconds>(seconds(2)).count());
+
+    QVERIFY(std::abs(cc.getBottleneckBandwidth() - LINK_BYTES_PER_USEC) < LINK_BYTES_PER_USEC * 0.1);
+    QVERIFY(cc.getMinRTT() >= LINK_RTT_USECS && cc.getMinRTT() < LINK_RTT_USECS * 1.1);
+
+    // two bandwidth delay products, in packets
+    int expectedWindowSize = (int)(2 * LINK_BYTES_PER_USEC * LINK_RTT_USECS / SimulatedLink::PACKET_SIZE);
+    QVERIFY(std::abs(cc.getCongestionWindowSize() - expectedWindowSize) < expectedWindowSize * 0.1);
+
+    // pacing at somewhere in the probe bandwidth gain cycle
+    double pacedBytesPerUsec = SimulatedLink::PACKET_SIZE / cc.getPacketSendPeriod();
+    QVERIFY(pacedBytesPerUsec > LINK_BYTES_PER_USEC * 0.7 && pacedBytesPerUsec < LINK_BYTES_PER_USEC * 1.3);
+}
+
+void CongestionControlTests::bbrProbeRTTTest() {
+    TestBBRCC cc { SequenceNumber() };
+    SimulatedLink link { LINK_BYTES_PER_USEC, LINK_RTT_USECS };
+
+    link.run(cc, duration_cast<microseconds>(seconds(2)).count());
+    int windowSize = cc.getCongestionWindowSize();
+
+    // the min RTT expires after 10 seconds
+    bool probedRTT = false;
+    int maxProbingWindowSize = 0;
+    link.run(cc, duration_cast<microseconds>(seconds(12)).count(), [&](int64_t) {
+        if (cc.isProbingRTT()) {
+            probedRTT = true;
+            maxProbingWindowSize = std::max(maxProbingWindowSize, cc.getCongestionWindowSize());
+        }
+    });
+
+    QVERIFY(probedRTT);
+    QVERIFY(maxProbingWindowSize <= 4);
+    QVERIFY(!cc.isProbingRTT());
+    QCOMPARE(cc.getCongestionWindowSize(), windowSize);
+    QVERIFY(std::abs(cc.getBottleneckBandwidth() - LINK_BYTES_PER_USEC) < LINK_BYTES_PER_USEC * 0.1);
+}
+
+// collects what an impairment writes out
+struct ImpairedWrites {
+    std::mutex mutex;
+    std::vector<std::pair<QByteArray, p_high_resolution_clock::time_point>> writes;
+
+    ImpairedWriteFunction function() {
+        return [this](const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+            std::lock_guard<std::mutex> lock(mutex);
+            writes.emplace_back(datagram, p_high_resolution_clock::now());
+        };
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return writes.size();
+    }
+};
+
+static void waitForWrites(ImpairedWrites& writes, size_t numWrites) {
+    auto timeout = p_high_resolution_clock::now() + seconds(5);
+    while (writes.size() < numWrites && p_high_resolution_clock::now() < timeout) {
+        QThread::msleep(1);
+    }
+}
+
+void CongestionControlTests::impairmentLossTest() {
+    const int NUM_DATAGRAMS = 2000;
+    const HifiSockAddr sockAddr { QHostAddress::LocalHost, 1234 };
+
+    NetworkImpairment::Settings settings;
+    settings.lossRate = 0.1;
+
+    std::vector<QByteArray> received[2];
+    for (auto& run : received) {
+        ImpairedWrites writes;
+        {
+            NetworkImpairment impairment { settings, writes.function() };
+            impairment.start();
+
+            for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+                auto datagram = QByteArray::number(i);
+                impairment.queue(datagram.constData(), datagram.size(), sockAddr);
+            }
+
+            // nothing is delayed, so this is plenty for the impairment thread to write out what survived
+            QThread::msleep(100);
+        }
+
+        for (auto& write : writes.writes) {
+            run.push_back(write.first);
+        }
+    }
+
+    QVERIFY(received[0].size() > NUM_DATAGRAMS * 0.85 && received[0].size() < NUM_DATAGRAMS * 0.95);
+    QVERIFY(received[0] == received[1]);
+}
+
+void CongestionControlTests::impairmentDelayTest() {
+    const int NUM_DATAGRAMS = 10;
+    const int DATAGRAM_SIZE = 1000;
+    const HifiSockAddr sockAddr { QHostAddress::LocalHost, 1234 };
+
+    // each datagram takes 1ms to serialize, then is held for 20ms
+    NetworkImpairment::Settings settings;
+    settings.delayUsecs = 20000;
+    settings.rateCapBitsPerSecond = 8000000;
+
+    ImpairedWrites writes;
+    NetworkImpairment impairment { settings, writes.function() };
+    impairment.start();
+
+    QByteArray datagram { DATAGRAM_SIZE, 0 };
+    auto sendTime = p_high_resolution_clock::now();
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        impairment.queue(datagram.constData(), datagram.size(), sockAddr);
+    }
+
+    waitForWrites(writes, NUM_DATAGRAMS);
+    QCOMPARE(writes.size(), (size_t)NUM_DATAGRAMS);
+
+    auto firstDelay = duration_cast<microseconds>(writes.writes.front().second - sendTime).count();
+    auto lastDelay = duration_cast<microseconds>(writes.writes.back().second - sendTime).count();
+    QVERIFY(firstDelay >= 21000);
+    QVERIFY(lastDelay >= 30000);
+}
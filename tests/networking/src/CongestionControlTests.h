@@ -0,0 +1,35 @@
+//
+//  CongestionControlTests.h
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CongestionControlTests_h
+#define hifi_CongestionControlTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class CongestionControlTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that BBRCC finds the bandwidth and RTT of a simulated link and sizes its window to their product
+    void bbrConvergenceTest();
+
+    // Test that BBRCC drops its window to probe the RTT once its min RTT expires, then restores it
+    void bbrProbeRTTTest();
+
+    // Test that the network impairment drops at its loss rate, and that the same seed drops the same datagrams
+    void impairmentLossTest();
+
+    // Test that the network impairment holds datagrams for the delay and serializes them at the rate cap
+    void impairmentDelayTest();
+};
+
+#endif // hifi_CongestionControlTests_h
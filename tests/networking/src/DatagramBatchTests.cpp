@@ -0,0 +1,159 @@
+//
+//  DatagramBatchTests.cpp
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-10.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DatagramBatchTests.h"
+
+#include <QtNetwork/QUdpSocket>
+
+#include <SharedUtil.h>
+#include <udt/Constants.h>
+#include <udt/DatagramBatch.h>
+
+QTEST_MAIN(DatagramBatchTests)
+
+using namespace udt;
+
+const int BENCHMARK_ROUNDS = 2000;
+const quint64 READ_TIMEOUT_USECS = USECS_PER_SECOND;
+
+// reads until numExpected datagrams have arrived or we time out, since loopback delivery can lag the send
+static int readBatches(DatagramBatchReader& reader, QUdpSocket& socket, int numExpected,
+                       std::vector<QByteArray>* received = nullptr) {
+    int numReceived = 0;
+    auto timeout = usecTimestampNow() + READ_TIMEOUT_USECS;
+
+    while (numReceived < numExpected && usecTimestampNow() < timeout) {
+        int numRead = reader.read(socket.socketDescriptor());
+        for (int i = 0; i < numRead; ++i) {
+            if (received) {
+                auto buffer = reader.takeBuffer(i);
+                received->emplace_back(buffer.get(), reader.getSize(i));
+            }
+        }
+        numReceived += std::max(numRead, 0);
+    }
+
+    return numReceived;
+}
+
+void DatagramBatchTests::roundTripTest() {
+    if (!DatagramBatchReader::isSupported()) {
+        QSKIP("Batched datagram I/O is not supported on this platform");
+    }
+
+    QUdpSocket sender;
+    QUdpSocket receiver;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+    HifiSockAddr destination(QHostAddress::LocalHost, receiver.localPort());
+
+    const int NUM_DATAGRAMS = 16;
+    std::vector<QByteArray> sent;
+    DatagramBatchWriter writer;
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        sent.push_back(QByteArray(1 + i * 64, 'a' + i));
+        QVERIFY(writer.add(sent.back().constData(), sent.back().size(), destination));
+    }
+
+    qint64 expectedBytes = 0;
+    for (auto& datagram : sent) {
+        expectedBytes += datagram.size();
+    }
+    QCOMPARE(writer.flush(sender.socketDescriptor()), expectedBytes);
+    QVERIFY(writer.isEmpty());
+
+    DatagramBatchReader reader;
+    std::vector<QByteArray> received;
+    QCOMPARE(readBatches(reader, receiver, NUM_DATAGRAMS, &received), NUM_DATAGRAMS);
+
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        QCOMPARE(received[i], sent[i]);
+    }
+
+    QCOMPARE(reader.getSenderSockAddr(0), HifiSockAddr(QHostAddress::LocalHost, sender.localPort()));
+
+    // nothing left to read
+    QCOMPARE(reader.read(receiver.socketDescriptor()), 0);
+}
+
+void DatagramBatchTests::fullBatchTest() {
+    if (!DatagramBatchWriter::isSupported()) {
+        QSKIP("Batched datagram I/O is not supported on this platform");
+    }
+
+    char data[1] = { 0 };
+    HifiSockAddr destination(QHostAddress::LocalHost, 1);
+
+    DatagramBatchWriter writer;
+    for (int i = 0; i < MAX_DATAGRAM_BATCH_SIZE; ++i) {
+        QVERIFY(writer.add(data, sizeof(data), destination));
+    }
+    QVERIFY(writer.isFull());
+    QVERIFY(!writer.add(data, sizeof(data), destination));
+}
+
+void DatagramBatchTests::benchmark() {
+    if (!DatagramBatchReader::isSupported()) {
+        QSKIP("Batched datagram I/O is not supported on this platform");
+    }
+
+    QUdpSocket sender;
+    QUdpSocket receiver;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+    HifiSockAddr destination(QHostAddress::LocalHost, receiver.localPort());
+    QByteArray payload(MAX_PACKET_SIZE, 'x');
+
+    // QUdpSocket - one syscall and one allocation per datagram in each direction
+    int numQtPackets = 0;
+    auto startTime = usecTimestampNow();
+    for (int round = 0; round < BENCHMARK_ROUNDS; ++round) {
+        for (int i = 0; i < MAX_DATAGRAM_BATCH_SIZE; ++i) {
+            sender.writeDatagram(payload, destination.getAddress(), destination.getPort());
+        }
+
+        int numRead = 0;
+        auto timeout = usecTimestampNow() + READ_TIMEOUT_USECS;
+        while (numRead < MAX_DATAGRAM_BATCH_SIZE && usecTimestampNow() < timeout) {
+            if (receiver.hasPendingDatagrams()) {
+                auto size = receiver.pendingDatagramSize();
+                auto buffer = std::unique_ptr<char[]>(new char[size]);
+                HifiSockAddr senderSockAddr;
+                receiver.readDatagram(buffer.get(), size,
+                                      senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
+                ++numRead;
+            }
+        }
+        numQtPackets += numRead;
+    }
+    auto qtUsecs = std::max(usecTimestampNow() - startTime, (quint64)1);
+
+    // batched - one syscall per MAX_DATAGRAM_BATCH_SIZE datagrams in each direction
+    DatagramBatchReader reader;
+    DatagramBatchWriter writer;
+    int numBatchedPackets = 0;
+    startTime = usecTimestampNow();
+    for (int round = 0; round < BENCHMARK_ROUNDS; ++round) {
+        while (writer.add(payload.constData(), payload.size(), destination)) {}
+        writer.flush(sender.socketDescriptor());
+
+        numBatchedPackets += readBatches(reader, receiver, MAX_DATAGRAM_BATCH_SIZE);
+    }
+    auto batchedUsecs = std::max(usecTimestampNow() - startTime, (quint64)1);
+
+    qDebug() << "QUdpSocket:" << (numQtPackets * USECS_PER_SECOND / qtUsecs) << "packets/sec";
+    qDebug() << "Batched:" << (numBatchedPackets * USECS_PER_SECOND / batchedUsecs) << "packets/sec";
+
+    QCOMPARE(numQtPackets, BENCHMARK_ROUNDS * MAX_DATAGRAM_BATCH_SIZE);
+    QCOMPARE(numBatchedPackets, BENCHMARK_ROUNDS * MAX_DATAGRAM_BATCH_SIZE);
+}
@@ -0,0 +1,32 @@
+//
+//  DatagramBatchTests.h
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-10.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DatagramBatchTests_h
+#define hifi_DatagramBatchTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class DatagramBatchTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a batch written with sendmmsg is read back intact with recvmmsg
+    void roundTripTest();
+
+    // Test that a batch larger than MAX_DATAGRAM_BATCH_SIZE is rejected until flushed
+    void fullBatchTest();
+
+    // Compare packets/sec for the QUdpSocket path against the batched path over loopback
+    void benchmark();
+};
+
+#endif // hifi_DatagramBatchTests_h
@@ -0,0 +1,175 @@
+//
+//  HMACAuthTests.cpp
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-14.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "HMACAuthTests.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QUuid>
+
+#include <HMACAuth.h>
+#include <SharedUtil.h>
+#include <udt/Constants.h>
+#include <udt/PacketHeaders.h>
+
+QTEST_MAIN(HMACAuthTests)
+
+const int BENCHMARK_VERIFIES_PER_THREAD = 200000;
+const int REKEY_ROUNDS = 2000;
+
+static QByteArray hashOf(const HMACAuth& hmacAuth, const QByteArray& data) {
+    HMACAuth::HMACHash hashResult;
+    if (!hmacAuth.calculateHash(hashResult, data.constData(), data.size())) {
+        return QByteArray();
+    }
+    return QByteArray(reinterpret_cast<const char*>(hashResult.data()), hashResult.size);
+}
+
+void HMACAuthTests::knownVectorsTest() {
+    const QByteArray key("Jefe");
+    const QByteArray data("what do ya want for nothing?");
+
+    // RFC 2202 test case 2
+    HMACAuth md5Auth(HMACAuth::MD5);
+    QVERIFY(md5Auth.setKey(key.constData(), key.size()));
+    QCOMPARE(hashOf(md5Auth, data).toHex(), QByteArray("750c783e6ab0b503eaa86e310a5db738"));
+
+    // RFC 4231 test case 2
+    HMACAuth sha256Auth(HMACAuth::SHA256);
+    QVERIFY(sha256Auth.setKey(key.constData(), key.size()));
+    QCOMPARE(hashOf(sha256Auth, data).toHex(),
+             QByteArray("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"));
+
+    // RFC 4231 test case 6 - a key longer than the block size is hashed first
+    const QByteArray longKey(131, '\xaa');
+    QVERIFY(sha256Auth.setKey(longKey.constData(), longKey.size()));
+    QCOMPARE(hashOf(sha256Auth, "Test Using Larger Than Block-Size Key - Hash Key First").toHex(),
+             QByteArray("60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54"));
+
+    if (HMACAuth::isSupported(HMACAuth::BLAKE2S256)) {
+        HMACAuth blake2sAuth(HMACAuth::BLAKE2S256);
+        QVERIFY(blake2sAuth.setKey(key.constData(), key.size()));
+        QCOMPARE(hashOf(blake2sAuth, data).toHex(),
+                 QByteArray("90b6281e2f3038c9056af0b4a7e763cae6fe5d9eb4386a0ec95237890c104ff0"));
+    }
+}
+
+void HMACAuthTests::supportedMethodsTest() {
+    uint32_t supportedMethods = HMACAuth::getSupportedMethods();
+
+    // every node can use the fallback method
+    QVERIFY(supportedMethods & (1 << HMACAuth::MD5));
+    for (int method = HMACAuth::MD5; method <= HMACAuth::BLAKE2S256; method++) {
+        QCOMPARE((bool)(supportedMethods & (1 << method)), HMACAuth::isSupported((HMACAuth::AuthMethod)method));
+    }
+}
+
+void HMACAuthTests::verifyTest() {
+    HMACAuth hmacAuth(HMACAuth::SHA256);
+    QVERIFY(hmacAuth.setKey(QUuid::createUuid()));
+
+    QByteArray data(MAX_PACKET_SIZE, 'x');
+    QByteArray hash = hashOf(hmacAuth, data);
+    QCOMPARE(hash.size(), 32);
+
+    // packets only carry the first NUM_BYTES_MD5_HASH bytes of the hash
+    QVERIFY(hmacAuth.verifyHash(hash.constData(), NUM_BYTES_MD5_HASH, data.constData(), data.size()));
+
+    hash[0] = hash[0] ^ 1;
+    QVERIFY(!hmacAuth.verifyHash(hash.constData(), NUM_BYTES_MD5_HASH, data.constData(), data.size()));
+
+    // asking for more than the digest holds never verifies
+    QVERIFY(!hmacAuth.verifyHash(hash.constData(), HMACAuth::MAX_HASH_SIZE, data.constData(), data.size()));
+
+    // without a key nothing verifies
+    HMACAuth unkeyedAuth;
+    QVERIFY(!unkeyedAuth.verifyHash(hash.constData(), NUM_BYTES_MD5_HASH, data.constData(), data.size()));
+}
+
+void HMACAuthTests::rekeyTest() {
+    const QUuid firstKey = QUuid::createUuid();
+    const QUuid secondKey = QUuid::createUuid();
+    const QByteArray data("rekey");
+
+    HMACAuth firstAuth;
+    HMACAuth secondAuth;
+    firstAuth.setKey(firstKey);
+    secondAuth.setKey(secondKey);
+    const QByteArray firstHash = hashOf(firstAuth, data);
+    const QByteArray secondHash = hashOf(secondAuth, data);
+
+    HMACAuth hmacAuth;
+    hmacAuth.setKey(firstKey);
+
+    std::atomic<bool> done { false };
+    std::atomic<int> numBadHashes { 0 };
+    std::thread reader([&] {
+        while (!done) {
+            QByteArray hash = hashOf(hmacAuth, data);
+            if (hash != firstHash && hash != secondHash) {
+                ++numBadHashes;
+            }
+        }
+    });
+
+    for (int i = 0; i < REKEY_ROUNDS; ++i) {
+        hmacAuth.setKey((i % 2) ? firstKey : secondKey);
+    }
+    done = true;
+    reader.join();
+
+    QCOMPARE(numBadHashes.load(), 0);
+}
+
+void HMACAuthTests::benchmark() {
+    const QUuid key = QUuid::createUuid();
+    const QByteArray data(MAX_PACKET_SIZE, 'x');
+    const int numCores = std::max(QThread::idealThreadCount(), 1);
+
+    for (auto authMethod : { HMACAuth::MD5, HMACAuth::SHA1, HMACAuth::SHA256, HMACAuth::BLAKE2S256 }) {
+        if (!HMACAuth::isSupported(authMethod)) {
+            continue;
+        }
+
+        // all threads share one HMACAuth, the way the socket threads share a node's
+        HMACAuth hmacAuth(authMethod);
+        hmacAuth.setKey(key);
+        const QByteArray hash = hashOf(hmacAuth, data);
+
+        for (int numThreads : { 1, numCores }) {
+            std::atomic<int> numVerified { 0 };
+            std::vector<std::thread> threads;
+
+            auto startTime = usecTimestampNow();
+            for (int i = 0; i < numThreads; ++i) {
+                threads.emplace_back([&] {
+                    int verified = 0;
+                    for (int j = 0; j < BENCHMARK_VERIFIES_PER_THREAD; ++j) {
+                        verified += hmacAuth.verifyHash(hash.constData(), NUM_BYTES_MD5_HASH,
+                                                        data.constData(), data.size()) ? 1 : 0;
+                    }
+                    numVerified += verified;
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            auto usecs = std::max(usecTimestampNow() - startTime, (quint64)1);
+
+            qDebug() << "Method" << authMethod << "on" << numThreads << "threads:"
+                << (numVerified * USECS_PER_SECOND / usecs / numThreads) << "verifies/sec per core";
+
+            QCOMPARE(numVerified.load(), numThreads * BENCHMARK_VERIFIES_PER_THREAD);
+        }
+    }
+}
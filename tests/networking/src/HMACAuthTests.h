@@ -0,0 +1,38 @@
+//
+//  HMACAuthTests.h
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-14.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_HMACAuthTests_h
+#define hifi_HMACAuthTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class HMACAuthTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test the supported methods against the RFC 2202 and RFC 4231 test vectors
+    void knownVectorsTest();
+
+    // Test that the supported methods mask, sent in the domain connect request, matches isSupported
+    void supportedMethodsTest();
+
+    // Test that a truncated hash verifies and a corrupted one does not
+    void verifyTest();
+
+    // Test that hashes calculated while another thread re-keys are always for one of the two keys
+    void rekeyTest();
+
+    // Report verifications/sec per core for each method on one thread and on every core
+    void benchmark();
+};
+
+#endif // hifi_HMACAuthTests_h
@@ -0,0 +1,89 @@
+//
+//  PacketBufferPoolTests.cpp
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-17.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPoolTests.h"
+
+#include <thread>
+#include <vector>
+
+#include <NLPacket.h>
+#include <udt/Packet.h>
+#include <udt/PacketBufferPool.h>
+
+QTEST_MAIN(PacketBufferPoolTests)
+
+using namespace udt;
+
+const int NUM_BUFFERS = 1000;
+
+void PacketBufferPoolTests::reuseTest() {
+    const char* released;
+    {
+        auto buffer = PacketBufferPool::acquire();
+        QVERIFY(buffer);
+        released = buffer.get();
+    }
+
+    auto before = PacketBufferPool::getStats();
+    auto buffer = PacketBufferPool::acquire();
+    auto after = PacketBufferPool::getStats();
+
+    QCOMPARE(buffer.get(), released);
+    QCOMPARE(after.hits, before.hits + 1);
+    QCOMPARE(after.misses, before.misses);
+}
+
+void PacketBufferPoolTests::crossThreadTest() {
+    std::vector<PacketBuffer> buffers;
+    for (int i = 0; i < NUM_BUFFERS; ++i) {
+        buffers.push_back(PacketBufferPool::acquire());
+    }
+
+    // release them all on a thread that exits, the way a receive worker would
+    std::thread releaser([&] {
+        buffers.clear();
+    });
+    releaser.join();
+
+    auto before = PacketBufferPool::getStats();
+    QVERIFY(before.numFree >= (quint64)NUM_BUFFERS);
+
+    for (int i = 0; i < NUM_BUFFERS; ++i) {
+        buffers.push_back(PacketBufferPool::acquire());
+    }
+    auto after = PacketBufferPool::getStats();
+
+    QCOMPARE(after.misses, before.misses);
+    QCOMPARE(after.hits, before.hits + NUM_BUFFERS);
+}
+
+void PacketBufferPoolTests::packetTest() {
+    {
+        auto packet = NLPacket::create(PacketType::Ping);
+        packet->writePrimitive(quint64(42));
+    }
+
+    auto before = PacketBufferPool::getStats();
+    auto packet = NLPacket::create(PacketType::Ping);
+    auto after = PacketBufferPool::getStats();
+    QCOMPARE(after.hits, before.hits + 1);
+
+    // the recycled buffer still comes back zeroed
+    for (qint64 i = 0; i < packet->getPayloadCapacity(); ++i) {
+        QCOMPARE(packet->getPayload()[i], (char)0);
+    }
+
+    // a plain buffer can still be handed to a received packet
+    auto size = Packet::totalHeaderSize(false);
+    auto received = Packet::fromReceivedPacket(std::unique_ptr<char[]>(new char[size]()), size,
+                                               HifiSockAddr(QHostAddress::LocalHost, 1));
+    QCOMPARE(received->getDataSize(), (qint64)size);
+}
@@ -0,0 +1,32 @@
+//
+//  PacketBufferPoolTests.h
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-17.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketBufferPoolTests_h
+#define hifi_PacketBufferPoolTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketBufferPoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a released buffer is handed out again instead of allocating
+    void reuseTest();
+
+    // Test that buffers released on another thread find their way back to the pool
+    void crossThreadTest();
+
+    // Test that packets draw their buffers from the pool and return them, zeroed on create
+    void packetTest();
+};
+
+#endif // hifi_PacketBufferPoolTests_h
@@ -0,0 +1,94 @@
+//
+//  ReceiveWorkerPoolTests.cpp
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-12.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceiveWorkerPoolTests.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include <udt/Packet.h>
+#include <udt/ReceiveWorkerPool.h>
+
+QTEST_MAIN(ReceiveWorkerPoolTests)
+
+using namespace udt;
+
+const int NUM_WORKERS = 4;
+const int NUM_SENDERS = 16;
+const int PACKETS_PER_SENDER = 500;
+
+static std::unique_ptr<Packet> createPacket(quint16 senderPort, uint32_t index) {
+    auto size = Packet::totalHeaderSize(false) + sizeof(index);
+    auto data = std::unique_ptr<char[]>(new char[size]());
+    memcpy(data.get() + Packet::totalHeaderSize(false), &index, sizeof(index));
+    return Packet::fromReceivedPacket(std::move(data), size, HifiSockAddr(QHostAddress::LocalHost, senderPort));
+}
+
+static uint32_t indexInPacket(const Packet& packet) {
+    uint32_t index;
+    memcpy(&index, packet.getPayload(), sizeof(index));
+    return index;
+}
+
+void ReceiveWorkerPoolTests::deliveryTest() {
+    std::atomic<int> numProcessed { 0 };
+
+    {
+        ReceiveWorkerPool pool(NUM_WORKERS, [&](std::unique_ptr<Packet> packet) {
+            ++numProcessed;
+        });
+
+        for (int i = 0; i < NUM_SENDERS * PACKETS_PER_SENDER; ++i) {
+            pool.queue(createPacket(1 + (i % NUM_SENDERS), i));
+        }
+        pool.flush();
+
+        QTRY_COMPARE(numProcessed.load(), NUM_SENDERS * PACKETS_PER_SENDER);
+    }
+}
+
+void ReceiveWorkerPoolTests::orderingTest() {
+    std::mutex mutex;
+    std::unordered_map<quint16, uint32_t> lastIndex;
+    std::unordered_map<quint16, Qt::HANDLE> senderThread;
+    std::atomic<int> numOutOfOrder { 0 };
+    std::atomic<int> numProcessed { 0 };
+
+    ReceiveWorkerPool pool(NUM_WORKERS, [&](std::unique_ptr<Packet> packet) {
+        auto port = packet->getSenderSockAddr().getPort();
+        auto index = indexInPacket(*packet);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = lastIndex.find(port);
+        if (it != lastIndex.end()) {
+            if (index <= it->second || senderThread[port] != QThread::currentThreadId()) {
+                ++numOutOfOrder;
+            }
+        }
+        lastIndex[port] = index;
+        senderThread[port] = QThread::currentThreadId();
+        ++numProcessed;
+    });
+
+    for (int i = 0; i < NUM_SENDERS * PACKETS_PER_SENDER; ++i) {
+        pool.queue(createPacket(1 + (i % NUM_SENDERS), i));
+
+        // hand off at irregular intervals like the socket does at the end of each read
+        if (i % 37 == 0) {
+            pool.flush();
+        }
+    }
+    pool.flush();
+
+    QTRY_COMPARE(numProcessed.load(), NUM_SENDERS * PACKETS_PER_SENDER);
+    QCOMPARE(numOutOfOrder.load(), 0);
+}
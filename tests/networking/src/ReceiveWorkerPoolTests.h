@@ -0,0 +1,29 @@
+//
+//  ReceiveWorkerPoolTests.h
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-12.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReceiveWorkerPoolTests_h
+#define hifi_ReceiveWorkerPoolTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ReceiveWorkerPoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that every queued packet is processed exactly once
+    void deliveryTest();
+
+    // Test that packets from one sender are processed in order, on one worker
+    void orderingTest();
+};
+
+#endif // hifi_ReceiveWorkerPoolTests_h
@@ -0,0 +1,92 @@
+//
+//  ReceivedPacketTests.cpp
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceivedPacketTests.h"
+
+#include <NLPacket.h>
+#include <ReceivedMessage.h>
+#include <ReceivedPacket.h>
+
+QTEST_MAIN(ReceivedPacketTests)
+
+static const quint16 SEQUENCE_NUMBER = 1234;
+static const QString CODEC_NAME = "opus";
+
+static std::unique_ptr<NLPacket> createStreamPacket() {
+    auto packet = NLPacket::create(PacketType::MicrophoneAudioNoEcho);
+    packet->writePrimitive(SEQUENCE_NUMBER);
+    packet->writeString(CODEC_NAME);
+    packet->write(QByteArray(64, 'x'));
+    return packet;
+}
+
+void ReceivedPacketTests::viewTest() {
+    auto packet = createStreamPacket();
+    const char* payload = packet->getPayload();
+    qint64 payloadSize = packet->getPayloadSize();
+
+    ReceivedPacket received(std::move(packet));
+    QCOMPARE(received.getType(), PacketType::MicrophoneAudioNoEcho);
+    QCOMPARE(received.getSize(), payloadSize);
+
+    // no copy of the payload was made
+    QVERIFY(received.getRawMessage() == payload);
+
+    quint16 sequenceNumber;
+    received.readPrimitive(&sequenceNumber);
+    QCOMPARE(sequenceNumber, SEQUENCE_NUMBER);
+    QCOMPARE(received.readString(), CODEC_NAME);
+    QCOMPARE(received.getBytesLeftToRead(), (qint64)64);
+
+    auto audio = received.readWithoutCopy(received.getBytesLeftToRead());
+    QVERIFY(audio.constData() == payload + payloadSize - 64);
+    QCOMPARE(received.getBytesLeftToRead(), (qint64)0);
+}
+
+void ReceivedPacketTests::copyTest() {
+    QByteArray message;
+    QByteArray all;
+    QByteArray expected;
+    {
+        auto packet = createStreamPacket();
+        expected = QByteArray(packet->getPayload(), packet->getPayloadSize());
+
+        ReceivedPacket received(std::move(packet));
+        message = received.getMessage();
+        all = received.readAll();
+        QVERIFY(message.constData() != received.getRawMessage());
+        QVERIFY(all.constData() != received.getRawMessage());
+    }
+
+    // the packet is gone, the arrays still hold its contents
+    QCOMPARE(message, expected);
+    QCOMPARE(all, expected);
+}
+
+void ReceivedPacketTests::messageTest() {
+    auto packet = createStreamPacket();
+    QByteArray expected(packet->getPayload(), packet->getPayloadSize());
+
+    // a ReceivedMessage reads the packet from its current position, the way it is handed over on receipt
+    packet->seek(0);
+    auto message = QSharedPointer<ReceivedMessage>::create(*packet);
+    ReceivedPacketPointer received = ReceivedMessage::toPacketPointer(message);
+    QWeakPointer<ReceivedMessage> weakMessage = message;
+    message.clear();
+
+    // the packet pointer keeps the message alive
+    QVERIFY(!weakMessage.isNull());
+    QCOMPARE(received->getType(), PacketType::MicrophoneAudioNoEcho);
+    QCOMPARE(received->readAll(), expected);
+
+    received.reset();
+    QVERIFY(weakMessage.isNull());
+}
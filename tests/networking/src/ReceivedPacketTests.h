@@ -0,0 +1,32 @@
+//
+//  ReceivedPacketTests.h
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReceivedPacketTests_h
+#define hifi_ReceivedPacketTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ReceivedPacketTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a received packet reads straight out of the packet's payload
+    void viewTest();
+
+    // Test that the byte arrays handed out by a packet view outlive the packet
+    void copyTest();
+
+    // Test that a ReceivedMessage can be shared as a ReceivedPacketPointer
+    void messageTest();
+};
+
+#endif // hifi_ReceivedPacketTests_h
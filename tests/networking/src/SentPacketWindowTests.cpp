@@ -0,0 +1,129 @@
+//
+//  SentPacketWindowTests.cpp
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SentPacketWindowTests.h"
+
+#include <udt/LossList.h>
+#include <udt/SentPacketWindow.h>
+
+QTEST_MAIN(SentPacketWindowTests)
+
+using namespace udt;
+
+// fills the window with numPackets packets starting at first, returning the raw pointers for comparison
+static std::vector<Packet*> fill(SentPacketWindow& window, SequenceNumber first, int numPackets) {
+    std::vector<Packet*> packets;
+    for (int i = 0; i < numPackets; ++i) {
+        auto packet = Packet::create();
+        packets.push_back(packet.get());
+        window.add(first + i, std::move(packet));
+    }
+    return packets;
+}
+
+void SentPacketWindowTests::findReleaseTest() {
+    SentPacketWindow window;
+    SequenceNumber first { 100 };
+    auto packets = fill(window, first, 10);
+
+    QCOMPARE(window.getSize(), 10);
+    for (int i = 0; i < 10; ++i) {
+        auto entry = window.find(first + i);
+        QVERIFY(entry);
+        QVERIFY(entry->packet.get() == packets[i]);
+        QCOMPARE((int)entry->resends, 0);
+    }
+    QVERIFY(!window.find(first - 1));
+    QVERIFY(!window.find(first + 10));
+
+    // releasing something already released is a no-op
+    window.release(first + 3);
+    QCOMPARE(window.getSize(), 6);
+    window.release(first + 1);
+    QCOMPARE(window.getSize(), 6);
+    QVERIFY(!window.find(first + 3));
+    QVERIFY(window.find(first + 4)->packet.get() == packets[4]);
+
+    // releasing past the end empties the window
+    window.release(first + 50);
+    QVERIFY(window.isEmpty());
+
+    // and an empty window starts over at whatever is added next
+    auto packet = Packet::create();
+    auto rawPacket = packet.get();
+    window.add(first + 60, std::move(packet));
+    QVERIFY(window.find(first + 60)->packet.get() == rawPacket);
+}
+
+void SentPacketWindowTests::growTest() {
+    const int NUM_PACKETS = 1000;
+
+    SentPacketWindow window;
+    SequenceNumber first { 0 };
+
+    // move the front off zero so growing has to compact a ring that has wrapped
+    fill(window, first, 200);
+    window.release(first + 199);
+    first = first + 200;
+
+    auto packets = fill(window, first, NUM_PACKETS);
+    QCOMPARE(window.getSize(), NUM_PACKETS);
+    for (int i = 0; i < NUM_PACKETS; ++i) {
+        QVERIFY(window.find(first + i)->packet.get() == packets[i]);
+    }
+}
+
+void SentPacketWindowTests::wrapTest() {
+    SentPacketWindow window;
+    SequenceNumber first { SequenceNumber::MAX - 4 };
+    auto packets = fill(window, first, 10);
+
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY(window.find(first + i)->packet.get() == packets[i]);
+    }
+
+    window.release(SequenceNumber { 1 });
+    QCOMPARE(window.getSize(), 3);
+    QVERIFY(window.find(SequenceNumber { 2 })->packet.get() == packets[7]);
+}
+
+void SentPacketWindowTests::lossListTest() {
+    LossList list;
+
+    list.append(SequenceNumber { 10 }, SequenceNumber { 12 });
+    list.append(SequenceNumber { 20 });
+    list.append(SequenceNumber { 30 }, SequenceNumber { 35 });
+    QCOMPARE(list.getLength(), 10);
+
+    // bridges the first two intervals and runs into the third
+    list.insert(SequenceNumber { 13 }, SequenceNumber { 31 });
+    QCOMPARE(list.getLength(), 26);
+    QCOMPARE(list.getFirstSequenceNumber(), SequenceNumber { 10 });
+
+    // splits the merged interval in two
+    QVERIFY(list.remove(SequenceNumber { 15 }));
+    QVERIFY(!list.remove(SequenceNumber { 15 }));
+    QCOMPARE(list.getLength(), 25);
+
+    list.remove(SequenceNumber { 5 }, SequenceNumber { 16 });
+    QCOMPARE(list.getLength(), 19);
+    QCOMPARE(list.getFirstSequenceNumber(), SequenceNumber { 17 });
+
+    // cuts a hole out of the middle of an interval
+    list.remove(SequenceNumber { 20 }, SequenceNumber { 29 });
+    QCOMPARE(list.getLength(), 9);
+
+    QCOMPARE(list.popFirstSequenceNumber(), SequenceNumber { 17 });
+    QCOMPARE(list.popFirstSequenceNumber(), SequenceNumber { 18 });
+    QCOMPARE(list.popFirstSequenceNumber(), SequenceNumber { 19 });
+    QCOMPARE(list.popFirstSequenceNumber(), SequenceNumber { 30 });
+    QCOMPARE(list.getLength(), 5);
+}
@@ -0,0 +1,35 @@
+//
+//  SentPacketWindowTests.h
+//  tests/networking/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SentPacketWindowTests_h
+#define hifi_SentPacketWindowTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class SentPacketWindowTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that packets can be found until they're released, and that release stops at the window
+    void findReleaseTest();
+
+    // Test that the window keeps its packets in order while it grows past its initial capacity
+    void growTest();
+
+    // Test that the window indexes correctly across the sequence number wrap
+    void wrapTest();
+
+    // Test that the loss list merges, splits and pops intervals correctly
+    void lossListTest();
+};
+
+#endif // hifi_SentPacketWindowTests_h
@@ -0,0 +1,105 @@
+//
+//  EntityEncodeCacheTests.cpp
+//  tests/octree/src
+//
+//  Created by Roxanne Skelly on 2019-06-22.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEncodeCacheTests.h"
+
+#include <EntityItemProperties.h>
+#include <EntityNodeData.h>
+#include <EntityTreeElement.h>
+#include <ShapeEntityItem.h>
+
+QTEST_MAIN(EntityEncodeCacheTests)
+
+static EntityItemPointer makeBox(const QString& name) {
+    EntityItemProperties properties;
+    properties.setName(name);
+    return ShapeEntityItem::boxFactory(EntityItemID(QUuid::createUuid()), properties);
+}
+
+// encodes the entity for a client when nodeData is given, the way the entity server does, otherwise as an edit
+static QByteArray encode(const EntityItemPointer& entity, NodeData* nodeData,
+                         EntityTreeElementExtraEncodeDataPointer extra = EntityTreeElementExtraEncodeDataPointer(),
+                         OctreeElement::AppendState* state = nullptr, int maxSize = MAX_OCTREE_PACKET_DATA_SIZE) {
+    OctreePacketData packetData(false, maxSize);
+    EncodeBitstreamParams params(WANT_EXISTS_BITS, nodeData);
+    if (!extra) {
+        extra = std::make_shared<EntityTreeElementExtraEncodeData>();
+    }
+
+    OctreeElement::AppendState appendState = entity->appendEntityData(&packetData, params, extra);
+    if (state) {
+        *state = appendState;
+    }
+    return QByteArray((const char*)packetData.getUncompressedData(), packetData.getUncompressedSize());
+}
+
+void EntityEncodeCacheTests::testSharedEncoding() {
+    EntityNodeData nodeData;
+    auto entity = makeBox("shared");
+
+    QByteArray first = encode(entity, &nodeData);
+    QByteArray second = encode(entity, &nodeData);
+    QByteArray uncached = encode(entity, nullptr);
+
+    QVERIFY(!first.isEmpty());
+    QCOMPARE(second, first);
+    QCOMPARE(first, uncached);
+}
+
+void EntityEncodeCacheTests::testUnchangedServedFromCache() {
+    EntityNodeData nodeData;
+    auto entity = makeBox("cached");
+    QByteArray cached = encode(entity, &nodeData);
+
+    // a bare setter moves no timestamp and doesn't invalidate, so clients keep getting the cached bytes
+    entity->setName("changed behind the cache");
+    QByteArray uncached = encode(entity, nullptr);
+    QVERIFY(uncached != cached);
+    QCOMPARE(encode(entity, &nodeData), cached);
+
+    // until the cache is invalidated
+    entity->invalidateEncodeCache();
+    QCOMPARE(encode(entity, &nodeData), uncached);
+}
+
+void EntityEncodeCacheTests::testEditInvalidates() {
+    EntityNodeData nodeData;
+    auto entity = makeBox("before");
+
+    QByteArray before = encode(entity, &nodeData);
+
+    EntityItemProperties properties;
+    properties.setName("after");
+    QVERIFY(entity->setProperties(properties));
+
+    QByteArray after = encode(entity, &nodeData);
+    QVERIFY(after != before);
+    QCOMPARE(after, encode(entity, nullptr));
+}
+
+void EntityEncodeCacheTests::testPartialBypassesCache() {
+    EntityNodeData nodeData;
+    auto entity = makeBox("partial");
+    QByteArray full = encode(entity, &nodeData);
+
+    // an entity that doesn't fit is encoded in parts, which are never cached
+    auto extra = std::make_shared<EntityTreeElementExtraEncodeData>();
+    OctreeElement::AppendState state;
+    QByteArray part = encode(entity, &nodeData, extra, &state, full.size() / 2);
+    QCOMPARE(state, OctreeElement::PARTIAL);
+    QVERIFY(part.size() < full.size());
+
+    QByteArray rest = encode(entity, &nodeData, extra, &state);
+    QCOMPARE(state, OctreeElement::COMPLETED);
+    QVERIFY(rest.size() < full.size());
+
+    QCOMPARE(encode(entity, &nodeData), full);
+}
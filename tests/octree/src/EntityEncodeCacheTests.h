@@ -0,0 +1,27 @@
+//
+//  EntityEncodeCacheTests.h
+//  tests/octree/src
+//
+//  Created by Roxanne Skelly on 2019-06-22.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEncodeCacheTests_h
+#define hifi_EntityEncodeCacheTests_h
+
+#include <QtTest/QtTest>
+
+class EntityEncodeCacheTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testSharedEncoding();
+    void testUnchangedServedFromCache();
+    void testEditInvalidates();
+    void testPartialBypassesCache();
+};
+
+#endif // hifi_EntityEncodeCacheTests_h
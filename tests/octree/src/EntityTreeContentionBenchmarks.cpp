@@ -0,0 +1,231 @@
+//
+//  EntityTreeContentionBenchmarks.cpp
+//  tests/octree/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTreeContentionBenchmarks.h"
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include <DependencyManager.h>
+#include <EntityTree.h>
+#include <LimitedNodeList.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <StatTracker.h>
+
+QTEST_MAIN(EntityTreeContentionBenchmarks)
+
+static const float WORLD_SIZE = 400.0f;
+static const float BOX_SIZE = 1.0f;
+static const float QUERY_RADIUS = 10.0f;
+static const int EDITS_PER_BATCH = 50;
+static const int BENCHMARK_MSECS = 2000;
+
+static glm::vec3 randomPosition(std::mt19937& generator) {
+    std::uniform_real_distribution<float> distribution(0.0f, WORLD_SIZE);
+    return glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+}
+
+static EntityTreePointer makeTree(int numEntities, QVector<EntityItemID>& entityIDs) {
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->setIsServer(true);
+    tree->createRootElement();
+
+    std::mt19937 generator(numEntities);
+    tree->withWriteLock([&] {
+        for (int i = 0; i < numEntities; i++) {
+            EntityItemID entityID(QUuid::createUuid());
+            EntityItemProperties properties;
+            properties.setType(EntityTypes::Box);
+            properties.setName(QString("box %1").arg(i % 10));
+            properties.setPosition(randomPosition(generator));
+            properties.setDimensions(glm::vec3(BOX_SIZE));
+            if (tree->addEntity(entityID, properties)) {
+                entityIDs.push_back(entityID);
+            }
+        }
+    });
+    return tree;
+}
+
+static void sortedCompare(QVector<QUuid> actual, QVector<QUuid> expected) {
+    std::sort(actual.begin(), actual.end());
+    std::sort(expected.begin(), expected.end());
+    QCOMPARE(actual, expected);
+}
+
+void EntityTreeContentionBenchmarks::initTestCase() {
+    DependencyManager::set<StatTracker>();
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<NodeList>(NodeType::EntityServer, INVALID_PORT);
+}
+
+void EntityTreeContentionBenchmarks::testSnapshotMatchesTree() {
+    QVector<EntityItemID> entityIDs;
+    EntityTreePointer tree = makeTree(2000, entityIDs);
+    QCOMPARE(entityIDs.size(), 2000);
+
+    auto snapshot = tree->getReadSnapshot();
+    QCOMPARE((int)snapshot->getEntityCount(), entityIDs.size());
+
+    PickFilter searchFilter(PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES));
+    std::mt19937 generator(1);
+    for (int i = 0; i < 20; i++) {
+        glm::vec3 center = randomPosition(generator);
+        QVector<QUuid> fromTree, fromSnapshot;
+
+        tree->withReadLock([&] {
+            tree->evalEntitiesInSphere(center, QUERY_RADIUS, searchFilter, fromTree);
+        });
+        snapshot->evalEntitiesInSphere(center, QUERY_RADIUS, searchFilter, fromSnapshot);
+        sortedCompare(fromSnapshot, fromTree);
+
+        tree->withReadLock([&] {
+            tree->evalEntitiesInSphereWithName(center, 2.0f * QUERY_RADIUS, "BOX 3", false, searchFilter, fromTree);
+        });
+        snapshot->evalEntitiesInSphereWithName(center, 2.0f * QUERY_RADIUS, "BOX 3", false, searchFilter, fromSnapshot);
+        sortedCompare(fromSnapshot, fromTree);
+
+        AABox box(center, glm::vec3(QUERY_RADIUS));
+        tree->withReadLock([&] {
+            tree->evalEntitiesInBox(box, searchFilter, fromTree);
+        });
+        snapshot->evalEntitiesInBox(box, searchFilter, fromSnapshot);
+        sortedCompare(fromSnapshot, fromTree);
+    }
+}
+
+void EntityTreeContentionBenchmarks::testSnapshotFollowsEdits() {
+    QVector<EntityItemID> entityIDs;
+    EntityTreePointer tree = makeTree(100, entityIDs);
+    PickFilter searchFilter(PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES));
+    QCOMPARE(tree->getReadSnapshotTolerance(), (quint64)0);
+
+    // a location nothing else is near
+    glm::vec3 target(-WORLD_SIZE / 2.0f);
+    auto before = tree->getReadSnapshot();
+    QVector<QUuid> found;
+    before->evalEntitiesInSphere(target, QUERY_RADIUS, searchFilter, found);
+    QVERIFY(found.isEmpty());
+
+    EntityItemProperties properties;
+    properties.setPosition(target);
+    tree->withWriteLock([&] {
+        QVERIFY(tree->updateEntity(entityIDs[0], properties));
+    });
+
+    // the old snapshot doesn't change under its readers, the next one sees the edit
+    before->evalEntitiesInSphere(target, QUERY_RADIUS, searchFilter, found);
+    QVERIFY(found.isEmpty());
+    auto after = tree->getReadSnapshot();
+    QVERIFY(after->getEpoch() > before->getEpoch());
+    after->evalEntitiesInSphere(target, QUERY_RADIUS, searchFilter, found);
+    QCOMPARE(found, QVector<QUuid>({ entityIDs[0] }));
+
+    // within the tolerance readers keep the snapshot they have
+    tree->setReadSnapshotTolerance(USECS_PER_SECOND * 60);
+    tree->withWriteLock([&] {
+        tree->deleteEntity(entityIDs[0], true);
+    });
+    QVERIFY(tree->getReadSnapshot() == after);
+    tree->setReadSnapshotTolerance(0);
+    tree->getReadSnapshot()->evalEntitiesInSphere(target, QUERY_RADIUS, searchFilter, found);
+    QVERIFY(found.isEmpty());
+}
+
+enum class QueryMode {
+    TreeLock,
+    Snapshot,
+    FrameToleranceSnapshot,
+    TolerantSnapshot
+};
+
+void EntityTreeContentionBenchmarks::benchmark() {
+    const int NUM_ENTITIES = 20000;
+    const int NUM_QUERY_THREADS = std::max(2, (int)std::thread::hardware_concurrency() - 1);
+    const quint64 SNAPSHOT_TOLERANCE = 50 * USECS_PER_MSEC;
+
+    QVector<EntityItemID> entityIDs;
+    EntityTreePointer tree = makeTree(NUM_ENTITIES, entityIDs);
+    PickFilter searchFilter(PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES));
+
+    // queries/s and edits/s are what the tolerance buys, the age of the snapshots the queries ran against is its cost
+    for (QueryMode mode : { QueryMode::TreeLock, QueryMode::Snapshot, QueryMode::FrameToleranceSnapshot,
+                            QueryMode::TolerantSnapshot }) {
+        quint64 tolerance = 0;
+        if (mode == QueryMode::FrameToleranceSnapshot) {
+            tolerance = EntityTree::FRAME_READ_SNAPSHOT_TOLERANCE;
+        } else if (mode == QueryMode::TolerantSnapshot) {
+            tolerance = SNAPSHOT_TOLERANCE;
+        }
+        tree->setReadSnapshotTolerance(tolerance);
+
+        std::atomic<bool> running { true };
+        std::atomic<uint64_t> numQueries { 0 };
+        std::atomic<uint64_t> numEdits { 0 };
+        std::atomic<uint64_t> totalSnapshotAge { 0 };
+
+        // the edit thread applies batches the way OctreeInboundPacketProcessor does, one write lock per batch
+        std::thread editThread([&] {
+            std::mt19937 generator(2);
+            std::uniform_int_distribution<int> pick(0, entityIDs.size() - 1);
+            while (running) {
+                tree->withWriteLock([&] {
+                    for (int i = 0; i < EDITS_PER_BATCH; i++) {
+                        EntityItemProperties properties;
+                        properties.setPosition(randomPosition(generator));
+                        tree->updateEntity(entityIDs[pick(generator)], properties);
+                    }
+                });
+                numEdits += EDITS_PER_BATCH;
+                std::this_thread::yield();
+            }
+        });
+
+        std::vector<std::thread> queryThreads;
+        for (int t = 0; t < NUM_QUERY_THREADS; t++) {
+            queryThreads.emplace_back([&, t] {
+                std::mt19937 generator(t + 3);
+                QVector<QUuid> found;
+                while (running) {
+                    glm::vec3 center = randomPosition(generator);
+                    if (mode == QueryMode::TreeLock) {
+                        tree->withReadLock([&] {
+                            tree->evalEntitiesInSphere(center, QUERY_RADIUS, searchFilter, found);
+                        });
+                    } else {
+                        auto snapshot = tree->getReadSnapshot();
+                        snapshot->evalEntitiesInSphere(center, QUERY_RADIUS, searchFilter, found);
+                        totalSnapshotAge += usecTimestampNow() - snapshot->getCaptureTime();
+                    }
+                    numQueries++;
+                }
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(BENCHMARK_MSECS));
+        running = false;
+        editThread.join();
+        for (auto& thread : queryThreads) {
+            thread.join();
+        }
+
+        static const char* MODE_NAMES[] = { "tree lock", "snapshot", "snapshot frame tolerance", "snapshot 50ms tolerance" };
+        float seconds = (float)BENCHMARK_MSECS / MSECS_PER_SECOND;
+        qDebug().nospace() << MODE_NAMES[(int)mode] << ": " << NUM_QUERY_THREADS << " query threads "
+            << (numQueries / seconds) << " queries/s, " << (numEdits / seconds) << " edits/s, "
+            << (mode == QueryMode::TreeLock ? 0 : totalSnapshotAge / std::max<uint64_t>(numQueries, 1))
+            << " us average snapshot age";
+    }
+    tree->setReadSnapshotTolerance(EntityTree::DEFAULT_READ_SNAPSHOT_TOLERANCE);
+}
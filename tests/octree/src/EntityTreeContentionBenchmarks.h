@@ -0,0 +1,27 @@
+//
+//  EntityTreeContentionBenchmarks.h
+//  tests/octree/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeContentionBenchmarks_h
+#define hifi_EntityTreeContentionBenchmarks_h
+
+#include <QtTest/QtTest>
+
+class EntityTreeContentionBenchmarks : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testSnapshotMatchesTree();
+    void testSnapshotFollowsEdits();
+    void benchmark();
+};
+
+#endif // hifi_EntityTreeContentionBenchmarks_h
@@ -0,0 +1,110 @@
+//
+//  NativeEntityEditFilterTests.cpp
+//  tests/octree/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NativeEntityEditFilterTests.h"
+
+#include <NativeEntityEditFilter.h>
+
+QTEST_MAIN(NativeEntityEditFilterTests)
+
+static NativeEntityEditFilter::Pointer compile(const char* description) {
+    QString error;
+    auto filter = NativeEntityEditFilter::compile(QByteArray(description), error);
+    if (!filter) {
+        qDebug() << error;
+    }
+    return filter;
+}
+
+static bool filter(const NativeEntityEditFilter::Pointer& filter, EntityItemProperties& properties, bool& wasChanged,
+                   const QUuid& senderID = QUuid::createUuid()) {
+    NativeEntityEditFilter::Edit edit;
+    edit.filterType = EntityTree::FilterType::Edit;
+    edit.senderID = senderID;
+    wasChanged = false;
+    return filter->filter(edit, properties, properties, wasChanged);
+}
+
+void NativeEntityEditFilterTests::testRejectsUnknownDescriptions() {
+    QVERIFY(NativeEntityEditFilter::isNativeFilter("{ \"clamp\": {} }"));
+    QVERIFY(!NativeEntityEditFilter::isNativeFilter("function filter(properties) { return properties; }"));
+
+    QVERIFY(compile("{}"));
+    QVERIFY(!compile("{ \"script\": true }"));
+    QVERIFY(!compile("{ \"properties\": { \"allow\": [ \"notAProperty\" ] } }"));
+    QVERIFY(!compile("{ \"clamp\": { \"color\": { \"max\": 1 } } }"));
+    QVERIFY(!compile("{ \"rateLimit\": { \"editsPerSecond\": 0 } }"));
+
+    auto deletes = compile("{ \"filterTypes\": [ \"delete\" ] }");
+    QVERIFY(deletes);
+    QVERIFY(deletes->wantsToFilterDelete() && !deletes->wantsToFilterEdit());
+}
+
+void NativeEntityEditFilterTests::testPropertyLists() {
+    auto filterPointer = compile("{ \"properties\": { \"allow\": [ \"position\", \"rotation\" ], \"deny\": [ \"rotation\" ] } }");
+    QVERIFY(filterPointer);
+    bool wasChanged;
+
+    EntityItemProperties moved;
+    moved.setPosition(glm::vec3(1.0f));
+    QVERIFY(filter(filterPointer, moved, wasChanged));
+    QVERIFY(!wasChanged);
+
+    EntityItemProperties renamed;
+    renamed.setPosition(glm::vec3(1.0f));
+    renamed.setName("renamed");
+    QVERIFY(!filter(filterPointer, renamed, wasChanged));
+
+    EntityItemProperties rotated;
+    rotated.setRotation(glm::quat());
+    QVERIFY(!filter(filterPointer, rotated, wasChanged));
+}
+
+void NativeEntityEditFilterTests::testClamps() {
+    auto filterPointer = compile("{ \"clamp\": { \"position\": { \"min\": [ 0, 0, 0 ], \"max\": { \"x\": 10, \"y\": 10, \"z\": 10 } },"
+                                 " \"velocity\": { \"maxLength\": 2 }, \"lifetime\": { \"max\": 60 } } }");
+    QVERIFY(filterPointer);
+    bool wasChanged;
+
+    EntityItemProperties inside;
+    inside.setPosition(glm::vec3(5.0f));
+    inside.setVelocity(glm::vec3(1.0f, 0.0f, 0.0f));
+    inside.setLifetime(30.0f);
+    QVERIFY(filter(filterPointer, inside, wasChanged));
+    QVERIFY(!wasChanged);
+
+    EntityItemProperties outside;
+    outside.setPosition(glm::vec3(-5.0f, 5.0f, 20.0f));
+    outside.setVelocity(glm::vec3(0.0f, 4.0f, 0.0f));
+    outside.setLifetime(ENTITY_ITEM_IMMORTAL_LIFETIME);
+    QVERIFY(filter(filterPointer, outside, wasChanged));
+    QVERIFY(wasChanged);
+    QCOMPARE(outside.getPosition(), glm::vec3(0.0f, 5.0f, 10.0f));
+    QCOMPARE(outside.getVelocity(), glm::vec3(0.0f, 2.0f, 0.0f));
+    QCOMPARE(outside.getLifetime(), 60.0f);
+}
+
+void NativeEntityEditFilterTests::testRateLimit() {
+    auto filterPointer = compile("{ \"rateLimit\": { \"editsPerSecond\": 1, \"burst\": 3 } }");
+    QVERIFY(filterPointer);
+    bool wasChanged;
+
+    QUuid sender = QUuid::createUuid();
+    for (int i = 0; i < 3; i++) {
+        EntityItemProperties properties;
+        QVERIFY(filter(filterPointer, properties, wasChanged, sender));
+    }
+    EntityItemProperties properties;
+    QVERIFY(!filter(filterPointer, properties, wasChanged, sender));
+
+    // the limit is per sender
+    QVERIFY(filter(filterPointer, properties, wasChanged, QUuid::createUuid()));
+}
@@ -0,0 +1,27 @@
+//
+//  NativeEntityEditFilterTests.h
+//  tests/octree/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NativeEntityEditFilterTests_h
+#define hifi_NativeEntityEditFilterTests_h
+
+#include <QtTest/QtTest>
+
+class NativeEntityEditFilterTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRejectsUnknownDescriptions();
+    void testPropertyLists();
+    void testClamps();
+    void testRateLimit();
+};
+
+#endif // hifi_NativeEntityEditFilterTests_h
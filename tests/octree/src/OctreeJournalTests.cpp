@@ -0,0 +1,151 @@
+//
+//  OctreeJournalTests.cpp
+//  tests/octree/src
+//
+//  Created by Roxanne Skelly on 2019-06-18.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeJournalTests.h"
+
+#include <QtCore/QTemporaryDir>
+
+#include <OctreeJournal.h>
+
+QTEST_MAIN(OctreeJournalTests)
+
+using Record = OctreeJournal::Record;
+using RecordType = OctreeJournal::RecordType;
+
+static void writeSnapshot(OctreeJournal& journal, const QUuid& id, int64_t dataVersion, const OctreeJournal::Records& records) {
+    QVERIFY(journal.beginSnapshot(id, dataVersion, "paths"));
+    for (const auto& record : records) {
+        QVERIFY(journal.writeSnapshotRecord(record));
+    }
+    QVERIFY(journal.commitSnapshot());
+}
+
+void OctreeJournalTests::testReplay() {
+    QTemporaryDir directory;
+    OctreeJournal journal(directory.filePath("models"));
+
+    QUuid treeID = QUuid::createUuid();
+    QUuid a = QUuid::createUuid();
+    QUuid b = QUuid::createUuid();
+    QUuid c = QUuid::createUuid();
+
+    writeSnapshot(journal, treeID, 3, { { RecordType::Upsert, a, "a0" }, { RecordType::Upsert, b, "b0" } });
+    QVERIFY(journal.hasSnapshot());
+
+    QVERIFY(journal.append({ { RecordType::Upsert, a, "a1" }, { RecordType::Upsert, c, "c0" },
+                             { RecordType::Version, QUuid(), OctreeJournal::encodeVersion(4) } }));
+    QVERIFY(journal.append({ { RecordType::Delete, b, QByteArray() }, { RecordType::Upsert, c, "c1" },
+                             { RecordType::Version, QUuid(), OctreeJournal::encodeVersion(5) } }));
+
+    OctreeJournal::Contents contents;
+    QVERIFY(journal.load(contents));
+    QCOMPARE(contents.id, treeID);
+    QCOMPARE(contents.dataVersion, (int64_t)5);
+    QCOMPARE(contents.treeData, QByteArray("paths"));
+
+    // the latest state of each id that is still alive, in the order they first appeared
+    QCOMPARE((int)contents.records.size(), 2);
+    QCOMPARE(contents.records[0].id, a);
+    QCOMPARE(contents.records[0].data, QByteArray("a1"));
+    QCOMPARE(contents.records[1].id, c);
+    QCOMPARE(contents.records[1].data, QByteArray("c1"));
+}
+
+void OctreeJournalTests::testTornAppend() {
+    QTemporaryDir directory;
+    QUuid a = QUuid::createUuid();
+    QUuid b = QUuid::createUuid();
+
+    {
+        OctreeJournal journal(directory.filePath("models"));
+        writeSnapshot(journal, QUuid::createUuid(), 1, {});
+        QVERIFY(journal.append({ { RecordType::Upsert, a, "a0" } }));
+    }
+
+    // cut the next append short, as a crash in the middle of the write would
+    QFile journalFile(directory.filePath("models.journal"));
+    QVERIFY(journalFile.open(QIODevice::ReadWrite | QIODevice::Append));
+    qint64 completeSize = journalFile.size();
+    journalFile.write(QByteArray("\x40\x00\x00\x00\x01partial", 12));
+    journalFile.close();
+
+    OctreeJournal journal(directory.filePath("models"));
+    OctreeJournal::Contents contents;
+    QVERIFY(journal.load(contents));
+    QCOMPARE((int)contents.records.size(), 1);
+    QCOMPARE(QFileInfo(journalFile.fileName()).size(), completeSize);
+
+    // appends made after the damage has been cut away are read back
+    QVERIFY(journal.append({ { RecordType::Upsert, b, "b0" } }));
+    QVERIFY(journal.load(contents));
+    QCOMPARE((int)contents.records.size(), 2);
+    QCOMPARE(contents.records[1].data, QByteArray("b0"));
+}
+
+void OctreeJournalTests::testUnfinishedCompaction() {
+    QTemporaryDir directory;
+    OctreeJournal journal(directory.filePath("models"));
+    QUuid a = QUuid::createUuid();
+    QUuid b = QUuid::createUuid();
+
+    writeSnapshot(journal, QUuid::createUuid(), 1, {});
+    QVERIFY(journal.append({ { RecordType::Upsert, a, "a0" } }));
+    QVERIFY(journal.rotate());
+
+    // a compaction that never commits leaves the previous snapshot and the rotated journal in place
+    QVERIFY(journal.beginSnapshot(QUuid::createUuid(), 2, QByteArray()));
+    journal.abortSnapshot();
+
+    QVERIFY(journal.append({ { RecordType::Upsert, b, "b0" } }));
+    QVERIFY(journal.rotate());
+    QVERIFY(QFile::exists(journal.getRotatedJournalFilename()));
+    QVERIFY(!QFile::exists(journal.getJournalFilename()));
+
+    OctreeJournal::Contents contents;
+    QVERIFY(journal.load(contents));
+    QCOMPARE((int)contents.records.size(), 2);
+    QCOMPARE(contents.dataVersion, (int64_t)1);
+
+    // committing a snapshot folds the rotated journal away
+    writeSnapshot(journal, contents.id, 2, contents.records);
+    QVERIFY(!QFile::exists(journal.getRotatedJournalFilename()));
+    QVERIFY(journal.load(contents));
+    QCOMPARE((int)contents.records.size(), 2);
+    QCOMPARE(contents.dataVersion, (int64_t)2);
+}
+
+void OctreeJournalTests::testMoveAside() {
+    QTemporaryDir directory;
+    OctreeJournal journal(directory.filePath("models"));
+    QUuid treeID = QUuid::createUuid();
+    QUuid a = QUuid::createUuid();
+
+    writeSnapshot(journal, treeID, 1, { { RecordType::Upsert, a, "a0" } });
+    QVERIFY(journal.append({ { RecordType::Upsert, a, "a1" } }));
+
+    // a damaged snapshot is kept where it can be recovered from, not loaded
+    QVERIFY(journal.moveAside(".damaged"));
+    QVERIFY(!journal.hasSnapshot());
+    QVERIFY(!QFile::exists(journal.getJournalFilename()));
+
+    QVERIFY(QFile::exists(journal.getSnapshotFilename() + ".damaged"));
+    QVERIFY(QFile::exists(journal.getJournalFilename() + ".damaged"));
+
+    // and moving it back restores it as it was
+    QVERIFY(QFile::rename(journal.getSnapshotFilename() + ".damaged", journal.getSnapshotFilename()));
+    QVERIFY(QFile::rename(journal.getJournalFilename() + ".damaged", journal.getJournalFilename()));
+
+    OctreeJournal::Contents contents;
+    QVERIFY(journal.load(contents));
+    QCOMPARE(contents.id, treeID);
+    QCOMPARE((int)contents.records.size(), 1);
+    QCOMPARE(contents.records[0].data, QByteArray("a1"));
+}
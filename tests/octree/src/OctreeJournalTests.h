@@ -0,0 +1,27 @@
+//
+//  OctreeJournalTests.h
+//  tests/octree/src
+//
+//  Created by Roxanne Skelly on 2019-06-18.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeJournalTests_h
+#define hifi_OctreeJournalTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeJournalTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testReplay();
+    void testTornAppend();
+    void testUnfinishedCompaction();
+    void testMoveAside();
+};
+
+#endif // hifi_OctreeJournalTests_h
@@ -0,0 +1,189 @@
+//
+//  PhysicsStepBenchmarks.cpp
+//  tests/physics/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PhysicsStepBenchmarks.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+
+#include <BulletUtil.h>
+#include <NumericalConstants.h>
+#include <ObjectMotionState.h>
+#include <PhysicsCollisionGroups.h>
+#include <PhysicsEngine.h>
+#include <PhysicsHelpers.h>
+#include <ShapeManager.h>
+
+QTEST_GUILESS_MAIN(PhysicsStepBenchmarks)
+
+static const float BOX_HALF_EXTENT = 0.25f;
+static const int PILE_SIDE = 5;
+static const int PILE_HEIGHT = 4;
+static const int BOXES_PER_PILE = PILE_SIDE * PILE_SIDE * PILE_HEIGHT;
+static const float PILE_SPACING = 4.0f;
+static const float DROP_GAP = 0.02f;
+static const float GRAVITY = -9.8f;
+static const uint32_t SUBSTEPS_PER_SECOND = (uint32_t)(1.0f / PHYSICS_ENGINE_FIXED_SUBSTEP);
+
+static ShapeManager shapeManager;
+
+// a box that stays where the engine puts it, with nothing to sync back to
+class BoxMotionState : public ObjectMotionState {
+public:
+    BoxMotionState(const glm::vec3& position, const glm::vec3& halfExtents, bool isStatic) :
+        ObjectMotionState(nullptr),
+        _id(QUuid::createUuid()),
+        _isStatic(isStatic)
+    {
+        _type = MOTIONSTATE_TYPE_ENTITY;
+        _transform.setIdentity();
+        _transform.setOrigin(glmToBullet(position));
+
+        ShapeInfo info;
+        info.setBox(halfExtents);
+        setShape(getShapeManager()->getShape(info));
+    }
+
+    void getWorldTransform(btTransform& worldTrans) const override { worldTrans = _transform; }
+    void setWorldTransform(const btTransform& worldTrans) override { _transform = worldTrans; }
+
+    uint32_t getIncomingDirtyFlags() override { return 0; }
+    void clearIncomingDirtyFlags() override { }
+
+    PhysicsMotionType computePhysicsMotionType() const override {
+        return _isStatic ? MOTION_TYPE_STATIC : MOTION_TYPE_DYNAMIC;
+    }
+    bool isMoving() const override { return !_isStatic; }
+
+    float getObjectRestitution() const override { return 0.2f; }
+    float getObjectFriction() const override { return 0.5f; }
+    float getObjectLinearDamping() const override { return 0.0f; }
+    float getObjectAngularDamping() const override { return 0.0f; }
+
+    glm::vec3 getObjectPosition() const override { return bulletToGLM(_transform.getOrigin()); }
+    glm::quat getObjectRotation() const override { return bulletToGLM(_transform.getRotation()); }
+    glm::vec3 getObjectLinearVelocity() const override { return glm::vec3(0.0f); }
+    glm::vec3 getObjectAngularVelocity() const override { return glm::vec3(0.0f); }
+    glm::vec3 getObjectGravity() const override { return glm::vec3(0.0f, _isStatic ? 0.0f : GRAVITY, 0.0f); }
+
+    const QUuid getObjectID() const override { return _id; }
+    QUuid getSimulatorID() const override { return QUuid(); }
+
+    void computeCollisionGroupAndMask(int32_t& group, int32_t& mask) const override {
+        group = _isStatic ? BULLET_COLLISION_GROUP_STATIC : BULLET_COLLISION_GROUP_DYNAMIC;
+        mask = _isStatic ? BULLET_COLLISION_MASK_STATIC : BULLET_COLLISION_MASK_DYNAMIC;
+    }
+
+protected:
+    bool isReadyToComputeShape() const override { return true; }
+    const btCollisionShape* computeNewShape() override { return _shape; }
+
+private:
+    btTransform _transform;
+    QUuid _id;
+    bool _isStatic;
+};
+
+// piles of touching boxes dropped on a floor, each pile is one island
+class Scene {
+public:
+    Scene(int numBoxes) : _engine(glm::vec3(0.0f)) {
+        _engine.init();
+
+        _objects.push_back(new BoxMotionState(glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(500.0f, 1.0f, 500.0f), true));
+
+        int numPiles = (numBoxes + BOXES_PER_PILE - 1) / BOXES_PER_PILE;
+        int pilesPerRow = (int)ceilf(sqrtf((float)numPiles));
+        float boxSize = 2.0f * BOX_HALF_EXTENT;
+        for (int i = 0; i < numBoxes; ++i) {
+            int pile = i / BOXES_PER_PILE;
+            int box = i % BOXES_PER_PILE;
+            glm::vec3 pileCorner((pile % pilesPerRow) * PILE_SPACING, 0.0f, (pile / pilesPerRow) * PILE_SPACING);
+            glm::vec3 offset((box % PILE_SIDE) * boxSize, (box / (PILE_SIDE * PILE_SIDE)) * (boxSize + DROP_GAP),
+                             ((box / PILE_SIDE) % PILE_SIDE) * boxSize);
+            glm::vec3 position = pileCorner + offset + glm::vec3(BOX_HALF_EXTENT, BOX_HALF_EXTENT + DROP_GAP, BOX_HALF_EXTENT);
+            _objects.push_back(new BoxMotionState(position, glm::vec3(BOX_HALF_EXTENT), false));
+        }
+
+        _engine.addObjects(_objects);
+    }
+
+    ~Scene() {
+        _engine.removeObjects(_objects);
+        for (auto object : _objects) {
+            delete object;
+        }
+    }
+
+    // returns the seconds spent in the steps that advanced the simulation
+    double step(uint32_t numSubsteps) {
+        double seconds = 0.0;
+        uint32_t endStep = _engine.getNumSubsteps() + numSubsteps;
+        while (_engine.getNumSubsteps() < endStep) {
+            uint32_t lastStep = _engine.getNumSubsteps();
+            QElapsedTimer timer;
+            timer.start();
+            _engine.stepSimulation();
+            _engine.getChangedMotionStates();
+            _engine.getCollisionEvents();
+            if (_engine.getNumSubsteps() > lastStep) {
+                seconds += (double)timer.nsecsElapsed() / NSECS_PER_SECOND;
+            } else {
+                // the engine steps in real time, wait for the next substep to come due
+                QThread::usleep(100);
+            }
+        }
+        return seconds;
+    }
+
+    const VectorOfMotionStates& getObjects() const { return _objects; }
+
+private:
+    PhysicsEngine _engine;
+    VectorOfMotionStates _objects;
+};
+
+void PhysicsStepBenchmarks::initTestCase() {
+    ObjectMotionState::setShapeManager(&shapeManager);
+}
+
+void PhysicsStepBenchmarks::cleanupTestCase() {
+    PhysicsEngine::setNumSolverThreads(1);
+}
+
+void PhysicsStepBenchmarks::testPilesStayOnFloor() {
+    PhysicsEngine::setNumSolverThreads(0);
+
+    Scene scene(10 * BOXES_PER_PILE);
+    scene.step(2 * SUBSTEPS_PER_SECOND);
+
+    for (auto object : scene.getObjects()) {
+        btVector3 position = object->getRigidBody()->getWorldTransform().getOrigin();
+        QVERIFY(!std::isnan(position.getY()));
+        if (object->getMotionType() == MOTION_TYPE_DYNAMIC) {
+            QVERIFY(position.getY() > 0.5f * BOX_HALF_EXTENT);
+        }
+    }
+}
+
+void PhysicsStepBenchmarks::benchmark() {
+    for (int numThreads : { 1, 0 }) {
+        PhysicsEngine::setNumSolverThreads(numThreads);
+
+        for (int numBoxes : { 500, 1000, 2000, 4000 }) {
+            Scene scene(numBoxes);
+            double seconds = scene.step(SUBSTEPS_PER_SECOND);
+
+            qDebug().nospace() << "threads " << PhysicsEngine::getNumSolverThreads() << ": " << numBoxes << " boxes "
+                << (seconds * MSECS_PER_SECOND / SUBSTEPS_PER_SECOND) << "ms per substep";
+        }
+    }
+}
@@ -16,6 +16,7 @@
 
 #include <QtGlobal>
 #include <QtTest/QtTest>
+#include <QtCore/QBuffer>
 #include <QtCore/QTemporaryFile>
 #include <QtCore/QString>
 
@@ -23,12 +24,16 @@
 #pragma clang diagnostic pop
 #endif
 
+#include <cstring>
+#include <functional>
+
 #ifdef Q_OS_WIN32
 #include <Windows.h>
 #endif
 
 #include <recording/Clip.h>
 #include <recording/Frame.h>
+#include <recording/impl/ColumnarClip.h>
 
 #include <SharedUtil.h>
 
@@ -119,10 +124,229 @@ void testClipOrdering() {
     Q_UNUSED(lastFrameTimeOffset); // FIXME - Unix build not yet upgraded to Qt 5.5.1 we can remove this once it is
 }
 
+// big enough frames that the clip spans several chunks
+static const int COLUMNAR_FRAME_COUNT = 40;
+static const int COLUMNAR_FRAME_SIZE = 10000;
+static const Frame::Time COLUMNAR_FRAME_INTERVAL = 10;
+
+static Clip::Pointer makeColumnarSourceClip() {
+    auto clip = Clip::newClip();
+    for (int i = 0; i < COLUMNAR_FRAME_COUNT; ++i) {
+        auto frame = std::make_shared<Frame>();
+        frame->type = TEST_FRAME_TYPE;
+        frame->timeOffset = i * COLUMNAR_FRAME_INTERVAL;
+        frame->data = QByteArray(COLUMNAR_FRAME_SIZE + i, (char)('a' + i % 26));
+        clip->addFrame(frame);
+    }
+    return clip;
+}
+
+static QByteArray writeColumnar(const Clip::Pointer& clip, bool compressed) {
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    if (!ColumnarClip::write(buffer, clip, compressed)) {
+        return QByteArray();
+    }
+    return buffer.data();
+}
+
+static ColumnarClip::FileHeader readColumnarHeader(const QByteArray& data) {
+    ColumnarClip::FileHeader header;
+    memcpy(&header, data.constData(), sizeof(ColumnarClip::FileHeader));
+    return header;
+}
+
+// the chunk table is the last of the 8 byte aligned sections ahead of the chunk data
+static size_t columnarChunkTableOffset(const ColumnarClip::FileHeader& header) {
+    auto align = [](size_t offset) { return (offset + 7) & ~(size_t)7; };
+    size_t offset = align(sizeof(ColumnarClip::FileHeader));
+    offset = align(offset + header.typeMapSize);
+    offset = align(offset + header.frameCount * sizeof(Frame::Time));
+    offset = align(offset + header.frameCount * sizeof(uint32_t));
+    offset = align(offset + header.frameCount * sizeof(uint32_t));
+    return align(offset + header.frameCount * sizeof(FrameType));
+}
+
+static ColumnarClip::ChunkHeader* columnarChunk(QByteArray& data, size_t index) {
+    auto header = readColumnarHeader(data);
+    return reinterpret_cast<ColumnarClip::ChunkHeader*>(data.data() + columnarChunkTableOffset(header)) + index;
+}
+
+static void compareColumnarClip(const Clip::Pointer& readClip, const Clip::Pointer& writeClip) {
+    readClip->seek(0);
+    writeClip->seek(0);
+
+    size_t count = 0;
+    auto readFrame = readClip->nextFrame();
+    auto writeFrame = writeClip->nextFrame();
+    for (; readFrame && writeFrame; readFrame = readClip->nextFrame(), writeFrame = writeClip->nextFrame(), ++count) {
+        QVERIFY(readFrame->type == writeFrame->type);
+        QVERIFY(readFrame->timeOffset == writeFrame->timeOffset);
+        QVERIFY(readFrame->data == writeFrame->data);
+    }
+    QVERIFY(!readFrame && !writeFrame);
+    QVERIFY(writeClip->frameCount() == count);
+    QVERIFY(readClip->frameCount() == count);
+    QVERIFY(readClip->duration() == writeClip->duration());
+}
+
+void testColumnarClipPersist() {
+    auto writeClip = makeColumnarSourceClip();
+
+    QByteArray compressedData;
+    for (bool compressed : { true, false }) {
+        auto data = writeColumnar(writeClip, compressed);
+        QVERIFY(!data.isEmpty());
+        QVERIFY(ColumnarClip::isColumnar(reinterpret_cast<const uint8_t*>(data.constData()), data.size()));
+        QVERIFY(readColumnarHeader(data).chunkCount > 1);
+        if (compressed) {
+            compressedData = data;
+        } else {
+            QVERIFY(compressedData.size() < data.size());
+        }
+
+        auto bufferClip = ColumnarClip::fromBuffer(data, "columnar buffer");
+        QVERIFY(bufferClip);
+        compareColumnarClip(bufferClip, writeClip);
+
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        QString fileName = file.fileName();
+        file.close();
+        QVERIFY(ColumnarClip::write(fileName, writeClip, compressed));
+        QVERIFY(ColumnarClip::isColumnarFile(fileName));
+        auto fileClip = ColumnarClip::fromFile(fileName);
+        QVERIFY(fileClip);
+        compareColumnarClip(fileClip, writeClip);
+    }
+
+    // the record based format isn't mistaken for a columnar one
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QString fileName = file.fileName();
+    file.close();
+    Clip::toFile(fileName, writeClip);
+    QVERIFY(!ColumnarClip::isColumnarFile(fileName));
+    QVERIFY(!ColumnarClip::fromFile(fileName));
+}
+
+void testColumnarClipSeek() {
+    auto writeClip = makeColumnarSourceClip();
+    for (bool compressed : { true, false }) {
+        auto readClip = ColumnarClip::fromBuffer(writeColumnar(writeClip, compressed), "columnar seek");
+        QVERIFY(readClip);
+
+        // backwards, so every chunk boundary is crossed going back to the previous chunk
+        for (int i = COLUMNAR_FRAME_COUNT - 1; i >= 0; --i) {
+            readClip->seekFrameTime(i * COLUMNAR_FRAME_INTERVAL);
+            QVERIFY(readClip->positionFrameTime() == i * COLUMNAR_FRAME_INTERVAL);
+            auto frame = readClip->peekFrame();
+            QVERIFY(frame);
+            QVERIFY(frame->timeOffset == i * COLUMNAR_FRAME_INTERVAL);
+            QVERIFY(frame->data == QByteArray(COLUMNAR_FRAME_SIZE + i, (char)('a' + i % 26)));
+        }
+
+        // jumping between the ends, and landing between frames picks the next one
+        for (int i = 0; i < COLUMNAR_FRAME_COUNT / 2; ++i) {
+            for (int index : { i, COLUMNAR_FRAME_COUNT - 1 - i }) {
+                Frame::Time time = index * COLUMNAR_FRAME_INTERVAL;
+                readClip->seekFrameTime(index > 0 ? time - COLUMNAR_FRAME_INTERVAL / 2 : time);
+                auto frame = readClip->nextFrame();
+                QVERIFY(frame);
+                QVERIFY(frame->timeOffset == index * COLUMNAR_FRAME_INTERVAL);
+                QVERIFY(frame->data.size() == COLUMNAR_FRAME_SIZE + index);
+                QVERIFY(frame->data.at(0) == (char)('a' + index % 26));
+            }
+        }
+
+        readClip->seekFrameTime(COLUMNAR_FRAME_COUNT * COLUMNAR_FRAME_INTERVAL);
+        QVERIFY(readClip->positionFrameTime() == Frame::INVALID_TIME);
+        QVERIFY(!readClip->nextFrame());
+    }
+}
+
+void testColumnarClipUnknownFrames() {
+    auto writeClip = Clip::newClip();
+    // Simulate an unknown frametype, including as the first frame
+    for (Frame::Time time = 0; time < 100; time += 10) {
+        FrameType type = (time % 20 == 0) ? Frame::TYPE_INVALID - 1 : TEST_FRAME_TYPE;
+        auto frame = std::make_shared<Frame>();
+        frame->type = type;
+        frame->timeOffset = time;
+        frame->data = QByteArray(16, (char)time);
+        writeClip->addFrame(frame);
+    }
+
+    auto readClip = ColumnarClip::fromBuffer(writeColumnar(writeClip, true), "columnar unknown frames");
+    QVERIFY(readClip);
+
+    // the unknown frames are passed over, from the start and after seeks onto them
+    QVERIFY(readClip->positionFrameTime() == 10);
+    Frame::Time expectedTime = 10;
+    for (auto frame = readClip->nextFrame(); frame; frame = readClip->nextFrame(), expectedTime += 20) {
+        QVERIFY(frame->type == TEST_FRAME_TYPE);
+        QVERIFY(frame->timeOffset == expectedTime);
+        QVERIFY(frame->data == QByteArray(16, (char)expectedTime));
+    }
+    QVERIFY(expectedTime == 110);
+
+    readClip->seekFrameTime(40);
+    QVERIFY(readClip->positionFrameTime() == 50);
+    readClip->skipFrame();
+    QVERIFY(readClip->positionFrameTime() == 70);
+}
+
+void testColumnarClipCorruption() {
+    auto writeClip = makeColumnarSourceClip();
+    const QByteArray data = writeColumnar(writeClip, true);
+    QVERIFY(ColumnarClip::fromBuffer(data, "columnar intact"));
+
+    auto header = readColumnarHeader(data);
+    QVERIFY(header.chunkCount > 2);
+
+    // truncated anywhere, through the header, the columns, the chunk table or the chunk data
+    for (int size : { 0, 3, (int)sizeof(ColumnarClip::FileHeader) - 1, (int)sizeof(ColumnarClip::FileHeader),
+                      (int)columnarChunkTableOffset(header), data.size() / 2, data.size() - 1 }) {
+        QVERIFY(!ColumnarClip::fromBuffer(data.left(size), "columnar truncated"));
+    }
+
+    auto corrupt = [&](const std::function<void(QByteArray&)>& corruption) {
+        QByteArray corrupted = data;
+        corruption(corrupted);
+        return ColumnarClip::fromBuffer(corrupted, "columnar corrupt");
+    };
+    auto corruptHeader = [&](const std::function<void(ColumnarClip::FileHeader&)>& corruption) {
+        return corrupt([&](QByteArray& corrupted) {
+            auto corruptedHeader = readColumnarHeader(corrupted);
+            corruption(corruptedHeader);
+            memcpy(corrupted.data(), &corruptedHeader, sizeof(ColumnarClip::FileHeader));
+        });
+    };
+
+    QVERIFY(!corruptHeader([](ColumnarClip::FileHeader& fileHeader) { fileHeader.magic[0] = 'X'; }));
+    QVERIFY(!corruptHeader([](ColumnarClip::FileHeader& fileHeader) { fileHeader.version = ColumnarClip::VERSION + 1; }));
+    QVERIFY(!corruptHeader([](ColumnarClip::FileHeader& fileHeader) { fileHeader.frameCount = 0x7FFFFFFF; }));
+    QVERIFY(!corruptHeader([](ColumnarClip::FileHeader& fileHeader) { fileHeader.chunkCount = 0x7FFFFFFF; }));
+    QVERIFY(!corruptHeader([](ColumnarClip::FileHeader& fileHeader) { fileHeader.typeMapSize = 0x7FFFFFFF; }));
+
+    size_t lastChunk = header.chunkCount - 1;
+    QVERIFY(!corrupt([](QByteArray& corrupted) { columnarChunk(corrupted, 0)->firstFrame = 1; }));
+    QVERIFY(!corrupt([&](QByteArray& corrupted) { columnarChunk(corrupted, 1)->firstFrame = header.frameCount + 1; }));
+    QVERIFY(!corrupt([](QByteArray& corrupted) {
+        columnarChunk(corrupted, 2)->firstFrame = columnarChunk(corrupted, 1)->firstFrame - 1;
+    }));
+    QVERIFY(!corrupt([&](QByteArray& corrupted) { columnarChunk(corrupted, lastChunk)->fileOffset = corrupted.size() + 1; }));
+    QVERIFY(!corrupt([&](QByteArray& corrupted) { columnarChunk(corrupted, lastChunk)->storedSize = corrupted.size(); }));
+}
+
 int main(int, const char**) {
     setupHifiApplication("Recording Test");
 
     testFrameTypeRegistration();
     testFilePersist();
     testClipOrdering();
+    testColumnarClipPersist();
+    testColumnarClipSeek();
+    testColumnarClipUnknownFrames();
+    testColumnarClipCorruption();
 }
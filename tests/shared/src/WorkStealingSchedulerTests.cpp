@@ -0,0 +1,246 @@
+//
+//  WorkStealingSchedulerTests.cpp
+//  tests/shared/src
+//
+//  Created by Roxanne Skelly on 2019-06-14.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "WorkStealingSchedulerTests.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <PortableHighResolutionClock.h>
+#include <WorkStealingScheduler.h>
+
+QTEST_MAIN(WorkStealingSchedulerTests)
+
+const int NUM_BENCHMARK_NODES = 400;
+const int NUM_BENCHMARK_FRAMES = 200;
+const int HEAVY_NODE_INTERVAL = 10;
+const int LIGHT_NODE_COST = 200;
+const int HEAVY_NODE_COST = 20 * LIGHT_NODE_COST;
+
+// stands in for mixing one node - a listener near a crowd costs a lot more than one on its own
+static float mixSyntheticNode(int cost, float seed) {
+    float value = seed;
+    for (int i = 0; i < cost; ++i) {
+        value = value * 0.999f + 0.001f * (float)i;
+    }
+    return value;
+}
+
+static int nodeCost(int node) {
+    return (node % HEAVY_NODE_INTERVAL == 0) ? HEAVY_NODE_COST : LIGHT_NODE_COST;
+}
+
+// the pool the mixers used before - one shared queue, and a mutex and condition variable round trip per frame
+class SharedQueuePool {
+public:
+    using Function = std::function<void(int workerIndex, int item)>;
+
+    SharedQueuePool(int numThreads) : _numThreads(numThreads) {
+        for (int i = 0; i < numThreads; ++i) {
+            _threads.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    ~SharedQueuePool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+            ++_generation;
+        }
+        _workCondition.notify_all();
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    void run(int numItems, Function function) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _function = function;
+        _numItems = numItems;
+        _next = 0;
+        _numFinished = 0;
+        ++_generation;
+        _workCondition.notify_all();
+        _doneCondition.wait(lock, [&] { return _numFinished == _numThreads; });
+    }
+
+private:
+    void work(int workerIndex) {
+        int generation = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _workCondition.wait(lock, [&] { return _generation != generation; });
+                generation = _generation;
+                if (_stop) {
+                    return;
+                }
+            }
+
+            int item;
+            while ((item = pop()) != -1) {
+                _function(workerIndex, item);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                ++_numFinished;
+            }
+            _doneCondition.notify_one();
+        }
+    }
+
+    int pop() {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        return _next < _numItems ? _next++ : -1;
+    }
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::mutex _queueMutex;
+    std::condition_variable _workCondition;
+    std::condition_variable _doneCondition;
+    Function _function;
+    int _numThreads;
+    int _numItems { 0 };
+    int _next { 0 };
+    int _numFinished { 0 };
+    int _generation { 0 };
+    bool _stop { false };
+};
+
+static void reportPercentiles(const char* name, int numThreads, std::vector<uint64_t>& frameTimes) {
+    std::sort(frameTimes.begin(), frameTimes.end());
+    auto percentile = [&](float p) {
+        return frameTimes[std::min(frameTimes.size() - 1, (size_t)(p * frameTimes.size()))];
+    };
+    qDebug() << name << "threads:" << numThreads
+        << "p50:" << percentile(0.50f) << "us"
+        << "p90:" << percentile(0.90f) << "us"
+        << "p99:" << percentile(0.99f) << "us"
+        << "max:" << frameTimes.back() << "us";
+}
+
+template <typename F>
+static uint64_t timeFrame(F frame) {
+    auto start = p_high_resolution_clock::now();
+    frame();
+    auto elapsed = p_high_resolution_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+void WorkStealingSchedulerTests::testCoverage() {
+    const int NUM_THREADS = 4;
+    WorkStealingScheduler scheduler("Coverage", NUM_THREADS);
+    QCOMPARE(scheduler.getNumThreads(), NUM_THREADS);
+
+    for (int chunkSize : { 0, 1, 3, 64, 1000 }) {
+        for (int numItems : { 0, 1, 5, 257, 1000 }) {
+            std::vector<std::atomic<int>> hits(numItems);
+            for (auto& hit : hits) {
+                hit = 0;
+            }
+
+            std::vector<std::atomic<int>> workersBusy(NUM_THREADS);
+            for (auto& busy : workersBusy) {
+                busy = 0;
+            }
+            std::atomic<bool> overlapped { false };
+
+            scheduler.run(numItems, [&](int workerIndex, int begin, int end) {
+                if (workersBusy[workerIndex]++ != 0) {
+                    overlapped = true;
+                }
+                for (int i = begin; i < end; ++i) {
+                    ++hits[i];
+                }
+                --workersBusy[workerIndex];
+            }, chunkSize);
+
+            QVERIFY(!overlapped);
+            for (int i = 0; i < numItems; ++i) {
+                QCOMPARE(hits[i].load(), 1);
+            }
+        }
+    }
+}
+
+void WorkStealingSchedulerTests::testResize() {
+    WorkStealingScheduler scheduler("Resize");
+
+    // with no workers the range runs on the calling thread
+    int numRun = 0;
+    scheduler.run(10, [&](int workerIndex, int begin, int end) {
+        QCOMPARE(workerIndex, 0);
+        numRun += end - begin;
+    });
+    QCOMPARE(numRun, 10);
+
+    for (int numThreads : { 1, 8, 2, 5 }) {
+        scheduler.setNumThreads(numThreads);
+        QCOMPARE(scheduler.getNumThreads(), numThreads);
+
+        for (int frame = 0; frame < 100; ++frame) {
+            std::atomic<int> numItemsRun { 0 };
+            std::atomic<bool> badWorker { false };
+            scheduler.run(100, [&](int workerIndex, int begin, int end) {
+                if (workerIndex < 0 || workerIndex >= numThreads) {
+                    badWorker = true;
+                }
+                numItemsRun += end - begin;
+            });
+            QCOMPARE(numItemsRun.load(), 100);
+            QVERIFY(!badWorker);
+        }
+    }
+}
+
+void WorkStealingSchedulerTests::benchmark() {
+    for (int numThreads : { 1, 2, 4, 8, 16, 32, 64 }) {
+        // per-worker sinks so the synthetic work can't be optimized out
+        std::vector<float> sinks(numThreads, 0.0f);
+        std::vector<uint64_t> frameTimes;
+        frameTimes.reserve(NUM_BENCHMARK_FRAMES);
+
+        {
+            SharedQueuePool pool(numThreads);
+            for (int frame = 0; frame < NUM_BENCHMARK_FRAMES; ++frame) {
+                frameTimes.push_back(timeFrame([&] {
+                    pool.run(NUM_BENCHMARK_NODES, [&](int workerIndex, int node) {
+                        sinks[workerIndex] += mixSyntheticNode(nodeCost(node), (float)node);
+                    });
+                }));
+            }
+        }
+        reportPercentiles("shared queue  ", numThreads, frameTimes);
+
+        frameTimes.clear();
+        {
+            WorkStealingScheduler scheduler("Benchmark", numThreads);
+            for (int frame = 0; frame < NUM_BENCHMARK_FRAMES; ++frame) {
+                frameTimes.push_back(timeFrame([&] {
+                    scheduler.run(NUM_BENCHMARK_NODES, [&](int workerIndex, int begin, int end) {
+                        for (int node = begin; node < end; ++node) {
+                            sinks[workerIndex] += mixSyntheticNode(nodeCost(node), (float)node);
+                        }
+                    });
+                }));
+            }
+        }
+        reportPercentiles("work stealing ", numThreads, frameTimes);
+
+        QVERIFY(std::all_of(sinks.begin(), sinks.end(), [](float sink) { return sink == sink; }));
+    }
+}
@@ -0,0 +1,31 @@
+//
+//  WorkStealingSchedulerTests.h
+//  tests/shared/src
+//
+//  Created by Roxanne Skelly on 2019-06-14.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_WorkStealingSchedulerTests_h
+#define hifi_WorkStealingSchedulerTests_h
+
+#include <QtTest/QtTest>
+
+class WorkStealingSchedulerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    // Test that every item of a range is run exactly once, by one worker at a time, for various chunk sizes
+    void testCoverage();
+
+    // Test that jobs keep running correctly across thread count changes
+    void testResize();
+
+    // Report mix-like frame time percentiles at 1-64 threads against a shared-queue condition variable pool
+    void benchmark();
+};
+
+#endif // hifi_WorkStealingSchedulerTests_h
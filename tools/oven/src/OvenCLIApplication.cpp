@@ -23,6 +23,7 @@ static const QString CLI_INPUT_PARAMETER = "i";
 static const QString CLI_OUTPUT_PARAMETER = "o";
 static const QString CLI_TYPE_PARAMETER = "t";
 static const QString CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER = "disable-texture-compression";
+static const QString CLI_TEXTURE_COMPRESSION_THREADS_PARAMETER = "texture-compression-threads";
 
 OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
     QCoreApplication(argc, argv)
@@ -34,7 +35,8 @@ OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
         { CLI_INPUT_PARAMETER, "Path to file that you would like to bake.", "input" },
         { CLI_OUTPUT_PARAMETER, "Path to folder that will be used as output.", "output" },
         { CLI_TYPE_PARAMETER, "Type of asset.", "type" },
-        { CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER, "Disable texture compression." }
+        { CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER, "Disable texture compression." },
+        { CLI_TEXTURE_COMPRESSION_THREADS_PARAMETER, "Most threads to compress a texture on, 0 for one per core.", "count" }
     });
 
     parser.addHelpOption();
@@ -51,6 +53,10 @@ OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
             TextureBaker::setCompressionEnabled(false);
         }
 
+        if (parser.isSet(CLI_TEXTURE_COMPRESSION_THREADS_PARAMETER)) {
+            image::setMaxCompressionThreads(parser.value(CLI_TEXTURE_COMPRESSION_THREADS_PARAMETER).toInt());
+        }
+
         QMetaObject::invokeMethod(cli, "bakeFile", Qt::QueuedConnection, Q_ARG(QUrl, inputUrl),
                                     Q_ARG(QString, outputUrl.toString()), Q_ARG(QString, type));
     } else {
@@ -0,0 +1,107 @@
+//
+//  main.cpp
+//  tools/recording-converter/src
+//
+//  Created by Roxanne Skelly on 2019-06-27.
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonObject>
+
+#include <SharedUtil.h>
+
+#include <recording/Clip.h>
+#include <recording/Frame.h>
+#include <recording/impl/ColumnarClip.h>
+#include <recording/impl/FileClip.h>
+
+// Converts recordings in the record based .hfr format to the columnar format playback maps in place
+int main(int argc, char* argv[]) {
+    setupHifiApplication("Recording Converter");
+
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity Recording Converter");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+    const QCommandLineOption uncompressedOption("uncompressed", "store the frame data uncompressed");
+    parser.addOption(uncompressedOption);
+    const QCommandLineOption verifyOption("verify", "read the converted recording back and compare it with the original");
+    parser.addOption(verifyOption);
+    parser.addPositionalArgument("input", "recording to convert");
+    parser.addPositionalArgument("output", "converted recording");
+
+    if (!parser.parse(app.arguments())) {
+        qCritical() << parser.errorText();
+        parser.showHelp(1);
+    }
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+    }
+
+    auto arguments = parser.positionalArguments();
+    if (arguments.size() != 2) {
+        parser.showHelp(1);
+    }
+    const QString& inputPath = arguments[0];
+    const QString& outputPath = arguments[1];
+
+    if (recording::ColumnarClip::isColumnarFile(inputPath)) {
+        qCritical() << inputPath << "is already columnar";
+        return 2;
+    }
+
+    // the source only keeps frames of types registered here, so register every type it was recorded with
+    auto clip = std::make_shared<recording::FileClip>(inputPath);
+    auto frameTypeNames = clip->getHeader().object()[recording::Clip::FRAME_TYPE_MAP].toObject().keys();
+    for (const auto& frameTypeName : frameTypeNames) {
+        recording::Frame::registerFrameType(frameTypeName);
+    }
+    clip = std::make_shared<recording::FileClip>(inputPath);
+    if (clip->frameCount() == 0) {
+        qCritical() << "Unable to read" << inputPath;
+        return 2;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    bool compressed = !parser.isSet(uncompressedOption);
+    if (!recording::ColumnarClip::write(outputPath, clip, compressed)) {
+        qCritical() << "Unable to write" << outputPath;
+        return 3;
+    }
+    qDebug() << "Converted" << clip->frameCount() << "frames in" << timer.elapsed() << "ms,"
+        << QFileInfo(inputPath).size() << "bytes to" << QFileInfo(outputPath).size();
+
+    if (parser.isSet(verifyOption)) {
+        auto converted = recording::ColumnarClip::fromFile(outputPath);
+        if (!converted || converted->frameCount() != clip->frameCount()) {
+            qCritical() << "Converted recording has" << (converted ? converted->frameCount() : 0) << "frames, expected"
+                << clip->frameCount();
+            return 4;
+        }
+
+        clip->seek(0);
+        converted->seek(0);
+        size_t frameIndex = 0;
+        for (auto frame = clip->nextFrame(); frame; frame = clip->nextFrame(), ++frameIndex) {
+            auto convertedFrame = converted->nextFrame();
+            if (!convertedFrame || convertedFrame->type != frame->type ||
+                convertedFrame->timeOffset != frame->timeOffset || convertedFrame->data != frame->data) {
+                qCritical() << "Frame" << frameIndex << "differs";
+                return 4;
+            }
+        }
+        qDebug() << "Verified" << frameIndex << "frames";
+    }
+
+    return 0;
+}
@@ -13,11 +13,13 @@
 
 #include <QtCore/QDebug>
 
+#include <udt/BBRCC.h>
 #include <udt/Constants.h>
 #include <udt/Packet.h>
 #include <udt/PacketList.h>
 
 #include <LogHandler.h>
+#include <SharedUtil.h>
 
 const QCommandLineOption PORT_OPTION { "p", "listening port for socket (defaults to random)", "port", 0 };
 const QCommandLineOption TARGET_OPTION {
@@ -55,6 +57,27 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption CONGESTION_CONTROL {
+    "congestion-control", "congestion control for sent packets, vegas or bbr (default is vegas)", "name"
+};
+const QCommandLineOption IMPAIR_DELAY {
+    "delay", "emulated one-way delay added to everything the test sends (default is none)", "milliseconds"
+};
+const QCommandLineOption IMPAIR_JITTER {
+    "jitter", "emulated jitter, up to this much more delay at random (default is none)", "milliseconds"
+};
+const QCommandLineOption IMPAIR_LOSS {
+    "loss", "emulated loss of everything the test sends (default is none)", "percent"
+};
+const QCommandLineOption IMPAIR_RATE_CAP {
+    "rate-cap", "emulated bottleneck for everything the test sends (default is uncapped)", "Mb/s"
+};
+const QCommandLineOption IMPAIR_SEED {
+    "impairment-seed", "seed for emulated jitter and loss, to reproduce a run (default is 742272)", "integer"
+};
+const QCommandLineOption LOOPBACK {
+    "loopback", "send to an in-process receiver on localhost and report throughput once max-send-bytes arrive"
+};
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (Mb/s)", "Est. Max (Mb/s)", "RTT (ms)", "CW (P)", "Period (us)",
@@ -95,6 +118,31 @@ UDTTest::UDTTest(int& argc, char** argv) :
         }
     }
     
+    if (_argumentParser.isSet(LOOPBACK)) {
+        if (_argumentParser.isSet(TARGET_OPTION)) {
+            qCritical() << "Cannot set a target AND send over loopback.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        } else if (!_argumentParser.isSet(MAX_SEND_BYTES)) {
+            qCritical() << "Sending over loopback requires max-send-bytes to know when to report throughput.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        } else {
+            setupLoopbackReceiver();
+        }
+    }
+    
+    if (_argumentParser.isSet(CONGESTION_CONTROL)) {
+        auto congestionControl = _argumentParser.value(CONGESTION_CONTROL);
+        if (congestionControl == "bbr") {
+            _socket.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(
+                new udt::CongestionControlFactory<udt::BBRCC>()));
+        } else if (congestionControl != "vegas") {
+            qCritical() << "Unknown congestion control" << congestionControl << "- expected vegas or bbr.";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        }
+    }
+
+    setupNetworkImpairment();
+
     if (_argumentParser.isSet(PACKET_SIZE)) {
         // parse the desired packet size
         _minPacketSize = _maxPacketSize = _argumentParser.value(PACKET_SIZE).toInt();
@@ -168,6 +216,7 @@ UDTTest::UDTTest(int& argc, char** argv) :
     _generator.seed(messageSeed);
     
     if (!_target.isNull()) {
+        _loopbackStartUsecs = usecTimestampNow();
         sendInitialPackets();
     } else {
         // this is a receiver - in case there are ordered packets (messages) being sent to us make sure that we handle them
@@ -224,7 +273,8 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, LOOPBACK, CONGESTION_CONTROL,
+        IMPAIR_DELAY, IMPAIR_JITTER, IMPAIR_LOSS, IMPAIR_RATE_CAP, IMPAIR_SEED
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -239,6 +289,76 @@ void UDTTest::parseArguments() {
     }
 }
 
+void UDTTest::setupLoopbackReceiver() {
+    _loopbackSocket.reset(new udt::Socket());
+    _loopbackSocket->bind(QHostAddress::LocalHost);
+
+    // the receiver only counts what arrives - ordered data is verified by running a separate listening udt-test
+    auto countBytes = [this](std::unique_ptr<udt::Packet> packet) {
+        _loopbackReceivedBytes += packet->getDataSize();
+    };
+    _loopbackSocket->setPacketHandler(countBytes);
+    _loopbackSocket->setMessageHandler(countBytes);
+
+    _target = HifiSockAddr(QHostAddress::LocalHost, _loopbackSocket->localPort());
+    qDebug() << "Packets will be sent to the loopback receiver at" << _target;
+}
+
+void UDTTest::setupNetworkImpairment() {
+    static const int USECS_PER_MSEC = 1000;
+    static const double PERCENT = 100.0;
+    static const int BITS_PER_MEGABIT = 1000000;
+
+    udt::NetworkImpairment::Settings settings;
+    bool isImpaired = false;
+
+    if (_argumentParser.isSet(IMPAIR_DELAY)) {
+        settings.delayUsecs = (int)(_argumentParser.value(IMPAIR_DELAY).toDouble() * USECS_PER_MSEC);
+        isImpaired = true;
+    }
+    if (_argumentParser.isSet(IMPAIR_JITTER)) {
+        settings.jitterUsecs = (int)(_argumentParser.value(IMPAIR_JITTER).toDouble() * USECS_PER_MSEC);
+        isImpaired = true;
+    }
+    if (_argumentParser.isSet(IMPAIR_LOSS)) {
+        settings.lossRate = _argumentParser.value(IMPAIR_LOSS).toDouble() / PERCENT;
+        isImpaired = true;
+    }
+    if (_argumentParser.isSet(IMPAIR_RATE_CAP)) {
+        settings.rateCapBitsPerSecond = (int)(_argumentParser.value(IMPAIR_RATE_CAP).toDouble() * BITS_PER_MEGABIT);
+        isImpaired = true;
+    }
+    if (_argumentParser.isSet(IMPAIR_SEED)) {
+        settings.seed = _argumentParser.value(IMPAIR_SEED).toUInt();
+    }
+
+    if (isImpaired) {
+        _socket.setNetworkImpairment(settings);
+
+        // over loopback impair the ACKs on the way back too, so the delay shows up in the RTT both ways
+        if (_loopbackSocket) {
+            _loopbackSocket->setNetworkImpairment(settings);
+        }
+    }
+}
+
+void UDTTest::reportLoopbackThroughput() {
+    static const double MEGABITS_PER_BYTE = 8.0 / 1000000.0;
+
+    quint64 receivedBytes = _loopbackReceivedBytes;
+    if (receivedBytes < (quint64)_maxSendBytes) {
+        return;
+    }
+
+    double elapsedSeconds = (double)(usecTimestampNow() - _loopbackStartUsecs) / USECS_PER_SECOND;
+
+    qDebug() << "Received" << receivedBytes << "bytes over loopback in"
+        << qPrintable(QString::number(elapsedSeconds, 'f', 3)) << "s -"
+        << qPrintable(QString::number(receivedBytes * MEGABITS_PER_BYTE / elapsedSeconds, 'f', 2)) << "Mb/s";
+
+    quit();
+}
+
 void UDTTest::sendInitialPackets() {
     static const int NUM_INITIAL_PACKETS = 500;
     
@@ -391,6 +511,10 @@ void UDTTest::sampleStats() {
         
         // output this line of values
         qDebug() << qPrintable(values.join(" | "));
+
+        if (_loopbackSocket) {
+            reportLoopbackThroughput();
+        }
     } else {
         if (first) {
             // output the headers for stats for our table
@@ -15,6 +15,7 @@
 #define hifi_UDTTest_h
 
 
+#include <atomic>
 #include <random>
 
 #include <QtCore/QCoreApplication>
@@ -41,6 +42,9 @@ public slots:
     
 private:
     void parseArguments();
+    void setupLoopbackReceiver(); // binds an in-process receiver on localhost and targets it
+    void setupNetworkImpairment(); // emulates the delay, jitter, loss and rate cap we were asked for
+    void reportLoopbackThroughput();
     void handleMessage(std::unique_ptr<Message> message);
     
     void sendInitialPackets(); // fills the queue with packets to start
@@ -71,6 +75,10 @@ private:
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+
+    std::unique_ptr<udt::Socket> _loopbackSocket; // receives our own packets when benchmarking over loopback
+    std::atomic<quint64> _loopbackReceivedBytes { 0 };
+    quint64 _loopbackStartUsecs { 0 };
 };
 
 #endif // hifi_UDTTest_h